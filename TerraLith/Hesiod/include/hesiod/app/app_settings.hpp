@@ -85,8 +85,16 @@ struct AppSettings
     bool enable_smart_preview_cache = true;
     int  cache_memory_limit_mb = 512;
     bool enable_incremental_evaluation = true;
-    int  default_resolution = 2048;  // 1024, 2048, 4096, 8192
-    int  default_tiling = 4;         // 2x2, 4x4, 8x8
+    int  node_output_cache_limit_mb = 1024; // memoized node outputs
+    bool enable_disk_cache = true;          // node outputs saved next to the project
+    int  disk_cache_limit_mb = 4096;
+    int  bake_memory_budget_mb = 8192;      // variants baked at the same time
+    int  default_resolution = 2048;         // 1024, 2048, 4096, 8192
+    int  default_tiling = 4;                // 2x2, 4x4, 8x8
+    int  compute_threads = 0;               // thread pool size, 0 = hardware concurrency
+    int  max_concurrent_nodes = 0;          // 0 = auto, thread budget split by tile count
+    bool enable_progressive_preview = true; // coarse level first, then full resolution
+    int  progressive_preview_factor = 4;    // resolution divider of the coarse level
   } performance;
 
   // 0.6: Vulkan tab settings
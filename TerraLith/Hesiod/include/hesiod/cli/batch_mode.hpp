@@ -25,7 +25,8 @@ void run_batch_mode(const std::string     &filename,
                     const hmap::Vec2<int> &shape,
                     const hmap::Vec2<int> &tiling,
                     float                  overlap,
-                    const GraphConfig     *p_input_model_config = nullptr);
+                    const GraphConfig     *p_input_model_config = nullptr,
+                    int                    nvariants = 0);
 void run_node_inventory();
 void run_snapshot_generation();
 
@@ -0,0 +1,102 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
+   License. The full license is in the file LICENSE, distributed with this software. */
+#pragma once
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hesiod
+{
+
+// Content-addressed node output cache.
+// Entries are keyed by a hash of everything a node computation depends on
+// (node type, attribute values, graph config and hashes of the input data),
+// so that any node recomputed with the same key can reuse the outputs
+// instead of running its compute function (undo/redo, slider round trips,
+// duplicated nodes...). Bounded in memory, least recently used entries are
+// evicted first.
+//
+// Entries can also be persisted in a sidecar directory of the project (one
+// compressed file per key), so that reopening a project restores the node
+// outputs instead of recomputing them. The (de)serialization of the entries
+// is done by the nodes, the cache only handles the files.
+class NodeOutputCache
+{
+public:
+  struct Entry
+  {
+    std::vector<std::any> values; // copies of the output port data
+    std::vector<uint64_t> hashes; // content hashes of the output port data
+    size_t                size_bytes = 0;
+  };
+
+  static NodeOutputCache &instance();
+
+  // Store the outputs of a computation (replaces any entry with the same key)
+  void store(uint64_t key, Entry entry);
+
+  // Retrieve the outputs of a computation, returns false if not cached
+  bool retrieve(uint64_t key, Entry &entry);
+
+  // Same as retrieve, without counting a hit nor touching the entry (saving)
+  bool peek(uint64_t key, Entry &entry) const;
+
+  // Clear the entire cache
+  void clear();
+
+  // Get cache statistics
+  float get_hit_rate() const;
+  float get_memory_usage_mb() const;
+
+  // Set memory limit (MB)
+  void set_memory_limit_mb(int limit_mb);
+
+  // Set the disk cache directory (empty path to disable the disk tier)
+  void                  set_disk_cache_dir(const std::filesystem::path &dir);
+  std::filesystem::path get_disk_cache_dir() const;
+
+  // Set disk limit (MB), least recently used files are removed first
+  void set_disk_limit_mb(int limit_mb);
+
+  // Check if an entry has been written to disk
+  bool has_on_disk(uint64_t key) const;
+
+  // Read / write the serialized data of an entry (compressed on disk)
+  bool read_from_disk(uint64_t key, std::string &blob) const;
+  void write_to_disk(uint64_t key, const std::string &blob) const;
+
+  // Remove the least recently used files exceeding the disk limit
+  void evict_disk_if_needed() const;
+
+private:
+  NodeOutputCache() = default;
+  NodeOutputCache(const NodeOutputCache &) = delete;
+  NodeOutputCache &operator=(const NodeOutputCache &) = delete;
+
+  // LRU eviction support
+  void evict_if_needed();
+  void erase(uint64_t key);
+
+  std::filesystem::path get_disk_path(uint64_t key) const;
+
+  std::unordered_map<uint64_t, Entry>                         cache_;
+  std::list<uint64_t>                                         lru_order_;
+  std::unordered_map<uint64_t, std::list<uint64_t>::iterator> lru_map_;
+  mutable std::mutex                                          mutex_;
+
+  size_t memory_limit_bytes_ = 1024 * 1024 * 1024; // 1 GB default
+  size_t current_memory_bytes_ = 0;
+  size_t cache_hits_ = 0;
+  size_t cache_misses_ = 0;
+
+  std::filesystem::path disk_dir_ = {};
+  size_t                disk_limit_bytes_ = 4096ull * 1024 * 1024; // 4 GB default
+};
+
+} // namespace hesiod
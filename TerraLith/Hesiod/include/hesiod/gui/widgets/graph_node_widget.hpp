@@ -4,6 +4,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 
 #include <QScrollArea>
 #include <QThread>
@@ -152,6 +153,7 @@ private slots:
   void on_worker_node_compute_started(const std::string &node_id);
   void on_worker_node_compute_finished(const std::string &node_id);
   void on_worker_progress_updated(const std::string &node_id, float percent);
+  void on_worker_preview_finished();
   void on_worker_node_execution_time(const std::string &node_id, float time_ms, int backend_type);
   void on_worker_compute_all_finished(bool was_cancelled);
 
@@ -182,9 +184,10 @@ private:
   bool                               suppress_undo_ = false; // when true, skip pushing undo commands
 
   // Background compute
-  QThread     *worker_thread_ = nullptr;
-  GraphWorker *graph_worker_  = nullptr;
-  bool         is_computing_  = false;
+  QThread              *worker_thread_ = nullptr;
+  GraphWorker          *graph_worker_  = nullptr;
+  bool                  is_computing_  = false;
+  std::set<std::string> pending_ids_; // edited while computing, restarted afterwards
 
   // Saved callbacks (suppressed during background compute)
   std::function<void(const std::string &)>              saved_compute_started_;
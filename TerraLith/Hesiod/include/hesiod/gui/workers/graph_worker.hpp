@@ -3,6 +3,9 @@
  * this software. */
 #pragma once
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -20,9 +23,14 @@ class GraphWorker : public QObject
 public:
   explicit GraphWorker(QObject *parent = nullptr);
 
+  // with a 'preview_factor' larger than 1, the nodes are first computed at a
+  // resolution divided by this factor (see ScopedPreviewResolution), then refined at
+  // full resolution once the preview has been acknowledged
   void configure(GraphNode                      *p_graph,
-                 const std::vector<std::string> &sorted_node_ids);
+                 const std::vector<std::string> &sorted_node_ids,
+                 int                             preview_factor = 1);
 
+  void acknowledge_preview(); // preview displayed, refinement can start
   void request_cancel();
   bool is_cancel_requested() const;
 
@@ -33,13 +41,23 @@ signals:
   void node_compute_started(const std::string &node_id);
   void node_compute_finished(const std::string &node_id);
   void progress_updated(const std::string &node_id, float progress_percent);
+  void preview_finished();
   void node_execution_time(const std::string &node_id, float time_ms, int backend_type);
   void compute_all_finished(bool was_cancelled);
 
 private:
+  // outputs of the 'reset_ids' nodes are reallocated at full resolution before
+  // their computation, returns false if cancelled
+  bool compute_nodes(const std::vector<std::string> &node_ids,
+                     const std::set<std::string>    &reset_ids);
+
   GraphNode                *p_graph_ = nullptr;
   std::vector<std::string>  sorted_ids_;
+  int                       preview_factor_ = 1;
   std::atomic<bool>         cancel_requested_{false};
+  bool                      preview_acknowledged_ = false;
+  std::mutex                preview_mutex_;
+  std::condition_variable   preview_cv_;
 };
 
 } // namespace hesiod
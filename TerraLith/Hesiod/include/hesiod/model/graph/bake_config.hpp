@@ -26,6 +26,11 @@ struct BakeConfig
   std::string           base_name = "";     // empty = use project name
   int                   format_override = -1; // -1 = use node settings, 0=PNG8, 1=PNG16, 2=RAW16
 
+  // export directory of the variant 'k' (0 being the unmodified seeds), auto-derived
+  // from the project path if no export path is set
+  std::filesystem::path get_variant_export_path(const std::filesystem::path &project_path,
+                                                int                          k) const;
+
   void           json_from(nlohmann::json const &json);
   nlohmann::json json_to() const;
 };
@@ -33,6 +38,11 @@ struct BakeConfig
 // =====================================
 // Functions
 // =====================================
+void override_export_nodes_settings(nlohmann::json              &json,
+                                    const std::filesystem::path &export_path,
+                                    unsigned int                 random_seeds_increment,
+                                    const BakeConfig            &bake_settings);
+
 void override_export_nodes_settings(const std::string           &fname,
                                     const std::filesystem::path &export_path,
                                     unsigned int                 random_seeds_increment,
@@ -52,6 +52,15 @@ public:
   void reseed(bool backward);
   void update();
 
+  // low-memory batch mode, outputs are only allocated while needed (to be set
+  // before loading)
+  bool get_lazy_outputs() const { return this->lazy_outputs; }
+  void set_lazy_outputs(bool new_lazy_outputs) { this->lazy_outputs = new_lazy_outputs; }
+  void update_batch();
+
+  // write the node outputs not yet in the persistent output cache
+  void store_outputs_on_disk();
+
   // --- Serialization ---
   void           json_from(nlohmann::json const &json, GraphConfig *p_config);
   void           json_from(nlohmann::json const &json);
@@ -79,6 +88,7 @@ private:
   std::vector<std::string> graph_order;
   BroadcastMap             broadcast_params;
   FlattenConfig            export_param;
+  bool                     lazy_outputs = false;
 };
 
 } // namespace hesiod
@@ -2,6 +2,7 @@
    License. The full license is in the file LICENSE, distributed with this software. */
 #pragma once
 #include <functional>
+#include <set>
 
 #include "nlohmann/json.hpp"
 
@@ -14,7 +15,8 @@
 namespace hesiod
 {
 
-class BaseNode; // forward
+class BaseNode;      // forward
+class HeightmapPool; // forward
 
 // =====================================
 // GraphNode
@@ -47,6 +49,7 @@ public:
   virtual void remove_node(const std::string &id) override;
   void         update() override;
   void         update(const std::string &node_id) override;
+  void         post_update() override; // graph at rest, collects the node outputs
 
   // --- Inter-graph Broadcasting ---
   BroadcastMap *get_p_broadcast_params() { return this->p_broadcast_params; }
@@ -56,6 +59,23 @@ public:
   // --- Others... ---
   void reseed(bool backward);
 
+  // --- Scheduling ---
+  int  get_max_concurrent_nodes() const;
+  void update_max_workers();
+
+  // --- Low-memory batch update ---
+  // With lazy outputs, the heightmap outputs are released as soon as the nodes
+  // are created and only allocated when the node is computed by 'update_batch',
+  // which also releases them once their last consumer is done (except for the
+  // pinned nodes and the broadcast nodes). If 'p_node_ids' is provided, only these
+  // nodes are computed, the outputs of the other nodes they read are expected to be
+  // set by the caller and are left untouched (see VariantBaker)
+  bool get_lazy_outputs() const { return this->lazy_outputs; }
+  void set_lazy_outputs(bool new_lazy_outputs) { this->lazy_outputs = new_lazy_outputs; }
+  void update_batch(HeightmapPool                &pool,
+                    const std::set<std::string> &pinned_node_ids = {},
+                    const std::set<std::string> *p_node_ids = nullptr);
+
   // --- Compute Callbacks
   std::function<void(const std::string &node_id)> compute_started;
   std::function<void(const std::string &node_id)> compute_finished;
@@ -78,10 +98,15 @@ private:
   // --- Helpers ---
   void setup_new_broadcast_node(BaseNode *p_node);
   void setup_new_receive_node(BaseNode *p_node);
+  void allocate_node_outputs(BaseNode *p_node, HeightmapPool &pool);
+  void release_node_outputs(BaseNode            *p_node,
+                            HeightmapPool       *p_pool,
+                            const std::set<int> &kept_port_ids = {});
 
   // --- Members ---
   std::shared_ptr<GraphConfig> config;
   BroadcastMap                *p_broadcast_params = nullptr; // own by GraphManager
+  bool                         lazy_outputs = false;
 };
 
 } // namespace hesiod
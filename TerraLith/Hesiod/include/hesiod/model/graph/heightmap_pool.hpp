@@ -0,0 +1,60 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
+   License. The full license is in the file LICENSE, distributed with this software. */
+#pragma once
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "highmap/heightmap.hpp"
+
+namespace hesiod
+{
+
+// Recycles heightmap buffers released by the low-memory batch update
+// (see GraphNode::update_batch). Heightmaps are bucketed by layout
+// (shape, tiling and overlap), i.e. by tile sizes, so that an acquired
+// heightmap can be used as is by the computing node. Thread-safe.
+class HeightmapPool
+{
+public:
+  HeightmapPool() = default;
+
+  // returns a zero-filled heightmap, from the pool if a buffer with the
+  // same layout is available. The bytes are accounted to 'p_owner', the
+  // storage the heightmap is handed to (e.g. a node output), several
+  // buffers can be acquired for the same owner (RGBA channels)
+  hmap::Heightmap acquire(const void     *p_owner,
+                          hmap::Vec2<int> shape,
+                          hmap::Vec2<int> tiling,
+                          float           overlap);
+
+  // gives the buffer back to the pool, heightmaps with tiles still
+  // shared with another heightmap (copy-on-write) are simply dropped.
+  // The bytes acquired for 'p_owner' are deducted at its first release,
+  // whatever the owner did with the buffers (nodes often replace them),
+  // an owner unknown to the pool is pooled without accounting
+  void release(const void *p_owner, hmap::Heightmap &&h);
+
+  void clear();
+
+  size_t get_allocated_bytes() const;
+  size_t get_peak_bytes() const;
+  size_t get_pooled_bytes() const;
+  size_t get_reuse_count() const;
+
+private:
+  using Key = std::tuple<int, int, int, int, float>;
+
+  static size_t get_bytes(const hmap::Heightmap &h);
+
+  std::map<Key, std::vector<hmap::Heightmap>> buckets;
+  size_t                                      allocated_bytes = 0; // acquired, in use
+  size_t                                      peak_bytes = 0;
+  size_t                                      pooled_bytes = 0;
+  size_t                                      reuse_count = 0;
+  std::map<const void *, size_t>              acquired; // owner -> bytes
+  mutable std::mutex                          mtx;
+};
+
+} // namespace hesiod
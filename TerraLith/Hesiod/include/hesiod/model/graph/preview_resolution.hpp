@@ -0,0 +1,65 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
+   License. The full license is in the file LICENSE, distributed with this software. */
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gnode/data.hpp"
+
+#include "hesiod/model/graph/graph_config.hpp"
+
+namespace hesiod
+{
+
+class GraphNode; // forward
+
+// Coarse level of the progressive (coarse-to-fine) evaluation of the graph editor.
+//
+// While the object lives, the given nodes use a copy of the graph config with its
+// shape divided by 'factor' (the graph config itself, read by the GUI, is left
+// untouched), their outputs are reallocated at this reduced resolution and their
+// inputs read from the other nodes (full resolution, not recomputed) are replaced by
+// downsampled copies. The parameters relative to the resolution (radii computed as
+// 'attr * shape.x'...) therefore scale consistently. The nodes are not memoized.
+//
+// On destruction the graph config and the links are restored but the outputs of the
+// nodes keep the reduced resolution: 'BaseNode::propagate_config_change' must be
+// called before recomputing them at full resolution.
+class ScopedPreviewResolution
+{
+public:
+  ScopedPreviewResolution(GraphNode                      &graph,
+                          const std::vector<std::string> &node_ids,
+                          int                             factor);
+  ~ScopedPreviewResolution();
+
+  ScopedPreviewResolution(const ScopedPreviewResolution &) = delete;
+  ScopedPreviewResolution &operator=(const ScopedPreviewResolution &) = delete;
+
+  // nodes among 'sorted_ids' which can be computed at a reduced resolution, i.e. not
+  // the nodes with side effects (exports, broadcasting) and their descendants. Empty
+  // if the reduced resolution is not worth it
+  static std::vector<std::string> get_node_ids(GraphNode                      &graph,
+                                               const std::vector<std::string> &sorted_ids,
+                                               int                             factor);
+
+  // reduced shape, equal to the config shape if the factor cannot be applied
+  static hmap::Vec2<int> get_shape(const GraphConfig &config, int factor);
+
+private:
+  struct Relink
+  {
+    std::string                      node_id;
+    int                              port_index;
+    std::shared_ptr<gnode::BaseData> data; // original data
+  };
+
+  GraphNode                                    &graph;
+  std::vector<std::string>                      node_ids;
+  std::shared_ptr<GraphConfig>                  config; // reduced resolution
+  std::vector<Relink>                           relinks;
+  std::vector<std::shared_ptr<gnode::BaseData>> downsampled_data;
+};
+
+} // namespace hesiod
@@ -0,0 +1,66 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
+   License. The full license is in the file LICENSE, distributed with this software. */
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "nlohmann/json.hpp"
+
+#include "hesiod/model/graph/bake_config.hpp"
+#include "hesiod/model/graph/graph_config.hpp"
+
+namespace hesiod
+{
+
+class GraphManager; // forward
+
+// Bakes the variants of a project (variant 0 with the seeds of the project, variant k
+// with the seeds incremented by k) from a single load of the graphs.
+//
+// The nodes depending on the variant index are the nodes with a seed attribute and
+// the export nodes (see override_export_nodes_settings), plus everything downstream,
+// including the Receive nodes of a variant-dependent broadcast tag. Variant 0 is
+// computed first and keeps the outputs of the invariant nodes read by the
+// variant-dependent ones. The other variants then only compute the variant-dependent
+// nodes, reading these shared outputs, several variants at a time within a memory
+// budget. The heightmap tiles are copy-on-write: a shared output is only duplicated
+// if a node of the variant writes to it, which is accounted in the memory footprint
+// of a variant.
+class VariantBaker
+{
+public:
+  // 'json' is the project data (with the "graph_manager" key), 'config' is used
+  // for all the graphs
+  VariantBaker(const nlohmann::json        &json,
+               const GraphConfig           &config,
+               const BakeConfig            &bake_settings,
+               const std::filesystem::path &project_path);
+
+  // returns the number of variants successfully baked (including variant 0)
+  int bake(size_t memory_budget_mb);
+
+  // called after each variant (from the baking threads)
+  std::function<void(int k, int ndone, int nvariants)> variant_done;
+
+private:
+  nlohmann::json                build_variant_json(int k) const;
+  std::shared_ptr<GraphManager> load_variant(int k) const;
+  void find_variant_nodes(GraphManager &graph_manager);
+  bool run_variant(int k, GraphManager &reference, size_t *p_peak_bytes) const;
+
+  nlohmann::json        json;
+  GraphConfig           config;
+  BakeConfig            bake_settings;
+  std::filesystem::path project_path;
+
+  // per graph: nodes computed for each variant, and invariant nodes whose outputs
+  // are read by them
+  std::map<std::string, std::set<std::string>> variant_node_ids;
+  std::map<std::string, std::set<std::string>> shared_node_ids;
+};
+
+} // namespace hesiod
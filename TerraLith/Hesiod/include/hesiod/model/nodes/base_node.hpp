@@ -1,7 +1,9 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General Public
    License. The full license is in the file LICENSE, distributed with this software. */
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <stdexcept>
 
@@ -40,6 +42,7 @@ public:
   // --- Configuration ---
   std::shared_ptr<const GraphConfig> get_config_ref() const;
   void                               propagate_config_change();
+  void set_config_ref(std::weak_ptr<GraphConfig> new_config); // see ScopedPreviewResolution
 
   // --- Runtime info ---
   NodeRuntimeInfo get_runtime_info() const;
@@ -59,11 +62,22 @@ public:
   void set_compute_vulkan_fct(std::function<bool(BaseNode &node)> fct);
   bool supports_vulkan_compute() const;
   ComputeBackend get_last_backend_used() const;
+  bool           was_cancelled() const; // last compute interrupted by the context
 
   // --- GPU toggle ---
   void set_vulkan_enabled(bool enabled);
   bool is_vulkan_enabled() const;
 
+  // --- Memoization (outputs reused when parameters and inputs are unchanged) ---
+  void     collect_outputs(); // drops the detached tiles, nobody may read the outputs
+  bool     copy_outputs_from(const BaseNode &source); // same node in another graph
+  uint64_t get_output_hash(int port_index) const;     // 0 if unknown
+  void     invalidate_memo();
+  bool     is_memoizable() const;
+  void     set_memoization_enabled(bool enabled);
+  bool     was_reused() const; // last compute reused the outputs
+  void     store_outputs_on_disk(); // persistent tier of the output cache
+
   // --- Serialization ---
   virtual void           json_from(nlohmann::json const &json);
   virtual nlohmann::json json_to() const;
@@ -116,6 +130,12 @@ public:
   std::function<void(const std::string &id)> compute_started;
 
 private:
+  // --- Memoization ---
+  uint64_t compute_memo_key() const; // 0 if the key cannot be determined
+  void     hash_outputs();
+  bool     restore_outputs(uint64_t key);
+  void     store_outputs(uint64_t key);
+
   // --- Members ---
   std::map<std::string, std::unique_ptr<attr::AbstractAttribute>> attr = {};
 
@@ -128,6 +148,12 @@ private:
   std::function<void(BaseNode &node)> compute_fct = nullptr;
   std::function<bool(BaseNode &node)> compute_vulkan_fct = nullptr;
   bool                                vulkan_enabled_ = true;
+  bool                                memoization_enabled_ = true;
+  std::atomic<uint64_t>               memo_key_ = 0; // key of the current outputs,
+                                                     // also read when saving
+  std::vector<uint64_t>               output_hashes_ = {};
+  bool                                reused_ = false;
+  bool                                cancelled_ = false;
 };
 
 // =====================================
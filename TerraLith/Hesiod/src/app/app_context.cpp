@@ -6,6 +6,7 @@
 #include <QStandardPaths>
 
 #include "hesiod/app/app_context.hpp"
+#include "hesiod/core/node_output_cache.hpp"
 #include "hesiod/logger.hpp"
 #include "hesiod/model/graph/graph_manager.hpp"
 #include "hesiod/model/utils.hpp"
@@ -13,6 +14,18 @@
 namespace hesiod
 {
 
+// the persistent node output cache is a sidecar directory of the project file
+static void helper_set_disk_cache_dir(const AppSettings &settings,
+                                      const std::string &fname)
+{
+  std::filesystem::path dir = {};
+
+  if (settings.performance.enable_disk_cache)
+    dir = std::filesystem::path(fname + ".cache");
+
+  NodeOutputCache::instance().set_disk_cache_dir(dir);
+}
+
 void AppContext::initialize()
 {
   Logger::log()->trace("AppContext::initialize");
@@ -89,6 +102,9 @@ void AppContext::load_project_model(const std::string &fname)
 
   this->new_project();
 
+  // valid node outputs are restored from the disk cache during the update
+  helper_set_disk_cache_dir(this->app_settings, fname);
+
   nlohmann::json json = json_from_file(fname);
   this->project_model->json_from(json);
 }
@@ -115,6 +131,9 @@ void AppContext::save_project_model(const std::string &fname) const
 
   nlohmann::json json = this->project_model->json_to();
   json_to_file(json, fname, /* merge_with_existing_content */ true);
+
+  helper_set_disk_cache_dir(this->app_settings, fname);
+  this->project_model->get_graph_manager_ref()->store_outputs_on_disk();
 }
 
 void AppContext::save_settings() const
@@ -168,10 +168,30 @@ void AppSettings::json_from(nlohmann::json const &json)
   json_safe_get(json,
                 "performance.enable_incremental_evaluation",
                 performance.enable_incremental_evaluation);
+  json_safe_get(json,
+                "performance.node_output_cache_limit_mb",
+                performance.node_output_cache_limit_mb);
+  json_safe_get(json, "performance.enable_disk_cache", performance.enable_disk_cache);
+  json_safe_get(json,
+                "performance.disk_cache_limit_mb",
+                performance.disk_cache_limit_mb);
+  json_safe_get(json,
+                "performance.bake_memory_budget_mb",
+                performance.bake_memory_budget_mb);
   json_safe_get(json,
                 "performance.default_resolution",
                 performance.default_resolution);
   json_safe_get(json, "performance.default_tiling", performance.default_tiling);
+  json_safe_get(json, "performance.compute_threads", performance.compute_threads);
+  json_safe_get(json,
+                "performance.max_concurrent_nodes",
+                performance.max_concurrent_nodes);
+  json_safe_get(json,
+                "performance.enable_progressive_preview",
+                performance.enable_progressive_preview);
+  json_safe_get(json,
+                "performance.progressive_preview_factor",
+                performance.progressive_preview_factor);
 
   // 0.6: vulkan settings
   json_safe_get(json,
@@ -281,8 +301,16 @@ nlohmann::json AppSettings::json_to() const
   json["performance.cache_memory_limit_mb"] = performance.cache_memory_limit_mb;
   json["performance.enable_incremental_evaluation"] =
       performance.enable_incremental_evaluation;
+  json["performance.node_output_cache_limit_mb"] = performance.node_output_cache_limit_mb;
+  json["performance.enable_disk_cache"] = performance.enable_disk_cache;
+  json["performance.disk_cache_limit_mb"] = performance.disk_cache_limit_mb;
+  json["performance.bake_memory_budget_mb"] = performance.bake_memory_budget_mb;
   json["performance.default_resolution"] = performance.default_resolution;
   json["performance.default_tiling"] = performance.default_tiling;
+  json["performance.compute_threads"] = performance.compute_threads;
+  json["performance.max_concurrent_nodes"] = performance.max_concurrent_nodes;
+  json["performance.enable_progressive_preview"] = performance.enable_progressive_preview;
+  json["performance.progressive_preview_factor"] = performance.progressive_preview_factor;
 
   // 0.6: vulkan
   json["vulkan.enable_vulkan_globally"] = vulkan_settings.enable_vulkan_globally;
@@ -7,18 +7,20 @@
 #include <sstream>
 
 #include <QDesktopServices>
+#include <QEventLoop>
 #include <QFileDialog>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QStatusBar>
+#include <QThread>
 #include <QUndoStack>
 #include <QUrl>
 
 #include "highmap/opencl/gpu_opencl.hpp"
+#include "highmap/thread_pool.hpp"
 
 #include "hesiod/app/hesiod_application.hpp"
-#include "hesiod/cli/batch_mode.hpp"
 #include "hesiod/gui/project_ui.hpp"
 #include "hesiod/gui/widgets/about_dialog.hpp"
 #include "hesiod/gui/widgets/bake_config_dialog.hpp"
@@ -34,6 +36,7 @@
 #include "hesiod/gui/widgets/project_settings_dialog.hpp"
 #include "hesiod/gui/widgets/splash_screen.hpp"
 #include "hesiod/gui/widgets/tool_tip_blocker.hpp"
+#include "hesiod/core/node_output_cache.hpp"
 #include "hesiod/core/preview_cache_manager.hpp"
 #include "hesiod/core/settings_manager.hpp"
 #include "hesiod/core/terminal_logger.hpp"
@@ -43,6 +46,7 @@
 #include "hesiod/model/graph/graph_config.hpp"
 #include "hesiod/model/graph/graph_manager.hpp"
 #include "hesiod/model/graph/graph_node.hpp"
+#include "hesiod/model/graph/variant_baker.hpp"
 #include "hesiod/model/utils.hpp"
 
 namespace fs = std::filesystem;
@@ -111,6 +115,17 @@ HesiodApplication::HesiodApplication(int &argc, char **argv) : QApplication(argc
   auto &pcm = PreviewCacheManager::instance();
   pcm.set_memory_limit_mb(sm.performance.cache_memory_limit_mb);
 
+  // Memoized node outputs
+  NodeOutputCache::instance().set_memory_limit_mb(
+      this->context.app_settings.performance.node_output_cache_limit_mb);
+  NodeOutputCache::instance().set_disk_limit_mb(
+      this->context.app_settings.performance.disk_cache_limit_mb);
+
+  // CPU thread pool, sized once before any computation (also used by
+  // the batch mode)
+  hmap::ThreadPool::get_instance().set_nthreads(
+      static_cast<size_t>(std::max(0, this->context.app_settings.performance.compute_threads)));
+
   Logger::log()->info("Hesiod 0.6 core managers initialized");
 
   // apply style
@@ -451,11 +466,12 @@ void HesiodApplication::on_export_batch()
 
   this->notify("Baking and exporting...");
 
-  // block UI
+  // block UI (the baking runs in a separate thread, the dialog is updated as the
+  // variants are done)
   QProgressDialog progress(tr("Baking and exporting..."),
                            QString(),
                            0,
-                           0,
+                           bake_settings.nvariants + 1,
                            this->main_window);
   progress.setWindowModality(Qt::ApplicationModal);
   progress.setCancelButton(nullptr);
@@ -463,89 +479,84 @@ void HesiodApplication::on_export_batch()
   progress.show();
   QCoreApplication::processEvents();
 
-  // Determine base export path: user-chosen or auto-derived
-  fs::path base_export_path;
-  if (!bake_settings.export_path.empty())
-  {
-    base_export_path = bake_settings.export_path;
-  }
-  else
-  {
-    // auto-derive from project path
-    fs::path pname = project_path.filename();
-    if (pname.empty())
-      base_export_path = "export";
-    else
-      base_export_path = fs::path(pname.string() + "_export");
-
-    base_export_path = project_path.empty()
-                           ? base_export_path
-                           : project_path.parent_path() / base_export_path;
-  }
+  fs::path base_export_path = bake_settings.get_variant_export_path(project_path, 0);
 
-  for (int k = 0; k < bake_settings.nvariants + 1; ++k)
-  {
-    const std::string msg = std::format("Baking variant {}/{}...",
-                                        k + 1,
-                                        bake_settings.nvariants + 1);
-    this->notify(msg);
+  // --- bake configuration, shared by all the graphs
 
-    QCoreApplication::processEvents(); // render progress dialog
+  // retrieve config of the first graph
+  auto graph_nodes = this->context.project_model->get_graph_manager_ref()
+                         ->get_graph_nodes();
+  auto         it = graph_nodes.begin();
+  GraphConfig *p_config = it != graph_nodes.end() ? it->second->get_config_ref()
+                                                  : nullptr;
 
-    fs::path export_path = base_export_path;
+  if (p_config)
+  {
+    GraphConfig bake_config;
+    bake_config.shape = hmap::Vec2<int>(bake_settings.resolution,
+                                        bake_settings.resolution);
+    bake_config.tiling = p_config->tiling;
+    bake_config.overlap = p_config->overlap;
+    bake_config.hmap_transform_mode_cpu = p_config->hmap_transform_mode_cpu;
+    bake_config.hmap_transform_mode_gpu = p_config->hmap_transform_mode_gpu;
+
+    if (bake_settings.force_distributed)
+    {
+      bake_config.hmap_transform_mode_cpu = hmap::TransformMode::DISTRIBUTED;
+      bake_config.hmap_transform_mode_gpu = hmap::TransformMode::DISTRIBUTED;
+    }
 
-    if (k > 0)
-      export_path /= "variants_" + std::to_string(k);
+    // --- run, the graphs are loaded once and the variants computed in parallel
 
-    Logger::log()->info("MainWindow::on_export_batch: export path: {}",
-                        export_path.string());
+    VariantBaker baker(this->context.project_model->json_to(),
+                       bake_config,
+                       bake_settings,
+                       project_path);
 
-    // create it
-    if (!fs::exists(export_path))
+    // called from the baking threads, the dialog is updated by the GUI thread
+    baker.variant_done = [&progress](int k, int ndone, int nvariants)
     {
-      Logger::log()->trace("MainWindow::on_export_batch: creating export directory {}",
-                           export_path.string());
-      fs::create_directories(export_path);
-    }
+      Logger::log()->info("HesiodApplication::on_export_batch: variant {} baked ({}/{})",
+                          k,
+                          ndone,
+                          nvariants);
 
-    // --- save an hesiod file and tweak it
+      QMetaObject::invokeMethod(
+          &progress,
+          [&progress, ndone]() { progress.setValue(ndone); },
+          Qt::QueuedConnection);
+    };
 
-    // save graph node to a temporary file
-    fs::path fname = export_path / "hesiod_bake.hsd";
-    this->save_project_model_and_ui(fname.string());
+    const size_t memory_budget_mb = static_cast<size_t>(
+        this->context.app_settings.performance.bake_memory_budget_mb);
 
-    // force auto_export for export nodes and overwrite export paths
-    override_export_nodes_settings(fname.string(),
-                                   export_path,
-                                   static_cast<uint>(k),
-                                   bake_settings);
+    int nbaked = 0;
 
-    // --- run
+    QThread *p_thread = QThread::create([&baker, &nbaked, memory_budget_mb]()
+                                        { nbaked = baker.bake(memory_budget_mb); });
 
-    // retrieve config of the first graph
-    auto graph_nodes = this->context.project_model->get_graph_manager_ref()
-                           ->get_graph_nodes();
-    auto         it = graph_nodes.begin();
-    GraphConfig *p_config = it != graph_nodes.end() ? it->second->get_config_ref()
-                                                    : nullptr;
+    // the GUI keeps processing its events (progress dialog) until the baking is
+    // done
+    QEventLoop loop;
+    QObject::connect(p_thread, &QThread::finished, &loop, &QEventLoop::quit);
 
-    if (p_config)
-    {
-      GraphConfig bake_config = *p_config;
+    p_thread->start();
+    loop.exec();
+    p_thread->wait();
+    delete p_thread;
 
-      if (bake_settings.force_distributed)
-      {
-        bake_config.hmap_transform_mode_cpu = hmap::TransformMode::DISTRIBUTED;
-        bake_config.hmap_transform_mode_gpu = hmap::TransformMode::DISTRIBUTED;
-      }
+    if (nbaked < bake_settings.nvariants + 1)
+      Logger::log()->error("HesiodApplication::on_export_batch: {} variant(s) failed",
+                           bake_settings.nvariants + 1 - nbaked);
+
+    // add the UI state to the baked project files
+    for (int k = 0; k < bake_settings.nvariants + 1; ++k)
+    {
+      fs::path fname = bake_settings.get_variant_export_path(project_path, k) /
+                       "hesiod_bake.hsd";
 
-      // run batch node
-      hesiod::cli::run_batch_mode(
-          fname.string(),
-          hmap::Vec2<int>(bake_settings.resolution, bake_settings.resolution),
-          bake_config.tiling,
-          bake_config.overlap,
-          &bake_config);
+      if (fs::exists(fname))
+        this->project_ui->save_ui_state(fname.string());
     }
   }
 
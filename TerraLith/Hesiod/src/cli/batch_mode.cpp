@@ -12,8 +12,10 @@
 #include "hesiod/gui/widgets/gui_utils.hpp"
 #include "hesiod/logger.hpp"
 #include "hesiod/model/graph/graph_manager.hpp"
+#include "hesiod/model/graph/variant_baker.hpp"
 #include "hesiod/model/nodes/node_factory.hpp"
 #include "hesiod/model/nodes/post_process.hpp"
+#include "hesiod/model/utils.hpp"
 
 namespace hesiod::cli
 {
@@ -56,6 +58,12 @@ int parse_args(args::ArgumentParser &parser, int argc, char *argv[])
       "Tile overlapping ratio (in [0, 1[), ex. --overlap=0.25",
       {"overlap"});
 
+  args::ValueFlag<int> variants_arg(
+      batch_args,
+      "variants",
+      "Number of seed variants baked in addition to the project seeds, ex. --variants=10",
+      {"variants"});
+
   try
   {
     parser.ParseCLI(argc, argv);
@@ -65,7 +73,9 @@ int parse_args(args::ArgumentParser &parser, int argc, char *argv[])
       run_batch_mode(args::get(batch),
                      shape_arg ? args::get(shape_arg) : hmap::Vec2<int>(0, 0),
                      tiling_arg ? args::get(tiling_arg) : hmap::Vec2<int>(0, 0),
-                     overlap_arg ? args::get(overlap_arg) : -1.f);
+                     overlap_arg ? args::get(overlap_arg) : -1.f,
+                     nullptr,
+                     variants_arg ? args::get(variants_arg) : 0);
       return 0;
     }
     else if (snapshot_generation)
@@ -98,13 +108,15 @@ void run_batch_mode(const std::string     &filename,
                     const hmap::Vec2<int> &shape,
                     const hmap::Vec2<int> &tiling,
                     float                  overlap,
-                    const GraphConfig     *p_input_model_config)
+                    const GraphConfig     *p_input_model_config,
+                    int                    nvariants)
 {
   Logger::log()->info("executing Hesiod in batch mode");
   Logger::log()->trace("file: {}", filename);
   Logger::log()->trace("cli shape: {{{}, {}}}", shape.x, shape.y);
   Logger::log()->trace("cli tiling: {{{}, {}}}", tiling.x, tiling.y);
   Logger::log()->trace("cli overlap: {}", overlap);
+  Logger::log()->trace("cli variants: {}", nvariants);
 
   // define actual computation configuration based on CLI inputs. If
   // nothing is provided, use the configs from the input file but if
@@ -133,7 +145,29 @@ void run_batch_mode(const std::string     &filename,
     Logger::log()->info("compute overlap: {}", config.overlap);
   }
 
+  // seed variants, baked with the settings of the project (export
+  // directories, file naming...)
+  if (nvariants > 0)
+  {
+    nlohmann::json json = json_from_file(filename);
+
+    BakeConfig bake_settings;
+    if (json.contains("bake_config"))
+      bake_settings.json_from(json["bake_config"]);
+
+    bake_settings.nvariants = nvariants;
+    bake_settings.resolution = config.shape.x;
+
+    VariantBaker baker(json, config, bake_settings, filename);
+    baker.bake(
+        static_cast<size_t>(HSD_CTX.app_settings.performance.bake_memory_budget_mb));
+    return;
+  }
+
+  // low-memory update: outputs are allocated when their node is
+  // computed and released after their last consumer
   GraphManager graph_manager;
+  graph_manager.set_lazy_outputs(true);
   graph_manager.load_from_file(filename, &config);
 
   // flatten & export if there is a configuration defined
@@ -0,0 +1,299 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+#include <QByteArray>
+
+#include "hesiod/core/node_output_cache.hpp"
+#include "hesiod/logger.hpp"
+
+// zlib level, the heightmap data do not compress much further at higher
+// levels and the cache is written when the project is saved
+#define HSD_DISK_CACHE_COMPRESSION_LEVEL 1
+
+namespace hesiod
+{
+
+NodeOutputCache &NodeOutputCache::instance()
+{
+  static NodeOutputCache inst;
+  return inst;
+}
+
+void NodeOutputCache::store(uint64_t key, Entry entry)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // an entry larger than the whole budget would evict everything else
+  if (entry.size_bytes > memory_limit_bytes_)
+    return;
+
+  erase(key);
+
+  current_memory_bytes_ += entry.size_bytes;
+  cache_[key] = std::move(entry);
+
+  lru_order_.push_front(key);
+  lru_map_[key] = lru_order_.begin();
+
+  evict_if_needed();
+}
+
+bool NodeOutputCache::retrieve(uint64_t key, Entry &entry)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = cache_.find(key);
+  if (it == cache_.end())
+  {
+    cache_misses_++;
+    return false;
+  }
+
+  cache_hits_++;
+  entry = it->second;
+
+  // touch
+  lru_order_.erase(lru_map_[key]);
+  lru_order_.push_front(key);
+  lru_map_[key] = lru_order_.begin();
+
+  return true;
+}
+
+bool NodeOutputCache::peek(uint64_t key, Entry &entry) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = cache_.find(key);
+  if (it == cache_.end())
+    return false;
+
+  entry = it->second;
+  return true;
+}
+
+void NodeOutputCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+  lru_order_.clear();
+  lru_map_.clear();
+  current_memory_bytes_ = 0;
+  cache_hits_ = 0;
+  cache_misses_ = 0;
+}
+
+float NodeOutputCache::get_hit_rate() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t total = cache_hits_ + cache_misses_;
+  if (total == 0)
+    return 0.0f;
+  return static_cast<float>(cache_hits_) / static_cast<float>(total) * 100.0f;
+}
+
+float NodeOutputCache::get_memory_usage_mb() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<float>(current_memory_bytes_) / (1024.0f * 1024.0f);
+}
+
+void NodeOutputCache::set_memory_limit_mb(int limit_mb)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  memory_limit_bytes_ = static_cast<size_t>(limit_mb) * 1024 * 1024;
+  evict_if_needed();
+}
+
+void NodeOutputCache::set_disk_cache_dir(const std::filesystem::path &dir)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  disk_dir_ = dir;
+}
+
+std::filesystem::path NodeOutputCache::get_disk_cache_dir() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return disk_dir_;
+}
+
+void NodeOutputCache::set_disk_limit_mb(int limit_mb)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    disk_limit_bytes_ = static_cast<size_t>(limit_mb) * 1024 * 1024;
+  }
+  evict_disk_if_needed();
+}
+
+bool NodeOutputCache::has_on_disk(uint64_t key) const
+{
+  std::filesystem::path path = get_disk_path(key);
+  std::error_code       ec;
+  return !path.empty() && std::filesystem::exists(path, ec);
+}
+
+bool NodeOutputCache::read_from_disk(uint64_t key, std::string &blob) const
+{
+  std::filesystem::path path = get_disk_path(key);
+  std::error_code       ec;
+
+  if (path.empty() || !std::filesystem::exists(path, ec))
+    return false;
+
+  std::ifstream f(path, std::ios::binary);
+  if (!f)
+    return false;
+
+  std::string compressed((std::istreambuf_iterator<char>(f)),
+                         std::istreambuf_iterator<char>());
+
+  QByteArray data = qUncompress(reinterpret_cast<const uchar *>(compressed.data()),
+                                static_cast<qsizetype>(compressed.size()));
+
+  if (data.isEmpty())
+  {
+    Logger::log()->warn("NodeOutputCache::read_from_disk: corrupted file {}",
+                        path.string());
+    std::filesystem::remove(path, ec);
+    return false;
+  }
+
+  blob.assign(data.constData(), static_cast<size_t>(data.size()));
+
+  // the modification time is used for the LRU eviction
+  std::filesystem::last_write_time(path,
+                                   std::filesystem::file_time_type::clock::now(),
+                                   ec);
+
+  return true;
+}
+
+void NodeOutputCache::write_to_disk(uint64_t key, const std::string &blob) const
+{
+  std::filesystem::path path = get_disk_path(key);
+  std::error_code       ec;
+
+  if (path.empty())
+    return;
+
+  std::filesystem::create_directories(path.parent_path(), ec);
+
+  QByteArray data = qCompress(reinterpret_cast<const uchar *>(blob.data()),
+                              static_cast<qsizetype>(blob.size()),
+                              HSD_DISK_CACHE_COMPRESSION_LEVEL);
+
+  // written aside and renamed, a file in the cache is always complete
+  std::filesystem::path tmp_path = path;
+  tmp_path += ".tmp";
+
+  {
+    std::ofstream f(tmp_path, std::ios::binary);
+    f.write(data.constData(), static_cast<std::streamsize>(data.size()));
+
+    if (!f)
+    {
+      Logger::log()->error("NodeOutputCache::write_to_disk: could not write file {}",
+                           tmp_path.string());
+      f.close();
+      std::filesystem::remove(tmp_path, ec);
+      return;
+    }
+  }
+
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec)
+    Logger::log()->error("NodeOutputCache::write_to_disk: could not rename file {}: {}",
+                         tmp_path.string(),
+                         ec.message());
+}
+
+void NodeOutputCache::evict_disk_if_needed() const
+{
+  std::filesystem::path dir;
+  size_t                limit;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dir = disk_dir_;
+    limit = disk_limit_bytes_;
+  }
+
+  std::error_code ec;
+  if (dir.empty() || !std::filesystem::is_directory(dir, ec))
+    return;
+
+  struct FileInfo
+  {
+    std::filesystem::path           path;
+    size_t                          size;
+    std::filesystem::file_time_type time;
+  };
+
+  std::vector<FileInfo> files;
+  size_t                total = 0;
+
+  for (auto &entry : std::filesystem::directory_iterator(dir, ec))
+    if (entry.is_regular_file(ec) && entry.path().extension() == ".bin")
+    {
+      FileInfo info{entry.path(), entry.file_size(ec), entry.last_write_time(ec)};
+      total += info.size;
+      files.push_back(info);
+    }
+
+  if (total <= limit)
+    return;
+
+  std::sort(files.begin(),
+            files.end(),
+            [](const FileInfo &a, const FileInfo &b) { return a.time < b.time; });
+
+  for (auto &info : files)
+  {
+    if (total <= limit)
+      break;
+
+    Logger::log()->trace("NodeOutputCache::evict_disk_if_needed: removing {}",
+                         info.path.string());
+
+    if (std::filesystem::remove(info.path, ec))
+      total -= info.size;
+  }
+}
+
+void NodeOutputCache::evict_if_needed()
+{
+  while (current_memory_bytes_ > memory_limit_bytes_ && !lru_order_.empty())
+  {
+    Logger::log()->trace("NodeOutputCache::evict_if_needed: evicting {:016x}",
+                         lru_order_.back());
+    erase(lru_order_.back());
+  }
+}
+
+std::filesystem::path NodeOutputCache::get_disk_path(uint64_t key) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (disk_dir_.empty())
+    return {};
+
+  return disk_dir_ / std::format("{:016x}.bin", key);
+}
+
+void NodeOutputCache::erase(uint64_t key)
+{
+  auto it = cache_.find(key);
+  if (it == cache_.end())
+    return;
+
+  current_memory_bytes_ -= it->second.size_bytes;
+  lru_order_.erase(lru_map_[key]);
+  lru_map_.erase(key);
+  cache_.erase(it);
+}
+
+} // namespace hesiod
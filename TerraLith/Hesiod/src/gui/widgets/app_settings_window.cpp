@@ -193,7 +193,28 @@ QWidget *AppSettingsWindow::create_performance_tab()
 
   bind_bool(form, "Enable incremental evaluation",
             ctx.app_settings.performance.enable_incremental_evaluation,
-            "Only recompute dirty nodes and their downstream chain");
+            "Reuse the outputs of the nodes whose parameters and inputs did not change");
+
+  bind_spinbox(form, "Node output cache limit (MB)",
+               ctx.app_settings.performance.node_output_cache_limit_mb,
+               0, 65536,
+               "Maximum memory for the memoized node outputs (applied at startup)");
+
+  bind_bool(form, "Enable disk cache",
+            ctx.app_settings.performance.enable_disk_cache,
+            "Save the node outputs next to the project file, reopening the project "
+            "then skips their computation");
+
+  bind_spinbox(form, "Disk cache limit (MB)",
+               ctx.app_settings.performance.disk_cache_limit_mb,
+               0, 1048576,
+               "Maximum size of the disk cache of a project, least recently used "
+               "entries are removed first (applied at startup)");
+
+  bind_spinbox(form, "Bake memory budget (MB)",
+               ctx.app_settings.performance.bake_memory_budget_mb,
+               256, 1048576,
+               "Memory available for baking several variants at the same time");
 
   add_title(form, "Defaults");
 
@@ -207,6 +228,31 @@ QWidget *AppSettingsWindow::create_performance_tab()
              {"2x2", "4x4", "8x8"},
              "Default tile subdivision for parallel computation");
 
+  add_title(form, "Parallelism");
+
+  bind_spinbox(form, "Compute threads",
+               ctx.app_settings.performance.compute_threads,
+               0, 256,
+               "Thread budget shared by the graph and the tiles (0 = all cores, applied at startup)");
+
+  bind_spinbox(form, "Max. concurrent nodes",
+               ctx.app_settings.performance.max_concurrent_nodes,
+               0, 64,
+               "Independent branches computed at the same time (0 = auto)");
+
+  add_title(form, "Progressive Preview");
+
+  bind_bool(form, "Enable progressive preview",
+            ctx.app_settings.performance.enable_progressive_preview,
+            "Compute the edited nodes at a reduced resolution first, then refine "
+            "them at full resolution in the background (a new edit interrupts the "
+            "refinement)");
+
+  bind_spinbox(form, "Preview resolution divider",
+               ctx.app_settings.performance.progressive_preview_factor,
+               2, 16,
+               "Resolution of the first level, divided by this factor (4 or 8)");
+
   return widget;
 }
 
@@ -986,6 +986,11 @@ void GraphNodeWidget::on_node_reload_request(const std::string &node_id)
     return;
 
   auto sorted = gno->get_nodes_to_update(node_id);
+
+  // upstream nodes still being computed (hence dirty), see start_background_compute
+  if (sorted.empty() && this->is_computing_)
+    sorted = {node_id};
+
   this->start_background_compute(sorted);
 }
 
@@ -1795,7 +1800,20 @@ void GraphNodeWidget::start_background_compute(const std::vector<std::string> &s
 
   if (this->is_computing_)
   {
-    Logger::log()->warn("GraphNodeWidget::start_background_compute: already running");
+    // progressive mode: a new edit preempts the running compute (the refinement in
+    // particular), the edited nodes and the nodes left dirty are recomputed once it
+    // has stopped (the nodes are not marked dirty here, the worker may be computing
+    // them)
+    if (HSD_CTX.app_settings.performance.enable_progressive_preview)
+    {
+      this->pending_ids_.insert(sorted_ids.begin(), sorted_ids.end());
+
+      if (this->graph_worker_)
+        this->graph_worker_->request_cancel();
+    }
+    else
+      Logger::log()->warn("GraphNodeWidget::start_background_compute: already running");
+
     return;
   }
 
@@ -1821,7 +1839,11 @@ void GraphNodeWidget::start_background_compute(const std::vector<std::string> &s
   this->worker_thread_ = new QThread(this);
   this->graph_worker_ = new GraphWorker(); // no parent -- will be moved
 
-  this->graph_worker_->configure(gno.get(), sorted_ids);
+  const auto &perf = HSD_CTX.app_settings.performance;
+  int preview_factor = perf.enable_progressive_preview ? perf.progressive_preview_factor
+                                                       : 1;
+
+  this->graph_worker_->configure(gno.get(), sorted_ids, preview_factor);
   this->graph_worker_->moveToThread(this->worker_thread_);
 
   // Connect worker signals to widget slots (auto queued cross-thread)
@@ -1837,6 +1859,10 @@ void GraphNodeWidget::start_background_compute(const std::vector<std::string> &s
           &GraphWorker::progress_updated,
           this,
           &GraphNodeWidget::on_worker_progress_updated);
+  connect(this->graph_worker_,
+          &GraphWorker::preview_finished,
+          this,
+          &GraphNodeWidget::on_worker_preview_finished);
   connect(this->graph_worker_,
           &GraphWorker::node_execution_time,
           this,
@@ -1911,6 +1937,17 @@ void GraphNodeWidget::on_worker_progress_updated(const std::string &node_id,
   Q_EMIT this->update_progress(node_id, percent);
 }
 
+void GraphNodeWidget::on_worker_preview_finished()
+{
+  // the previews and viewers have been updated with the reduced resolution outputs
+  // (the compute_finished signals are processed before this one), the worker can
+  // now refine them
+  Logger::log()->trace("GraphNodeWidget::on_worker_preview_finished");
+
+  if (this->graph_worker_)
+    this->graph_worker_->acknowledge_preview();
+}
+
 void GraphNodeWidget::on_worker_node_execution_time(const std::string &node_id,
                                                     float              time_ms,
                                                     int                backend_type)
@@ -1968,6 +2005,29 @@ void GraphNodeWidget::on_worker_compute_all_finished(bool was_cancelled)
 
   if (was_cancelled)
     Logger::log()->info("GraphNodeWidget: compute was cancelled");
+
+  // preempted by an edit: restart with every dirty node and their descendants
+  // (get_nodes_to_update is empty for the nodes with a dirty ancestor, which are
+  // gathered with the ancestor)
+  if (gno && !this->pending_ids_.empty())
+  {
+    // the worker is done, the edited nodes can be marked dirty (they may have been
+    // deleted in the meantime)
+    for (auto &nid : this->pending_ids_)
+      if (!gno->is_node_id_available(nid))
+        gno->get_node_ref_by_id(nid)->is_dirty = true;
+
+    this->pending_ids_.clear();
+
+    std::vector<std::string> dirty_ids;
+    for (auto &[nid, p_node] : gno->get_nodes())
+      if (p_node->is_dirty)
+        for (auto &id : gno->get_nodes_to_update(nid))
+          if (!contains(dirty_ids, id))
+            dirty_ids.push_back(id);
+
+    this->start_background_compute(gno->topological_sort(dirty_ids));
+  }
 }
 
 void GraphNodeWidget::setup_connections()
@@ -3,6 +3,7 @@
  * this software. */
 #include <QApplication>
 #include <QLabel>
+#include <QMetaObject>
 #include <QStatusBar>
 
 #include "hesiod/app/hesiod_application.hpp"
@@ -85,23 +86,32 @@ void MainWindow::setup_connections_with_project()
     return;
   }
 
-  // GraphNode model -> MainWindow
+  // GraphNode model -> MainWindow, the graph nodes are computed by several threads:
+  // the widgets are updated by the GUI thread (direct call if already there,
+  // queued otherwise)
   ctx.project_model->get_graph_manager_ref()->update_progress = [this](float progress)
   {
-    if (progress == 0.f || progress == 100.f)
-    {
-      this->progress_bar->setValue(0);
-      this->progress_bar->setTextVisible(false);
-
-      const std::string message = (progress == 0.f) ? "Updating graph..."
-                                                    : "Graph updated successfully.";
-
-      this->notify(message);
-      return;
-    }
-
-    this->progress_bar->setTextVisible(true);
-    this->progress_bar->setValue(static_cast<int>(progress));
+    QMetaObject::invokeMethod(
+        this,
+        [this, progress]()
+        {
+          if (progress == 0.f || progress == 100.f)
+          {
+            this->progress_bar->setValue(0);
+            this->progress_bar->setTextVisible(false);
+
+            const std::string message = (progress == 0.f)
+                                            ? "Updating graph..."
+                                            : "Graph updated successfully.";
+
+            this->notify(message);
+            return;
+          }
+
+          this->progress_bar->setTextVisible(true);
+          this->progress_bar->setValue(static_cast<int>(progress));
+        },
+        Qt::AutoConnection);
   };
 
   // Resolution combo -> GraphManager
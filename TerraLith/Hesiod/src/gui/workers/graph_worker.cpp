@@ -3,9 +3,12 @@
  * this software. */
 #include <chrono>
 
+#include "highmap/execution_context.hpp"
+
 #include "hesiod/gui/workers/graph_worker.hpp"
 #include "hesiod/logger.hpp"
 #include "hesiod/model/graph/graph_node.hpp"
+#include "hesiod/model/graph/preview_resolution.hpp"
 #include "hesiod/model/nodes/base_node.hpp"
 
 namespace hesiod
@@ -14,56 +17,106 @@ namespace hesiod
 GraphWorker::GraphWorker(QObject *parent) : QObject(parent) {}
 
 void GraphWorker::configure(GraphNode                      *p_graph,
-                            const std::vector<std::string> &sorted_node_ids)
+                            const std::vector<std::string> &sorted_node_ids,
+                            int                             preview_factor)
 {
   this->p_graph_ = p_graph;
   this->sorted_ids_ = sorted_node_ids;
+  this->preview_factor_ = preview_factor;
   this->cancel_requested_.store(false);
+  this->preview_acknowledged_ = false;
+
+  if (this->p_graph_)
+    this->p_graph_->update_max_workers();
 }
 
-void GraphWorker::request_cancel() { this->cancel_requested_.store(true); }
+void GraphWorker::acknowledge_preview()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->preview_mutex_);
+    this->preview_acknowledged_ = true;
+  }
+  this->preview_cv_.notify_all();
+}
+
+void GraphWorker::request_cancel()
+{
+  {
+    // also wakes up a refinement waiting for the preview acknowledgement
+    std::lock_guard<std::mutex> lock(this->preview_mutex_);
+    this->cancel_requested_.store(true);
+  }
+  this->preview_cv_.notify_all();
+}
 
 bool GraphWorker::is_cancel_requested() const
 {
   return this->cancel_requested_.load();
 }
 
-void GraphWorker::do_compute()
+bool GraphWorker::compute_nodes(const std::vector<std::string> &node_ids,
+                                const std::set<std::string>    &reset_ids)
 {
-  Logger::log()->trace("GraphWorker::do_compute: starting {} nodes",
-                       this->sorted_ids_.size());
-
-  bool cancelled = false;
-  int  total = static_cast<int>(this->sorted_ids_.size());
+  int              total = static_cast<int>(node_ids.size());
+  std::atomic<int> ndone{0};
+  std::atomic<int> nreused{0}; // outputs unchanged or restored from the cache
 
-  for (int i = 0; i < total; ++i)
+  // called from the graph scheduler threads, independent branches are
+  // computed concurrently (signals are queued to the GUI thread)
+  auto node_task = [this, &ndone, &nreused, &reset_ids, total](const std::string &nid)
   {
-    if (this->cancel_requested_.load())
-    {
-      Logger::log()->info("GraphWorker::do_compute: cancelled at node {}/{}", i, total);
-      cancelled = true;
-      break;
-    }
-
-    const std::string &nid = this->sorted_ids_[i];
-
     // Progress before compute
-    float progress = (total > 1)
-                         ? 100.f * static_cast<float>(i) / static_cast<float>(total)
-                         : 0.f;
+    float progress = (total > 1) ? 100.f * static_cast<float>(ndone.load()) /
+                                       static_cast<float>(total)
+                                 : 0.f;
     Q_EMIT this->progress_updated(nid, progress);
 
     // Signal: compute started
     Q_EMIT this->node_compute_started(nid);
 
-    // Execute the node
+    // Execute the node, the long operators poll the context: the cancel
+    // request interrupts them and their progress moves the progress bar
+    // (reported by steps of 1%, from possibly several tile threads)
+    std::atomic<int> percent_reported{0};
+
+    auto on_progress = [this, &nid, &ndone, &percent_reported, total](float f)
+    {
+      int percent = static_cast<int>(100.f * f);
+      int previous = percent_reported.load();
+
+      while (percent > previous &&
+             !percent_reported.compare_exchange_weak(previous, percent))
+        ;
+
+      if (percent <= previous)
+        return;
+
+      float nodes_done = static_cast<float>(ndone.load()) + 0.01f * percent;
+      Q_EMIT this->progress_updated(nid,
+                                    100.f * nodes_done / static_cast<float>(total));
+    };
+
+    hmap::ExecutionContext context([this]()
+                                   { return this->cancel_requested_.load(); },
+                                   on_progress);
+    hmap::ScopedExecutionContext scope(&context);
+
     auto t0 = std::chrono::steady_clock::now();
 
     gnode::Node *p_node = this->p_graph_->get_node_ref_by_id(nid);
+    BaseNode    *p_base = dynamic_cast<BaseNode *>(p_node);
+
     if (p_node)
     {
+      if (p_base && reset_ids.contains(nid))
+        p_base->propagate_config_change();
+
       p_node->is_dirty = true;
       p_node->update();
+
+      // partial outputs, to be recomputed next time
+      if (p_base && p_base->was_cancelled())
+        p_node->is_dirty = true;
     }
 
     auto  t1 = std::chrono::steady_clock::now();
@@ -72,23 +125,100 @@ void GraphWorker::do_compute()
 
     // Read which backend was used (CPU, Vulkan, etc.)
     int backend_type = 0; // ComputeBackend::NONE
-    BaseNode *p_base = dynamic_cast<BaseNode *>(p_node);
     if (p_base)
+    {
       backend_type = static_cast<int>(p_base->get_last_backend_used());
+      if (p_base->was_reused())
+        ++nreused;
+    }
 
     // Signal: compute finished + execution time
     Q_EMIT this->node_compute_finished(nid);
     Q_EMIT this->node_execution_time(nid, elapsed_ms, backend_type);
 
     // Progress after compute
-    float progress_after =
-        (total > 1)
-            ? 100.f * static_cast<float>(i + 1) / static_cast<float>(total)
-            : 100.f;
+    int   n = ++ndone;
+    float progress_after = (total > 1) ? 100.f * static_cast<float>(n) /
+                                             static_cast<float>(total)
+                                       : 100.f;
     Q_EMIT this->progress_updated(nid, progress_after);
+  };
+
+  auto stop_requested = [this]() { return this->cancel_requested_.load(); };
+
+  bool completed = this->p_graph_->execute_nodes(node_ids, node_task, stop_requested);
+
+  if (!completed)
+    Logger::log()->info("GraphWorker::compute_nodes: cancelled after {}/{} nodes",
+                        ndone.load(),
+                        total);
+
+  Logger::log()->trace("GraphWorker::compute_nodes: {}/{} nodes reused their outputs",
+                       nreused.load(),
+                       ndone.load());
+
+  return completed;
+}
+
+void GraphWorker::do_compute()
+{
+  Logger::log()->trace("GraphWorker::do_compute: starting {} nodes",
+                       this->sorted_ids_.size());
+
+  // progressive evaluation, coarse level first
+  std::vector<std::string> preview_ids = ScopedPreviewResolution::get_node_ids(
+      *this->p_graph_,
+      this->sorted_ids_,
+      this->preview_factor_);
+
+  bool completed = true;
+
+  if (!preview_ids.empty())
+  {
+    {
+      ScopedPreviewResolution preview(*this->p_graph_, preview_ids, this->preview_factor_);
+      completed = this->compute_nodes(preview_ids, {});
+    }
+
+    // the outputs are only reallocated for the refinement once the GUI is done
+    // with displaying them (the signals are processed in order)
+    if (completed)
+    {
+      Q_EMIT this->preview_finished();
+
+      std::unique_lock<std::mutex> lock(this->preview_mutex_);
+      this->preview_cv_.wait(lock,
+                             [this]()
+                             {
+                               return this->preview_acknowledged_ ||
+                                      this->cancel_requested_.load();
+                             });
+    }
+
+    // coarse outputs until refined
+    for (auto &nid : preview_ids)
+      this->p_graph_->get_node_ref_by_id(nid)->is_dirty = true;
+  }
+
+  // full resolution
+  if (completed && !this->cancel_requested_.load())
+  {
+    std::set<std::string> reset_ids(preview_ids.begin(), preview_ids.end());
+    completed = this->compute_nodes(this->sorted_ids_, reset_ids);
+  }
+  else
+    completed = false;
+
+  // refinement preempted, the outputs left at the reduced resolution are reset (the
+  // nodes remain dirty) so that the graph never mixes resolutions
+  for (auto &nid : preview_ids)
+  {
+    BaseNode *p_node = this->p_graph_->get_node_ref_by_id<BaseNode>(nid);
+    if (p_node && p_node->is_dirty)
+      p_node->propagate_config_change();
   }
 
-  Q_EMIT this->compute_all_finished(cancelled);
+  Q_EMIT this->compute_all_finished(!completed);
 }
 
 } // namespace hesiod
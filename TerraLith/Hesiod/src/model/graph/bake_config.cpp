@@ -7,6 +7,34 @@
 namespace hesiod
 {
 
+std::filesystem::path BakeConfig::get_variant_export_path(
+    const std::filesystem::path &project_path,
+    int                          k) const
+{
+  std::filesystem::path path;
+
+  if (!this->export_path.empty())
+  {
+    path = this->export_path;
+  }
+  else
+  {
+    // auto-derive from project path
+    std::filesystem::path pname = project_path.filename();
+    if (pname.empty())
+      path = "export";
+    else
+      path = std::filesystem::path(pname.string() + "_export");
+
+    path = project_path.empty() ? path : project_path.parent_path() / path;
+  }
+
+  if (k > 0)
+    path /= "variants_" + std::to_string(k);
+
+  return path;
+}
+
 void BakeConfig::json_from(nlohmann::json const &json)
 {
   json_safe_get(json, "resolution", resolution);
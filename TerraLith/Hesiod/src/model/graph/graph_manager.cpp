@@ -8,10 +8,13 @@
 #include "highmap/interpolate_array.hpp"
 
 #include "hesiod/app/hesiod_application.hpp"
+#include "hesiod/core/node_output_cache.hpp"
 #include "hesiod/logger.hpp"
 #include "hesiod/model/graph/graph_config.hpp"
 #include "hesiod/model/graph/graph_manager.hpp"
 #include "hesiod/model/graph/graph_node.hpp"
+#include "hesiod/model/graph/heightmap_pool.hpp"
+#include "hesiod/model/nodes/base_node.hpp"
 #include "hesiod/model/utils.hpp"
 
 namespace hesiod
@@ -268,6 +271,7 @@ void GraphManager::json_from(nlohmann::json const &json, GraphConfig *p_config)
 
       if (json.contains("graph_nodes") && json["graph_nodes"].contains(graph_id))
       {
+        graph->set_lazy_outputs(this->lazy_outputs);
         graph->json_from(json["graph_nodes"][graph_id], p_config);
       }
       else
@@ -312,7 +316,10 @@ void GraphManager::load_from_file(const std::string &fname, GraphConfig *p_confi
   this->json_from(json["graph_manager"], p_config);
 
   // update graphs
-  this->update();
+  if (this->lazy_outputs)
+    this->update_batch();
+  else
+    this->update();
 }
 
 void GraphManager::on_broadcast_node_updated(const std::string &graph_id,
@@ -410,4 +417,36 @@ void GraphManager::update()
     this->graph_nodes.at(graph_id)->update();
 }
 
+void GraphManager::store_outputs_on_disk()
+{
+  Logger::log()->trace("GraphManager::store_outputs_on_disk");
+
+  for (auto &graph_id : this->graph_order)
+    for (auto &[_, p_node] : this->graph_nodes.at(graph_id)->get_nodes())
+      if (BaseNode *p_basenode = dynamic_cast<BaseNode *>(p_node.get()))
+        p_basenode->store_outputs_on_disk();
+
+  NodeOutputCache::instance().evict_disk_if_needed();
+}
+
+void GraphManager::update_batch()
+{
+  Logger::log()->trace("GraphManager::update_batch()");
+
+  // the outputs used by the flatten export are kept
+  std::map<std::string, std::set<std::string>> pinned_node_ids;
+
+  for (auto &ids : this->export_param.ids)
+    pinned_node_ids[std::get<0>(ids)].insert(std::get<1>(ids));
+
+  HeightmapPool pool;
+
+  for (auto &graph_id : this->graph_order)
+    this->graph_nodes.at(graph_id)->update_batch(pool, pinned_node_ids[graph_id]);
+
+  Logger::log()->info("batch update: peak output memory {:.1f} MB, {} buffer(s) reused",
+                      static_cast<float>(pool.get_peak_bytes()) / (1024.f * 1024.f),
+                      pool.get_reuse_count());
+}
+
 } // namespace hesiod
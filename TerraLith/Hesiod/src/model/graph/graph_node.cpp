@@ -2,7 +2,9 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include "hesiod/model/graph/graph_node.hpp"
+#include "hesiod/app/hesiod_application.hpp"
 #include "hesiod/logger.hpp"
+#include "hesiod/model/graph/heightmap_pool.hpp"
 #include "hesiod/model/nodes/base_node.hpp"
 #include "hesiod/model/nodes/broadcast_node.hpp"
 #include "hesiod/model/nodes/node_factory.hpp"
@@ -10,6 +12,9 @@
 #include "hesiod/model/utils.hpp"
 
 #include <iostream>
+#include <mutex>
+
+#include "highmap/thread_pool.hpp"
 
 namespace hesiod
 {
@@ -92,6 +97,30 @@ std::string GraphNode::add_node(const std::shared_ptr<gnode::Node> &node,
   return node_id;
 }
 
+void GraphNode::allocate_node_outputs(BaseNode *p_node, HeightmapPool &pool)
+{
+  p_node->invalidate_memo();
+
+  for (int k = 0; k < p_node->get_nports(); k++)
+  {
+    if (p_node->get_ports()[k]->get_port_type() != gnode::PortType::OUT)
+      continue;
+
+    if (auto *p_h = p_node->get_value_ref<hmap::Heightmap>(k))
+    {
+      *p_h = pool.acquire(p_h, CONFIG((*p_node)));
+    }
+    else if (auto *p_rgba = p_node->get_value_ref<hmap::HeightmapRGBA>(k))
+    {
+      // channels also go through the pool, they are released to it
+      *p_rgba = hmap::HeightmapRGBA(pool.acquire(p_rgba, CONFIG((*p_node))),
+                                    pool.acquire(p_rgba, CONFIG((*p_node))),
+                                    pool.acquire(p_rgba, CONFIG((*p_node))),
+                                    pool.acquire(p_rgba, CONFIG((*p_node))));
+    }
+  }
+}
+
 void GraphNode::change_config_values(const GraphConfig &new_config)
 {
   Logger::log()->trace("GraphNode::change_config_values");
@@ -105,6 +134,26 @@ void GraphNode::change_config_values(const GraphConfig &new_config)
   this->update();
 }
 
+int GraphNode::get_max_concurrent_nodes() const
+{
+  const auto &perf = HSD_CTX.app_settings.performance;
+
+  if (perf.max_concurrent_nodes > 0)
+    return perf.max_concurrent_nodes;
+
+  int nthreads = static_cast<int>(hmap::ThreadPool::get_instance().get_nthreads());
+
+  // in distributed (or halo exchange) mode, hmap::transform already runs one
+  // task per tile within each node, the thread budget is shared between the
+  // nodes
+  int ntiles = 1;
+  if (this->config->hmap_transform_mode_cpu == hmap::TransformMode::DISTRIBUTED ||
+      this->config->hmap_transform_mode_cpu == hmap::TransformMode::HALO)
+    ntiles = this->config->tiling.x * this->config->tiling.y;
+
+  return std::max(1, nthreads / std::max(1, ntiles));
+}
+
 std::shared_ptr<GraphNode> GraphNode::get_shared()
 {
   try
@@ -186,6 +235,10 @@ void GraphNode::json_from(nlohmann::json const &json, GraphConfig *p_input_confi
 
       // set its parameters
       dynamic_cast<BaseNode *>(node.get())->json_from(json_node);
+
+      // storage allocated only when the node is computed
+      if (this->lazy_outputs)
+        this->release_node_outputs(dynamic_cast<BaseNode *>(node.get()), nullptr);
     }
   }
   else
@@ -263,6 +316,10 @@ void GraphNode::on_broadcast_node_updated(const std::string &tag)
 {
   Logger::log()->trace("GraphNode::on_broadcast_node_updated: tag: {}", tag);
 
+  // the receivers are computed by the batch update of this graph
+  if (this->lazy_outputs)
+    return;
+
   // loop over the nodes and update those with Receive type
   for (auto &[node_id, p_gnode] : this->nodes)
   {
@@ -291,6 +348,45 @@ void GraphNode::on_broadcast_node_updated(const std::string &tag)
   }
 }
 
+void GraphNode::post_update()
+{
+  // no node is being computed, the tiles detached from the outputs while they
+  // were shared (output cache, copies between graphs) can be dropped
+  for (auto &[nid, p_node] : this->nodes)
+    if (BaseNode *p_basenode = dynamic_cast<BaseNode *>(p_node.get()))
+      p_basenode->collect_outputs();
+}
+
+void GraphNode::release_node_outputs(BaseNode            *p_node,
+                                     HeightmapPool       *p_pool,
+                                     const std::set<int> &kept_port_ids)
+{
+  p_node->invalidate_memo();
+
+  for (int k = 0; k < p_node->get_nports(); k++)
+  {
+    if (p_node->get_ports()[k]->get_port_type() != gnode::PortType::OUT ||
+        kept_port_ids.contains(k))
+      continue;
+
+    if (auto *p_h = p_node->get_value_ref<hmap::Heightmap>(k))
+    {
+      if (p_pool)
+        p_pool->release(p_h, std::move(*p_h));
+
+      *p_h = hmap::Heightmap();
+    }
+    else if (auto *p_rgba = p_node->get_value_ref<hmap::HeightmapRGBA>(k))
+    {
+      if (p_pool)
+        for (auto &h : p_rgba->rgba)
+          p_pool->release(p_rgba, std::move(h));
+
+      *p_rgba = hmap::HeightmapRGBA();
+    }
+  }
+}
+
 void GraphNode::remove_node(const std::string &id)
 {
   Logger::log()->trace("GraphNode::remove_node: id = {}", id);
@@ -334,6 +430,13 @@ void GraphNode::reseed(bool backward)
   this->update();
 }
 
+void GraphNode::update_max_workers()
+{
+  this->set_max_workers(this->get_max_concurrent_nodes());
+
+  Logger::log()->trace("GraphNode::update_max_workers: {}", this->get_max_workers());
+}
+
 void GraphNode::set_p_broadcast_params(BroadcastMap *new_p_broadcast_params)
 {
   Logger::log()->trace("GraphNode::set_p_broadcast_params: ptr = {}",
@@ -402,6 +505,8 @@ void GraphNode::update()
   if (this->update_started)
     this->update_started();
 
+  this->update_max_workers();
+
   gnode::Graph::update();
 
   if (this->update_finished)
@@ -415,10 +520,128 @@ void GraphNode::update(const std::string &node_id)
   if (this->update_started)
     this->update_started();
 
+  this->update_max_workers();
+
   gnode::Graph::update(node_id);
 
   if (this->update_finished)
     this->update_finished();
 }
 
+void GraphNode::update_batch(HeightmapPool                &pool,
+                             const std::set<std::string> &pinned_node_ids,
+                             const std::set<std::string> *p_node_ids)
+{
+  Logger::log()->trace("GraphNode::update_batch");
+
+  if (this->update_started)
+    this->update_started();
+
+  this->update_max_workers();
+
+  std::vector<std::string> node_ids = {};
+
+  // every node is computed exactly once, the outputs are not memoized (they
+  // are released as soon as possible instead)
+  for (auto &[nid, p_node] : this->nodes)
+  {
+    if (p_node_ids && !p_node_ids->contains(nid))
+      continue;
+
+    p_node->is_dirty = true;
+    node_ids.push_back(nid);
+
+    if (BaseNode *p_basenode = dynamic_cast<BaseNode *>(p_node.get()))
+      p_basenode->set_memoization_enabled(false);
+  }
+
+  std::vector<std::string> sorted_ids = this->topological_sort(node_ids);
+
+  auto is_computed = [p_node_ids](const std::string &nid)
+  { return !p_node_ids || p_node_ids->contains(nid); };
+
+  // liveness: number of pending consumers (links) of each node and,
+  // for each node, the upstream nodes it consumes
+  std::map<std::string, int>                      nconsumers;
+  std::map<std::string, std::vector<std::string>> upstream_ids;
+  std::map<std::string, std::set<int>>            linked_port_ids;
+
+  for (auto &link : this->get_links())
+    if (is_computed(link.to))
+    {
+      nconsumers[link.from]++;
+      upstream_ids[link.to].push_back(link.from);
+      linked_port_ids[link.from].insert(link.port_from);
+    }
+
+  auto is_pinned = [this, &pinned_node_ids](const std::string &nid)
+  {
+    // broadcast outputs are read by the other graphs
+    BaseNode *p_node = this->get_node_ref_by_id<BaseNode>(nid);
+    return pinned_node_ids.contains(nid) || p_node->get_node_type() == "Broadcast";
+  };
+
+  std::mutex liveness_mtx;
+  size_t     ndone = 0;
+
+  auto node_task = [this,
+                    &pool,
+                    &nconsumers,
+                    &upstream_ids,
+                    &linked_port_ids,
+                    &is_computed,
+                    &is_pinned,
+                    &liveness_mtx,
+                    &ndone,
+                    nids = sorted_ids.size()](const std::string &nid)
+  {
+    BaseNode *p_node = this->get_node_ref_by_id<BaseNode>(nid);
+
+    this->allocate_node_outputs(p_node, pool);
+    p_node->update();
+
+    // outputs nobody reads are released right away (they are still
+    // allocated, the node functions write every output)
+    if (!is_pinned(nid))
+    {
+      auto it = linked_port_ids.find(nid);
+      this->release_node_outputs(p_node,
+                                 &pool,
+                                 it != linked_port_ids.end() ? it->second
+                                                             : std::set<int>{});
+    }
+
+    // release what is not needed anymore
+    std::vector<std::string> dead_ids = {};
+    {
+      std::lock_guard<std::mutex> lock(liveness_mtx);
+
+      for (auto &up_id : upstream_ids[nid])
+        if (--nconsumers[up_id] == 0)
+          dead_ids.push_back(up_id);
+
+      if (nconsumers[nid] == 0)
+        dead_ids.push_back(nid);
+
+      if (this->update_progress)
+        this->update_progress(nid, 100.f * static_cast<float>(++ndone) / nids);
+    }
+
+    // the outputs of the nodes not computed here are owned by the caller,
+    // they are neither released nor accounted by the pool
+    for (auto &dead_id : dead_ids)
+      if (!is_pinned(dead_id) && is_computed(dead_id))
+      {
+        Logger::log()->trace("GraphNode::update_batch: releasing {}", dead_id);
+        this->release_node_outputs(this->get_node_ref_by_id<BaseNode>(dead_id), &pool);
+      }
+  };
+
+  this->execute_nodes(sorted_ids, node_task);
+  this->post_update();
+
+  if (this->update_finished)
+    this->update_finished();
+}
+
 } // namespace hesiod
@@ -0,0 +1,126 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
+   License. The full license is in the file LICENSE, distributed with this software. */
+#include "highmap/thread_pool.hpp"
+
+#include "hesiod/model/graph/heightmap_pool.hpp"
+
+namespace hesiod
+{
+
+hmap::Heightmap HeightmapPool::acquire(const void     *p_owner,
+                                       hmap::Vec2<int> shape,
+                                       hmap::Vec2<int> tiling,
+                                       float           overlap)
+{
+  Key key = {shape.x, shape.y, tiling.x, tiling.y, overlap};
+
+  hmap::Heightmap h;
+  bool            reused = false;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    auto it = this->buckets.find(key);
+
+    if (it != this->buckets.end() && !it->second.empty())
+    {
+      h = std::move(it->second.back());
+      it->second.pop_back();
+      this->pooled_bytes -= get_bytes(h);
+      this->reuse_count++;
+      reused = true;
+    }
+  }
+
+  if (reused)
+  {
+    // recycled buffers hold the values of their previous owner
+    hmap::parallel_for(h.get_ntiles(),
+                       [&h](size_t k)
+                       {
+                         hmap::Array &a = h.tiles[k];
+                         a = 0.f;
+                       });
+  }
+  else
+  {
+    h = hmap::Heightmap(shape, tiling, overlap);
+  }
+
+  std::lock_guard<std::mutex> lock(this->mtx);
+  size_t nbytes = get_bytes(h);
+  this->acquired[p_owner] += nbytes;
+  this->allocated_bytes += nbytes;
+  this->peak_bytes = std::max(this->peak_bytes, this->allocated_bytes);
+
+  return h;
+}
+
+void HeightmapPool::clear()
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+
+  this->buckets.clear();
+  this->pooled_bytes = 0;
+}
+
+size_t HeightmapPool::get_allocated_bytes() const
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+  return this->allocated_bytes;
+}
+
+size_t HeightmapPool::get_bytes(const hmap::Heightmap &h)
+{
+  size_t n = 0;
+  for (auto &t : h.tiles)
+    n += t.vector.size() * sizeof(float);
+  return n;
+}
+
+size_t HeightmapPool::get_peak_bytes() const
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+  return this->peak_bytes;
+}
+
+size_t HeightmapPool::get_pooled_bytes() const
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+  return this->pooled_bytes;
+}
+
+size_t HeightmapPool::get_reuse_count() const
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+  return this->reuse_count;
+}
+
+void HeightmapPool::release(const void *p_owner, hmap::Heightmap &&h)
+{
+  size_t nbytes = get_bytes(h);
+
+  bool is_shared = false;
+  for (size_t k = 0; k < h.get_ntiles(); ++k)
+    is_shared |= h.tiles.is_shared(k);
+
+  std::lock_guard<std::mutex> lock(this->mtx);
+
+  auto it = this->acquired.find(p_owner);
+
+  if (it != this->acquired.end())
+  {
+    this->allocated_bytes -= it->second;
+    this->acquired.erase(it);
+  }
+
+  if (is_shared || nbytes == 0)
+    return;
+
+  Key key = {h.shape.x, h.shape.y, h.tiling.x, h.tiling.y, h.overlap};
+
+  this->buckets[key].push_back(std::move(h));
+  this->pooled_bytes += nbytes;
+}
+
+} // namespace hesiod
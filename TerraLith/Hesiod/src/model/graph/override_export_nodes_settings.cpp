@@ -2,7 +2,6 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include <filesystem>
-#include <random>
 
 #include "hesiod/gui/widgets/bake_config_dialog.hpp"
 #include "hesiod/logger.hpp"
@@ -25,21 +24,14 @@ static std::string format_value_to_choice(int format_value)
   }
 }
 
-void override_export_nodes_settings(const std::string           &fname,
+void override_export_nodes_settings(nlohmann::json              &json,
                                     const std::filesystem::path &export_path,
                                     unsigned int                 random_seeds_increment,
                                     const BakeConfig            &bake_settings)
 {
-  Logger::log()->trace("override_export_nodes_settings: fname = {}, export_path = {}",
-                       fname,
+  Logger::log()->trace("override_export_nodes_settings: export_path = {}",
                        export_path.string());
 
-  std::random_device rd;
-
-  // load
-  nlohmann::json json = json_from_file(fname);
-
-  // modify
   for (auto &[key, value] : json["graph_manager"]["graph_nodes"].items())
     for (auto &j : value["nodes"])
     {
@@ -139,8 +131,22 @@ void override_export_nodes_settings(const std::string           &fname,
         }
       }
     }
+}
+
+void override_export_nodes_settings(const std::string           &fname,
+                                    const std::filesystem::path &export_path,
+                                    unsigned int                 random_seeds_increment,
+                                    const BakeConfig            &bake_settings)
+{
+  Logger::log()->trace("override_export_nodes_settings: fname = {}", fname);
+
+  nlohmann::json json = json_from_file(fname);
+
+  override_export_nodes_settings(json,
+                                 export_path,
+                                 random_seeds_increment,
+                                 bake_settings);
 
-  // write back
   json_to_file(json, fname);
 }
 
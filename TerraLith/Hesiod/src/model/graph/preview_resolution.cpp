@@ -0,0 +1,198 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <map>
+#include <set>
+
+#include "hesiod/logger.hpp"
+#include "hesiod/model/graph/graph_node.hpp"
+#include "hesiod/model/graph/preview_resolution.hpp"
+#include "hesiod/model/nodes/base_node.hpp"
+
+// minimum number of cells per tile at the reduced resolution
+#define HSD_PREVIEW_MIN_TILE_SHAPE 32
+
+namespace hesiod
+{
+
+// downsampled copy of the data of an output port, nullptr for the data which do not
+// depend on the resolution (clouds, paths...)
+static std::shared_ptr<gnode::BaseData> helper_downsample(BaseNode          &node,
+                                                          int                port_index,
+                                                          const GraphConfig &config)
+{
+  auto downsample = [&config](const hmap::Heightmap &h)
+  {
+    hmap::Heightmap h_out(config.shape, config.tiling, config.overlap);
+    hmap::Array     array = h.to_array(config.shape);
+    h_out.from_array_interp_nearest(array);
+    return h_out;
+  };
+
+  if (auto *p_h = node.get_value_ref<hmap::Heightmap>(port_index))
+  {
+    return std::make_shared<gnode::Data<hmap::Heightmap>>(downsample(*p_h));
+  }
+  else if (auto *p_rgba = node.get_value_ref<hmap::HeightmapRGBA>(port_index))
+  {
+    if (p_rgba->rgba.size() != 4)
+      return std::make_shared<gnode::Data<hmap::HeightmapRGBA>>(config.shape,
+                                                                config.tiling,
+                                                                config.overlap);
+
+    return std::make_shared<gnode::Data<hmap::HeightmapRGBA>>(
+        downsample(p_rgba->rgba[0]),
+        downsample(p_rgba->rgba[1]),
+        downsample(p_rgba->rgba[2]),
+        downsample(p_rgba->rgba[3]));
+  }
+  else if (auto *p_a = node.get_value_ref<hmap::Array>(port_index))
+  {
+    return std::make_shared<gnode::Data<hmap::Array>>(
+        p_a->resample_to_shape(config.shape));
+  }
+  else if (auto *p_v = node.get_value_ref<std::vector<hmap::Heightmap>>(port_index))
+  {
+    std::vector<hmap::Heightmap> v;
+    for (auto &h : *p_v)
+      v.push_back(downsample(h));
+
+    return std::make_shared<gnode::Data<std::vector<hmap::Heightmap>>>(std::move(v));
+  }
+
+  return nullptr;
+}
+
+ScopedPreviewResolution::ScopedPreviewResolution(GraphNode                      &graph,
+                                                 const std::vector<std::string> &node_ids,
+                                                 int                             factor)
+    : graph(graph), node_ids(node_ids),
+      config(std::make_shared<GraphConfig>(*graph.get_config_ref()))
+{
+  GraphConfig *p_config = this->config.get();
+  p_config->set_shape(
+      ScopedPreviewResolution::get_shape(*this->graph.get_config_ref(), factor));
+
+  Logger::log()->trace("ScopedPreviewResolution: {} nodes at {}x{}",
+                       this->node_ids.size(),
+                       p_config->shape.x,
+                       p_config->shape.y);
+
+  // outputs at the reduced resolution
+  for (auto &nid : this->node_ids)
+    if (BaseNode *p_node = this->graph.get_node_ref_by_id<BaseNode>(nid))
+    {
+      p_node->set_config_ref(this->config);
+      p_node->set_memoization_enabled(false);
+      p_node->propagate_config_change();
+    }
+
+  // inputs from the nodes left at full resolution, a given output is downsampled
+  // only once whatever the number of nodes reading it
+  std::set<std::string> ids(this->node_ids.begin(), this->node_ids.end());
+  std::map<std::pair<std::string, int>, std::shared_ptr<gnode::BaseData>> downsampled;
+
+  for (auto &link : this->graph.get_links())
+  {
+    if (ids.contains(link.from) || !ids.contains(link.to))
+      continue;
+
+    BaseNode    *p_from = this->graph.get_node_ref_by_id<BaseNode>(link.from);
+    gnode::Node *p_to = this->graph.get_node_ref_by_id(link.to);
+    if (!p_from || !p_to)
+      continue;
+
+    auto key = std::make_pair(link.from, link.port_from);
+
+    if (!downsampled.contains(key))
+      downsampled[key] = helper_downsample(*p_from, link.port_from, *p_config);
+
+    if (!downsampled.at(key))
+      continue;
+
+    auto p_port_from = p_from->get_ports()[link.port_from];
+    auto p_port_to = p_to->get_ports()[link.port_to];
+
+    this->relinks.push_back(
+        {link.to, link.port_to, p_port_from->get_data_shared_ptr_downcasted()});
+    p_port_to->set_data(downsampled.at(key));
+  }
+
+  for (auto &[_, data] : downsampled)
+    if (data)
+      this->downsampled_data.push_back(data);
+}
+
+ScopedPreviewResolution::~ScopedPreviewResolution()
+{
+  for (auto &relink : this->relinks)
+    if (gnode::Node *p_node = this->graph.get_node_ref_by_id(relink.node_id))
+      p_node->get_ports()[relink.port_index]->set_data(relink.data);
+
+  // the nodes of the graph editor are always memoized (only batch updates disable it)
+  for (auto &nid : this->node_ids)
+    if (BaseNode *p_node = this->graph.get_node_ref_by_id<BaseNode>(nid))
+    {
+      p_node->set_config_ref(this->graph.get_config_shared());
+      p_node->set_memoization_enabled(true);
+    }
+}
+
+std::vector<std::string> ScopedPreviewResolution::get_node_ids(
+    GraphNode                      &graph,
+    const std::vector<std::string> &sorted_ids,
+    int                             factor)
+{
+  if (ScopedPreviewResolution::get_shape(*graph.get_config_ref(), factor) ==
+      graph.get_config_ref()->shape)
+    return {};
+
+  // the exports would write coarse files and the broadcast tags are shared with the
+  // other graphs (computed at full resolution), these nodes and everything
+  // downstream are only computed at full resolution. Since the ids are sorted, the
+  // upstream nodes are always checked first
+  auto connectivity_up = graph.get_connectivity_upstream();
+
+  std::set<std::string>    excluded_ids;
+  std::vector<std::string> node_ids;
+
+  for (auto &nid : sorted_ids)
+  {
+    gnode::Node *p_node = graph.get_node_ref_by_id(nid);
+    if (!p_node)
+      continue;
+
+    const std::string label = p_node->get_label();
+    bool excluded = label.find("Export") != std::string::npos || label == "Broadcast" ||
+                    label == "Receive";
+
+    for (auto &up_id : connectivity_up[nid])
+      excluded |= excluded_ids.contains(up_id);
+
+    if (excluded)
+      excluded_ids.insert(nid);
+    else
+      node_ids.push_back(nid);
+  }
+
+  return node_ids;
+}
+
+hmap::Vec2<int> ScopedPreviewResolution::get_shape(const GraphConfig &config, int factor)
+{
+  if (factor <= 1)
+    return config.shape;
+
+  hmap::Vec2<int> shape_min(HSD_PREVIEW_MIN_TILE_SHAPE * config.tiling.x,
+                            HSD_PREVIEW_MIN_TILE_SHAPE * config.tiling.y);
+
+  hmap::Vec2<int> shape(std::max(config.shape.x / factor, shape_min.x),
+                        std::max(config.shape.y / factor, shape_min.y));
+
+  if (shape.x >= config.shape.x || shape.y >= config.shape.y)
+    return config.shape;
+
+  return shape;
+}
+
+} // namespace hesiod
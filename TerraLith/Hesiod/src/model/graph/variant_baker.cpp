@@ -0,0 +1,336 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
+   License. The full license is in the file LICENSE, distributed with this software. */
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "attributes/seed_attribute.hpp"
+
+#include "hesiod/logger.hpp"
+#include "hesiod/model/graph/graph_manager.hpp"
+#include "hesiod/model/graph/graph_node.hpp"
+#include "hesiod/model/graph/heightmap_pool.hpp"
+#include "hesiod/model/graph/variant_baker.hpp"
+#include "hesiod/model/nodes/base_node.hpp"
+#include "hesiod/model/nodes/broadcast_node.hpp"
+#include "hesiod/model/nodes/receive_node.hpp"
+#include "hesiod/model/utils.hpp"
+
+namespace hesiod
+{
+
+// nodes modified by override_export_nodes_settings from one variant to another, or
+// receiving a variant-dependent broadcast
+static bool helper_is_variant_source(BaseNode                    &node,
+                                     const std::set<std::string> &variant_tags)
+{
+  for (auto &[_, attr] : *node.get_attributes_ref())
+    if (attr && attr->get_type() == attr::AttributeType::SEED)
+      return true;
+
+  if (node.get_label().find("Export") != std::string::npos)
+    return true;
+
+  if (ReceiveNode *p_receive = dynamic_cast<ReceiveNode *>(&node))
+    return variant_tags.contains(p_receive->get_current_tag());
+
+  return false;
+}
+
+// memory of the heightmap tiles of the outputs not shared anymore with the node they
+// were copied from, i.e. duplicated because a node of the variant wrote to them
+static size_t helper_detached_bytes(const hmap::Heightmap &h)
+{
+  size_t nbytes = 0;
+  for (size_t k = 0; k < h.tiles.size(); k++)
+    if (!h.tiles.is_shared(k))
+      nbytes += std::as_const(h.tiles)[k].vector.size() * sizeof(float);
+  return nbytes;
+}
+
+static size_t helper_detached_bytes(BaseNode &node)
+{
+  size_t nbytes = 0;
+
+  for (int k = 0; k < node.get_nports(); k++)
+  {
+    if (node.get_port_type(k) != gngui::PortType::OUT)
+      continue;
+
+    void *ptr = node.get_value_ref_void(k);
+    if (!ptr)
+      continue;
+
+    if (node.get_data_type(k) == typeid(hmap::Heightmap).name())
+      nbytes += helper_detached_bytes(*static_cast<hmap::Heightmap *>(ptr));
+    else if (node.get_data_type(k) == typeid(hmap::HeightmapRGBA).name())
+      for (auto &h : static_cast<hmap::HeightmapRGBA *>(ptr)->rgba)
+        nbytes += helper_detached_bytes(h);
+  }
+
+  return nbytes;
+}
+
+VariantBaker::VariantBaker(const nlohmann::json        &json,
+                           const GraphConfig           &config,
+                           const BakeConfig            &bake_settings,
+                           const std::filesystem::path &project_path)
+    : json(json), config(config), bake_settings(bake_settings),
+      project_path(project_path)
+{
+}
+
+int VariantBaker::bake(size_t memory_budget_mb)
+{
+  const int nvariants = this->bake_settings.nvariants + 1;
+
+  Logger::log()->trace("VariantBaker::bake: nvariants = {}, memory budget = {} MB",
+                       nvariants,
+                       memory_budget_mb);
+
+  std::atomic<int> ndone{0};
+  std::atomic<int> nsuccess{0};
+
+  auto on_variant_done = [this, &ndone, &nsuccess, nvariants](int k, bool success)
+  {
+    int n = ++ndone;
+    if (success)
+      nsuccess++;
+
+    if (this->variant_done)
+      this->variant_done(k, n, nvariants);
+  };
+
+  // --- variant 0, computes everything and keeps the shared outputs
+
+  std::shared_ptr<GraphManager> reference = this->load_variant(0);
+  this->find_variant_nodes(*reference);
+
+  try
+  {
+    // the outputs used by the flatten export are kept as well
+    std::map<std::string, std::set<std::string>> pinned_node_ids = this->shared_node_ids;
+
+    for (auto &ids : reference->get_export_param().ids)
+      pinned_node_ids[std::get<0>(ids)].insert(std::get<1>(ids));
+
+    HeightmapPool pool;
+
+    for (auto &graph_id : reference->get_graph_order())
+      reference->get_graph_ref_by_id(graph_id)->update_batch(pool,
+                                                             pinned_node_ids[graph_id]);
+
+    if (!reference->get_export_param().export_path.empty())
+      reference->export_flatten();
+
+    Logger::log()->info("VariantBaker::bake: variant 0 done, peak memory {:.1f} MB",
+                        static_cast<float>(pool.get_peak_bytes()) / (1024.f * 1024.f));
+
+    on_variant_done(0, true);
+  }
+  catch (const std::exception &e)
+  {
+    // the other variants read the outputs of this one
+    Logger::log()->error("VariantBaker::bake: variant 0 failed: {}", e.what());
+    return 0;
+  }
+
+  if (nvariants == 1)
+    return nsuccess;
+
+  // --- first variant alone, to measure its memory footprint
+
+  size_t peak_bytes = 0;
+  on_variant_done(1, this->run_variant(1, *reference, &peak_bytes));
+
+  if (nvariants == 2)
+    return nsuccess;
+
+  // --- the others, as many at a time as the budget allows
+
+  const size_t budget_bytes = memory_budget_mb * 1024 * 1024;
+  const size_t nhw = std::max(1u, std::thread::hardware_concurrency());
+
+  size_t nthreads = budget_bytes / std::max(peak_bytes, size_t(1));
+  nthreads = std::clamp(nthreads, size_t(1), std::min(nhw, size_t(nvariants - 2)));
+
+  Logger::log()->info("VariantBaker::bake: {:.1f} MB per variant, {} at a time",
+                      static_cast<float>(peak_bytes) / (1024.f * 1024.f),
+                      nthreads);
+
+  std::atomic<int>         next_k{2};
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < nthreads; ++i)
+    threads.emplace_back(
+        [this, &reference, &next_k, &on_variant_done, nvariants]()
+        {
+          for (int k = next_k++; k < nvariants; k = next_k++)
+            on_variant_done(k, this->run_variant(k, *reference, nullptr));
+        });
+
+  for (auto &thread : threads)
+    thread.join();
+
+  return nsuccess;
+}
+
+nlohmann::json VariantBaker::build_variant_json(int k) const
+{
+  nlohmann::json json_variant = this->json;
+
+  override_export_nodes_settings(
+      json_variant,
+      this->bake_settings.get_variant_export_path(this->project_path, k),
+      static_cast<unsigned int>(k),
+      this->bake_settings);
+
+  return json_variant;
+}
+
+void VariantBaker::find_variant_nodes(GraphManager &graph_manager)
+{
+  this->variant_node_ids.clear();
+  this->shared_node_ids.clear();
+
+  // broadcast tags of the variant-dependent Broadcast nodes, received by the
+  // graphs below
+  std::set<std::string> variant_tags = {};
+
+  for (auto &graph_id : graph_manager.get_graph_order())
+  {
+    GraphNode *p_graph = graph_manager.get_graph_ref_by_id(graph_id);
+
+    std::set<std::string> &node_ids = this->variant_node_ids[graph_id];
+    std::set<std::string> &shared_ids = this->shared_node_ids[graph_id];
+
+    std::vector<std::string> all_ids = {};
+    for (auto &[nid, _] : p_graph->get_nodes())
+      all_ids.push_back(nid);
+
+    const auto connectivity_up = p_graph->get_connectivity_upstream();
+
+    for (auto &nid : p_graph->topological_sort(all_ids))
+    {
+      BaseNode *p_node = p_graph->get_node_ref_by_id<BaseNode>(nid);
+
+      bool is_variant = helper_is_variant_source(*p_node, variant_tags);
+
+      for (auto &up_id : connectivity_up.at(nid))
+        is_variant |= node_ids.contains(up_id);
+
+      if (!is_variant)
+        continue;
+
+      node_ids.insert(nid);
+
+      if (BroadcastNode *p_broadcast = dynamic_cast<BroadcastNode *>(p_node))
+        variant_tags.insert(p_broadcast->get_broadcast_tag());
+    }
+
+    for (auto &link : p_graph->get_links())
+      if (node_ids.contains(link.to) && !node_ids.contains(link.from))
+        shared_ids.insert(link.from);
+
+    Logger::log()->info(
+        "VariantBaker::find_variant_nodes: graph {}, {}/{} node(s) computed per "
+        "variant, {} shared output(s)",
+        graph_id,
+        node_ids.size(),
+        all_ids.size(),
+        shared_ids.size());
+  }
+}
+
+std::shared_ptr<GraphManager> VariantBaker::load_variant(int k) const
+{
+  Logger::log()->trace("VariantBaker::load_variant: k = {}", k);
+
+  // the node creation is not meant to be thread-safe
+  static std::mutex           load_mutex;
+  std::lock_guard<std::mutex> lock(load_mutex);
+
+  const std::filesystem::path export_path = this->bake_settings.get_variant_export_path(
+      this->project_path,
+      k);
+
+  Logger::log()->info("VariantBaker::load_variant: export path: {}",
+                      export_path.string());
+
+  if (!std::filesystem::exists(export_path))
+    std::filesystem::create_directories(export_path);
+
+  nlohmann::json json_variant = this->build_variant_json(k);
+
+  // keep a copy of the project actually baked
+  json_to_file(json_variant, (export_path / "hesiod_bake.hsd").string());
+
+  GraphConfig config_variant = this->config;
+
+  auto graph_manager = std::make_shared<GraphManager>();
+  graph_manager->set_lazy_outputs(true);
+  graph_manager->json_from(json_variant["graph_manager"], &config_variant);
+
+  return graph_manager;
+}
+
+bool VariantBaker::run_variant(int           k,
+                               GraphManager &reference,
+                               size_t       *p_peak_bytes) const
+{
+  Logger::log()->trace("VariantBaker::run_variant: k = {}", k);
+
+  try
+  {
+    std::shared_ptr<GraphManager> graph_manager = this->load_variant(k);
+
+    // a pool of its own, its peak only covers the outputs of this variant
+    // (accounted to the ports that acquired them, whatever the nodes did
+    // with the buffers)
+    HeightmapPool pool;
+    size_t        detached_bytes = 0;
+
+    for (auto &graph_id : graph_manager->get_graph_order())
+    {
+      GraphNode *p_graph = graph_manager->get_graph_ref_by_id(graph_id);
+      GraphNode *p_graph_ref = reference.get_graph_ref_by_id(graph_id);
+
+      // outputs computed by variant 0
+      for (auto &nid : this->shared_node_ids.at(graph_id))
+      {
+        BaseNode *p_node = p_graph->get_node_ref_by_id<BaseNode>(nid);
+        BaseNode *p_node_ref = p_graph_ref->get_node_ref_by_id<BaseNode>(nid);
+
+        if (!p_node->copy_outputs_from(*p_node_ref))
+          throw std::runtime_error("outputs of node " + nid + " could not be shared");
+      }
+
+      p_graph->update_batch(pool, {}, &this->variant_node_ids.at(graph_id));
+
+      // the copied outputs are not allocated by the pool, what the variant
+      // duplicated is kept until the end
+      for (auto &nid : this->shared_node_ids.at(graph_id))
+        detached_bytes += helper_detached_bytes(
+            *p_graph->get_node_ref_by_id<BaseNode>(nid));
+    }
+
+    const size_t peak_bytes = pool.get_peak_bytes() + detached_bytes;
+
+    if (p_peak_bytes)
+      *p_peak_bytes = peak_bytes;
+
+    Logger::log()->info("VariantBaker::run_variant: variant {} done, {:.1f} MB",
+                        k,
+                        static_cast<float>(peak_bytes) / (1024.f * 1024.f));
+    return true;
+  }
+  catch (const std::exception &e)
+  {
+    Logger::log()->error("VariantBaker::run_variant: variant {} failed: {}", k, e.what());
+    return false;
+  }
+}
+
+} // namespace hesiod
@@ -3,10 +3,12 @@
  * this software. */
 #include <format>
 #include <fstream>
+#include <mutex>
 #include <unordered_map>
 
 #include <QCoreApplication>
 
+#include "highmap/execution_context.hpp"
 #include "highmap/geometry/cloud.hpp"
 #include "highmap/geometry/path.hpp"
 #include "highmap/heightmap.hpp"
@@ -72,6 +74,29 @@ void BaseNode::compute()
     this->compute_started(this->get_id());
 
   this->update_runtime_info(NodeRuntimeStep::NRS_UPDATE_START);
+  this->cancelled_ = false;
+
+  // content-addressed memoization: the outputs are kept if the key did not
+  // change since the last computation (this is what stops the propagation
+  // downstream of a node whose output did not change), or restored from the
+  // output cache
+  const uint64_t key = this->is_memoizable() ? this->compute_memo_key() : 0;
+
+  this->reused_ = key && (key == this->memo_key_ || this->restore_outputs(key));
+
+  if (this->reused_)
+  {
+    Logger::log()->trace("BaseNode::compute: outputs reused for node {}({})",
+                         this->get_label(),
+                         this->get_id());
+
+    this->memo_key_ = key;
+    this->update_runtime_info(NodeRuntimeStep::NRS_UPDATE_END);
+
+    if (this->compute_finished)
+      this->compute_finished(this->get_id());
+    return;
+  }
 
   bool handled = false;
 
@@ -81,12 +106,22 @@ void BaseNode::compute()
   // sets vulkan_enabled_ via set_vulkan_enabled().
   if (this->vulkan_enabled_ && this->compute_vulkan_fct)
   {
+    // the Vulkan pipelines are shared singletons, nodes computed
+    // concurrently by the graph scheduler take turns on the GPU
+    static std::mutex           vulkan_mutex;
+    std::lock_guard<std::mutex> lock(vulkan_mutex);
+
     try
     {
       handled = this->compute_vulkan_fct(*this);
       if (handled)
         this->runtime_info.last_backend_used = ComputeBackend::VULKAN;
     }
+    catch (const hmap::OperationCancelled &)
+    {
+      this->cancelled_ = true;
+      handled = true;
+    }
     catch (const std::exception &e)
     {
       Logger::log()->warn("BaseNode::compute: Vulkan compute failed for node {}: {}, "
@@ -101,13 +136,47 @@ void BaseNode::compute()
   if (!handled)
   {
     this->runtime_info.last_backend_used = ComputeBackend::CPU;
-    if (this->compute_fct)
-      this->compute_fct(*this);
-    else
-      Logger::log()->warn("BaseNode::compute: no compute function set for node {}",
-                          this->get_id());
+
+    // the long HighMap operators poll the execution context installed by the
+    // caller (if any) and throw when it is cancelled
+    try
+    {
+      if (this->compute_fct)
+        this->compute_fct(*this);
+      else
+        Logger::log()->warn("BaseNode::compute: no compute function set for node {}",
+                            this->get_id());
+    }
+    catch (const hmap::OperationCancelled &)
+    {
+      this->cancelled_ = true;
+    }
+  }
+
+  if (this->cancelled_)
+  {
+    // the outputs are partial, they must not be reused nor cached
+    Logger::log()->trace("BaseNode::compute: cancelled for node {}({})",
+                         this->get_label(),
+                         this->get_id());
+
+    this->invalidate_memo();
+    this->update_runtime_info(NodeRuntimeStep::NRS_UPDATE_END);
+
+    if (this->compute_finished)
+      this->compute_finished(this->get_id());
+    return;
   }
 
+  // the node is done with its outputs, nobody else reads them yet
+  this->collect_outputs();
+
+  this->hash_outputs();
+  this->memo_key_ = key;
+
+  if (key)
+    this->store_outputs(key);
+
   this->update_runtime_info(NodeRuntimeStep::NRS_UPDATE_END);
 
   if (this->compute_finished)
@@ -521,6 +590,9 @@ void BaseNode::propagate_config_change()
                        this->get_caption(),
                        this->get_id());
 
+  // the outputs are reset below
+  this->invalidate_memo();
+
   // go through the data and modify is needed (only outputs hold data)
   for (int k = 0; k < this->get_nports(); k++)
     if (this->get_port_type(k) == gngui::PortType::OUT)
@@ -583,6 +655,11 @@ void BaseNode::set_attr_ordered_key(const std::vector<std::string> &new_attr_ord
   this->attr_ordered_key = new_attr_ordered_key;
 }
 
+void BaseNode::set_config_ref(std::weak_ptr<GraphConfig> new_config)
+{
+  this->config = new_config;
+}
+
 void BaseNode::set_comment(const std::string &new_comment)
 {
   this->comment = new_comment;
@@ -608,6 +685,8 @@ ComputeBackend BaseNode::get_last_backend_used() const
   return this->runtime_info.last_backend_used;
 }
 
+bool BaseNode::was_cancelled() const { return this->cancelled_; }
+
 void BaseNode::set_vulkan_enabled(bool enabled)
 {
   this->vulkan_enabled_ = enabled;
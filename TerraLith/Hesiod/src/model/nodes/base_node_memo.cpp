@@ -0,0 +1,720 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <any>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "gnode/graph.hpp"
+
+#include "highmap/geometry/cloud.hpp"
+#include "highmap/geometry/path.hpp"
+#include "highmap/heightmap.hpp"
+
+#include "hesiod/app/hesiod_application.hpp"
+#include "hesiod/build_id.hpp"
+#include "hesiod/core/node_output_cache.hpp"
+#include "hesiod/logger.hpp"
+#include "hesiod/model/nodes/base_node.hpp"
+
+namespace hesiod
+{
+
+// --- helpers
+
+// the data are consumed by 8-byte words mixed with a multiply-xorshift,
+// hashing a full-resolution heightmap is then much cheaper than computing it
+static uint64_t helper_hash_bytes(const void *data, size_t nbytes, uint64_t h)
+{
+  constexpr uint64_t m = 0x9e3779b97f4a7c15ull;
+
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  size_t               k = 0;
+
+  for (; k + 8 <= nbytes; k += 8)
+  {
+    uint64_t w;
+    std::memcpy(&w, p + k, 8);
+    h = (h ^ w) * m;
+    h ^= h >> 32;
+  }
+
+  for (; k < nbytes; k++)
+    h = (h ^ p[k]) * m;
+
+  h = (h ^ nbytes) * m;
+  return h ^ (h >> 29);
+}
+
+template <typename T> static uint64_t helper_hash_pod(const T &v, uint64_t h)
+{
+  return helper_hash_bytes(&v, sizeof(T), h);
+}
+
+static uint64_t helper_hash_data(const hmap::Array &array, uint64_t h)
+{
+  h = helper_hash_pod(array.shape, h);
+  return helper_hash_bytes(array.vector.data(), array.vector.size() * sizeof(float), h);
+}
+
+static uint64_t helper_hash_data(const hmap::Heightmap &hm, uint64_t h)
+{
+  h = helper_hash_pod(hm.shape, h);
+  h = helper_hash_pod(hm.tiling, h);
+  h = helper_hash_pod(hm.overlap, h);
+
+  // const access, shared tiles are not detached
+  for (size_t k = 0; k < hm.tiles.size(); k++)
+    h = helper_hash_data(static_cast<const hmap::Array &>(hm.tiles[k]), h);
+
+  return h;
+}
+
+static uint64_t helper_hash_data(const hmap::HeightmapRGBA &rgba, uint64_t h)
+{
+  for (auto &hm : rgba.rgba)
+    h = helper_hash_data(hm, h);
+  return h;
+}
+
+static uint64_t helper_hash_data(const hmap::Cloud &cloud, uint64_t h)
+{
+  h = helper_hash_pod(cloud.points.size(), h);
+  for (auto &p : cloud.points)
+  {
+    float xyv[3] = {p.x, p.y, p.v};
+    h = helper_hash_bytes(xyv, sizeof(xyv), h);
+  }
+  return h;
+}
+
+static uint64_t helper_hash_data(const hmap::Path &path, uint64_t h)
+{
+  h = helper_hash_data(static_cast<const hmap::Cloud &>(path), h);
+  return helper_hash_pod(path.closed, h);
+}
+
+static uint64_t helper_hash_data(const std::vector<float> &vec, uint64_t h)
+{
+  return helper_hash_bytes(vec.data(), vec.size() * sizeof(float), h);
+}
+
+static uint64_t helper_hash_data(const std::vector<hmap::Heightmap> &vec, uint64_t h)
+{
+  h = helper_hash_pod(vec.size(), h);
+  for (auto &hm : vec)
+    h = helper_hash_data(hm, h);
+  return h;
+}
+
+static size_t helper_data_bytes(const hmap::Array &array)
+{
+  return array.vector.size() * sizeof(float);
+}
+
+static size_t helper_data_bytes(const hmap::Heightmap &hm)
+{
+  size_t nbytes = 0;
+  for (size_t k = 0; k < hm.tiles.size(); k++)
+    nbytes += helper_data_bytes(static_cast<const hmap::Array &>(hm.tiles[k]));
+  return nbytes;
+}
+
+static size_t helper_data_bytes(const hmap::HeightmapRGBA &rgba)
+{
+  size_t nbytes = 0;
+  for (auto &hm : rgba.rgba)
+    nbytes += helper_data_bytes(hm);
+  return nbytes;
+}
+
+static size_t helper_data_bytes(const hmap::Cloud &cloud)
+{
+  return cloud.points.size() * sizeof(hmap::Point);
+}
+
+static size_t helper_data_bytes(const std::vector<float> &vec)
+{
+  return vec.size() * sizeof(float);
+}
+
+static size_t helper_data_bytes(const std::vector<hmap::Heightmap> &vec)
+{
+  size_t nbytes = 0;
+  for (auto &hm : vec)
+    nbytes += helper_data_bytes(hm);
+  return nbytes;
+}
+
+// --- serialization (disk cache), native endianness, the files are not
+// meant to be shared between machines
+
+// blob reader, throws on truncated data
+struct BlobReader
+{
+  const char *p;
+  const char *end;
+
+  template <typename T> T read()
+  {
+    T v;
+    this->read_bytes(&v, sizeof(T));
+    return v;
+  }
+
+  void read_bytes(void *dst, size_t nbytes)
+  {
+    if (static_cast<size_t>(this->end - this->p) < nbytes)
+      throw std::runtime_error("truncated node output cache data");
+
+    std::memcpy(dst, this->p, nbytes);
+    this->p += nbytes;
+  }
+};
+
+template <typename T> static void helper_write_pod(std::string &buf, const T &v)
+{
+  buf.append(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+static void helper_write_floats(std::string &buf, const std::vector<float> &vec)
+{
+  helper_write_pod(buf, static_cast<uint64_t>(vec.size()));
+  buf.append(reinterpret_cast<const char *>(vec.data()), vec.size() * sizeof(float));
+}
+
+static void helper_read_floats(BlobReader &reader, std::vector<float> &vec)
+{
+  uint64_t n = reader.read<uint64_t>();
+  if (n != vec.size())
+    throw std::runtime_error("inconsistent node output cache data");
+
+  reader.read_bytes(vec.data(), n * sizeof(float));
+}
+
+static void helper_write_data(std::string &buf, const hmap::Array &array)
+{
+  helper_write_pod(buf, array.shape);
+  helper_write_floats(buf, array.vector);
+}
+
+static void helper_read_data(BlobReader &reader, hmap::Array &array)
+{
+  array = hmap::Array(reader.read<hmap::Vec2<int>>());
+  helper_read_floats(reader, array.vector);
+}
+
+static void helper_write_data(std::string &buf, const hmap::Heightmap &hm)
+{
+  helper_write_pod(buf, hm.shape);
+  helper_write_pod(buf, hm.tiling);
+  helper_write_pod(buf, hm.overlap);
+
+  for (size_t k = 0; k < hm.tiles.size(); k++)
+    helper_write_floats(buf, hm.tiles[k].vector);
+}
+
+static void helper_read_data(BlobReader &reader, hmap::Heightmap &hm)
+{
+  auto shape = reader.read<hmap::Vec2<int>>();
+  auto tiling = reader.read<hmap::Vec2<int>>();
+  auto overlap = reader.read<float>();
+
+  // the tile geometry is rebuilt by the constructor, only the values are read
+  hm = hmap::Heightmap(shape, tiling, overlap);
+
+  for (size_t k = 0; k < hm.tiles.size(); k++)
+    helper_read_floats(reader, hm.tiles[k].vector);
+}
+
+static void helper_write_data(std::string &buf, const hmap::HeightmapRGBA &rgba)
+{
+  helper_write_pod(buf, rgba.shape);
+  helper_write_pod(buf, static_cast<uint64_t>(rgba.rgba.size()));
+  for (auto &hm : rgba.rgba)
+    helper_write_data(buf, hm);
+}
+
+static void helper_read_data(BlobReader &reader, hmap::HeightmapRGBA &rgba)
+{
+  rgba = hmap::HeightmapRGBA();
+  rgba.shape = reader.read<hmap::Vec2<int>>();
+  rgba.rgba.resize(reader.read<uint64_t>());
+  for (auto &hm : rgba.rgba)
+    helper_read_data(reader, hm);
+}
+
+static void helper_write_data(std::string &buf, const hmap::Cloud &cloud)
+{
+  helper_write_pod(buf, static_cast<uint64_t>(cloud.points.size()));
+  for (auto &p : cloud.points)
+  {
+    float xyv[3] = {p.x, p.y, p.v};
+    helper_write_pod(buf, xyv);
+  }
+}
+
+static void helper_read_data(BlobReader &reader, hmap::Cloud &cloud)
+{
+  cloud.points.clear();
+
+  uint64_t n = reader.read<uint64_t>();
+  for (uint64_t k = 0; k < n; k++)
+  {
+    float xyv[3];
+    reader.read_bytes(xyv, sizeof(xyv));
+    cloud.points.push_back(hmap::Point(xyv[0], xyv[1], xyv[2]));
+  }
+}
+
+static void helper_write_data(std::string &buf, const hmap::Path &path)
+{
+  helper_write_data(buf, static_cast<const hmap::Cloud &>(path));
+  helper_write_pod(buf, path.closed);
+}
+
+static void helper_read_data(BlobReader &reader, hmap::Path &path)
+{
+  helper_read_data(reader, static_cast<hmap::Cloud &>(path));
+  path.closed = reader.read<bool>();
+}
+
+static void helper_write_data(std::string &buf, const std::vector<float> &vec)
+{
+  helper_write_floats(buf, vec);
+}
+
+static void helper_read_data(BlobReader &reader, std::vector<float> &vec)
+{
+  uint64_t n = reader.read<uint64_t>();
+  if (n > static_cast<uint64_t>(reader.end - reader.p) / sizeof(float))
+    throw std::runtime_error("truncated node output cache data");
+
+  vec.resize(n);
+  reader.read_bytes(vec.data(), n * sizeof(float));
+}
+
+static void helper_write_data(std::string &buf, const std::vector<hmap::Heightmap> &vec)
+{
+  helper_write_pod(buf, static_cast<uint64_t>(vec.size()));
+  for (auto &hm : vec)
+    helper_write_data(buf, hm);
+}
+
+static void helper_read_data(BlobReader &reader, std::vector<hmap::Heightmap> &vec)
+{
+  vec.resize(reader.read<uint64_t>());
+  for (auto &hm : vec)
+    helper_read_data(reader, hm);
+}
+
+static void helper_collect_data(hmap::Heightmap &hm) { hm.tiles.collect(); }
+
+static void helper_collect_data(hmap::HeightmapRGBA &rgba)
+{
+  for (auto &hm : rgba.rgba)
+    helper_collect_data(hm);
+}
+
+static void helper_collect_data(std::vector<hmap::Heightmap> &vec)
+{
+  for (auto &hm : vec)
+    helper_collect_data(hm);
+}
+
+// no tile storage
+template <typename T> static void helper_collect_data(T &) {}
+
+// type-erased operations on the data of a port
+struct PortDataOps
+{
+  std::function<uint64_t(const void *)>             hash;
+  std::function<size_t(const void *)>               bytes;
+  std::function<std::any(const void *)>             copy;
+  std::function<void(const std::any &, void *)>    restore;
+  std::function<void(const std::any &, std::string &)> write;
+  std::function<std::any(BlobReader &)>             read;
+  std::function<void(void *)>                       collect;
+};
+
+template <typename T> static PortDataOps helper_make_ops()
+{
+  // NB - heightmap copies share their tiles (copy-on-write): storing an
+  // heightmap in the cache is cheap, but the next computation of the node
+  // writing its outputs detaches (duplicates) every shared tile, the previous
+  // ones being retired until 'collect' is called
+  return PortDataOps{
+      [](const void *p) { return helper_hash_data(*static_cast<const T *>(p), 0); },
+      [](const void *p) { return helper_data_bytes(*static_cast<const T *>(p)); },
+      [](const void *p) { return std::any(*static_cast<const T *>(p)); },
+      [](const std::any &a, void *p)
+      { *static_cast<T *>(p) = std::any_cast<const T &>(a); },
+      [](const std::any &a, std::string &buf)
+      { helper_write_data(buf, std::any_cast<const T &>(a)); },
+      [](BlobReader &reader)
+      {
+        T v;
+        helper_read_data(reader, v);
+        return std::any(std::move(v));
+      },
+      [](void *p) { helper_collect_data(*static_cast<T *>(p)); }};
+}
+
+static const PortDataOps *helper_get_ops(const std::string &typeid_name)
+{
+  static const std::unordered_map<std::string, PortDataOps> ops_map = {
+      {typeid(hmap::Array).name(), helper_make_ops<hmap::Array>()},
+      {typeid(hmap::Cloud).name(), helper_make_ops<hmap::Cloud>()},
+      {typeid(hmap::Heightmap).name(), helper_make_ops<hmap::Heightmap>()},
+      {typeid(hmap::HeightmapRGBA).name(), helper_make_ops<hmap::HeightmapRGBA>()},
+      {typeid(hmap::Path).name(), helper_make_ops<hmap::Path>()},
+      {typeid(std::vector<float>).name(), helper_make_ops<std::vector<float>>()},
+      {typeid(std::vector<hmap::Heightmap>).name(),
+       helper_make_ops<std::vector<hmap::Heightmap>>()}};
+
+  auto it = ops_map.find(typeid_name);
+  return (it != ops_map.end()) ? &it->second : nullptr;
+}
+
+// file layout: magic, version, build stamp, number of ports and, for each
+// output port, its data type, content hash and data
+#define HSD_DISK_CACHE_MAGIC 0x43445348u // "HSDC"
+#define HSD_DISK_CACHE_VERSION 2u
+
+// the memo keys do not depend on the node implementations, the outputs
+// cached by another version of the application must not be reused
+static const std::string &helper_build_stamp()
+{
+  static const std::string stamp = std::to_string(HESIOD_VERSION_MAJOR) + "." +
+                                   std::to_string(HESIOD_VERSION_MINOR) + "." +
+                                   std::to_string(HESIOD_VERSION_PATCH) + "+" +
+                                   HESIOD_BUILD_ID;
+  return stamp;
+}
+
+// HESIOD_BUILD_ID (generated at build time) is empty when the sources are not
+// a git checkout and ends with '-dirty' with uncommitted changes: the builds
+// cannot be told apart and the disk tier is off
+static bool helper_has_build_id()
+{
+  const std::string id = HESIOD_BUILD_ID;
+  return !id.empty() && !id.ends_with("-dirty");
+}
+
+static std::string helper_serialize_entry(const BaseNode                &node,
+                                          const NodeOutputCache::Entry &entry)
+{
+  std::string buf;
+  helper_write_pod(buf, static_cast<uint32_t>(HSD_DISK_CACHE_MAGIC));
+  helper_write_pod(buf, static_cast<uint32_t>(HSD_DISK_CACHE_VERSION));
+  helper_write_pod(buf, static_cast<uint32_t>(helper_build_stamp().size()));
+  buf.append(helper_build_stamp());
+  helper_write_pod(buf, static_cast<uint32_t>(node.get_nports()));
+
+  for (int k = 0; k < node.get_nports(); k++)
+  {
+    if (node.get_port_type(k) != gngui::PortType::OUT)
+      continue;
+
+    const std::string  type = map_type_name(node.get_data_type(k));
+    const PortDataOps *p_ops = helper_get_ops(node.get_data_type(k));
+
+    helper_write_pod(buf, static_cast<uint32_t>(type.size()));
+    buf.append(type);
+    helper_write_pod(buf, entry.hashes[k]);
+    p_ops->write(entry.values[k], buf);
+  }
+
+  return buf;
+}
+
+static bool helper_deserialize_entry(const BaseNode         &node,
+                                     const std::string      &buf,
+                                     NodeOutputCache::Entry &entry)
+{
+  try
+  {
+    BlobReader reader{buf.data(), buf.data() + buf.size()};
+
+    if (reader.read<uint32_t>() != HSD_DISK_CACHE_MAGIC ||
+        reader.read<uint32_t>() != HSD_DISK_CACHE_VERSION)
+      return false;
+
+    // written by another build
+    uint32_t stamp_size = reader.read<uint32_t>();
+    if (stamp_size != helper_build_stamp().size())
+      return false;
+
+    std::string stamp(stamp_size, '\0');
+    reader.read_bytes(stamp.data(), stamp.size());
+
+    if (stamp != helper_build_stamp() ||
+        reader.read<uint32_t>() != static_cast<uint32_t>(node.get_nports()))
+      return false;
+
+    entry.values.assign(node.get_nports(), std::any());
+    entry.hashes.assign(node.get_nports(), 0);
+    entry.size_bytes = buf.size();
+
+    for (int k = 0; k < node.get_nports(); k++)
+    {
+      if (node.get_port_type(k) != gngui::PortType::OUT)
+        continue;
+
+      const PortDataOps *p_ops = helper_get_ops(node.get_data_type(k));
+
+      uint32_t type_size = reader.read<uint32_t>();
+      if (type_size > static_cast<uint32_t>(reader.end - reader.p))
+        return false;
+
+      std::string type(type_size, '\0');
+      reader.read_bytes(type.data(), type.size());
+
+      if (!p_ops || type != map_type_name(node.get_data_type(k)))
+        return false;
+
+      entry.hashes[k] = reader.read<uint64_t>();
+      entry.values[k] = p_ops->read(reader);
+    }
+
+    return reader.p == reader.end;
+  }
+  catch (const std::exception &e)
+  {
+    Logger::log()->warn("helper_deserialize_entry: node {}, {}", node.get_id(), e.what());
+    return false;
+  }
+}
+
+// --- class definition
+
+uint64_t BaseNode::compute_memo_key() const
+{
+  const gnode::Graph *p_graph = this->get_p_graph();
+  if (!p_graph)
+    return 0;
+
+  // node type, parameters and data configuration
+  std::string str = this->get_label();
+
+  for (const auto &[key, attr] : this->attr)
+    str += key + attr->json_to().dump();
+
+  str += this->get_config_ref()->json_to().dump();
+  str += this->vulkan_enabled_ ? "1" : "0";
+
+  uint64_t h = helper_hash_bytes(str.data(), str.size(), 0);
+
+  // input data, identified by the hashes of the upstream outputs
+  std::vector<uint64_t> input_hashes(this->get_nports(), 0);
+
+  for (auto &link : p_graph->get_links())
+    if (link.to == this->get_id())
+    {
+      auto *p_up = p_graph->get_node_ref_by_id<BaseNode>(link.from);
+
+      uint64_t hu = p_up ? p_up->get_output_hash(link.port_from) : 0;
+      if (hu == 0)
+        return 0; // upstream content unknown
+
+      input_hashes[link.port_to] = hu;
+    }
+
+  h = helper_hash_bytes(input_hashes.data(), input_hashes.size() * sizeof(uint64_t), h);
+
+  return h ? h : 1;
+}
+
+void BaseNode::collect_outputs()
+{
+  for (int k = 0; k < this->get_nports(); k++)
+    if (this->get_port_type(k) == gngui::PortType::OUT)
+    {
+      const PortDataOps *p_ops = helper_get_ops(this->get_data_type(k));
+      void              *ptr = this->get_value_ref_void(k);
+
+      if (p_ops && ptr)
+        p_ops->collect(ptr);
+    }
+}
+
+bool BaseNode::copy_outputs_from(const BaseNode &source)
+{
+  if (source.get_nports() != this->get_nports())
+    return false;
+
+  for (int k = 0; k < this->get_nports(); k++)
+    if (this->get_port_type(k) == gngui::PortType::OUT)
+    {
+      const PortDataOps *p_ops = helper_get_ops(this->get_data_type(k));
+      void              *ptr = this->get_value_ref_void(k);
+      void              *ptr_source = source.get_value_ref_void(k);
+
+      if (!p_ops || !ptr || !ptr_source ||
+          source.get_data_type(k) != this->get_data_type(k))
+        return false;
+
+      p_ops->restore(p_ops->copy(ptr_source), ptr);
+    }
+
+  this->output_hashes_ = source.output_hashes_;
+  this->memo_key_ = source.memo_key_.load();
+  this->is_dirty = false;
+  return true;
+}
+
+uint64_t BaseNode::get_output_hash(int port_index) const
+{
+  if (port_index < 0 || port_index >= static_cast<int>(this->output_hashes_.size()))
+    return 0;
+
+  return this->output_hashes_[port_index];
+}
+
+void BaseNode::hash_outputs()
+{
+  this->output_hashes_.assign(this->get_nports(), 0);
+
+  if (!this->memoization_enabled_ ||
+      !HSD_CTX.app_settings.performance.enable_incremental_evaluation)
+    return;
+
+  for (int k = 0; k < this->get_nports(); k++)
+    if (this->get_port_type(k) == gngui::PortType::OUT)
+    {
+      const PortDataOps *p_ops = helper_get_ops(this->get_data_type(k));
+      void              *ptr = this->get_value_ref_void(k);
+
+      if (p_ops && ptr)
+      {
+        uint64_t h = p_ops->hash(ptr);
+        this->output_hashes_[k] = h ? h : 1;
+      }
+    }
+}
+
+void BaseNode::invalidate_memo()
+{
+  this->memo_key_ = 0;
+  this->output_hashes_.clear();
+}
+
+bool BaseNode::is_memoizable() const
+{
+  if (!this->memoization_enabled_ ||
+      !HSD_CTX.app_settings.performance.enable_incremental_evaluation)
+    return false;
+
+  // files, broadcast routing and debug nodes have side effects or depend on
+  // data which are not carried by their inputs
+  const std::string &c = this->category;
+  return !(c.starts_with("IO") || c.starts_with("Routing") || c.starts_with("Debug"));
+}
+
+bool BaseNode::restore_outputs(uint64_t key)
+{
+  NodeOutputCache       &cache = NodeOutputCache::instance();
+  NodeOutputCache::Entry entry;
+
+  if (!cache.retrieve(key, entry))
+  {
+    // persistent tier, the entry is then kept in memory as well
+    std::string blob;
+
+    if (!helper_has_build_id() || !cache.read_from_disk(key, blob) ||
+        !helper_deserialize_entry(*this, blob, entry))
+      return false;
+
+    Logger::log()->trace("BaseNode::restore_outputs: node {}({}) restored from disk",
+                         this->get_label(),
+                         this->get_id());
+
+    cache.store(key, entry);
+  }
+
+  if (entry.values.size() != static_cast<size_t>(this->get_nports()))
+    return false;
+
+  for (int k = 0; k < this->get_nports(); k++)
+    if (this->get_port_type(k) == gngui::PortType::OUT)
+    {
+      const PortDataOps *p_ops = helper_get_ops(this->get_data_type(k));
+      void              *ptr = this->get_value_ref_void(k);
+
+      if (!p_ops || !ptr || !entry.values[k].has_value())
+        return false;
+
+      p_ops->restore(entry.values[k], ptr);
+    }
+
+  this->output_hashes_ = entry.hashes;
+  return true;
+}
+
+void BaseNode::set_memoization_enabled(bool enabled)
+{
+  this->memoization_enabled_ = enabled;
+  if (!enabled)
+    this->invalidate_memo();
+}
+
+void BaseNode::store_outputs_on_disk()
+{
+  // called from the GUI thread while the graph may be computed: the live
+  // outputs are not read, the entry of the output cache is an immutable
+  // snapshot of them (stored by the computing thread once they are final)
+  const uint64_t key = this->memo_key_.load();
+  if (!key || !helper_has_build_id())
+    return;
+
+  NodeOutputCache &cache = NodeOutputCache::instance();
+  if (cache.get_disk_cache_dir().empty() || cache.has_on_disk(key))
+    return;
+
+  // outputs evicted from the memory tier are not persisted
+  NodeOutputCache::Entry entry;
+  if (!cache.peek(key, entry))
+    return;
+
+  if (entry.hashes.size() != entry.values.size() ||
+      entry.values.size() != static_cast<size_t>(this->get_nports()))
+    return;
+
+  for (int k = 0; k < this->get_nports(); k++)
+    if (this->get_port_type(k) == gngui::PortType::OUT &&
+        (!helper_get_ops(this->get_data_type(k)) || !entry.values[k].has_value() ||
+         !entry.hashes[k]))
+      return;
+
+  cache.write_to_disk(key, helper_serialize_entry(*this, entry));
+}
+
+void BaseNode::store_outputs(uint64_t key)
+{
+  NodeOutputCache::Entry entry;
+  entry.values.resize(this->get_nports());
+  entry.hashes = this->output_hashes_;
+
+  for (int k = 0; k < this->get_nports(); k++)
+    if (this->get_port_type(k) == gngui::PortType::OUT)
+    {
+      const PortDataOps *p_ops = helper_get_ops(this->get_data_type(k));
+      void              *ptr = this->get_value_ref_void(k);
+
+      // data type not handled, the outputs cannot be restored
+      if (!p_ops || !ptr)
+        return;
+
+      entry.values[k] = p_ops->copy(ptr);
+      entry.size_bytes += p_ops->bytes(ptr);
+    }
+
+  NodeOutputCache::instance().store(key, std::move(entry));
+}
+
+bool BaseNode::was_reused() const { return this->reused_; }
+
+} // namespace hesiod
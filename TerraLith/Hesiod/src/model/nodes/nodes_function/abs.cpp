@@ -44,11 +44,13 @@ void compute_abs_node(BaseNode &node)
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
     hmap::transform(
-        {p_out, p_in},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = hmap::abs(*pa_in - node.get_attr<FloatAttribute>("vshift"));
         },
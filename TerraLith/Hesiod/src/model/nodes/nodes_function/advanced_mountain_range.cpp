@@ -88,15 +88,16 @@ void compute_advanced_mountain_range_node(BaseNode &node)
 
   // Use ridged noise as a base, then compose with a spine envelope
   hmap::transform(
-      {p_out, p_dx, p_dy},
-      [&node, ridge_sharpness, spine_kw, spine_amp](
-          std::vector<hmap::Array *> p_arrays,
-          hmap::Vec2<int>            shape,
-          hmap::Vec4<float>          bbox)
+      {p_out},
+      {p_dx, p_dy},
+      [&node, ridge_sharpness, spine_kw, spine_amp](std::vector<hmap::Array *>       p_arrays_out,
+                                                    std::vector<const hmap::Array *> p_arrays_in,
+                                                    hmap::Vec2<int>                  shape,
+                                                    hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_dx = p_arrays[1];
-        hmap::Array *pa_dy = p_arrays[2];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_dx = p_arrays_in[0];
+        const hmap::Array *pa_dy = p_arrays_in[1];
 
         // Ridged noise base layer
         *pa_out = hmap::gpu::noise_fbm(
@@ -77,15 +77,16 @@ void compute_alpine_peaks_node(BaseNode &node)
   float cirque_depth = node.get_attr<FloatAttribute>("cirque_depth");
 
   hmap::transform(
-      {p_out, p_dx, p_dy},
-      [&node, peak_sharp, ridge_pers, arete_str, cirque_depth](
-          std::vector<hmap::Array *> p_arrays,
-          hmap::Vec2<int>            shape,
-          hmap::Vec4<float>          bbox)
+      {p_out},
+      {p_dx, p_dy},
+      [&node, peak_sharp, ridge_pers, arete_str, cirque_depth](std::vector<hmap::Array *>       p_arrays_out,
+                                                               std::vector<const hmap::Array *> p_arrays_in,
+                                                               hmap::Vec2<int>                  shape,
+                                                               hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_dx = p_arrays[1];
-        hmap::Array *pa_dy = p_arrays[2];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_dx = p_arrays_in[0];
+        const hmap::Array *pa_dy = p_arrays_in[1];
 
         // Base ridged noise for mountain structure
         *pa_out = hmap::gpu::noise_fbm(
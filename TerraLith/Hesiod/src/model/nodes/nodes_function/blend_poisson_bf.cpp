@@ -46,13 +46,15 @@ void compute_blend_poisson_bf_node(BaseNode &node)
     hmap::Heightmap *p_mask = node.get_value_ref<hmap::Heightmap>("mask");
 
     hmap::transform(
-        {p_out, p_in1, p_in2, p_mask},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in1, p_in2, p_mask},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in1 = p_arrays[1];
-          hmap::Array *pa_in2 = p_arrays[2];
-          hmap::Array *pa_mask = p_arrays[3];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in1 = p_arrays_in[0];
+          const hmap::Array *pa_in2 = p_arrays_in[1];
+          const hmap::Array *pa_mask = p_arrays_in[2];
 
           *pa_out = hmap::gpu::blend_poisson_bf(*pa_in1,
                                                 *pa_in2,
@@ -36,7 +36,7 @@ void compute_broadcast_node(BaseNode &node)
   if (p_in)
   {
     hmap::Heightmap *p_thru = node.get_value_ref<hmap::Heightmap>("thru");
-    *p_thru = *p_in;
+    *p_thru = *p_in; // tiles are shared (copy-on-write), no data copy
 
     BroadcastNode *p_broadcast_node = dynamic_cast<BroadcastNode *>(&node);
 
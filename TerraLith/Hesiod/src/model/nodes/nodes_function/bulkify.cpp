@@ -57,15 +57,17 @@ void compute_bulkify_node(BaseNode &node)
     hmap::Heightmap *p_dy = node.get_value_ref<hmap::Heightmap>("dy");
 
     hmap::transform(
-        {p_out, p_in, p_dx, p_dy},
-        [&node](std::vector<hmap::Array *> p_arrays,
+        {p_out},
+        {p_in, p_dx, p_dy},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in,
                 hmap::Vec2<int> /* shape */,
-                hmap::Vec4<float> bbox)
+                hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
-          hmap::Array *pa_dx = p_arrays[2];
-          hmap::Array *pa_dy = p_arrays[3];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
+          const hmap::Array *pa_dx = p_arrays_in[1];
+          const hmap::Array *pa_dy = p_arrays_in[2];
 
           *pa_out = hmap::bulkify(
               *pa_in,
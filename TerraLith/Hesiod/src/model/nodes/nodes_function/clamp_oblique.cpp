@@ -57,13 +57,15 @@ void compute_clamp_oblique_node(BaseNode &node)
   {
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
-    hmap::transform({p_out, p_in},
-                    [&node](std::vector<hmap::Array *> p_arrays,
+    hmap::transform({p_out},
+    {p_in},
+                    [&node](std::vector<hmap::Array *>       p_arrays_out,
+                            std::vector<const hmap::Array *> p_arrays_in,
                             hmap::Vec2<int> /* shape */,
-                            hmap::Vec4<float> bbox)
+                            hmap::Vec4<float>                bbox)
                     {
-                      hmap::Array *pa_out = p_arrays[0];
-                      hmap::Array *pa_in = p_arrays[1];
+                      hmap::Array       *pa_out = p_arrays_out[0];
+                      const hmap::Array *pa_in = p_arrays_in[0];
 
                       *pa_out = *pa_in;
 
@@ -54,14 +54,16 @@ void compute_coastal_erosion_diffusion_node(BaseNode &node)
                                              : hmap::TransformMode::SINGLE_ARRAY;
 
     hmap::transform(
-        {p_depth, p_z, p_depth_out, p_z_out, p_mask},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_depth_out, p_z_out, p_mask},
+        {p_depth, p_z},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_depth = p_arrays[0];
-          hmap::Array *pa_z = p_arrays[1];
-          hmap::Array *pa_depth_out = p_arrays[2];
-          hmap::Array *pa_z_out = p_arrays[3];
-          hmap::Array *pa_mask = p_arrays[4];
+          const hmap::Array *pa_depth = p_arrays_in[0];
+          const hmap::Array *pa_z = p_arrays_in[1];
+          hmap::Array       *pa_depth_out = p_arrays_out[0];
+          hmap::Array       *pa_z_out = p_arrays_out[1];
+          hmap::Array       *pa_mask = p_arrays_out[2];
 
           *pa_z_out = *pa_z;
           *pa_depth_out = *pa_depth;
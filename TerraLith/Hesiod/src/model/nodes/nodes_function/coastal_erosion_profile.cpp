@@ -92,15 +92,17 @@ void compute_coastal_erosion_profile_node(BaseNode &node)
                     float(p_z_out->shape.x);
 
     hmap::transform(
-        {p_z, p_depth, p_mask, p_z_out, p_depth_out, p_shore_mask},
-        [&node, ir_ground, ir_water, slope_n](std::vector<hmap::Array *> p_arrays)
+        {p_z_out, p_depth_out, p_shore_mask},
+        {p_z, p_depth, p_mask},
+        [&node, ir_ground, ir_water, slope_n](std::vector<hmap::Array *>       p_arrays_out,
+                                              std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_z = p_arrays[0];
-          hmap::Array *pa_depth = p_arrays[1];
-          hmap::Array *pa_mask = p_arrays[2];
-          hmap::Array *pa_z_out = p_arrays[3];
-          hmap::Array *pa_depth_out = p_arrays[4];
-          hmap::Array *pa_shore_mask = p_arrays[5];
+          const hmap::Array *pa_z = p_arrays_in[0];
+          const hmap::Array *pa_depth = p_arrays_in[1];
+          const hmap::Array *pa_mask = p_arrays_in[2];
+          hmap::Array       *pa_z_out = p_arrays_out[0];
+          hmap::Array       *pa_depth_out = p_arrays_out[1];
+          hmap::Array       *pa_shore_mask = p_arrays_out[2];
 
           *pa_z_out = *pa_z;
           *pa_depth_out = *pa_depth;
@@ -42,12 +42,14 @@ void compute_combiner_min_node(BaseNode &node)
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
     hmap::transform(
-        {p_out, p_in1, p_in2},
-        [](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in1, p_in2},
+        [](std::vector<hmap::Array *>       p_arrays_out,
+           std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in1 = p_arrays[1];
-          hmap::Array *pa_in2 = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in1 = p_arrays_in[0];
+          const hmap::Array *pa_in2 = p_arrays_in[1];
           *pa_out = hmap::minimum(*pa_in1, *pa_in2);
         },
         node.get_config_ref()->hmap_transform_mode_cpu);
@@ -54,14 +54,16 @@ void compute_cone_node(BaseNode &node)
   hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
   hmap::transform(
-      {p_out, p_dx, p_dy},
-      [&node](std::vector<hmap::Array *> p_arrays,
-              hmap::Vec2<int>            shape,
-              hmap::Vec4<float>          bbox)
+      {p_out},
+      {p_dx, p_dy},
+      [&node](std::vector<hmap::Array *>       p_arrays_out,
+              std::vector<const hmap::Array *> p_arrays_in,
+              hmap::Vec2<int>                  shape,
+              hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_dx = p_arrays[1];
-        hmap::Array *pa_dy = p_arrays[2];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_dx = p_arrays_in[0];
+        const hmap::Array *pa_dy = p_arrays_in[1];
 
         *pa_out = hmap::cone(shape,
                              node.get_attr<FloatAttribute>("slope"),
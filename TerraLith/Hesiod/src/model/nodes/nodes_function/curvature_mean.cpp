@@ -49,11 +49,13 @@ void compute_curvature_mean_node(BaseNode &node)
     int nx = p_out->shape.x; // for gradient scaling
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, nx](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node, nx](std::vector<hmap::Array *>       p_arrays_out,
+                    std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           // compute mean curvature and scale it
           *pa_out = hmap::curvature_mean(*pa_in) * nx;
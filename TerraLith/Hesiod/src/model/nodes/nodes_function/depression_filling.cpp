@@ -24,12 +24,15 @@ void setup_depression_filling_node(BaseNode &node)
   node.add_port<hmap::Heightmap>(gnode::PortType::OUT, "fill map", CONFIG(node));
 
   // attribute(s)
-  node.add_attr<IntAttribute>("iterations", "iterations", 1000, 1, INT_MAX);
   node.add_attr<FloatAttribute>("epsilon", "epsilon", 1e-4, 1e-5, 1e-1, "{:.3e}", true);
   node.add_attr<BoolAttribute>("remap fill map", "remap fill map", true);
 
+  // deprecated, ignored (priority-flood is not iterative), kept for the
+  // projects saved with it
+  node.add_attr<IntAttribute>("iterations", "iterations (deprecated)", 1000, 1, INT_MAX);
+
   // attribute(s) order
-  node.set_attr_ordered_key({"iterations", "epsilon", "remap fill map"});
+  node.set_attr_ordered_key({"epsilon", "remap fill map", "_SEPARATOR_", "iterations"});
 }
 
 void compute_depression_filling_node(BaseNode &node)
@@ -47,17 +50,17 @@ void compute_depression_filling_node(BaseNode &node)
                                (float)p_in->shape.x;
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, epsilon_normalized](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [epsilon_normalized](std::vector<hmap::Array *>       p_arrays_out,
+                             std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = *pa_in;
 
-          hmap::depression_filling(*pa_out,
-                                   node.get_attr<IntAttribute>("iterations"),
-                                   epsilon_normalized);
+          hmap::depression_filling(*pa_out, epsilon_normalized);
         },
         hmap::TransformMode::SINGLE_ARRAY); // forced, not tileable
 
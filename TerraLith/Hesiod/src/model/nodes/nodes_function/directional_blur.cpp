@@ -51,12 +51,14 @@ void compute_directional_blur_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_in, p_angle},
-        [&node, ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in, p_angle},
+        [&node, ir](std::vector<hmap::Array *>       p_arrays_out,
+                    std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
-          hmap::Array *pa_angle = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
+          const hmap::Array *pa_angle = p_arrays_in[1];
 
           hmap::Array angle_deg(pa_in->shape, node.get_attr<FloatAttribute>("angle"));
           if (pa_angle)
@@ -46,11 +46,13 @@ void compute_erosion_node(BaseNode &node)
     if (node.get_attr<BoolAttribute>("GPU"))
     {
       hmap::transform(
-          {p_out, p_in},
-          [&ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&ir](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::gpu::erosion(*pa_in, ir);
           },
@@ -59,11 +61,13 @@ void compute_erosion_node(BaseNode &node)
     else
     {
       hmap::transform(
-          {p_out, p_in},
-          [&ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&ir](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::erosion(*pa_in, ir);
           },
@@ -91,11 +91,13 @@ void compute_expand_shrink_node(BaseNode &node)
     if (node.get_attr<BoolAttribute>("shrink"))
     {
       hmap::transform(
-          {p_out, p_mask},
-          [&node, &kernel_array](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_mask},
+          [&node, &kernel_array](std::vector<hmap::Array *>       p_arrays_out,
+                                 std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_mask = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_mask = p_arrays_in[0];
             hmap::gpu::shrink(*pa_out,
                               kernel_array,
                               pa_mask,
@@ -106,11 +108,13 @@ void compute_expand_shrink_node(BaseNode &node)
     else
     {
       hmap::transform(
-          {p_out, p_mask},
-          [&node, &kernel_array](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_mask},
+          [&node, &kernel_array](std::vector<hmap::Array *>       p_arrays_out,
+                                 std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_mask = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_mask = p_arrays_in[0];
             hmap::gpu::expand(*pa_out,
                               kernel_array,
                               pa_mask,
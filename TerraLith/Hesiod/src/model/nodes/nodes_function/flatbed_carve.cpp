@@ -90,15 +90,17 @@ void compute_flatbed_carve_node(BaseNode &node)
       float falloff = width * node.get_attr<FloatAttribute>("falloff_distance_ratio");
 
       hmap::transform(
-          {p_out, p_in, p_dr, p_mask},
-          [&node, width, falloff, p_path](std::vector<hmap::Array *> p_arrays,
+          {p_out, p_mask},
+          {p_in, p_dr},
+          [&node, width, falloff, p_path](std::vector<hmap::Array *>       p_arrays_out,
+                                          std::vector<const hmap::Array *> p_arrays_in,
                                           hmap::Vec2<int> /* shape */,
-                                          hmap::Vec4<float> bbox)
+                                          hmap::Vec4<float>                bbox)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
-            hmap::Array *pa_dr = p_arrays[2];
-            hmap::Array *pa_mask = p_arrays[3];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
+            const hmap::Array *pa_dr = p_arrays_in[1];
+            hmap::Array       *pa_mask = p_arrays_out[1];
 
             *pa_out = *pa_in;
 
@@ -45,11 +45,13 @@ void compute_flooding_from_boundaries_node(BaseNode &node)
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("water_depth");
 
     hmap::transform(
-        {p_out, p_in},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = hmap::flooding_from_boundaries(
               *pa_in,
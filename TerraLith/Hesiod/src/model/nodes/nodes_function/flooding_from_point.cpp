@@ -42,13 +42,15 @@ void compute_flooding_from_point_node(BaseNode &node)
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("water_depth");
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, p_cloud](std::vector<hmap::Array *> p_arrays,
-                         hmap::Vec2<int>            shape,
-                         hmap::Vec4<float>          bbox)
+        {p_out},
+        {p_in},
+        [&node, p_cloud](std::vector<hmap::Array *>       p_arrays_out,
+                         std::vector<const hmap::Array *> p_arrays_in,
+                         hmap::Vec2<int>                  shape,
+                         hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           // convert point positions to cell indices
           std::vector<int> i, j;
@@ -23,19 +23,24 @@ void setup_flooding_lake_system_node(BaseNode &node)
   node.add_port<hmap::Heightmap>(gnode::PortType::OUT, "water_depth", CONFIG(node));
 
   // attribute(s)
-  node.add_attr<IntAttribute>("iterations", "iterations", 1000, 1, INT_MAX);
   node.add_attr<FloatAttribute>("epsilon", "epsilon", 1e-1, 1e-5, 1e-1, "{:.3e}", true);
   node.add_attr<FloatAttribute>("mininal_radius", "mininal_radius", 0.05f, 0.f, 0.5f);
 
+  // deprecated, ignored (priority-flood is not iterative), kept for the
+  // projects saved with it
+  node.add_attr<IntAttribute>("iterations", "iterations (deprecated)", 1000, 1, INT_MAX);
+
   // attribute(s) order
   node.set_attr_ordered_key({"_GROUPBOX_BEGIN_Main Parameters",
-                             "iterations",
                              "epsilon",
                              "_GROUPBOX_END_",
                              //
                              "_GROUPBOX_BEGIN_Exclusion filter",
                              "mininal_radius",
-                             "_GROUPBOX_END_"});
+                             "_GROUPBOX_END_",
+                             //
+                             "_SEPARATOR_",
+                             "iterations"});
 }
 
 void compute_flooding_lake_system_node(BaseNode &node)
@@ -54,15 +59,15 @@ void compute_flooding_lake_system_node(BaseNode &node)
     float surface_threshold = M_PI * ir * ir;
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, epsilon_normalized, surface_threshold](
-            std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [epsilon_normalized, surface_threshold](std::vector<hmap::Array *>       p_arrays_out,
+                                                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = hmap::flooding_lake_system(*pa_in,
-                                               node.get_attr<IntAttribute>("iterations"),
                                                epsilon_normalized,
                                                surface_threshold);
         },
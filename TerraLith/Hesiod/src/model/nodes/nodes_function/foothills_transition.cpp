@@ -71,16 +71,17 @@ void compute_foothills_transition_node(BaseNode &node)
   float gamma = node.get_attr<FloatAttribute>("gamma");
 
   hmap::transform(
-      {p_out, p_mountains, p_plains, p_blend},
-      [seed, transition_w, foothill_scale, roughness_decay, octaves, noise_amp, gamma](
-          std::vector<hmap::Array *> p_arrays,
-          hmap::Vec2<int>            shape,
-          hmap::Vec4<float>          bbox)
+      {p_out},
+      {p_mountains, p_plains, p_blend},
+      [seed, transition_w, foothill_scale, roughness_decay, octaves, noise_amp, gamma](std::vector<hmap::Array *>       p_arrays_out,
+                                                                                       std::vector<const hmap::Array *> p_arrays_in,
+                                                                                       hmap::Vec2<int>                  shape,
+                                                                                       hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_mtn = p_arrays[1];
-        hmap::Array *pa_plain = p_arrays[2];
-        hmap::Array *pa_blend = p_arrays[3];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_mtn = p_arrays_in[0];
+        const hmap::Array *pa_plain = p_arrays_in[1];
+        const hmap::Array *pa_blend = p_arrays_in[2];
 
         // Generate blend factor if no mask is provided (based on mountain elevation)
         hmap::Array blend(shape);
@@ -52,11 +52,13 @@ void compute_gain_node(BaseNode &node)
     p_out->remap(0.f, 1.f, hmin, hmax);
 
     hmap::transform(
-        {p_out, p_mask},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_mask},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
 
           hmap::gain(*pa_out, node.get_attr<FloatAttribute>("gain"), pa_mask);
         },
@@ -56,11 +56,13 @@ void compute_gamma_correction_local_node(BaseNode &node)
     if (node.get_attr<BoolAttribute>("GPU"))
     {
       hmap::transform(
-          {p_out, p_mask},
-          [&node, &ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_mask},
+          [&node, &ir](std::vector<hmap::Array *>       p_arrays_out,
+                       std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_mask = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_mask = p_arrays_in[0];
 
             hmap::gpu::gamma_correction_local(*pa_out,
                                               node.get_attr<FloatAttribute>("gamma"),
@@ -73,11 +75,13 @@ void compute_gamma_correction_local_node(BaseNode &node)
     else
     {
       hmap::transform(
-          {p_out, p_mask},
-          [&node, &ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_mask},
+          [&node, &ir](std::vector<hmap::Array *>       p_arrays_out,
+                       std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_mask = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_mask = p_arrays_in[0];
 
             hmap::gamma_correction_local(*pa_out,
                                          node.get_attr<FloatAttribute>("gamma"),
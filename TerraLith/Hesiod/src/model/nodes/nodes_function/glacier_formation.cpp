@@ -80,15 +80,16 @@ void compute_glacier_formation_node(BaseNode &node)
 
   // Simulate glacier formation per tile
   hmap::transform(
-      {p_out, p_mask, p_ice},
-      [snow_line, accum_rate, viscosity, iterations, carve_depth, moraine_h, u_power](
-          std::vector<hmap::Array *> p_arrays,
-          hmap::Vec2<int>            shape,
-          hmap::Vec4<float> /* bbox */)
+      {p_out, p_ice},
+      {p_mask},
+      [snow_line, accum_rate, viscosity, iterations, carve_depth, moraine_h, u_power](std::vector<hmap::Array *>       p_arrays_out,
+                                                                                      std::vector<const hmap::Array *> p_arrays_in,
+                                                                                      hmap::Vec2<int>                  shape,
+                                                                                      hmap::Vec4<float> /* bbox */)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_mask = p_arrays[1];
-        hmap::Array *pa_ice = p_arrays[2];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_mask = p_arrays_in[0];
+        hmap::Array       *pa_ice = p_arrays_out[1];
 
         float hmin = pa_out->min();
         float hmax = pa_out->max();
@@ -40,22 +40,26 @@ void compute_gradient_node(BaseNode &node)
     hmap::Heightmap *p_dy = node.get_value_ref<hmap::Heightmap>("dy");
 
     hmap::transform(
-        {p_dx, p_in},
-        [](std::vector<hmap::Array *> p_arrays)
+        {p_dx},
+        {p_in},
+        [](std::vector<hmap::Array *>       p_arrays_out,
+           std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_dx = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_dx = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           hmap::gradient_x(*pa_in, *pa_dx);
         },
         node.get_config_ref()->hmap_transform_mode_cpu);
 
     hmap::transform(
-        {p_dy, p_in},
-        [](std::vector<hmap::Array *> p_arrays)
+        {p_dy},
+        {p_in},
+        [](std::vector<hmap::Array *>       p_arrays_out,
+           std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_dy = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_dy = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           hmap::gradient_y(*pa_in, *pa_dy);
         },
@@ -1,6 +1,9 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <atomic>
+#include <chrono>
+
 #include "highmap/erosion.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/math.hpp"
@@ -46,6 +49,8 @@ void setup_hydraulic_particle_node(BaseNode &node)
   node.add_attr<BoolAttribute>("deposition_only", "deposition_only", false);
   node.add_attr<BoolAttribute>("downscale", "downscale", false);
   node.add_attr<FloatAttribute>("kc", "kc", 512.f, 0.f, FLT_MAX);
+  node.add_attr<BoolAttribute>("GPU", "GPU", HSD_DEFAULT_GPU_MODE);
+  node.add_attr<IntAttribute>("nthreads", "nthreads", 0, 0, 64);
 
   // attribute(s) order
   node.set_attr_ordered_key({"seed",
@@ -61,7 +66,10 @@ void setup_hydraulic_particle_node(BaseNode &node)
                              "deposition_only",
                              "_SEPARATOR_",
                              "downscale",
-                             "kc"});
+                             "kc",
+                             "_SEPARATOR_",
+                             "GPU",
+                             "nthreads"});
 }
 
 void compute_hydraulic_particle_node(BaseNode &node)
@@ -92,36 +100,83 @@ void compute_hydraulic_particle_node(BaseNode &node)
     int nparticles = (int)(node.get_attr<FloatAttribute>("particle_density") *
                            p_out->shape.x * p_out->shape.y);
 
+    // erosion of a single array, on the GPU or on the CPU with the requested
+    // thread budget (the CPU result does not depend on it)
+    std::atomic<size_t> nparticles_total = 0;
+
+    auto erode = [&node, &nparticles_total](hmap::Array       &z,
+                                            const hmap::Array *pa_mask,
+                                            int                nparticles,
+                                            const hmap::Array *pa_bedrock,
+                                            const hmap::Array *pa_moisture_map,
+                                            hmap::Array       *pa_erosion_map,
+                                            hmap::Array       *pa_deposition_map)
+    {
+      if (node.get_attr<BoolAttribute>("GPU"))
+        hmap::gpu::hydraulic_particle(z,
+                                      pa_mask,
+                                      nparticles,
+                                      node.get_attr<SeedAttribute>("seed"),
+                                      pa_bedrock,
+                                      pa_moisture_map,
+                                      pa_erosion_map,
+                                      pa_deposition_map,
+                                      node.get_attr<FloatAttribute>("c_capacity"),
+                                      node.get_attr<FloatAttribute>("c_erosion"),
+                                      node.get_attr<FloatAttribute>("c_deposition"),
+                                      node.get_attr<FloatAttribute>("c_inertia"),
+                                      node.get_attr<FloatAttribute>("drag_rate"),
+                                      node.get_attr<FloatAttribute>("evap_rate"),
+                                      node.get_attr<BoolAttribute>("post_filtering"));
+      else
+        hmap::hydraulic_particle(z,
+                                 pa_mask,
+                                 nparticles,
+                                 node.get_attr<SeedAttribute>("seed"),
+                                 pa_bedrock,
+                                 pa_moisture_map,
+                                 pa_erosion_map,
+                                 pa_deposition_map,
+                                 node.get_attr<FloatAttribute>("c_capacity"),
+                                 node.get_attr<FloatAttribute>("c_erosion"),
+                                 node.get_attr<FloatAttribute>("c_deposition"),
+                                 node.get_attr<FloatAttribute>("c_inertia"),
+                                 node.get_attr<FloatAttribute>("drag_rate"),
+                                 node.get_attr<FloatAttribute>("evap_rate"),
+                                 node.get_attr<BoolAttribute>("post_filtering"),
+                                 node.get_attr<IntAttribute>("nthreads"));
+
+      nparticles_total += (size_t)nparticles;
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+
     if (!node.get_attr<BoolAttribute>("downscale"))
     {
       hmap::transform(
-          {p_out, p_bedrock, p_moisture_map, p_mask, p_erosion_map, p_deposition_map},
-          [&node, &nparticles](std::vector<hmap::Array *> p_arrays)
+          {p_out, p_erosion_map, p_deposition_map},
+          {p_bedrock, p_moisture_map, p_mask},
+          [&erode, &nparticles](std::vector<hmap::Array *>       p_arrays_out,
+                                std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_bedrock = p_arrays[1];
-            hmap::Array *pa_moisture_map = p_arrays[2];
-            hmap::Array *pa_mask = p_arrays[3];
-            hmap::Array *pa_erosion_map = p_arrays[4];
-            hmap::Array *pa_deposition_map = p_arrays[5];
-
-            hmap::gpu::hydraulic_particle(*pa_out,
-                                          pa_mask,
-                                          nparticles,
-                                          node.get_attr<SeedAttribute>("seed"),
-                                          pa_bedrock,
-                                          pa_moisture_map,
-                                          pa_erosion_map,
-                                          pa_deposition_map,
-                                          node.get_attr<FloatAttribute>("c_capacity"),
-                                          node.get_attr<FloatAttribute>("c_erosion"),
-                                          node.get_attr<FloatAttribute>("c_deposition"),
-                                          node.get_attr<FloatAttribute>("c_inertia"),
-                                          node.get_attr<FloatAttribute>("drag_rate"),
-                                          node.get_attr<FloatAttribute>("evap_rate"),
-                                          node.get_attr<BoolAttribute>("post_filtering"));
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_bedrock = p_arrays_in[0];
+            const hmap::Array *pa_moisture_map = p_arrays_in[1];
+            const hmap::Array *pa_mask = p_arrays_in[2];
+            hmap::Array       *pa_erosion_map = p_arrays_out[1];
+            hmap::Array       *pa_deposition_map = p_arrays_out[2];
+
+            erode(*pa_out,
+                  pa_mask,
+                  nparticles,
+                  pa_bedrock,
+                  pa_moisture_map,
+                  pa_erosion_map,
+                  pa_deposition_map);
           },
-          node.get_config_ref()->hmap_transform_mode_gpu);
+          node.get_attr<BoolAttribute>("GPU")
+              ? node.get_config_ref()->hmap_transform_mode_gpu
+              : node.get_config_ref()->hmap_transform_mode_cpu);
     }
     else
     {
@@ -130,19 +185,21 @@ void compute_hydraulic_particle_node(BaseNode &node)
                          nparticles);
 
       hmap::transform(
-          {p_out, p_bedrock, p_moisture_map, p_mask, p_erosion_map, p_deposition_map},
-          [&node, nparticles](std::vector<hmap::Array *> p_arrays,
-                              hmap::Vec2<int>            shape,
-                              hmap::Vec4<float>)
+          {p_out, p_erosion_map, p_deposition_map},
+          {p_bedrock, p_moisture_map, p_mask},
+          [&node, &erode, nparticles](std::vector<hmap::Array *>       p_arrays_out,
+                                      std::vector<const hmap::Array *> p_arrays_in,
+                                      hmap::Vec2<int>                  shape,
+                                      hmap::Vec4<float>)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_bedrock = p_arrays[1];
-            hmap::Array *pa_moisture_map = p_arrays[2];
-            hmap::Array *pa_mask = p_arrays[3];
-            hmap::Array *pa_erosion_map = p_arrays[4];
-            hmap::Array *pa_deposition_map = p_arrays[5];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_bedrock = p_arrays_in[0];
+            const hmap::Array *pa_moisture_map = p_arrays_in[1];
+            const hmap::Array *pa_mask = p_arrays_in[2];
+            hmap::Array       *pa_erosion_map = p_arrays_out[1];
+            hmap::Array       *pa_deposition_map = p_arrays_out[2];
 
-            auto lambda = [&node,
+            auto lambda = [&erode,
                            shape,
                            nparticles,
                            pa_mask,
@@ -158,11 +215,13 @@ void compute_hydraulic_particle_node(BaseNode &node)
               std::vector<hmap::Array>   coarse_arrays = {};
               std::vector<hmap::Array *> p_coarse_arrays = {};
 
-              for (auto pa : {pa_mask,
-                              pa_bedrock,
-                              pa_moisture_map,
-                              pa_erosion_map,
-                              pa_deposition_map})
+              const std::vector<const hmap::Array *> p_fields = {pa_mask,
+                                                                 pa_bedrock,
+                                                                 pa_moisture_map,
+                                                                 pa_erosion_map,
+                                                                 pa_deposition_map};
+
+              for (auto pa : p_fields)
               {
                 if (pa)
                   coarse_arrays.push_back(std::move(pa->resample_to_shape(shape_coarse)));
@@ -171,11 +230,7 @@ void compute_hydraulic_particle_node(BaseNode &node)
               }
 
               int k = 0;
-              for (auto pa : {pa_mask,
-                              pa_bedrock,
-                              pa_moisture_map,
-                              pa_erosion_map,
-                              pa_deposition_map})
+              for (auto pa : p_fields)
               {
                 if (pa)
                   p_coarse_arrays.push_back(&coarse_arrays[k]);
@@ -184,22 +239,13 @@ void compute_hydraulic_particle_node(BaseNode &node)
                 k++;
               }
 
-              hmap::gpu::hydraulic_particle(
-                  x,
-                  p_coarse_arrays[0], // mask
-                  nparticles,
-                  node.get_attr<SeedAttribute>("seed"),
-                  p_coarse_arrays[1], // bedrock
-                  p_coarse_arrays[2], // moisture
-                  p_coarse_arrays[3], // ero map
-                  p_coarse_arrays[4], // depo map
-                  node.get_attr<FloatAttribute>("c_capacity"),
-                  node.get_attr<FloatAttribute>("c_erosion"),
-                  node.get_attr<FloatAttribute>("c_deposition"),
-                  node.get_attr<FloatAttribute>("c_inertia"),
-                  node.get_attr<FloatAttribute>("drag_rate"),
-                  node.get_attr<FloatAttribute>("evap_rate"),
-                  node.get_attr<BoolAttribute>("post_filtering"));
+              erode(x,
+                    p_coarse_arrays[0], // mask
+                    nparticles,
+                    p_coarse_arrays[1],  // bedrock
+                    p_coarse_arrays[2],  // moisture
+                    p_coarse_arrays[3],  // ero map
+                    p_coarse_arrays[4]); // depo map
 
               // resample output fields to their original shape
               if (pa_erosion_map)
@@ -215,6 +261,14 @@ void compute_hydraulic_particle_node(BaseNode &node)
           hmap::TransformMode::SINGLE_ARRAY);
     }
 
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+                         .count();
+
+    Logger::log()->info("hydraulic_particle: {} particles, {:.0f} particles/s ({})",
+                        nparticles_total.load(),
+                        elapsed > 0.0 ? (double)nparticles_total.load() / elapsed : 0.0,
+                        node.get_attr<BoolAttribute>("GPU") ? "GPU" : "CPU");
+
     p_out->smooth_overlap_buffers();
 
     p_erosion_map->smooth_overlap_buffers();
@@ -95,13 +95,14 @@ void compute_hydraulic_procedural_node(BaseNode &node)
                               (float)p_out->tiling.x;
 
     hmap::transform(
-        {p_out, p_mask, p_ridge_mask},
-        [&node, hmin, hmax, talus_mask, global_wavelength](
-            std::vector<hmap::Array *> p_arrays)
+        {p_out, p_ridge_mask},
+        {p_mask},
+        [&node, hmin, hmax, talus_mask, global_wavelength](std::vector<hmap::Array *>       p_arrays_out,
+                                                           std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
-          hmap::Array *pa_ridge_mask = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
+          hmap::Array       *pa_ridge_mask = p_arrays_out[1];
 
           hmap::hydraulic_procedural(
               *pa_out,
@@ -97,13 +97,15 @@ void compute_hydraulic_schott_node(BaseNode &node)
     hmap::Heightmap flow_map = hmap::Heightmap(CONFIG(node), 1.f);
 
     hmap::transform(
-        {p_out, &talus_map, p_mask, &flow_map},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_out, &talus_map, &flow_map},
+        {p_mask},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_talus = p_arrays[1];
-          hmap::Array *pa_mask = p_arrays[2];
-          hmap::Array *pa_flow_map = p_arrays[3];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          hmap::Array       *pa_talus = p_arrays_out[1];
+          const hmap::Array *pa_mask = p_arrays_in[0];
+          hmap::Array       *pa_flow_map = p_arrays_out[2];
 
           hmap::gpu::hydraulic_schott(
               *pa_out,
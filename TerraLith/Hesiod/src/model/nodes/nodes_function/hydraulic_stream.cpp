@@ -62,12 +62,14 @@ void compute_hydraulic_stream_node(BaseNode &node)
     int ir = (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x);
 
     hmap::transform(
-        {p_out, p_mask, p_erosion_map},
-        [&node, &ir](std::vector<hmap::Array *> p_arrays)
+        {p_out, p_erosion_map},
+        {p_mask},
+        [&node, &ir](std::vector<hmap::Array *>       p_arrays_out,
+                     std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
-          hmap::Array *pa_erosion_map = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
+          hmap::Array       *pa_erosion_map = p_arrays_out[1];
 
           hmap::hydraulic_stream(*pa_out,
                                  pa_mask,
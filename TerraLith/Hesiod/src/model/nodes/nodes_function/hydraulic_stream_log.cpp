@@ -104,14 +104,16 @@ void compute_hydraulic_stream_log_node(BaseNode &node)
     gradient_ir = std::max(1, gradient_ir);
 
     hmap::transform(
-        {p_out, p_mask, p_erosion_map, p_deposition_map, p_flow_map},
-        [&node, deposition_ir, gradient_ir](std::vector<hmap::Array *> p_arrays)
+        {p_out, p_erosion_map, p_deposition_map, p_flow_map},
+        {p_mask},
+        [&node, deposition_ir, gradient_ir](std::vector<hmap::Array *>       p_arrays_out,
+                                            std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
-          hmap::Array *pa_erosion_map = p_arrays[2];
-          hmap::Array *pa_deposition_map = p_arrays[3];
-          hmap::Array *pa_flow_map = p_arrays[4];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
+          hmap::Array       *pa_erosion_map = p_arrays_out[1];
+          hmap::Array       *pa_deposition_map = p_arrays_out[2];
+          hmap::Array       *pa_flow_map = p_arrays_out[3];
 
           hmap::gpu::hydraulic_stream_log(
               *pa_out,
@@ -139,14 +139,16 @@ void compute_island_node(BaseNode &node)
   float scale = node.get_attr<FloatAttribute>("elevation_scale");
 
   hmap::transform(
-      {p_out, p_land, p_dr, p_depth, p_mask},
-      [&node, ir, scale](std::vector<hmap::Array *> p_arrays)
+      {p_out, p_depth, p_mask},
+      {p_land, p_dr},
+      [&node, ir, scale](std::vector<hmap::Array *>       p_arrays_out,
+                         std::vector<const hmap::Array *> p_arrays_in)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_land = p_arrays[1];
-        hmap::Array *pa_dr = p_arrays[2];
-        hmap::Array *pa_depth = p_arrays[3];
-        hmap::Array *pa_mask = p_arrays[4];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_land = p_arrays_in[0];
+        const hmap::Array *pa_dr = p_arrays_in[1];
+        hmap::Array       *pa_depth = p_arrays_out[1];
+        hmap::Array       *pa_mask = p_arrays_out[2];
 
         if (pa_dr)
         {
@@ -82,15 +82,16 @@ void compute_karst_terrain_node(BaseNode &node)
   *p_out = *p_in;
 
   hmap::transform(
-      {p_out, p_mask},
+      {p_out},
+      {p_mask},
       [seed, dissolution, sink_density, sink_depth, sink_radius, tower_density,
-       tower_height, roughness, iterations](
-          std::vector<hmap::Array *> p_arrays,
-          hmap::Vec2<int>            shape,
-          hmap::Vec4<float>          bbox)
+       tower_height, roughness, iterations](std::vector<hmap::Array *>       p_arrays_out,
+                                            std::vector<const hmap::Array *> p_arrays_in,
+                                            hmap::Vec2<int>                  shape,
+                                            hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_mask = p_arrays[1];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_mask = p_arrays_in[0];
 
         std::mt19937 rng(seed);
         std::uniform_real_distribution<float> dist(0.f, 1.f);
@@ -85,16 +85,17 @@ void compute_lava_flow_field_node(BaseNode &node)
   int   n_sources = node.get_attr<IntAttribute>("n_sources");
 
   hmap::transform(
-      {p_out, p_mask, p_flow},
+      {p_out, p_flow},
+      {p_mask},
       [seed, source_elev, viscosity, temperature, flow_volume, iterations,
-       cooling, buildup, texture, n_sources](
-          std::vector<hmap::Array *> p_arrays,
-          hmap::Vec2<int>            shape,
-          hmap::Vec4<float>          bbox)
+       cooling, buildup, texture, n_sources](std::vector<hmap::Array *>       p_arrays_out,
+                                             std::vector<const hmap::Array *> p_arrays_in,
+                                             hmap::Vec2<int>                  shape,
+                                             hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_mask = p_arrays[1];
-        hmap::Array *pa_flow = p_arrays[2];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_mask = p_arrays_in[0];
+        hmap::Array       *pa_flow = p_arrays_out[1];
 
         float hmin = pa_out->min();
         float hmax = pa_out->max();
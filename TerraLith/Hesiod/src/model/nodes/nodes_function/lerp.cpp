@@ -42,25 +42,29 @@ void compute_lerp_node(BaseNode &node)
 
     if (p_t)
       hmap::transform(
-          {p_out, p_a, p_b, p_t},
-          [](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_a, p_b, p_t},
+          [](std::vector<hmap::Array *>       p_arrays_out,
+             std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_a = p_arrays[1];
-            hmap::Array *pa_b = p_arrays[2];
-            hmap::Array *pa_t = p_arrays[3];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_a = p_arrays_in[0];
+            const hmap::Array *pa_b = p_arrays_in[1];
+            const hmap::Array *pa_t = p_arrays_in[2];
 
             *pa_out = hmap::lerp(*pa_a, *pa_b, *pa_t);
           },
           node.get_config_ref()->hmap_transform_mode_cpu);
     else
       hmap::transform(
-          {p_out, p_a, p_b},
-          [&node](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_a, p_b},
+          [&node](std::vector<hmap::Array *>       p_arrays_out,
+                  std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_a = p_arrays[1];
-            hmap::Array *pa_b = p_arrays[2];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_a = p_arrays_in[0];
+            const hmap::Array *pa_b = p_arrays_in[1];
 
             *pa_out = hmap::lerp(*pa_a, *pa_b, node.get_attr<FloatAttribute>("t"));
           },
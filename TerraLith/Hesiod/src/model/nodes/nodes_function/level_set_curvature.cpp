@@ -46,11 +46,13 @@ void compute_level_set_curvature_node(BaseNode &node)
     int ir = (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x);
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node, ir](std::vector<hmap::Array *>       p_arrays_out,
+                    std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = hmap::gpu::level_set_curvature(*pa_in, ir);
 
@@ -49,11 +49,13 @@ void compute_make_periodic_node(BaseNode &node)
         (int)(node.get_attr<FloatAttribute>("overlap") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, nbuffer](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node, nbuffer](std::vector<hmap::Array *>       p_arrays_out,
+                         std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = *pa_in;
 
@@ -56,12 +56,14 @@ void compute_mean_shift_node(BaseNode &node)
     float talus = node.get_attr<FloatAttribute>("talus_global") / (float)p_out->shape.x;
 
     hmap::transform(
-        {p_out, p_in, p_mask},
-        [&node, ir, talus](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in, p_mask},
+        [&node, ir, talus](std::vector<hmap::Array *>       p_arrays_out,
+                           std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
-          hmap::Array *pa_mask = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
+          const hmap::Array *pa_mask = p_arrays_in[1];
 
           *pa_out = hmap::gpu::mean_shift(*pa_in,
                                           ir,
@@ -41,32 +41,36 @@ void compute_median3x3_node(BaseNode &node)
     if (node.get_attr<BoolAttribute>("GPU"))
     {
       hmap::transform(
-          {p_out, p_in, p_mask},
-          [](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in, p_mask},
+          [](std::vector<hmap::Array *>       p_arrays_out,
+             std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
-            hmap::Array *pa_mask = p_arrays[2];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
+            const hmap::Array *pa_mask = p_arrays_in[1];
 
             *pa_out = *pa_in;
 
-            hmap::gpu::median_3x3(*pa_in, pa_mask);
+            hmap::gpu::median_3x3(*pa_out, pa_mask);
           },
           node.get_config_ref()->hmap_transform_mode_gpu);
     }
     else
     {
       hmap::transform(
-          {p_out, p_in, p_mask},
-          [](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in, p_mask},
+          [](std::vector<hmap::Array *>       p_arrays_out,
+             std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
-            hmap::Array *pa_mask = p_arrays[2];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
+            const hmap::Array *pa_mask = p_arrays_in[1];
 
             *pa_out = *pa_in;
 
-            hmap::median_3x3(*pa_in, pa_mask);
+            hmap::median_3x3(*pa_out, pa_mask);
           },
           node.get_config_ref()->hmap_transform_mode_gpu);
     }
@@ -42,12 +42,14 @@ void compute_merge_water_depths_node(BaseNode &node)
     hmap::Heightmap *p_depth = node.get_value_ref<hmap::Heightmap>("water_depth");
 
     hmap::transform(
-        {p_depth, p_in1, p_in2},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_depth},
+        {p_in1, p_in2},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_depth = p_arrays[0];
-          hmap::Array *pa_in1 = p_arrays[1];
-          hmap::Array *pa_in2 = p_arrays[2];
+          hmap::Array       *pa_depth = p_arrays_out[0];
+          const hmap::Array *pa_in1 = p_arrays_in[0];
+          const hmap::Array *pa_in2 = p_arrays_in[1];
 
           *pa_depth = hmap::merge_water_depths(*pa_in1,
                                                *pa_in2,
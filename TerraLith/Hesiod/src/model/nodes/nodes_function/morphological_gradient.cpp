@@ -45,11 +45,13 @@ void compute_morphological_gradient_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_in},
-        [ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [ir](std::vector<hmap::Array *>       p_arrays_out,
+             std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = hmap::gpu::morphological_gradient(*pa_in, ir);
         },
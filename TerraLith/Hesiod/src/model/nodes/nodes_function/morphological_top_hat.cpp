@@ -47,11 +47,13 @@ void compute_morphological_top_hat_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node, ir](std::vector<hmap::Array *>       p_arrays_out,
+                    std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           if (node.get_attr<BoolAttribute>("top_hat"))
           {
@@ -53,14 +53,16 @@ void compute_noise_node(BaseNode &node)
   if (node.get_attr<BoolAttribute>("GPU"))
   {
     hmap::transform(
-        {p_out, p_dx, p_dy},
-        [&node](std::vector<hmap::Array *> p_arrays,
-                hmap::Vec2<int>            shape,
-                hmap::Vec4<float>          bbox)
+        {p_out},
+        {p_dx, p_dy},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in,
+                hmap::Vec2<int>                  shape,
+                hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_dx = p_arrays[1];
-          hmap::Array *pa_dy = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_dx = p_arrays_in[0];
+          const hmap::Array *pa_dy = p_arrays_in[1];
 
           *pa_out = hmap::gpu::noise(
               (hmap::NoiseType)node.get_attr<EnumAttribute>("noise_type"),
@@ -77,14 +79,16 @@ void compute_noise_node(BaseNode &node)
   else
   {
     hmap::transform(
-        {p_out, p_dx, p_dy},
-        [&node](std::vector<hmap::Array *> p_arrays,
-                hmap::Vec2<int>            shape,
-                hmap::Vec4<float>          bbox)
+        {p_out},
+        {p_dx, p_dy},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in,
+                hmap::Vec2<int>                  shape,
+                hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_dx = p_arrays[1];
-          hmap::Array *pa_dy = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_dx = p_arrays_in[0];
+          const hmap::Array *pa_dy = p_arrays_in[1];
 
           *pa_out = hmap::noise(
               (hmap::NoiseType)node.get_attr<EnumAttribute>("noise_type"),
@@ -77,15 +77,17 @@ void compute_noise_fbm_node(BaseNode &node)
   if (node.is_vulkan_enabled())
   {
     hmap::transform(
-        {p_out, p_ctrl, p_dx, p_dy},
-        [&node](std::vector<hmap::Array *> p_arrays,
-                hmap::Vec2<int>            shape,
-                hmap::Vec4<float>          bbox)
+        {p_out},
+        {p_ctrl, p_dx, p_dy},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in,
+                hmap::Vec2<int>                  shape,
+                hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_ctrl = p_arrays[1];
-          hmap::Array *pa_dx = p_arrays[2];
-          hmap::Array *pa_dy = p_arrays[3];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_ctrl = p_arrays_in[0];
+          const hmap::Array *pa_dx = p_arrays_in[1];
+          const hmap::Array *pa_dy = p_arrays_in[2];
 
           *pa_out = hmap::gpu::noise_fbm(
               (hmap::NoiseType)node.get_attr<EnumAttribute>("noise_type"),
@@ -107,15 +109,17 @@ void compute_noise_fbm_node(BaseNode &node)
   else
   {
     hmap::transform(
-        {p_out, p_ctrl, p_dx, p_dy},
-        [&node](std::vector<hmap::Array *> p_arrays,
-                hmap::Vec2<int>            shape,
-                hmap::Vec4<float>          bbox)
+        {p_out},
+        {p_ctrl, p_dx, p_dy},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in,
+                hmap::Vec2<int>                  shape,
+                hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_ctrl = p_arrays[1];
-          hmap::Array *pa_dx = p_arrays[2];
-          hmap::Array *pa_dy = p_arrays[3];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_ctrl = p_arrays_in[0];
+          const hmap::Array *pa_dx = p_arrays_in[1];
+          const hmap::Array *pa_dy = p_arrays_in[2];
 
           *pa_out = hmap::noise_fbm(
               (hmap::NoiseType)node.get_attr<EnumAttribute>("noise_type"),
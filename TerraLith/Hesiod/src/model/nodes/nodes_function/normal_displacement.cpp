@@ -57,11 +57,13 @@ void compute_normal_displacement_node(BaseNode &node)
       if (node.get_attr<BoolAttribute>("GPU"))
       {
         hmap::transform(
-            {p_out, p_mask},
-            [&node, &ir](std::vector<hmap::Array *> p_arrays)
+            {p_out},
+            {p_mask},
+            [&node, &ir](std::vector<hmap::Array *>       p_arrays_out,
+                         std::vector<const hmap::Array *> p_arrays_in)
             {
-              hmap::Array *pa_out = p_arrays[0];
-              hmap::Array *pa_mask = p_arrays[1];
+              hmap::Array       *pa_out = p_arrays_out[0];
+              const hmap::Array *pa_mask = p_arrays_in[0];
 
               hmap::gpu::normal_displacement(*pa_out,
                                              pa_mask,
@@ -74,11 +76,13 @@ void compute_normal_displacement_node(BaseNode &node)
       else
       {
         hmap::transform(
-            {p_out, p_mask},
-            [&node, &ir](std::vector<hmap::Array *> p_arrays)
+            {p_out},
+            {p_mask},
+            [&node, &ir](std::vector<hmap::Array *>       p_arrays_out,
+                         std::vector<const hmap::Array *> p_arrays_in)
             {
-              hmap::Array *pa_out = p_arrays[0];
-              hmap::Array *pa_mask = p_arrays[1];
+              hmap::Array       *pa_out = p_arrays_out[0];
+              const hmap::Array *pa_mask = p_arrays_in[0];
 
               hmap::normal_displacement(*pa_out,
                                         pa_mask,
@@ -25,11 +25,14 @@ void setup_normal_map_to_heightmap_node(BaseNode &node)
 
   // attribute(s)
   node.add_attr<BoolAttribute>("poisson_solver", "poisson_solver", false);
-  node.add_attr<IntAttribute>("iterations", "iterations", 500, 1, INT_MAX);
-  node.add_attr<FloatAttribute>("omega", "omega", 1.5f, 1e-3f, 2.f);
+  node.add_attr<IntAttribute>("iterations", "iterations", 20, 1, INT_MAX);
+
+  // deprecated, ignored (the multigrid solver does not use over-relaxation),
+  // kept for the projects saved with it
+  node.add_attr<FloatAttribute>("omega", "omega (deprecated)", 1.5f, 1e-3f, 2.f);
 
   // attribute(s) order
-  node.set_attr_ordered_key({"poisson_solver", "iterations", "omega"});
+  node.set_attr_ordered_key({"poisson_solver", "iterations", "_SEPARATOR_", "omega"});
 
   setup_post_process_heightmap_attributes(node);
 }
@@ -53,9 +56,9 @@ void compute_normal_map_to_heightmap_node(BaseNode &node)
 
     if (node.get_attr<BoolAttribute>("poisson_solver"))
     {
-      z = hmap::normal_map_to_heightmap_poisson(ts,
-                                                node.get_attr<IntAttribute>("iterations"),
-                                                node.get_attr<FloatAttribute>("omega"));
+      z = hmap::normal_map_to_heightmap_poisson(
+          ts,
+          node.get_attr<IntAttribute>("iterations"));
     }
     else
     {
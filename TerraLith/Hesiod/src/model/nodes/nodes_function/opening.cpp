@@ -46,28 +46,34 @@ void compute_opening_node(BaseNode &node)
     if (node.get_attr<BoolAttribute>("GPU"))
     {
       hmap::transform(
-          {p_out, p_in},
-          [&ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&ir](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::gpu::opening(*pa_in, ir);
           },
-          node.get_config_ref()->hmap_transform_mode_gpu);
+          node.get_config_ref()->hmap_transform_mode_gpu,
+          2 * ir);
     }
     else
     {
       hmap::transform(
-          {p_out, p_in},
-          [&ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&ir](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::opening(*pa_in, ir);
           },
-          node.get_config_ref()->hmap_transform_mode_cpu);
+          node.get_config_ref()->hmap_transform_mode_cpu,
+          2 * ir);
     }
 
     p_out->smooth_overlap_buffers();
@@ -73,17 +73,19 @@ void compute_polygon_field_node(BaseNode &node)
   hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
   hmap::transform(
-      {p_out, p_dx, p_dy, p_dr, p_density, p_size},
-      [&node](std::vector<hmap::Array *> p_arrays,
-              hmap::Vec2<int>            shape,
-              hmap::Vec4<float>          bbox)
+      {p_out},
+      {p_dx, p_dy, p_dr, p_density, p_size},
+      [&node](std::vector<hmap::Array *>       p_arrays_out,
+              std::vector<const hmap::Array *> p_arrays_in,
+              hmap::Vec2<int>                  shape,
+              hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_dx = p_arrays[1];
-        hmap::Array *pa_dy = p_arrays[2];
-        hmap::Array *pa_dr = p_arrays[3];
-        hmap::Array *pa_density = p_arrays[4];
-        hmap::Array *pa_size = p_arrays[5];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_dx = p_arrays_in[0];
+        const hmap::Array *pa_dy = p_arrays_in[1];
+        const hmap::Array *pa_dr = p_arrays_in[2];
+        const hmap::Array *pa_density = p_arrays_in[3];
+        const hmap::Array *pa_size = p_arrays_in[4];
 
         hmap::Vec2<float> jitter(node.get_attr<FloatAttribute>("jitter.x"),
                                  node.get_attr<FloatAttribute>("jitter.y"));
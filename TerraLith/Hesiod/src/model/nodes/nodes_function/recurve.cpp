@@ -52,12 +52,14 @@ void compute_recurve_node(BaseNode &node)
           node.get_attr<VecFloatAttribute>("values").size());
 
       hmap::transform(
-          {p_out, p_in, p_mask},
-          [&node, t, hmin, hmax](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in, p_mask},
+          [&node, t, hmin, hmax](std::vector<hmap::Array *>       p_arrays_out,
+                                 std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
-            hmap::Array *pa_mask = p_arrays[2];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
+            const hmap::Array *pa_mask = p_arrays_in[1];
 
             *pa_out = *pa_in;
 
@@ -55,13 +55,15 @@ void compute_reverse_above_theshold_node(BaseNode &node)
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
     hmap::transform(
-        {p_out, p_in, p_th, p_mask},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in, p_th, p_mask},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
-          hmap::Array *pa_th = p_arrays[2];
-          hmap::Array *pa_mask = p_arrays[3];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
+          const hmap::Array *pa_th = p_arrays_in[1];
+          const hmap::Array *pa_mask = p_arrays_in[2];
 
           *pa_out = *pa_in;
 
@@ -106,15 +106,17 @@ void compute_rifts_node(BaseNode &node)
     p_out->remap(0.f, 1.f, hmin, hmax);
 
     hmap::transform(
-        {p_out, p_dx, p_dy, p_mask},
-        [&node](std::vector<hmap::Array *> p_arrays,
+        {p_out},
+        {p_dx, p_dy, p_mask},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in,
                 hmap::Vec2<int> /* shape */,
-                hmap::Vec4<float> bbox)
+                hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_dx = p_arrays[1];
-          hmap::Array *pa_dy = p_arrays[2];
-          hmap::Array *pa_mask = p_arrays[3];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_dx = p_arrays_in[0];
+          const hmap::Array *pa_dy = p_arrays_in[1];
+          const hmap::Array *pa_mask = p_arrays_in[2];
 
           hmap::gpu::rifts(*pa_out,
                            node.get_attr<WaveNbAttribute>("kw"),
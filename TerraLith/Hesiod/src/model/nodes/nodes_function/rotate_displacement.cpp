@@ -42,12 +42,14 @@ void compute_rotate_displacement_node(BaseNode &node)
     hmap::Heightmap *p_dy = node.get_value_ref<hmap::Heightmap>("dy");
 
     hmap::transform(
-        {p_in, p_dx, p_dy},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_dx, p_dy},
+        {p_in},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_in = p_arrays[0];
-          hmap::Array *pa_dx = p_arrays[1];
-          hmap::Array *pa_dy = p_arrays[2];
+          const hmap::Array *pa_in = p_arrays_in[0];
+          hmap::Array       *pa_dx = p_arrays_out[0];
+          hmap::Array       *pa_dy = p_arrays_out[1];
 
           hmap::rotate_displacement(*pa_in,
                                     node.get_attr<FloatAttribute>("angle"),
@@ -2,7 +2,6 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include "highmap/features.hpp"
-#include "highmap/opencl/gpu_opencl.hpp"
 #include "highmap/range.hpp"
 
 #include "attributes.hpp"
@@ -46,15 +45,18 @@ void compute_ruggedness_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_in},
-        [ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [ir](std::vector<hmap::Array *>       p_arrays_out,
+             std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
-          *pa_out = hmap::gpu::ruggedness(*pa_in, ir);
+          *pa_out = hmap::ruggedness(*pa_in, ir);
         },
-        node.get_config_ref()->hmap_transform_mode_gpu);
+        node.get_config_ref()->hmap_transform_mode_cpu,
+        ir);
 
     // post-process
     p_out->smooth_overlap_buffers();
@@ -53,11 +53,13 @@ void compute_select_slope_node(BaseNode &node)
     if (ir > 0)
     {
       hmap::transform(
-          {p_out, p_in},
-          [&node, ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&node, ir](std::vector<hmap::Array *>       p_arrays_out,
+                      std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::gpu::morphological_gradient(*pa_in, ir);
           },
@@ -65,11 +67,13 @@ void compute_select_slope_node(BaseNode &node)
     }
     else
       hmap::transform(
-          {p_out, p_in},
-          [&node](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&node](std::vector<hmap::Array *>       p_arrays_out,
+                  std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::gradient_norm(*pa_in);
           },
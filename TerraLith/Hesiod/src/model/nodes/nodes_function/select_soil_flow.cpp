@@ -68,11 +68,13 @@ void compute_select_soil_flow_node(BaseNode &node)
     // --- compute mask
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, nx, ir, talus](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node, nx, ir, talus](std::vector<hmap::Array *>       p_arrays_out,
+                               std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           float k_smooth = 0.01f; // little influence
 
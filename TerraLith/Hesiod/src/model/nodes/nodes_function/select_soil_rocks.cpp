@@ -86,11 +86,13 @@ void compute_select_soil_rocks_node(BaseNode &node)
     int ir_max = std::max(1, (int)(node.get_attr<FloatAttribute>("rmax") * nx));
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, ir_min, ir_max](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node, ir_min, ir_max](std::vector<hmap::Array *>       p_arrays_out,
+                                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           auto mode = static_cast<hmap::ClampMode>(
               node.get_attr<EnumAttribute>("curvature_clamp_mode"));
@@ -81,11 +81,13 @@ void compute_select_soil_weathered_node(BaseNode &node)
     hmap::Heightmap grad_norm(CONFIG(node));
 
     hmap::transform(
-        {&grad_norm, p_in},
-        [&node, ir_grad](std::vector<hmap::Array *> p_arrays)
+        {&grad_norm},
+        {p_in},
+        [&node, ir_grad](std::vector<hmap::Array *>       p_arrays_out,
+                         std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = hmap::gpu::morphological_gradient(*pa_in, ir_grad);
         },
@@ -107,12 +109,14 @@ void compute_select_soil_weathered_node(BaseNode &node)
     // --- compute mask
 
     hmap::transform(
-        {p_out, p_in, &grad_norm},
-        [&node, nx, ir_curv, ir_grad](std::vector<hmap::Array *> p_arrays)
+        {p_out, &grad_norm},
+        {p_in},
+        [&node, nx, ir_curv, ir_grad](std::vector<hmap::Array *>       p_arrays_out,
+                                      std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
-          hmap::Array *pa_grad_norm = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
+          hmap::Array       *pa_grad_norm = p_arrays_out[1];
 
           auto mode = static_cast<hmap::ClampMode>(
               node.get_attr<EnumAttribute>("curvature_clamp_mode"));
@@ -50,11 +50,13 @@ void compute_select_valley_node(BaseNode &node)
     if (node.get_attr<BoolAttribute>("GPU"))
     {
       hmap::transform(
-          {p_out, p_in},
-          [&node, ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&node, ir](std::vector<hmap::Array *>       p_arrays_out,
+                      std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::gpu::select_valley(
                 *pa_in,
@@ -67,11 +69,13 @@ void compute_select_valley_node(BaseNode &node)
     else
     {
       hmap::transform(
-          {p_out, p_in},
-          [&node, ir](std::vector<hmap::Array *> p_arrays)
+          {p_out},
+          {p_in},
+          [&node, ir](std::vector<hmap::Array *>       p_arrays_out,
+                      std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_in = p_arrays[1];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_in = p_arrays_in[0];
 
             *pa_out = hmap::select_valley(*pa_in,
                                           ir,
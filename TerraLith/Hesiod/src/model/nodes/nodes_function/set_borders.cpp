@@ -67,11 +67,13 @@ void compute_set_borders_node(BaseNode &node)
                        node.get_attr<FloatAttribute>("value_south")};
 
     hmap::transform(
-        {p_out, p_in},
-        [border_values, buffer_sizes](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [border_values, buffer_sizes](std::vector<hmap::Array *>       p_arrays_out,
+                                      std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = *pa_in;
 
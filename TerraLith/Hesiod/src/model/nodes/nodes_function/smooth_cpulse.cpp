@@ -54,15 +54,18 @@ void compute_smooth_cpulse_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_mask},
-        [&ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_mask},
+        [&ir](std::vector<hmap::Array *>       p_arrays_out,
+              std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
 
           hmap::gpu::smooth_cpulse(*pa_out, ir, pa_mask);
         },
-        node.get_config_ref()->hmap_transform_mode_gpu);
+        node.get_config_ref()->hmap_transform_mode_gpu,
+        ir);
 
     p_out->smooth_overlap_buffers();
 
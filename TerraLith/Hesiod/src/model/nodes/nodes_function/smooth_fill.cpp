@@ -59,12 +59,14 @@ void compute_smooth_fill_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_mask, p_deposition_map},
-        [&node, &ir](std::vector<hmap::Array *> p_arrays)
+        {p_out, p_deposition_map},
+        {p_mask},
+        [&node, &ir](std::vector<hmap::Array *>       p_arrays_out,
+                     std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
-          hmap::Array *pa_deposition = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
+          hmap::Array       *pa_deposition = p_arrays_out[1];
 
           hmap::gpu::smooth_fill(*pa_out,
                                  ir,
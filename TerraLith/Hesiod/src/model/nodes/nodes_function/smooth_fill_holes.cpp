@@ -54,11 +54,13 @@ void compute_smooth_fill_holes_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_mask},
-        [&ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_mask},
+        [&ir](std::vector<hmap::Array *>       p_arrays_out,
+              std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
 
           hmap::gpu::smooth_fill_holes(*pa_out, ir, pa_mask);
         },
@@ -47,11 +47,13 @@ void compute_smoothstep_node(BaseNode &node)
     float hmax = p_in->max();
 
     hmap::transform(
-        {p_out, p_in},
-        [&node, hmin, hmax](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_in},
+        [&node, hmin, hmax](std::vector<hmap::Array *>       p_arrays_out,
+                            std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
 
           *pa_out = *pa_in;
 
@@ -78,14 +78,15 @@ void compute_stratified_erosion_node(BaseNode &node)
   *p_out = *p_in;
 
   hmap::transform(
-      {p_out, p_mask},
-      [seed, n_layers, hardness_var, erosion_str, iterations, cliff_sharp, talus, noise_amp](
-          std::vector<hmap::Array *> p_arrays,
-          hmap::Vec2<int>            shape,
-          hmap::Vec4<float>          bbox)
+      {p_out},
+      {p_mask},
+      [seed, n_layers, hardness_var, erosion_str, iterations, cliff_sharp, talus, noise_amp](std::vector<hmap::Array *>       p_arrays_out,
+                                                                                             std::vector<const hmap::Array *> p_arrays_in,
+                                                                                             hmap::Vec2<int>                  shape,
+                                                                                             hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_mask = p_arrays[1];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_mask = p_arrays_in[0];
 
         float hmin = pa_out->min();
         float hmax = pa_out->max();
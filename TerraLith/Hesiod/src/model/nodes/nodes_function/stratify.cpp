@@ -72,12 +72,14 @@ void compute_stratify_node(BaseNode &node)
                                   node.get_attr<SeedAttribute>("seed"));
 
     hmap::transform(
-        {p_out, p_mask, p_noise},
-        [&node, &hs, &gs](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_mask, p_noise},
+        [&node, &hs, &gs](std::vector<hmap::Array *>       p_arrays_out,
+                          std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
-          hmap::Array *pa_noise = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
+          const hmap::Array *pa_noise = p_arrays_in[1];
 
           hmap::stratify(*pa_out, pa_mask, hs, gs, pa_noise);
         },
@@ -59,12 +59,14 @@ void compute_terrace_node(BaseNode &node)
     float hmax = p_out->max();
 
     hmap::transform(
-        {p_out, p_noise, p_mask},
-        [&node, hmin, hmax](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_noise, p_mask},
+        [&node, hmin, hmax](std::vector<hmap::Array *>       p_arrays_out,
+                            std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_noise = p_arrays[1];
-          hmap::Array *pa_mask = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_noise = p_arrays_in[0];
+          const hmap::Array *pa_mask = p_arrays_in[1];
 
           hmap::terrace(*pa_out,
                         node.get_attr<SeedAttribute>("seed"),
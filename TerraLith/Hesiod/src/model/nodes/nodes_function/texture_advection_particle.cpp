@@ -98,14 +98,16 @@ void compute_texture_advection_particle_node(BaseNode &node)
                                       hmap::Heightmap *p_field_out)
     {
       hmap::transform(
-          {p_field_out, p_z, p_field, p_advection_mask, p_mask},
-          [&node, nparticles](std::vector<hmap::Array *> p_arrays)
+          {p_field_out, p_field},
+          {p_z, p_advection_mask, p_mask},
+          [&node, nparticles](std::vector<hmap::Array *>       p_arrays_out,
+                              std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_field_out = p_arrays[0];
-            hmap::Array *pa_z = p_arrays[1];
-            hmap::Array *pa_field = p_arrays[2];
-            hmap::Array *pa_advection_mask = p_arrays[3];
-            hmap::Array *pa_mask = p_arrays[4];
+            hmap::Array       *pa_field_out = p_arrays_out[0];
+            const hmap::Array *pa_z = p_arrays_in[0];
+            hmap::Array       *pa_field = p_arrays_out[1];
+            const hmap::Array *pa_advection_mask = p_arrays_in[1];
+            const hmap::Array *pa_mask = p_arrays_in[2];
 
             *pa_field_out = hmap::gpu::advection_particle(
                 *pa_z,
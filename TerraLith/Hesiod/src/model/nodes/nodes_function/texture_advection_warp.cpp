@@ -62,13 +62,15 @@ void compute_texture_advection_warp_node(BaseNode &node)
                           hmap::Heightmap *p_field_out)
     {
       hmap::transform(
-          {p_field_out, p_z, p_field, p_mask},
-          [&node](std::vector<hmap::Array *> p_arrays)
+          {p_field_out, p_field},
+          {p_z, p_mask},
+          [&node](std::vector<hmap::Array *>       p_arrays_out,
+                  std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_field_out = p_arrays[0];
-            hmap::Array *pa_z = p_arrays[1];
-            hmap::Array *pa_field = p_arrays[2];
-            hmap::Array *pa_mask = p_arrays[3];
+            hmap::Array       *pa_field_out = p_arrays_out[0];
+            const hmap::Array *pa_z = p_arrays_in[0];
+            hmap::Array       *pa_field = p_arrays_out[1];
+            const hmap::Array *pa_mask = p_arrays_in[1];
 
             *pa_field_out = hmap::gpu::advection_warp(
                 *pa_z,
@@ -34,11 +34,16 @@ void setup_thermal_node(BaseNode &node)
   node.add_attr<BoolAttribute>("scale_talus_with_elevation",
                                "scale_talus_with_elevation",
                                false);
+  node.add_attr<BoolAttribute>("legacy_sweep", "legacy_sweep", false);
   node.add_attr<BoolAttribute>("GPU", "GPU", HSD_DEFAULT_GPU_MODE);
 
   // attribute(s) order
-  node.set_attr_ordered_key(
-      {"talus_global", "iterations", "scale_talus_with_elevation", "_SEPARATOR_", "GPU"});
+  node.set_attr_ordered_key({"talus_global",
+                             "iterations",
+                             "scale_talus_with_elevation",
+                             "_SEPARATOR_",
+                             "legacy_sweep",
+                             "GPU"});
 }
 
 void compute_thermal_node(BaseNode &node)
@@ -69,13 +74,15 @@ void compute_thermal_node(BaseNode &node)
     if (node.get_attr<BoolAttribute>("GPU"))
     {
       hmap::transform(
-          {p_out, p_mask, &talus_map, p_deposition_map},
-          [&node, &talus](std::vector<hmap::Array *> p_arrays)
+          {p_out, &talus_map, p_deposition_map},
+          {p_mask},
+          [&node, &talus](std::vector<hmap::Array *>       p_arrays_out,
+                          std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_mask = p_arrays[1];
-            hmap::Array *pa_talus_map = p_arrays[2];
-            hmap::Array *pa_deposition_map = p_arrays[3];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_mask = p_arrays_in[0];
+            hmap::Array       *pa_talus_map = p_arrays_out[1];
+            hmap::Array       *pa_deposition_map = p_arrays_out[2];
 
             hmap::gpu::thermal(*pa_out,
                                pa_mask,
@@ -89,20 +96,23 @@ void compute_thermal_node(BaseNode &node)
     else
     {
       hmap::transform(
-          {p_out, p_mask, &talus_map, p_deposition_map},
-          [&node, &talus](std::vector<hmap::Array *> p_arrays)
+          {p_out, &talus_map, p_deposition_map},
+          {p_mask},
+          [&node, &talus](std::vector<hmap::Array *>       p_arrays_out,
+                          std::vector<const hmap::Array *> p_arrays_in)
           {
-            hmap::Array *pa_out = p_arrays[0];
-            hmap::Array *pa_mask = p_arrays[1];
-            hmap::Array *pa_talus_map = p_arrays[2];
-            hmap::Array *pa_deposition_map = p_arrays[3];
+            hmap::Array       *pa_out = p_arrays_out[0];
+            const hmap::Array *pa_mask = p_arrays_in[0];
+            hmap::Array       *pa_talus_map = p_arrays_out[1];
+            hmap::Array       *pa_deposition_map = p_arrays_out[2];
 
             hmap::thermal(*pa_out,
                           pa_mask,
                           *pa_talus_map,
                           node.get_attr<IntAttribute>("iterations"),
                           nullptr, // bedrock
-                          pa_deposition_map);
+                          pa_deposition_map,
+                          node.get_attr<BoolAttribute>("legacy_sweep"));
           },
           node.get_config_ref()->hmap_transform_mode_cpu);
     }
@@ -79,14 +79,16 @@ void compute_thermal_scree_node(BaseNode &node)
     }
 
     hmap::transform(
-        {p_out, p_mask, &talus_map, p_zmax, p_deposition_map},
-        [&node, &talus](std::vector<hmap::Array *> p_arrays)
+        {p_out, &talus_map, p_deposition_map},
+        {p_mask, p_zmax},
+        [&node, &talus](std::vector<hmap::Array *>       p_arrays_out,
+                        std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
-          hmap::Array *pa_talus_map = p_arrays[2];
-          hmap::Array *pa_zmax = p_arrays[3];
-          hmap::Array *pa_deposition_map = p_arrays[4];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
+          hmap::Array       *pa_talus_map = p_arrays_out[1];
+          const hmap::Array *pa_zmax = p_arrays_in[1];
+          hmap::Array       *pa_deposition_map = p_arrays_out[2];
 
           hmap::gpu::thermal_scree(*pa_out,
                                    pa_mask,
@@ -43,7 +43,7 @@ void compute_thru_node(BaseNode &node)
   {
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
-    // copy the input heightmap
+    // tiles are shared with the input (copy-on-write), no data copy
     *p_out = *p_in;
   }
 }
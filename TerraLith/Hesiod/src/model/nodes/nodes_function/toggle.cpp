@@ -41,7 +41,8 @@ void compute_toggle_node(BaseNode &node)
   {
     hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
-    // copy the either A or B input heightmap based on the toggle state
+    // share either A or B input tiles based on the toggle state
+    // (copy-on-write, no data copy)
     if (node.get_attr<BoolAttribute>("toggle"))
       *p_out = *p_in_a;
     else
@@ -50,12 +50,14 @@ void compute_transfer_node(BaseNode &node)
     int ir = std::max(1, (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x));
 
     hmap::transform(
-        {p_out, p_s, p_t},
-        [&node, ir](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_s, p_t},
+        [&node, ir](std::vector<hmap::Array *>       p_arrays_out,
+                    std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_s = p_arrays[1];
-          hmap::Array *pa_t = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_s = p_arrays_in[0];
+          const hmap::Array *pa_t = p_arrays_in[1];
 
           *pa_out = hmap::gpu::transfer(
               *pa_s,
@@ -53,12 +53,14 @@ void compute_warp_node(BaseNode &node)
     float sy = node.get_attr<FloatAttribute>("scaling.y");
 
     hmap::transform(
-        {p_out, p_dx, p_dy},
-        [sx, sy](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_dx, p_dy},
+        [sx, sy](std::vector<hmap::Array *>       p_arrays_out,
+                 std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array dx = p_arrays[1] ? sx * (*p_arrays[1]) : hmap::Array(pa_out->shape);
-          hmap::Array dy = p_arrays[2] ? sy * (*p_arrays[2]) : hmap::Array(pa_out->shape);
+          hmap::Array *pa_out = p_arrays_out[0];
+          hmap::Array dx = p_arrays_in[0] ? sx * (*p_arrays_in[0]) : hmap::Array(pa_out->shape);
+          hmap::Array dy = p_arrays_in[1] ? sy * (*p_arrays_in[1]) : hmap::Array(pa_out->shape);
 
           hmap::gpu::warp(*pa_out, &dx, &dy);
         },
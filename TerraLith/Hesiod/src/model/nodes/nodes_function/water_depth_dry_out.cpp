@@ -52,11 +52,13 @@ void compute_water_depth_dry_out_node(BaseNode &node)
     float depth_max = p_in->max();
 
     hmap::transform(
-        {p_out, p_mask},
-        [&node, depth_max](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_mask},
+        [&node, depth_max](std::vector<hmap::Array *>       p_arrays_out,
+                           std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_mask = p_arrays[1];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_mask = p_arrays_in[0];
 
           hmap::water_depth_dry_out(*pa_out,
                                     node.get_attr<FloatAttribute>("dry_out_ratio"),
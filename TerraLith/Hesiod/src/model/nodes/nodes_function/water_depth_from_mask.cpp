@@ -37,11 +37,15 @@ void setup_water_depth_from_mask_node(BaseNode &node)
                                 1e-2f,
                                 "{:.3e}",
                                 true);
-  node.add_attr<IntAttribute>("iterations", "iterations", 500, 1, INT_MAX);
-  node.add_attr<FloatAttribute>("omega", "omega", 1.8f, 1e-3f, 1.9f);
+  node.add_attr<IntAttribute>("iterations", "iterations", 20, 1, INT_MAX);
+
+  // deprecated, ignored (the multigrid solver does not use over-relaxation),
+  // kept for the projects saved with it
+  node.add_attr<FloatAttribute>("omega", "omega (deprecated)", 1.8f, 1e-3f, 1.9f);
 
   // attribute(s) order
-  node.set_attr_ordered_key({"mask_threshold", "tolerance", "iterations", "omega"});
+  node.set_attr_ordered_key(
+      {"mask_threshold", "tolerance", "iterations", "_SEPARATOR_", "omega"});
 }
 
 void compute_water_depth_from_mask_node(BaseNode &node)
@@ -56,20 +60,21 @@ void compute_water_depth_from_mask_node(BaseNode &node)
     hmap::Heightmap *p_depth = node.get_value_ref<hmap::Heightmap>("water_depth");
 
     hmap::transform(
-        {p_depth, p_z, p_mask},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_depth},
+        {p_z, p_mask},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_depth = p_arrays[0];
-          hmap::Array *pa_z = p_arrays[1];
-          hmap::Array *pa_mask = p_arrays[2];
+          hmap::Array       *pa_depth = p_arrays_out[0];
+          const hmap::Array *pa_z = p_arrays_in[0];
+          const hmap::Array *pa_mask = p_arrays_in[1];
 
           *pa_depth = hmap::water_depth_from_mask(
               *pa_z,
               *pa_mask,
               node.get_attr<FloatAttribute>("mask_threshold"),
               node.get_attr<IntAttribute>("iterations"),
-              node.get_attr<FloatAttribute>("tolerance"),
-              node.get_attr<FloatAttribute>("omega"));
+              node.get_attr<FloatAttribute>("tolerance"));
         },
         node.get_config_ref()->hmap_transform_mode_cpu);
 
@@ -49,12 +49,14 @@ void compute_water_mask_node(BaseNode &node)
     hmap::Heightmap *p_mask = node.get_value_ref<hmap::Heightmap>("mask");
 
     hmap::transform(
-        {p_depth, p_z, p_mask},
-        [&node](std::vector<hmap::Array *> p_arrays)
+        {p_mask},
+        {p_depth, p_z},
+        [&node](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_depth = p_arrays[0];
-          hmap::Array *pa_z = p_arrays[1];
-          hmap::Array *pa_mask = p_arrays[2];
+          const hmap::Array *pa_depth = p_arrays_in[0];
+          const hmap::Array *pa_z = p_arrays_in[1];
+          hmap::Array       *pa_mask = p_arrays_out[0];
 
           float added_depth = node.get_attr<FloatAttribute>("additional_depth");
 
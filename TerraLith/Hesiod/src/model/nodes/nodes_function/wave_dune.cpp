@@ -46,13 +46,15 @@ void compute_wave_dune_node(BaseNode &node)
   hmap::Heightmap *p_out = node.get_value_ref<hmap::Heightmap>("output");
 
   hmap::transform(
-      {p_out, p_dr},
-      [&node](std::vector<hmap::Array *> p_arrays,
-              hmap::Vec2<int>            shape,
-              hmap::Vec4<float>          bbox)
+      {p_out},
+      {p_dr},
+      [&node](std::vector<hmap::Array *>       p_arrays_out,
+              std::vector<const hmap::Array *> p_arrays_in,
+              hmap::Vec2<int>                  shape,
+              hmap::Vec4<float>                bbox)
       {
-        hmap::Array *pa_out = p_arrays[0];
-        hmap::Array *pa_dr = p_arrays[1];
+        hmap::Array       *pa_out = p_arrays_out[0];
+        const hmap::Array *pa_dr = p_arrays_in[0];
 
         *pa_out = hmap::wave_dune(shape,
                                   node.get_attr<FloatAttribute>("kw"),
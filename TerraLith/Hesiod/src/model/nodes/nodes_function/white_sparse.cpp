@@ -61,11 +61,13 @@ void compute_white_sparse_node(BaseNode &node)
   {
     float hmin = p_out->min();
     hmap::transform(
-        {p_out, p_env},
-        [&hmin](std::vector<hmap::Array *> p_arrays)
+        {p_out},
+        {p_env},
+        [&hmin](std::vector<hmap::Array *>       p_arrays_out,
+                std::vector<const hmap::Array *> p_arrays_in)
         {
-          hmap::Array *pa_a = p_arrays[0];
-          hmap::Array *pa_b = p_arrays[1];
+          hmap::Array       *pa_a = p_arrays_out[0];
+          const hmap::Array *pa_b = p_arrays_in[0];
 
           *pa_a -= hmin;
           *pa_a *= *pa_b;
@@ -43,14 +43,19 @@ void compute_z_score_node(BaseNode &node)
 
     int ir = (int)(node.get_attr<FloatAttribute>("radius") * p_out->shape.x);
 
-    hmap::transform({p_out, p_in},
-                    [&node, ir](std::vector<hmap::Array *> p_arrays)
-                    {
-                      hmap::Array *pa_out = p_arrays[0];
-                      hmap::Array *pa_in = p_arrays[1];
-
-                      *pa_out = hmap::gpu::z_score(*pa_in, ir);
-                    });
+    hmap::transform(
+        {p_out},
+        {p_in},
+        [ir](std::vector<hmap::Array *>       p_arrays_out,
+             std::vector<const hmap::Array *> p_arrays_in)
+        {
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
+
+          *pa_out = hmap::z_score(*pa_in, ir);
+        },
+        node.get_config_ref()->hmap_transform_mode_cpu,
+        ir);
 
     p_out->smooth_overlap_buffers();
 
@@ -54,14 +54,16 @@ void compute_zeroed_edges_node(BaseNode &node)
     float sigma = node.get_attr<FloatAttribute>("sigma");
 
     hmap::transform(
-        {p_out, p_in, p_dr},
-        [&node, sigma](std::vector<hmap::Array *> p_arrays,
+        {p_out},
+        {p_in, p_dr},
+        [&node, sigma](std::vector<hmap::Array *>       p_arrays_out,
+                       std::vector<const hmap::Array *> p_arrays_in,
                        hmap::Vec2<int>,
-                       hmap::Vec4<float> bbox)
+                       hmap::Vec4<float>                bbox)
         {
-          hmap::Array *pa_out = p_arrays[0];
-          hmap::Array *pa_in = p_arrays[1];
-          hmap::Array *pa_dr = p_arrays[2];
+          hmap::Array       *pa_out = p_arrays_out[0];
+          const hmap::Array *pa_in = p_arrays_in[0];
+          const hmap::Array *pa_dr = p_arrays_in[1];
 
           *pa_out = *pa_in;
 
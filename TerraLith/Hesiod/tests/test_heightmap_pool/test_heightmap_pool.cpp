@@ -0,0 +1,111 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General Public
+   License. The full license is in the file LICENSE, distributed with this software. */
+#include <cstdlib>
+#include <iostream>
+
+#include "hesiod/model/graph/heightmap_pool.hpp"
+
+#define CHECK(cond)                                                                    \
+  if (!(cond))                                                                         \
+  {                                                                                    \
+    std::cerr << "FAILED: " << #cond << " (line " << __LINE__ << ")\n";                \
+    return EXIT_FAILURE;                                                               \
+  }
+
+int main()
+{
+  const hmap::Vec2<int> shape = {256, 256};
+  const hmap::Vec2<int> tiling = {4, 4};
+  const float           overlap = 0.25f;
+
+  hesiod::HeightmapPool pool;
+
+  // acquire / release round trip
+  hmap::Heightmap h1 = pool.acquire(&h1, shape, tiling, overlap);
+  hmap::Heightmap h2 = pool.acquire(&h2, shape, tiling, overlap);
+
+  const size_t nbytes = pool.get_allocated_bytes() / 2;
+
+  CHECK(nbytes > 0);
+  CHECK(pool.get_peak_bytes() == 2 * nbytes);
+
+  h1.tiles[0](0, 0) = 1.f;
+  pool.release(&h1, std::move(h1));
+
+  CHECK(pool.get_allocated_bytes() == nbytes);
+  CHECK(pool.get_pooled_bytes() == nbytes);
+
+  // recycled buffer is zero-filled
+  hmap::Heightmap h3 = pool.acquire(&h3, shape, tiling, overlap);
+
+  CHECK(pool.get_reuse_count() == 1);
+  CHECK(pool.get_pooled_bytes() == 0);
+  CHECK(h3.tiles[0](0, 0) == 0.f);
+  CHECK(pool.get_peak_bytes() == 2 * nbytes);
+
+  // heightmaps not acquired from the pool are pooled without accounting
+  hmap::Heightmap h_ext(shape, tiling, overlap);
+  pool.release(&h_ext, std::move(h_ext));
+
+  CHECK(pool.get_allocated_bytes() == 2 * nbytes);
+  CHECK(pool.get_pooled_bytes() == nbytes);
+
+  // shared (copy-on-write) buffers are dropped, not pooled
+  hmap::Heightmap h4 = h2;
+  pool.release(&h2, std::move(h2));
+
+  CHECK(pool.get_allocated_bytes() == nbytes);
+  CHECK(pool.get_pooled_bytes() == nbytes);
+
+  pool.release(&h3, std::move(h3));
+
+  CHECK(pool.get_allocated_bytes() == 0);
+  CHECK(pool.get_peak_bytes() == 2 * nbytes);
+
+  // the owner replaces the acquired buffer (e.g. '*p_out = *p_in') before
+  // releasing it, the acquired bytes are still deducted
+  hmap::Heightmap h5 = pool.acquire(&h5, shape, tiling, overlap);
+  h5 = hmap::Heightmap(shape, tiling, overlap);
+  pool.release(&h5, std::move(h5));
+
+  CHECK(pool.get_allocated_bytes() == 0);
+
+  // several buffers for the same owner (RGBA channels), deducted at once
+  std::vector<hmap::Heightmap> rgba;
+  for (int k = 0; k < 4; k++)
+    rgba.push_back(pool.acquire(&rgba, shape, tiling, overlap));
+
+  CHECK(pool.get_allocated_bytes() == 4 * nbytes);
+  CHECK(pool.get_peak_bytes() == 4 * nbytes);
+
+  rgba = std::vector<hmap::Heightmap>(4, hmap::Heightmap(shape, tiling, overlap));
+  for (auto &h : rgba)
+    pool.release(&rgba, std::move(h));
+
+  CHECK(pool.get_allocated_bytes() == 0);
+
+  pool.clear();
+  CHECK(pool.get_pooled_bytes() == 0);
+
+  // batch update of a chain of nodes replacing their outputs, as measured for
+  // the variant concurrency (VariantBaker): the peak is the two live outputs,
+  // not the number of nodes
+  hesiod::HeightmapPool        pool_chain;
+  std::vector<hmap::Heightmap> outputs(8);
+
+  for (size_t k = 0; k < outputs.size(); k++)
+  {
+    outputs[k] = pool_chain.acquire(&outputs[k], shape, tiling, overlap);
+    outputs[k] = k ? outputs[k - 1] : hmap::Heightmap(shape, tiling, overlap);
+
+    if (k)
+      pool_chain.release(&outputs[k - 1], std::move(outputs[k - 1]));
+  }
+
+  CHECK(pool_chain.get_peak_bytes() == 2 * nbytes);
+  CHECK(pool_chain.get_allocated_bytes() == nbytes);
+
+  std::cout << "test_heightmap_pool: OK\n";
+
+  return EXIT_SUCCESS;
+}
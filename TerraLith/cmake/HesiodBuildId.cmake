@@ -0,0 +1,17 @@
+# Script mode (cmake -P), run at build time to generate the build id header:
+#   -DGIT_EXECUTABLE=<git> -DSOURCE_DIR=<dir> -DOUTPUT=<header>
+# The id is empty if the sources are not a git checkout
+
+set(HESIOD_BUILD_ID "")
+
+if(GIT_EXECUTABLE)
+  execute_process(
+    COMMAND ${GIT_EXECUTABLE} describe --always --dirty --abbrev=12
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE HESIOD_BUILD_ID
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET)
+endif()
+
+# Use configure_file so it rewrites only if changed (no recompilation)
+configure_file("${CMAKE_CURRENT_LIST_DIR}/build_id.in" "${OUTPUT}" @ONLY)
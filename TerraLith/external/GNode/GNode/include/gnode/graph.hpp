@@ -172,6 +172,29 @@ public:
   void export_to_mermaid(const std::string &fname = "export.mmd",
                          const std::string &graph_label = "graph");
 
+  /**
+   * @brief Execute a task for each node of a topologically sorted node list,
+   * running concurrently the nodes whose upstream nodes (within the list) are
+   * done.
+   *
+   * Nodes are dispatched from a ready queue ordered by their position in
+   * `sorted_ids`. With a worker budget of 1 (see `set_max_workers`), the nodes
+   * are processed one at a time in the order of `sorted_ids`. If a task throws,
+   * no new node is dispatched and the first exception is rethrown once the
+   * running tasks are done.
+   *
+   * @param sorted_ids Node IDs, topologically sorted.
+   * @param node_task Task executed for each node ID (can be called from
+   * several threads at the same time).
+   * @param stop_requested Optional predicate polled before dispatching a node,
+   * the execution stops as soon as it returns `true`.
+   * @return true If all the nodes have been processed.
+   * @return false If the execution has been stopped.
+   */
+  bool execute_nodes(const std::vector<std::string>          &sorted_ids,
+                     std::function<void(const std::string &)> node_task,
+                     std::function<bool()> stop_requested = nullptr);
+
   /**
    * @brief Get the downstream connectivity of the graph.
    *
@@ -197,6 +220,13 @@ public:
 
   uint *get_id_count_ref() { return &this->id_count; }
 
+  /**
+   * @brief Get the maximum number of nodes computed at the same time.
+   *
+   * @return Worker budget.
+   */
+  int get_max_workers() const { return this->max_workers; }
+
   /**
    * @brief Get the link storage.
    *
@@ -283,6 +313,15 @@ public:
    * */
   void set_id_count(uint new_id_count) { this->id_count = new_id_count; }
 
+  /**
+   * @brief Set the maximum number of nodes computed at the same time during an
+   * update.
+   *
+   * @param new_max_workers Worker budget (1 for a serial update, 0 to use the
+   * hardware concurrency).
+   */
+  void set_max_workers(int new_max_workers);
+
   void set_update_callback(std::function<void(const std::string &,
                                               const std::vector<std::string> &,
                                               bool)> new_callback)
@@ -332,6 +371,11 @@ private:
    */
   std::string id = "";
 
+  /**
+   * @brief Maximum number of nodes computed at the same time.
+   */
+  int max_workers = 1;
+
   std::function<void(const std::string              &current_id,
                      const std::vector<std::string> &sorted_ids,
                      bool                            before_update)>
@@ -2,9 +2,14 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include <algorithm>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <queue>
+#include <set>
+#include <thread>
+#include <unordered_map>
 
 #include "demekgraph/updated/include/graph.hpp"
 #include "demekgraph/updated/include/layout.hpp"
@@ -124,6 +129,146 @@ std::vector<Point> Graph::compute_graph_layout_sugiyama()
   return points;
 }
 
+bool Graph::execute_nodes(
+    const std::vector<std::string>          &sorted_ids,
+    std::function<void(const std::string &)> node_task,
+    std::function<bool()>                    stop_requested)
+{
+  const size_t nnodes = sorted_ids.size();
+  const size_t nworkers = std::min(nnodes,
+                                   (size_t)std::max(1, this->max_workers));
+
+  // --- serial execution, in the order of the sorted list
+
+  if (nworkers <= 1)
+  {
+    for (auto &nid : sorted_ids)
+    {
+      if (stop_requested && stop_requested()) return false;
+      node_task(nid);
+    }
+    return true;
+  }
+
+  // --- ready-queue scheduler
+
+  // node indices in the sorted list, the ready queue is ordered by
+  // these indices so that the dispatching follows the topological
+  // order as much as possible
+  std::unordered_map<std::string, size_t> index;
+  for (size_t k = 0; k < nnodes; ++k)
+    index[sorted_ids[k]] = k;
+
+  // number of upstream nodes not done yet (only counting the nodes
+  // of the list) and downstream nodes within the list
+  std::vector<int>                 in_degree(nnodes, 0);
+  std::vector<std::vector<size_t>> downstream(nnodes);
+
+  for (auto &link : this->links)
+  {
+    auto it_from = index.find(link.from);
+    auto it_to = index.find(link.to);
+
+    if (it_from == index.end() || it_to == index.end()) continue;
+
+    // several links can join the same pair of nodes
+    if (contains(downstream[it_from->second], it_to->second)) continue;
+
+    downstream[it_from->second].push_back(it_to->second);
+    in_degree[it_to->second]++;
+  }
+
+  std::set<size_t> ready;
+  for (size_t k = 0; k < nnodes; ++k)
+    if (in_degree[k] == 0) ready.insert(k);
+
+  std::mutex              mtx;
+  std::condition_variable cv;
+  size_t                  ndone = 0;
+  size_t                  nrunning = 0;
+  bool                    stop = false;
+  std::exception_ptr      error = nullptr;
+
+  auto worker = [&]()
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+
+    while (true)
+    {
+      // wait for a node to be ready, or for the end of the update
+      // (all done, stop requested or nothing left that can be
+      // dispatched)
+      cv.wait(lock,
+              [&]()
+              {
+                return stop || !ready.empty() || ndone == nnodes ||
+                       nrunning == 0;
+              });
+
+      if (stop || ready.empty()) break;
+
+      size_t k = *ready.begin();
+      ready.erase(ready.begin());
+      nrunning++;
+
+      lock.unlock();
+
+      bool keep_going = !(stop_requested && stop_requested());
+
+      if (keep_going)
+      {
+        try
+        {
+          node_task(sorted_ids[k]);
+        }
+        catch (...)
+        {
+          keep_going = false;
+
+          std::lock_guard<std::mutex> error_lock(mtx);
+          if (!error) error = std::current_exception();
+        }
+      }
+
+      lock.lock();
+      nrunning--;
+
+      if (keep_going)
+      {
+        ndone++;
+        for (size_t kdw : downstream[k])
+          if (--in_degree[kdw] == 0) ready.insert(kdw);
+      }
+      else
+        stop = true;
+
+      cv.notify_all();
+    }
+
+    cv.notify_all();
+  };
+
+  Logger::log()->trace("Graph::execute_nodes: {} nodes, {} workers",
+                       nnodes,
+                       nworkers);
+
+  // the calling thread is also a worker
+  std::vector<std::thread> threads;
+  threads.reserve(nworkers - 1);
+
+  for (size_t k = 0; k < nworkers - 1; ++k)
+    threads.emplace_back(worker);
+
+  worker();
+
+  for (auto &t : threads)
+    t.join();
+
+  if (error) std::rethrow_exception(error);
+
+  return ndone == nnodes;
+}
+
 std::vector<std::string> Graph::get_nodes_to_update(const std::string &node_id)
 {
   if (this->is_node_id_available(node_id))
@@ -406,6 +551,14 @@ void Graph::remove_node(const std::string &id)
   this->nodes.erase(id);
 }
 
+void Graph::set_max_workers(int new_max_workers)
+{
+  if (new_max_workers <= 0)
+    this->max_workers = std::max(1, (int)std::thread::hardware_concurrency());
+  else
+    this->max_workers = new_max_workers;
+}
+
 std::vector<std::string> Graph::topological_sort(
     const std::vector<std::string> &dirty_node_ids)
 {
@@ -468,17 +621,30 @@ void Graph::update()
   for (auto &s : sorted_id)
     Logger::log()->trace("Graph::update: node id: {}", s);
 
-  for (auto nid : sorted_id)
+  // the callback is not required to be thread-safe
+  std::mutex callback_mtx;
+
+  auto node_task = [this, &sorted_id, &callback_mtx](const std::string &nid)
   {
-    if (this->update_callback) this->update_callback(nid, sorted_id, true);
+    if (this->update_callback)
+    {
+      std::lock_guard<std::mutex> lock(callback_mtx);
+      this->update_callback(nid, sorted_id, true);
+    }
 
     Logger::log()->trace("Updating node: {}({})",
                          this->get_node_ref_by_id(nid)->get_label(),
                          nid);
     this->get_node_ref_by_id(nid)->update();
 
-    if (this->update_callback) this->update_callback(nid, sorted_id, false);
-  }
+    if (this->update_callback)
+    {
+      std::lock_guard<std::mutex> lock(callback_mtx);
+      this->update_callback(nid, sorted_id, false);
+    }
+  };
+
+  this->execute_nodes(sorted_id, node_task);
 
   this->post_update();
 }
@@ -493,18 +659,35 @@ void Graph::update(const std::string &node_id)
 
   std::vector<std::string> sorted_id = this->get_nodes_to_update(node_id);
 
-  for (auto nid : sorted_id)
+  // mark all the nodes dirty beforehand, a node can then be picked up
+  // as soon as its upstream nodes are done
+  for (auto &nid : sorted_id)
+    this->get_node_ref_by_id(nid)->is_dirty = true;
+
+  // the callback is not required to be thread-safe
+  std::mutex callback_mtx;
+
+  auto node_task = [this, &sorted_id, &callback_mtx](const std::string &nid)
   {
-    if (this->update_callback) this->update_callback(nid, sorted_id, true);
+    if (this->update_callback)
+    {
+      std::lock_guard<std::mutex> lock(callback_mtx);
+      this->update_callback(nid, sorted_id, true);
+    }
 
     Logger::log()->trace("Graph::update: updating node: {}({})",
                          this->get_node_ref_by_id(nid)->get_label(),
                          nid);
-    this->get_node_ref_by_id(nid)->is_dirty = true;
     this->get_node_ref_by_id(nid)->update();
 
-    if (this->update_callback) this->update_callback(nid, sorted_id, false);
-  }
+    if (this->update_callback)
+    {
+      std::lock_guard<std::mutex> lock(callback_mtx);
+      this->update_callback(nid, sorted_id, false);
+    }
+  };
+
+  this->execute_nodes(sorted_id, node_task);
 
   this->post_update();
 }
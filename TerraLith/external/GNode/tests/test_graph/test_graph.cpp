@@ -74,5 +74,18 @@ int main()
   // g.print();
   // g.export_to_graphviz();
 
+  // independent branches are computed concurrently, the result must
+  // be the same as the serial update
+  std::cout << "\nPARALLEL UPDATE\n";
+
+  g.set_max_workers(4);
+  g.update();
+
+  float sum = *g.get_node_ref_by_id<Add>(id_add2)->get_value_ref<float>(
+      "a + b");
+  std::cout << "parallel update sum: " << sum << "\n";
+
+  if (sum != 16.f) return 1;
+
   return 0;
 }
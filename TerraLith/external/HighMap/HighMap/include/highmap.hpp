@@ -22,6 +22,7 @@
 #include "highmap/coord_frame.hpp"
 #include "highmap/curvature.hpp"
 #include "highmap/erosion.hpp"
+#include "highmap/execution_context.hpp"
 #include "highmap/export.hpp"
 #include "highmap/features.hpp"
 #include "highmap/filters.hpp"
@@ -56,4 +57,5 @@
 #include "highmap/shortest_path.hpp"
 #include "highmap/synthesis.hpp"
 #include "highmap/tensor.hpp"
+#include "highmap/tile_store.hpp"
 #include "highmap/transform.hpp"
@@ -101,6 +101,37 @@ Array blend_negate(const Array &array1, const Array &array2);
  */
 Array blend_overlay(const Array &array1, const Array &array2);
 
+/**
+ * @brief Blends two arrays using Poisson (gradient-domain) blending.
+ *
+ * The output has the Laplacian of @p array2 and the values of @p array1 on the
+ * array borders and outside the mask, i.e. the details of @p array2 are
+ * seamlessly transferred onto @p array1. The Poisson equation is solved using
+ * a multigrid solver, see solve_poisson_multigrid.
+ *
+ * @param  array1     First input array (base values).
+ * @param  array2     Second input array (details).
+ * @param  p_mask     Optional pointer to the blending mask, expected in [0,
+ *                    1]. Cells with a zero mask value keep the values of @p
+ *                    array1. If null, blending is applied globally.
+ * @param  cycles_max Maximum number of multigrid V-cycles.
+ * @param  tolerance  Relative reduction of the residual to reach.
+ * @return            The blended array.
+ *
+ * **Example**
+ * @include ex_blend_poisson.cpp
+ *
+ * **Result**
+ * @image html ex_blend_poisson.png
+ *
+ * @see               gpu::blend_poisson_bf
+ */
+Array blend_poisson(const Array &array1,
+                    const Array &array2,
+                    const Array *p_mask = nullptr,
+                    int          cycles_max = 50,
+                    float        tolerance = 1e-4f);
+
 /**
  * @brief Return the 'soft' blending of two arrays.
  *
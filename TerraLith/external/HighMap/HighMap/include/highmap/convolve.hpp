@@ -31,6 +31,8 @@ namespace hmap
  * This function applies a 1D convolution to the input array using the provided
  * kernel, considering the convolution in the row direction ('i' direction).
  *
+ * Kernels with more than 64 elements are applied with the FFT.
+ *
  * @param  array  Input array to be convolved.
  * @param  kernel 1D kernel to be used for the convolution.
  * @return        Array Resulting array after applying the 1D convolution.
@@ -52,6 +54,8 @@ Array convolve1d_i(const Array &array, const std::vector<float> &kernel);
  * This function applies a 1D convolution to the input array using the provided
  * kernel, considering the convolution in the column direction ('j' direction).
  *
+ * Kernels with more than 64 elements are applied with the FFT.
+ *
  * @param  array  Input array to be convolved.
  * @param  kernel 1D kernel to be used for the convolution.
  * @return        Array Resulting array after applying the 1D convolution.
@@ -15,8 +15,10 @@
  */
 #pragma once
 #include <cmath>
+#include <string>
 
 #include "highmap/array.hpp"
+#include "highmap/heightmap.hpp"
 
 // neighbor pattern search based on Moore pattern and define diagonal
 // weight coefficients ('c' corresponds to a weight coefficient
@@ -167,15 +169,20 @@ void coastal_erosion_profile(Array       &z,
                              Array *p_shore_mask = nullptr);
 
 /**
- * @brief Fill the depressions of the heightmap using the Planchon-Darboux
+ * @brief Fill the depressions of the heightmap using the priority-flood
  * algorithm.
  *
  * Fill heightmap depressions to ensure that every cell can be connected to the
- * boundaries following a downward slope @cite Planchon2002.
+ * boundaries following a downward slope @cite Barnes2014. The cells are
+ * processed in a single pass, from the lowest to the highest, starting from
+ * the domain borders. Each filled cell, i.e. a cell not higher than the cell
+ * it drains to, is raised `epsilon` above it so that no flat area is left,
+ * the cells outside the depressions are not modified.
  *
- * @param z          Input array.
- * @param iterations Number of iterations.
- * @param epsilon
+ * @param z       Input array.
+ * @param epsilon Minimum elevation difference between a filled cell and its
+ *                downstream neighbor (scaled by the neighbor distance for
+ *                diagonal neighbors).
  *
  * **Example**
  * @include ex_depression_filling.cpp
@@ -183,7 +190,7 @@ void coastal_erosion_profile(Array       &z,
  * **Result**
  * @image html ex_depression_filling.png
  */
-void depression_filling(Array &z, int iterations = 1000, float epsilon = 1e-4f);
+void depression_filling(Array &z, float epsilon = 1e-4f);
 
 /**
  * @brief
@@ -410,6 +417,16 @@ void hydraulic_musgrave(Array &z,
  * @param c_erosion          Erosion coefficient.
  * @param drag_rate          Drag rate.
  * @param evap_rate          Particle evaporation rate.
+ * @param post_filtering     Apply a light Laplace smoothing at the end.
+ * @param nthreads           Maximum number of threads used (0 for all the
+ *                           threads of the pool). The result does not depend
+ *                           on this number.
+ *
+ * The particles are advanced by batches of a few steps, bucketed by square
+ * tiles. Tiles that are not adjacent are processed in parallel (4 colors
+ * depending on the parity of the tile indices) and the particles within a
+ * tile in their index order, so that the result is reproducible for a given
+ * seed.
  *
  * **Example**
  * @include ex_hydraulic_particle.cpp
@@ -418,36 +435,38 @@ void hydraulic_musgrave(Array &z,
  * @image html ex_hydraulic_particle0.png
  * @image html ex_hydraulic_particle1.png
  */
-void hydraulic_particle(Array &z,
-                        Array *p_mask,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock = nullptr,
-                        Array *p_moisture_map = nullptr,
-                        Array *p_erosion_map = nullptr,    // -> out
-                        Array *p_deposition_map = nullptr, // -> out
-                        float  c_capacity = 10.f,
-                        float  c_erosion = 0.05f,
-                        float  c_deposition = 0.05f,
-                        float  c_inertia = 0.3f,
-                        float  drag_rate = 0.001f,
-                        float  evap_rate = 0.001f,
-                        bool   post_filtering = false);
-
-void hydraulic_particle(Array &z,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock = nullptr,
-                        Array *p_moisture_map = nullptr,
-                        Array *p_erosion_map = nullptr,    // -> out
-                        Array *p_deposition_map = nullptr, // -> out
-                        float  c_capacity = 10.f,
-                        float  c_erosion = 0.05f,
-                        float  c_deposition = 0.05f,
-                        float  c_inertia = 0.3f,
-                        float  drag_rate = 0.001f,
-                        float  evap_rate = 0.001f,
-                        bool   post_filtering = false); ///< @overload
+void hydraulic_particle(Array       &z,
+                        const Array *p_mask,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock = nullptr,
+                        const Array *p_moisture_map = nullptr,
+                        Array       *p_erosion_map = nullptr,    // -> out
+                        Array       *p_deposition_map = nullptr, // -> out
+                        float        c_capacity = 10.f,
+                        float        c_erosion = 0.05f,
+                        float        c_deposition = 0.05f,
+                        float        c_inertia = 0.3f,
+                        float        drag_rate = 0.001f,
+                        float        evap_rate = 0.001f,
+                        bool         post_filtering = false,
+                        int          nthreads = 0);
+
+void hydraulic_particle(Array       &z,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock = nullptr,
+                        const Array *p_moisture_map = nullptr,
+                        Array       *p_erosion_map = nullptr,    // -> out
+                        Array       *p_deposition_map = nullptr, // -> out
+                        float        c_capacity = 10.f,
+                        float        c_erosion = 0.05f,
+                        float        c_deposition = 0.05f,
+                        float        c_inertia = 0.3f,
+                        float        drag_rate = 0.001f,
+                        float        evap_rate = 0.001f,
+                        bool         post_filtering = false,
+                        int          nthreads = 0); ///< @overload
 
 /**
  * @brief Apply hydraulic erosion using a particle based procedure, using a
@@ -562,7 +581,7 @@ void hydraulic_procedural(
     bool           rotate90 = false,
     bool           use_default_mask = true,
     float          talus_mask = 0.f,
-    Array         *p_mask = nullptr,
+    const Array   *p_mask = nullptr,
     Array         *p_ridge_mask = nullptr,
     float          vmin = 0.f,
     float          vmax = -1.f);
@@ -586,6 +605,9 @@ void hydraulic_procedural(
  * @param ir                 Kernel radius. If `ir > 1`, a cone kernel is used
  *                           to carv channel flow erosion.
  * @param clipping_ratio     Flow accumulation clipping ratio.
+ * @param fill_depressions   Whether the depressions are filled before computing
+ *                           the flow accumulation (see
+ * {@link depression_filling}), otherwise the flow stops in the local minima.
  *
  * **Example**
  * @include ex_hydraulic_stream.cpp
@@ -594,24 +616,26 @@ void hydraulic_procedural(
  * @image html ex_hydraulic_stream0.png
  * @image html ex_hydraulic_stream1.png
  */
-void hydraulic_stream(Array &z,
-                      float  c_erosion,
-                      float  talus_ref,
-                      Array *p_bedrock = nullptr,
-                      Array *p_moisture_map = nullptr,
-                      Array *p_erosion_map = nullptr, // -> out
-                      int    ir = 1,
-                      float  clipping_ratio = 10.f);
-
-void hydraulic_stream(Array &z,
-                      Array *p_mask,
-                      float  c_erosion,
-                      float  talus_ref,
-                      Array *p_bedrock = nullptr,
-                      Array *p_moisture_map = nullptr,
-                      Array *p_erosion_map = nullptr, // -> out
-                      int    ir = 1,
-                      float  clipping_ratio = 10.f); ///< @overload
+void hydraulic_stream(Array       &z,
+                      float        c_erosion,
+                      float        talus_ref,
+                      const Array *p_bedrock = nullptr,
+                      const Array *p_moisture_map = nullptr,
+                      Array       *p_erosion_map = nullptr, // -> out
+                      int          ir = 1,
+                      float        clipping_ratio = 10.f,
+                      bool         fill_depressions = false);
+
+void hydraulic_stream(Array       &z,
+                      const Array *p_mask,
+                      float        c_erosion,
+                      float        talus_ref,
+                      const Array *p_bedrock = nullptr,
+                      const Array *p_moisture_map = nullptr,
+                      Array       *p_erosion_map = nullptr, // -> out
+                      int          ir = 1,
+                      float        clipping_ratio = 10.f,
+                      bool         fill_depressions = false); ///< @overload
 
 /**
  * @brief Applies hydraulic erosion with upscaling amplification.
@@ -734,36 +758,90 @@ void hydraulic_stream_upscale_amplification(
  * @image html ex_hydraulic_stream0.png
  * @image html ex_hydraulic_stream1.png
  */
-void hydraulic_stream_log(Array &z,
-                          float  c_erosion,
-                          float  talus_ref,
-                          int    deposition_ir = 32,
-                          float  deposition_scale_ratio = 1.f,
-                          float  gradient_power = 0.8f,
-                          float  gradient_scaling_ratio = 1.f,
-                          int    gradient_prefilter_ir = 16,
-                          float  saturation_ratio = 1.f,
-                          Array *p_bedrock = nullptr,
-                          Array *p_moisture_map = nullptr,
-                          Array *p_erosion_map = nullptr,
-                          Array *p_deposition_map = nullptr,
-                          Array *p_flow_map = nullptr);
-
-void hydraulic_stream_log(Array &z,
-                          float  c_erosion,
-                          float  talus_ref,
-                          Array *p_mask,
-                          int    deposition_ir = 32,
-                          float  deposition_scale_ratio = 1.f,
-                          float  gradient_power = 0.8f,
-                          float  gradient_scaling_ratio = 1.f,
-                          int    gradient_prefilter_ir = 16,
-                          float  saturation_ratio = 1.f,
-                          Array *p_bedrock = nullptr,
-                          Array *p_moisture_map = nullptr,
-                          Array *p_erosion_map = nullptr,
-                          Array *p_deposition_map = nullptr,
-                          Array *p_flow_map = nullptr); ///< @overload
+void hydraulic_stream_log(Array       &z,
+                          float        c_erosion,
+                          float        talus_ref,
+                          int          deposition_ir = 32,
+                          float        deposition_scale_ratio = 1.f,
+                          float        gradient_power = 0.8f,
+                          float        gradient_scaling_ratio = 1.f,
+                          int          gradient_prefilter_ir = 16,
+                          float        saturation_ratio = 1.f,
+                          const Array *p_bedrock = nullptr,
+                          const Array *p_moisture_map = nullptr,
+                          Array       *p_erosion_map = nullptr,
+                          Array       *p_deposition_map = nullptr,
+                          Array       *p_flow_map = nullptr);
+
+void hydraulic_stream_log(Array       &z,
+                          float        c_erosion,
+                          float        talus_ref,
+                          const Array *p_mask,
+                          int          deposition_ir = 32,
+                          float        deposition_scale_ratio = 1.f,
+                          float        gradient_power = 0.8f,
+                          float        gradient_scaling_ratio = 1.f,
+                          int          gradient_prefilter_ir = 16,
+                          float        saturation_ratio = 1.f,
+                          const Array *p_bedrock = nullptr,
+                          const Array *p_moisture_map = nullptr,
+                          Array       *p_erosion_map = nullptr,
+                          Array       *p_deposition_map = nullptr,
+                          Array       *p_flow_map = nullptr); ///< @overload
+
+/**
+ * @brief State of the 'virtual pipes' hydraulic erosion solver (water and
+ * suspended sediment heights, outflow fluxes), persistent between calls.
+ *
+ * The state is initialized by the solver if its shape does not match the
+ * heightmap shape. It can be saved to a file with the heightmap and reloaded
+ * later to resume a simulation, e.g. to split long simulations across several
+ * runs.
+ */
+struct VpipesState
+{
+  Array d;             ///< Water height.
+  Array s;             ///< Suspended sediment height.
+  Array fl;            ///< Outflow flux, left.
+  Array fr;            ///< Outflow flux, right.
+  Array ft;            ///< Outflow flux, top.
+  Array fb;            ///< Outflow flux, bottom.
+  int   iteration = 0; ///< Number of iterations already performed.
+
+  /**
+   * @brief Load a checkpoint (state and heightmap) from a binary file.
+   *
+   * The header is validated (signature, version, bounded shape) and the
+   * file size must match it, otherwise nothing is loaded: the state and the
+   * heightmap are only modified once the whole checkpoint has been read.
+   *
+   * @param  fname File name.
+   * @param  z     [out] Heightmap at the checkpoint.
+   * @return       True if the checkpoint has been loaded.
+   */
+  bool from_file(const std::string &fname, Array &z);
+
+  /**
+   * @brief Save a checkpoint (state and heightmap) to a binary file.
+   *
+   * @param  fname File name.
+   * @param  z     Heightmap at the current iteration.
+   * @return       True if the checkpoint has been saved.
+   */
+  bool to_file(const std::string &fname, const Array &z) const;
+};
+
+/**
+ * @brief Wall-clock time (in ms) spent in each phase of the 'virtual pipes'
+ * hydraulic erosion solver, accumulated over the calls.
+ */
+struct VpipesTimings
+{
+  float flux = 0.f;      ///< Rain and outflow fluxes.
+  float transport = 0.f; ///< Water transport and flow velocities.
+  float erosion = 0.f;   ///< Slope, erosion and deposition.
+  float advection = 0.f; ///< Sediment advection and evaporation.
+};
 
 /**
  * @brief Apply hydraulic erosion using the 'virtual pipes' algorithm.
@@ -820,6 +898,53 @@ void hydraulic_vpipes(Array &z,
                       float  rain_rate = 0.f,
                       float  evap_rate = 0.01f); ///< @overload
 
+/**
+ * @brief Apply hydraulic erosion using the 'virtual pipes' algorithm, starting
+ * from and updating a persistent solver state.
+ *
+ * The solver works in place on the state and on a few work arrays allocated
+ * once per call, each iteration being made of 4 passes over the rows of the
+ * array (fluxes, water transport, erosion, sediment advection) processed in
+ * parallel.
+ *
+ * The execution context (see {@link ExecutionContext}) is polled before each
+ * iteration, a cancelled simulation can then be resumed with the same state.
+ *
+ * @see                    {@link hydraulic_vpipes}
+ *
+ * @param z                Input array.
+ * @param state            Solver state (initialized if its shape does not
+ *                         match the input array shape).
+ * @param iterations       Number of iterations.
+ * @param p_bedrock        Lower elevation limit.
+ * @param p_moisture_map   Reference to the moisture map (quantity of rain),
+ *                         expected to be in [0, 1].
+ * @param water_height     Water height.
+ * @param c_capacity       Sediment capacity.
+ * @param c_erosion        Erosion coefficient.
+ * @param c_deposition     Deposition coefficient.
+ * @param rain_rate        Rain rate.
+ * @param evap_rate        Particle evaporation rate.
+ * @param p_timings        [out] Reference to the timings of the solver phases,
+ *                         accumulated (if not nullptr).
+ *
+ * **Example**
+ * @include ex_hydraulic_vpipes_resume.cpp
+ * @include ex_execution_context.cpp
+ */
+void hydraulic_vpipes(Array         &z,
+                      VpipesState   &state,
+                      int            iterations,
+                      Array         *p_bedrock = nullptr,
+                      Array         *p_moisture_map = nullptr,
+                      float          water_height = 0.1f,
+                      float          c_capacity = 0.1f,
+                      float          c_erosion = 0.05f,
+                      float          c_deposition = 0.05f,
+                      float          rain_rate = 0.f,
+                      float          evap_rate = 0.01f,
+                      VpipesTimings *p_timings = nullptr);
+
 /**
  * @brief Perform sediment deposition combined with thermal erosion.
  *
@@ -928,33 +1053,33 @@ void sediment_layer(Array       &z,
  * @image html ex_stratify.png
  */
 void stratify(Array             &z,
-              Array             *p_mask,
+              const Array       *p_mask,
               std::vector<float> hs,
               std::vector<float> gamma,
-              Array             *p_noise = nullptr);
+              const Array       *p_noise = nullptr);
 
 void stratify(Array             &z,
               std::vector<float> hs,
               std::vector<float> gamma,
-              Array             *p_noise = nullptr); ///< @overload
+              const Array       *p_noise = nullptr); ///< @overload
 
 void stratify(Array             &z,
               std::vector<float> hs,
               float              gamma = 0.5f,
-              Array             *p_noise = nullptr); ///< @overload
-
-void stratify(Array &z,
-              Array &partition,
-              int    nstrata,
-              float  strata_noise,
-              float  gamma,
-              float  gamma_noise,
-              int    npartitions,
-              uint   seed,
-              float  mixing_gain_factor = 1.f,
-              Array *p_noise = nullptr,
-              float  vmin = 1.f,
-              float  vmax = 0.f); ///< @overload
+              const Array       *p_noise = nullptr); ///< @overload
+
+void stratify(Array       &z,
+              Array       &partition,
+              int          nstrata,
+              float        strata_noise,
+              float        gamma,
+              float        gamma_noise,
+              int          npartitions,
+              uint         seed,
+              float        mixing_gain_factor = 1.f,
+              const Array *p_noise = nullptr,
+              float        vmin = 1.f,
+              float        vmax = 0.f); ///< @overload
 
 /**
  * @brief Stratify the heightmap by creating a multiscale series of layers with
@@ -1030,6 +1155,10 @@ void stratify_oblique(Array             &z,
  *
  * Based on https://www.shadertoy.com/view/XtKSWh
  *
+ * The cells are updated in place, color by color (4 colors given by the
+ * parities of the cell indices, such that the 8 neighbors of a cell have
+ * another color), the cells of a color being updated in parallel.
+ *
  * @param z                Input array.
  * @param p_mask           Filter mask, expected in [0, 1].
  * @param talus            Talus limit.
@@ -1037,6 +1166,9 @@ void stratify_oblique(Array             &z,
  * @param p_deposition_map [out] Reference to the deposition map, provided as an
  *                         output field.
  * @param iterations       Number of iterations.
+ * @param legacy_sweep     Use the former serial sweep (rotating row / column
+ *                         order) instead of the parallel color ordering, to
+ *                         reproduce previous results exactly.
  *
  * **Example**
  * @include ex_thermal.cpp
@@ -1045,23 +1177,26 @@ void stratify_oblique(Array             &z,
  * @image html ex_thermal.png
  */
 void thermal(Array       &z,
-             Array       *p_mask,
+             const Array *p_mask,
              const Array &talus,
              int          iterations = 10,
-             Array       *p_bedrock = nullptr,
-             Array       *p_deposition_map = nullptr);
+             const Array *p_bedrock = nullptr,
+             Array       *p_deposition_map = nullptr,
+             bool         legacy_sweep = false);
 
 void thermal(Array       &z,
              const Array &talus,
              int          iterations = 10,
-             Array       *p_bedrock = nullptr,
-             Array       *p_deposition_map = nullptr);
+             const Array *p_bedrock = nullptr,
+             Array       *p_deposition_map = nullptr,
+             bool         legacy_sweep = false);
 
-void thermal(Array &z,
-             float  talus,
-             int    iterations = 10,
-             Array *p_bedrock = nullptr,
-             Array *p_deposition_map = nullptr); ///< @overload
+void thermal(Array       &z,
+             float        talus,
+             int          iterations = 10,
+             const Array *p_bedrock = nullptr,
+             Array       *p_deposition_map = nullptr,
+             bool         legacy_sweep = false); ///< @overload
 
 /**
  * @brief Apply thermal weathering erosion with automatic determination of the
@@ -1094,11 +1229,11 @@ void thermal_auto_bedrock(Array &z,
                           int    iterations = 10,
                           Array *p_deposition_map = nullptr); ///< @overload
 
-void thermal_auto_bedrock(Array &z,
-                          Array *p_mask,
-                          float  talus,
-                          int    iterations = 10,
-                          Array *p_deposition_map = nullptr); ///< @overload
+void thermal_auto_bedrock(Array       &z,
+                          const Array *p_mask,
+                          float        talus,
+                          int          iterations = 10,
+                          Array       *p_deposition_map = nullptr); ///< @overload
 
 /**
  * @brief Apply modified thermal weathering of Olsen.
@@ -1239,37 +1374,37 @@ namespace hmap::gpu
 {
 
 /*! @brief See hmap::hydraulic_particle */
-void hydraulic_particle(Array &z,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock = nullptr,
-                        Array *p_moisture_map = nullptr,
-                        Array *p_erosion_map = nullptr,
-                        Array *p_deposition_map = nullptr,
-                        float  c_capacity = 10.f,
-                        float  c_erosion = 0.05f,
-                        float  c_deposition = 0.05f,
-                        float  c_inertia = 0.3f,
-                        float  drag_rate = 0.001f,
-                        float  evap_rate = 0.001f,
-                        bool   post_filtering = false);
+void hydraulic_particle(Array       &z,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock = nullptr,
+                        const Array *p_moisture_map = nullptr,
+                        Array       *p_erosion_map = nullptr,
+                        Array       *p_deposition_map = nullptr,
+                        float        c_capacity = 10.f,
+                        float        c_erosion = 0.05f,
+                        float        c_deposition = 0.05f,
+                        float        c_inertia = 0.3f,
+                        float        drag_rate = 0.001f,
+                        float        evap_rate = 0.001f,
+                        bool         post_filtering = false);
 
 /*! @brief See hmap::hydraulic_particle */
-void hydraulic_particle(Array &z,
-                        Array *p_mask,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock = nullptr,
-                        Array *p_moisture_map = nullptr,
-                        Array *p_erosion_map = nullptr,
-                        Array *p_deposition_map = nullptr,
-                        float  c_capacity = 10.f,
-                        float  c_erosion = 0.05f,
-                        float  c_deposition = 0.05f,
-                        float  c_inertia = 0.3f,
-                        float  drag_rate = 0.001f,
-                        float  evap_rate = 0.001f,
-                        bool   post_filtering = false);
+void hydraulic_particle(Array       &z,
+                        const Array *p_mask,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock = nullptr,
+                        const Array *p_moisture_map = nullptr,
+                        Array       *p_erosion_map = nullptr,
+                        Array       *p_deposition_map = nullptr,
+                        float        c_capacity = 10.f,
+                        float        c_erosion = 0.05f,
+                        float        c_deposition = 0.05f,
+                        float        c_inertia = 0.3f,
+                        float        drag_rate = 0.001f,
+                        float        evap_rate = 0.001f,
+                        bool         post_filtering = false);
 
 /**
  * @brief Simulates hydraulic erosion and deposition on a heightmap using the
@@ -1333,7 +1468,7 @@ void hydraulic_schott(Array       &z,
 void hydraulic_schott(Array       &z,
                       int          iterations,
                       const Array &talus,
-                      Array       *p_mask,
+                      const Array *p_mask,
                       float        c_erosion = 1.f,
                       float        c_thermal = 0.1f,
                       float        c_deposition = 0.2f,
@@ -1345,36 +1480,36 @@ void hydraulic_schott(Array       &z,
                       Array       *p_flow = nullptr); ///< @overload
 
 /*! @brief See hmap::hydraulic_stream_log */
-void hydraulic_stream_log(Array &z,
-                          float  c_erosion,
-                          float  talus_ref,
-                          int    deposition_ir = 32,
-                          float  deposition_scale_ratio = 1.f,
-                          float  gradient_power = 0.8f,
-                          float  gradient_scaling_ratio = 1.f,
-                          int    gradient_prefilter_ir = 16,
-                          float  saturation_ratio = 1.f,
-                          Array *p_bedrock = nullptr,
-                          Array *p_moisture_map = nullptr,
-                          Array *p_erosion_map = nullptr,
-                          Array *p_deposition_map = nullptr,
-                          Array *p_flow_map = nullptr);
-
-void hydraulic_stream_log(Array &z,
-                          float  c_erosion,
-                          float  talus_ref,
-                          Array *p_mask,
-                          int    deposition_ir = 32,
-                          float  deposition_scale_ratio = 1.f,
-                          float  gradient_power = 0.8f,
-                          float  gradient_scaling_ratio = 1.f,
-                          int    gradient_prefilter_ir = 16,
-                          float  saturation_ratio = 1.f,
-                          Array *p_bedrock = nullptr,
-                          Array *p_moisture_map = nullptr,
-                          Array *p_erosion_map = nullptr,
-                          Array *p_deposition_map = nullptr,
-                          Array *p_flow_map = nullptr); ///< @overload
+void hydraulic_stream_log(Array       &z,
+                          float        c_erosion,
+                          float        talus_ref,
+                          int          deposition_ir = 32,
+                          float        deposition_scale_ratio = 1.f,
+                          float        gradient_power = 0.8f,
+                          float        gradient_scaling_ratio = 1.f,
+                          int          gradient_prefilter_ir = 16,
+                          float        saturation_ratio = 1.f,
+                          const Array *p_bedrock = nullptr,
+                          const Array *p_moisture_map = nullptr,
+                          Array       *p_erosion_map = nullptr,
+                          Array       *p_deposition_map = nullptr,
+                          Array       *p_flow_map = nullptr);
+
+void hydraulic_stream_log(Array       &z,
+                          float        c_erosion,
+                          float        talus_ref,
+                          const Array *p_mask,
+                          int          deposition_ir = 32,
+                          float        deposition_scale_ratio = 1.f,
+                          float        gradient_power = 0.8f,
+                          float        gradient_scaling_ratio = 1.f,
+                          int          gradient_prefilter_ir = 16,
+                          float        saturation_ratio = 1.f,
+                          const Array *p_bedrock = nullptr,
+                          const Array *p_moisture_map = nullptr,
+                          Array       *p_erosion_map = nullptr,
+                          Array       *p_deposition_map = nullptr,
+                          Array       *p_flow_map = nullptr); ///< @overload
 
 /**
  * @brief Applies a "rift" deformation effect to a heightmap array.
@@ -1532,23 +1667,23 @@ void strata(Array             &z,
 void thermal(Array       &z,
              const Array &talus,
              int          iterations = 10,
-             Array       *p_bedrock = nullptr,
+             const Array *p_bedrock = nullptr,
              Array       *p_deposition_map = nullptr);
 
 /*! @brief See hmap::thermal */
 void thermal(Array       &z,
-             Array       *p_mask,
+             const Array *p_mask,
              const Array &talus,
              int          iterations = 10,
-             Array       *p_bedrock = nullptr,
+             const Array *p_bedrock = nullptr,
              Array       *p_deposition_map = nullptr);
 
 /*! @brief See hmap::thermal */
-void thermal(Array &z,
-             float  talus,
-             int    iterations = 10,
-             Array *p_bedrock = nullptr,
-             Array *p_deposition_map = nullptr);
+void thermal(Array       &z,
+             float        talus,
+             int          iterations = 10,
+             const Array *p_bedrock = nullptr,
+             Array       *p_deposition_map = nullptr);
 
 /*! @brief See hmap::thermal_auto_bedrock */
 void thermal_auto_bedrock(Array       &z,
@@ -1558,7 +1693,7 @@ void thermal_auto_bedrock(Array       &z,
 
 /*! @brief See hmap::thermal_auto_bedrock */
 void thermal_auto_bedrock(Array       &z,
-                          Array       *p_mask,
+                          const Array *p_mask,
                           const Array &talus,
                           int          iterations = 10,
                           Array       *p_deposition_map = nullptr);
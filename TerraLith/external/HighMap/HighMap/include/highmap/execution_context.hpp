@@ -0,0 +1,139 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+   Public License. The full license is in the file LICENSE, distributed with
+   this software. */
+
+/**
+ * @file execution_context.hpp
+ * @author  Otto Link (otto.link.bv@gmail.com)
+ * @brief Header file for the optional execution context (cancellation token
+ * and progress sink) polled by the long-running operators.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include <functional>
+#include <stdexcept>
+
+namespace hmap
+{
+
+/**
+ * @brief Exception thrown by the operators when the execution context they
+ * poll has been cancelled. The output arrays are then left in an unspecified
+ * (but valid) state.
+ */
+class OperationCancelled : public std::runtime_error
+{
+public:
+  OperationCancelled() : std::runtime_error("operation cancelled") {}
+};
+
+/**
+ * @brief The ExecutionContext class gathers a cancellation token and a
+ * progress sink, polled by the long-running operators (erosion, flooding,
+ * quilting...) at iteration granularity.
+ *
+ * The context is not passed as an argument but installed for the calling
+ * thread with a `ScopedExecutionContext`. It is forwarded to the tasks
+ * submitted to the thread pool through a `TaskGroup`, including the tiles of a
+ * distributed `transform`. Without a context, polling does nothing.
+ *
+ * ### Usage Example:
+ *
+ * @code
+ * std::atomic<bool> cancel = false;
+ *
+ * hmap::ExecutionContext ctx([&cancel]() { return cancel.load(); },
+ *                            [](float p) { std::cout << p << "\n"; });
+ *
+ * hmap::ScopedExecutionContext scope(&ctx);
+ *
+ * try
+ * {
+ *   hmap::hydraulic_vpipes(z, 2000);
+ * }
+ * catch (const hmap::OperationCancelled &)
+ * {
+ *   // z is not usable
+ * }
+ * @endcode
+ */
+class ExecutionContext
+{
+public:
+  ExecutionContext() = default;
+
+  /**
+   * @brief Constructs a new ExecutionContext object.
+   *
+   * @param cancel_requested Cancellation token, returns true when the
+   * operators must stop (can be called from several threads at the same time).
+   * @param progress Progress sink, called with the progress of the running
+   * operator in [0, 1] (can be called from several threads at the same time).
+   */
+  ExecutionContext(std::function<bool()>      cancel_requested,
+                   std::function<void(float)> progress = nullptr);
+
+  /**
+   * @brief Returns true if the cancellation has been requested.
+   */
+  bool is_cancel_requested() const;
+
+  /**
+   * @brief Reports the progress of the running operator.
+   *
+   * @param progress Progress in [0, 1]. For a tiled computation, this is the
+   * progress of the calling tile.
+   */
+  void report_progress(float progress) const;
+
+private:
+  std::function<bool()>      cancel_requested = nullptr;
+  std::function<void(float)> progress = nullptr;
+};
+
+/**
+ * @brief Installs an execution context for the calling thread for the lifetime
+ * of the object, restoring the previous one (if any) on destruction.
+ */
+class ScopedExecutionContext
+{
+public:
+  /**
+   * @brief Constructs a new ScopedExecutionContext object.
+   *
+   * @param p_context Reference to the context (can be nullptr to remove the
+   * current context), must outlive the scope.
+   */
+  explicit ScopedExecutionContext(const ExecutionContext *p_context);
+
+  ~ScopedExecutionContext();
+
+  ScopedExecutionContext(const ScopedExecutionContext &) = delete;
+  ScopedExecutionContext &operator=(const ScopedExecutionContext &) = delete;
+
+private:
+  const ExecutionContext *p_previous; ///< Context restored on destruction.
+};
+
+/**
+ * @brief Returns the execution context of the calling thread.
+ *
+ * @return const ExecutionContext* Reference to the context, nullptr if none.
+ */
+const ExecutionContext *get_execution_context();
+
+/**
+ * @brief Polls the execution context of the calling thread: reports the
+ * progress and throws if the cancellation has been requested. Meant to be
+ * called by the operators once per iteration.
+ *
+ * @param progress Progress of the operator in [0, 1], a negative value is not
+ * reported.
+ *
+ * @throw OperationCancelled If the cancellation has been requested.
+ */
+void poll_execution_context(float progress = -1.f);
+
+} // namespace hmap
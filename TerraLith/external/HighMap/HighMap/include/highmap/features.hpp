@@ -101,15 +101,24 @@ Array connected_components(
  * geomorphological units.
  * - Useful in large-scale landform mapping and environmental modeling.
  *
- * @param  array   The input array representing the terrain elevation data.
- * @param  irmin   The minimum radius (in pixels) for considering the
- *                 surrounding area during classification.
- * @param  irmax   The maximum radius (in pixels) for considering the
- *                 surrounding area during classification.
- * @param  epsilon The slope tolerance that defines 'flat' regions, affecting
- *                 the classification.
- * @return         Array An output array with each pixel classified into a
- *                 geomorphological feature.
+ * The maximum and minimum slopes of the 8 directions are obtained by
+ * scanning the rows, columns and diagonals of the array, each line being
+ * shared by all its cells (incremental convex hulls for the large radii).
+ *
+ * @param  array          The input array representing the terrain elevation
+ *                        data.
+ * @param  irmin          The minimum radius (in pixels) for considering the
+ *                        surrounding area during classification.
+ * @param  irmax          The maximum radius (in pixels) for considering the
+ *                        surrounding area during classification.
+ * @param  epsilon        The slope tolerance that defines 'flat' regions,
+ *                        affecting the classification.
+ * @param  p_pattern_code Reference to the output ternary pattern code of
+ *                        each pixel (if not nullptr), i.e. the sum of
+ *                        `(s[k] + 1) * 3^k` where `s[k]` is the signature
+ *                        (-1, 0 or 1) of the direction `k`, in [0, 6560].
+ * @return                Array An output array with each pixel classified
+ *                        into a geomorphological feature.
  *
  * **Example**
  * @include ex_geomorphons.cpp
@@ -117,8 +126,13 @@ Array connected_components(
  * **Result**
  * @image html ex_geomorphons0.png
  * @image html ex_geomorphons1.png
+ * @image html ex_geomorphons2.png
  */
-Array geomorphons(const Array &array, int irmin, int irmax, float epsilon);
+Array geomorphons(const Array &array,
+                  int          irmin,
+                  int          irmax,
+                  float        epsilon,
+                  Array       *p_pattern_code = nullptr);
 
 /**
  * @brief Performs k-means clustering on two input arrays, grouping similar data
@@ -259,6 +273,33 @@ Array kmeans_clustering3(const Array        &array1,
  */
 Array local_median_deviation(const Array &array, int ir);
 
+/**
+ * @brief Computes local statistics over a square window of radius @p ir.
+ *
+ * The windows are clipped at the array borders (the statistics are normalized
+ * by the actual number of cells of each window). The statistics are computed
+ * from summed-area tables of the values and of their squares, accumulated in
+ * double precision: the cost per cell is O(1), independent of the radius.
+ * Only the requested outputs (non-null pointers) are computed.
+ *
+ * @param array              Input array.
+ * @param ir                 Window radius, the window size is (2*ir + 1) x
+ *                           (2*ir + 1).
+ * @param p_mean             Output local mean.
+ * @param p_variance         Output local variance.
+ * @param p_sum_squares      Output local sum of the squared values.
+ * @param p_sum_squared_diff Output local sum of the squared differences between
+ *                           the cell value and the values of its window.
+ *
+ * @see                      mean_local(), ruggedness(), std_local(), z_score()
+ */
+void local_stats(const Array &array,
+                 int          ir,
+                 Array       *p_mean,
+                 Array       *p_variance = nullptr,
+                 Array       *p_sum_squares = nullptr,
+                 Array       *p_sum_squared_diff = nullptr);
+
 /**
  * @brief Return the local mean based on a mean filter with a square kernel.
  *
@@ -266,7 +307,7 @@ Array local_median_deviation(const Array &array, int ir);
  * filter with a square kernel. The local mean is determined by averaging values
  * within a square neighborhood defined by the footprint radius `ir`. The result
  * is an array where each value represents the mean of the surrounding values
- * within the kernel size.
+ * within the kernel size (clipped at the array borders), see local_stats.
  *
  * @param  array Input array from which the local mean is to be calculated.
  * @param  ir    Square kernel footprint radius. The size of the kernel used to
@@ -315,7 +356,8 @@ Array relative_elevation(const Array &array, int ir);
  * @brief Computes the ruggedness of each element in the input array.
  *
  * The ruggedness is calculated as the square root of the sum of squared
- * differences between each element and its neighbors within a specified radius.
+ * differences between each element and its neighbors within a specified radius
+ * (see local_stats).
  *
  * @param  array The input array for which ruggedness is to be computed.
  * @param  ir    The radius within which neighbors are considered for ruggedness
@@ -364,7 +406,8 @@ Array rugosity(const Array &z, int ir, bool convex = true);
  * @brief Computes the local standard deviation of a 2D array.
  *
  * This function calculates the standard deviation within a square neighborhood
- * around each element in the input array.
+ * around each element in the input array (clipped at the array borders), see
+ * local_stats.
  *
  * @param  array The input 2D array of values (e.g., a heightmap or intensity
  *               map).
@@ -421,6 +464,16 @@ Array std_local(const Array &array, int ir);
  */
 Array valley_width(const Array &z, int ir = 0, bool ridge_select = false);
 
+/**
+ * @brief Computes the local z-score of a 2D array, i.e. the deviation from the
+ * local mean in units of local standard deviation.
+ *
+ * @param  array The input 2D array of values.
+ * @param  ir    The radius of the square neighborhood window used for computing
+ *               local statistics (see local_stats).
+ * @return       The z-score array (zero where the local standard deviation is
+ *               zero).
+ */
 Array z_score(const Array &array, int ir);
 
 } // namespace hmap
@@ -443,10 +496,14 @@ Array ruggedness(const Array &array, int ir);
 /*! @brief See hmap::rugosity */
 Array rugosity(const Array &z, int ir, bool convex = true);
 
-/*! @brief See hmap::std_local */
+/*! @brief See hmap::std_local, except that the local averages use a
+ * smoothing (cpulse) window instead of the box window, the values therefore
+ * differ from the CPU version. */
 Array std_local(const Array &array, int ir);
 
-/*! @brief See hmap::z_score */
+/*! @brief See hmap::z_score, except that the local averages use a smoothing
+ * (cpulse) window instead of the box window, the values therefore differ from
+ * the CPU version. */
 Array z_score(const Array &array, int ir);
 
 } // namespace hmap::gpu
\ No newline at end of file
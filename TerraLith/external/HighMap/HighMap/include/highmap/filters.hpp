@@ -836,6 +836,9 @@ void make_binary(Array &array, float threshold = 0.f);
  * footprint radius specified by `ir`. The result is an array where each value
  * represents the local maximum within the defined kernel size.
  *
+ * The separable van Herk / Gil-Werman running maximum is used, the cost per
+ * cell does not depend on the kernel radius.
+ *
  * @param  array Input array from which local maxima are to be extracted.
  * @param  ir    Square kernel footprint radius. The size of the kernel used to
  *               determine the local maxima.
@@ -859,6 +862,9 @@ Array maximum_local(const Array &array, int ir);
  * the footprint radius specified by `ir`. The result is an array where each
  * value represents the local maximum within the disk-shaped kernel.
  *
+ * The kernel is the exact disk of radius `ir` (cells with p^2 + q^2 <= ir^2),
+ * decomposed in horizontal segments, i.e. a cost per cell in O(ir).
+ *
  * @param  array Input array from which local maxima are to be extracted.
  * @param  ir    Disk kernel footprint radius. The size of the disk-shaped
  *               kernel used to determine the local maxima.
@@ -1016,6 +1022,9 @@ Array median_pseudo(const Array &array, int ir);
  * footprint radius specified by `ir`. The result is an array where each value
  * represents the local minimum within the defined kernel size.
  *
+ * The separable van Herk / Gil-Werman running minimum is used, the cost per
+ * cell does not depend on the kernel radius.
+ *
  * @param  array Input array from which local minima are to be extracted.
  * @param  ir    Square kernel footprint radius. The size of the kernel used to
  *               determine the local minima.
@@ -1039,6 +1048,9 @@ Array minimum_local(const Array &array, int ir);
  * the footprint radius specified by `ir`. The result is an array where each
  * value represents the local minimum within the disk-shaped kernel.
  *
+ * The kernel is the exact disk of radius `ir` (cells with p^2 + q^2 <= ir^2),
+ * decomposed in horizontal segments, i.e. a cost per cell in O(ir).
+ *
  * @param  array Input array from which local minima are to be extracted.
  * @param  ir    Disk kernel footprint radius. The size of the disk-shaped
  *               kernel used to determine the local minima.
@@ -15,6 +15,8 @@
  */
 #pragma once
 #include <functional>
+#include <map>
+#include <mutex>
 
 #include "FastNoiseLite.h"
 #include "macrologger.h"
@@ -123,6 +125,26 @@ public:
    */
   float get_value(float x, float y, float ctrl_param) const;
 
+  /**
+   * @brief Evaluate the function for a batch of points.
+   *
+   * The default implementation calls the delegate for each point, derived
+   * classes can override it with a loop which does not go through the
+   * delegate (no indirect call per point).
+   *
+   * @param x          Input x coordinates.
+   * @param y          Input y coordinates.
+   * @param ctrl_param Input control parameters (can be nullptr, control
+   *                   parameter then set to 0).
+   * @param out        Output values.
+   * @param n          Number of points.
+   */
+  virtual void get_values(const float *x,
+                          const float *y,
+                          const float *ctrl_param,
+                          float       *out,
+                          size_t       n) const;
+
   /**
    * @brief Set a new delegate function.
    * @param new_delegate The new delegate function to set.
@@ -753,6 +775,39 @@ public:
     this->kw = new_kw;
   }
 
+  /**
+   * @brief Evaluate the noise for a batch of points, using the current seed.
+   */
+  void get_values(const float *x,
+                  const float *y,
+                  const float *ctrl_param,
+                  float       *out,
+                  size_t       n) const override;
+
+  /**
+   * @brief Evaluate the noise for a batch of points with a given seed,
+   * without modifying the object.
+   *
+   * Used by the fractal layering functions to evaluate each octave with its
+   * own seed: contrary to `set_seed`, it can be called concurrently from
+   * several threads. The default implementation ignores the seed and calls the
+   * delegate.
+   *
+   * @param x          Input x coordinates.
+   * @param y          Input y coordinates.
+   * @param ctrl_param Input control parameters (can be nullptr, control
+   *                   parameter then set to 0).
+   * @param out        Output values.
+   * @param n          Number of points.
+   * @param seed       Random seed.
+   */
+  virtual void get_values_seeded(const float *x,
+                                 const float *y,
+                                 const float *ctrl_param,
+                                 float       *out,
+                                 size_t       n,
+                                 uint         seed) const;
+
 protected:
   Vec2<float> kw;   ///< Frequency scaling vector.
   uint        seed; ///< Random seed for noise generation.
@@ -856,6 +911,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -889,6 +955,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -925,6 +1002,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -958,6 +1046,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -991,6 +1090,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -1024,6 +1134,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -1057,6 +1178,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -1090,6 +1222,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -1133,10 +1276,33 @@ public:
     this->update_interpolation_function();
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
   /**
    * @brief Update base interpolation.
    */
   void update_interpolation_function();
+
+private:
+  /**
+   * @brief Interpolation functions of the seeds other than the current one,
+   * built on demand by `get_values_seeded`.
+   */
+  mutable std::map<uint, HMAP_FCT_XY_TYPE> seeded_delegates;
+
+  /**
+   * @brief Mutex protecting the seeded delegates.
+   */
+  mutable std::mutex mutex;
 };
 
 /**
@@ -1175,10 +1341,33 @@ public:
     this->update_interpolation_function();
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
   /**
    * @brief Update base interpolation.
    */
   void update_interpolation_function();
+
+private:
+  /**
+   * @brief Interpolation functions of the seeds other than the current one,
+   * built on demand by `get_values_seeded`.
+   */
+  mutable std::map<uint, HMAP_FCT_XY_TYPE> seeded_delegates;
+
+  /**
+   * @brief Mutex protecting the seeded delegates.
+   */
+  mutable std::mutex mutex;
 };
 
 /**
@@ -1207,6 +1396,17 @@ public:
     this->noise.SetSeed(new_seed);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator object.
@@ -1253,6 +1453,17 @@ public:
     this->noise2.SetSeed(new_seed + 1);
   }
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
 private:
   /**
    * @brief FastNoiseLite noise generator objects.
@@ -1433,6 +1644,17 @@ public:
               float                          weight,
               float                          persistence,
               float                          lacunarity);
+
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
 };
 /**
  * @class FbmIqFunction
@@ -1458,6 +1680,17 @@ public:
                 float                          lacunarity,
                 float                          gradient_scale);
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
   /**
    * @brief Set the gradient scale.
    *
@@ -1502,6 +1735,17 @@ public:
                     float                          warp_scale,
                     float                          damp_scale);
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
   /**
    * @brief Set the initial warp.
    *
@@ -1571,6 +1815,17 @@ public:
                       float                          persistence,
                       float                          lacunarity);
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
   /**
    * @brief Set the smoothing parameter.
    *
@@ -1609,6 +1864,17 @@ public:
                     float                          lacunarity,
                     float                          k_smoothing);
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
   /**
    * @brief Set the smoothing parameter.
    *
@@ -1647,6 +1913,17 @@ public:
                    float                          lacunarity,
                    float                          warp_scale);
 
+  /**
+   * @brief Batched evaluation with a given seed, see
+   * NoiseFunction::get_values_seeded.
+   */
+  void get_values_seeded(const float *x,
+                         const float *y,
+                         const float *ctrl_param,
+                         float       *out,
+                         size_t       n,
+                         uint         seed) const override;
+
   /**
    * @brief Set the warp scale.
    *
@@ -87,16 +87,6 @@ public:
    */
   std::vector<std::vector<int>> connectivity = {};
 
-  /**
-   * @brief Adjacency matrix.
-   *
-   * This member variable represents the adjacency matrix of the graph. It is a
-   * map where each key is a pair of vertex indices and the value is the weight
-   * of the edge connecting those vertices. The adjacency matrix provides a way
-   * to quickly access the weight of an edge between any two vertices.
-   */
-  std::map<std::pair<int, int>, float> adjacency_matrix;
-
   /**
    * @brief Construct a new Graph object.
    *
@@ -173,6 +163,18 @@ public:
    */
   void add_edge(std::vector<int> edge);
 
+  /**
+   * @brief Set the weight of the connection between two points in the
+   * adjacency matrix, in both directions.
+   *
+   * The CSR adjacency is marked as outdated and rebuilt by the next traversal.
+   *
+   * @param i      First point index.
+   * @param j      Second point index.
+   * @param weight Connection weight.
+   */
+  void set_adjacency_weight(int i, int j, float weight);
+
   /**
    * @brief Return the shortest route between two points using Dijkstra's
    * algorithm.
@@ -182,16 +184,27 @@ public:
    * of point indices representing the route from the source to the target
    * point.
    *
+   * The search uses a binary heap on the CSR adjacency (rebuilt first if the
+   * adjacency matrix has been modified) and stops once the target is
+   * reached. If `astar_weight` is positive, the Euclidean distance to the
+   * target times `astar_weight` is used as an A* heuristic, which gives the
+   * shortest path as long as every edge weight is larger than `astar_weight`
+   * times the edge length (`astar_weight = 1` for the default edge weights).
+   *
    * @param  source_point_index The index of the starting point in the graph.
    * @param  target_point_index The index of the ending point in the graph.
+   * @param  astar_weight       A* heuristic weight, 0 for a plain Dijkstra
+   *                            search.
    * @return                    std::vector<int> A vector of point indices
    *                            representing the shortest path from the source
-   * to the target.
+   * to the target (empty if the target cannot be reached).
    *
    * **Example**
    * @include ex_graph_dijkstra.cpp
    */
-  std::vector<int> dijkstra(int source_point_index, int target_point_index);
+  std::vector<int> dijkstra(int   source_point_index,
+                            int   target_point_index,
+                            float astar_weight = 0.f);
 
   /**
    * @brief Get the length of edge `k`.
@@ -249,6 +262,28 @@ public:
    */
   size_t get_nedges();
 
+  /**
+   * @brief Get the adjacency matrix of the graph.
+   *
+   * The adjacency matrix is a map where each key is a pair of vertex indices
+   * and the value is the weight of the edge connecting those vertices. It is
+   * read-only, it is modified with `set_adjacency_weight` or rebuilt from the
+   * edges with `update_adjacency_matrix`, so that the CSR adjacency used by
+   * the traversals is kept up to date.
+   *
+   * @return const std::map<std::pair<int, int>, float>& The adjacency matrix.
+   */
+  const std::map<std::pair<int, int>, float> &get_adjacency_matrix() const;
+
+  /**
+   * @brief Get the weight of the connection between two points.
+   *
+   * @param  i First point index.
+   * @param  j Second point index.
+   * @return   float The connection weight, 0 if the points are not connected.
+   */
+  float get_adjacency_weight(int i, int j) const;
+
   /**
    * @brief Generate a Minimum Spanning Tree (MST) of the graph using Prim's
    * algorithm.
@@ -403,5 +438,34 @@ public:
    * relationships between nodes in the graph based on the current edges.
    */
   void update_connectivity();
+
+private:
+  /**
+   * @brief Adjacency matrix, pair of vertex indices -> edge weight.
+   *
+   * Private so that every modification marks the CSR adjacency as outdated,
+   * see `get_adjacency_matrix` and `set_adjacency_weight`.
+   */
+  std::map<std::pair<int, int>, float> adjacency_matrix;
+
+  /**
+   * @brief Compressed sparse row (CSR) copy of the adjacency matrix.
+   *
+   * The neighbors of point `i` and the corresponding edge weights are stored
+   * in `csr_neighbors` and `csr_weights`, between the indices `csr_offsets[i]`
+   * and `csr_offsets[i + 1]`. This contiguous storage is used by the graph
+   * traversal algorithms, see `update_csr_adjacency`.
+   */
+  std::vector<int>   csr_offsets = {};
+  std::vector<int>   csr_neighbors = {}; ///< @see csr_offsets
+  std::vector<float> csr_weights = {};   ///< @see csr_offsets
+
+  bool is_csr_outdated = true; ///< CSR adjacency to be rebuilt.
+
+  /**
+   * @brief Update the CSR adjacency from the adjacency matrix, called by the
+   * traversals when it is outdated.
+   */
+  void update_csr_adjacency();
 };
 } // namespace hmap
\ No newline at end of file
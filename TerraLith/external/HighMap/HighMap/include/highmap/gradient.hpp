@@ -330,7 +330,7 @@ Array normal_map_to_heightmap(const Tensor &nmap);
 
 /**
  * @brief Reconstruct a height/displacement map from a normal map by solving a
- * Poisson equation with Gauss–Seidel iteration.
+ * Poisson equation with a multigrid solver.
  *
  * The reconstruction is unique up to an additive constant. After solving, you
  * may subtract the mean or normalize to a desired range.
@@ -339,11 +339,10 @@ Array normal_map_to_heightmap(const Tensor &nmap);
  *     - Channel 0 = \(N_x\), channel 1 = \(N_y\), channel 2 = \(N_z\).
  *     - Values are expected in [0,1] or [-1,1]; if stored in [0,1], they will
  * be remapped internally to [-1,1].
- * @param  iterations Number of Gauss–Seidel iterations to perform (default =
- *                    500). Higher values improve accuracy but increase runtime.
- * @param  omega      Relaxation factor (1.0 = pure Gauss–Seidel; 1.0–2.0 =
- *                    over-relaxation). Recommended: 1.2–1.5 for faster
- * convergence.
+ * @param  iterations Maximum number of multigrid V-cycles (the solver stops
+ *                    earlier once converged).
+ * @param  omega      Deprecated, unused, kept for source compatibility (the
+ *                    multigrid solver does not rely on over-relaxation).
  *
  * @return            *     A 2D Array containing the reconstructed height map.
  *                    Values are not normalized; apply scaling or centering if
@@ -354,7 +353,7 @@ Array normal_map_to_heightmap(const Tensor &nmap);
  * @image html ex_normal_map_to_heightmap.png
  */
 Array normal_map_to_heightmap_poisson(const Tensor &nmap,
-                                      int           iterations = 500,
+                                      int           iterations = 50,
                                       float         omega = 1.5f);
 
 /**
@@ -427,6 +426,34 @@ void solve_poisson_gauss_seidel(const Array &rhs,
                                 int          iterations = 500,
                                 float        omega = 1.0f);
 
+/**
+ * @brief Solve the Poisson equation ∇²h = rhs using a geometric multigrid
+ * solver.
+ *
+ * The discretization is the same as for solve_poisson_gauss_seidel (5-point
+ * Laplacian, unit grid spacing). The array borders and the cells flagged by
+ * the optional mask are Dirichlet cells: their input values in @p h are kept.
+ * The solver performs V-cycles with red-black Gauss–Seidel smoothing
+ * (parallelized over the rows) until the residual is reduced by the factor @p
+ * tolerance, each cycle having a cost proportional to the number of cells.
+ *
+ * @param rhs          Right-hand side.
+ * @param h            Solution, initialized with the Dirichlet values and an
+ *                     initial guess elsewhere (0 is fine).
+ * @param p_mask_fixed Optional mask, cells with a value greater than zero are
+ *                     Dirichlet cells.
+ * @param cycles_max   Maximum number of V-cycles.
+ * @param tolerance    Stopping criterion, ratio between the final and initial
+ *                     maximum absolute residuals.
+ * @param sweeps       Number of pre- and post-smoothing sweeps per level.
+ */
+void solve_poisson_multigrid(const Array &rhs,
+                             Array       &h,
+                             const Array *p_mask_fixed = nullptr,
+                             int          cycles_max = 50,
+                             float        tolerance = 1e-4f,
+                             int          sweeps = 2);
+
 /**
  * @brief Unwraps a 2D phase array to correct discontinuities in phase data.
  *
@@ -13,7 +13,10 @@
  *
  */
 #pragma once
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 #include "highmap/array.hpp"
 #include "highmap/export.hpp"
@@ -43,12 +46,14 @@ enum TransformMode : int
   DISTRIBUTED,  ///< Distributed across multiple processors or threads.
   SEQUENTIAL,   ///< Performed sequentially in a single thread.
   SINGLE_ARRAY, ///< Transformation is applied to a single array of data.
+  HALO, ///< Distributed, each tile core padded with exact ghost cells.
 };
 
 static std::map<std::string, int> transform_mode_as_string = {
     {"Distributed", DISTRIBUTED},
     {"Sequential", SEQUENTIAL},
     {"Single array", SINGLE_ARRAY},
+    {"Halo exchange", HALO},
 };
 
 // --- forward declarations
@@ -142,6 +147,170 @@ public:
   void infos() const;
 };
 
+/**
+ * @brief TileVector class, copy-on-write storage of the tiles of an
+ * heightmap.
+ *
+ * Copying a TileVector only copies references to the tiles, which are then
+ * shared between the copies. A shared tile is duplicated ("detached") the
+ * first time it is accessed through a non-const accessor, so that a copy of
+ * an heightmap only materializes the tiles that are actually written
+ * afterwards. Read-only accesses should go through const references to avoid
+ * unnecessary duplications.
+ *
+ * A tile replaced by a detach is kept alive by the TileVector ("retired")
+ * until its next assignment, resize, destruction or `collect()`, so that
+ * references obtained by other threads before the detach remain valid. The
+ * owner of a TileVector that is written repeatedly without being reassigned
+ * is responsible for calling `collect()` between operator invocations, once
+ * no reference to its tiles is held anymore.
+ */
+class TileVector
+{
+public:
+  /**
+   * @brief Index-based iterator, dereferencing through `operator[]` (and
+   * therefore detaching shared tiles when iterating a non-const TileVector).
+   */
+  template <typename Owner, typename Value> class Iterator
+  {
+  public:
+    Iterator(Owner *p_owner, size_t k) : p_owner(p_owner), k(k) {}
+
+    Value &operator*() const { return (*this->p_owner)[this->k]; }
+
+    Value *operator->() const { return &(*this->p_owner)[this->k]; }
+
+    Iterator &operator++()
+    {
+      ++this->k;
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const { return this->k == other.k; }
+
+    bool operator!=(const Iterator &other) const { return this->k != other.k; }
+
+  private:
+    Owner *p_owner;
+    size_t k;
+  };
+
+  using iterator = Iterator<TileVector, Tile>;
+  using const_iterator = Iterator<const TileVector, const Tile>;
+
+  TileVector() = default;
+
+  TileVector(const TileVector &other);
+
+  TileVector(TileVector &&other) noexcept;
+
+  ~TileVector();
+
+  TileVector &operator=(const TileVector &other);
+
+  TileVector &operator=(TileVector &&other) noexcept;
+
+  /**
+   * @brief Returns a tile for writing, the tile is detached beforehand if it
+   * is shared with another TileVector.
+   *
+   * @param  k Tile index.
+   * @return   Tile& Tile reference.
+   */
+  Tile &operator[](size_t k);
+
+  /**
+   * @brief Returns a tile for reading, the tile is never detached.
+   *
+   * @param  k Tile index.
+   * @return   const Tile& Tile reference.
+   */
+  const Tile &operator[](size_t k) const;
+
+  iterator begin() { return iterator(this, 0); }
+
+  iterator end() { return iterator(this, this->ntiles); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+
+  const_iterator end() const { return const_iterator(this, this->ntiles); }
+
+  /**
+   * @brief Returns true if the tile is shared with another TileVector.
+   *
+   * @param  k Tile index.
+   * @return   bool Sharing status.
+   */
+  bool is_shared(size_t k) const;
+
+  /**
+   * @brief Releases the tiles retired by previous detaches.
+   *
+   * Must only be called at a quiescent point, i.e. when no other thread holds
+   * a reference obtained through the accessors of this TileVector.
+   */
+  void collect();
+
+  /**
+   * @brief Returns the number of tiles retired by detaches and not released
+   * yet.
+   *
+   * @return size_t Number of retired tiles.
+   */
+  size_t get_nretired() const;
+
+  /**
+   * @brief Changes the number of tiles, existing tiles are kept and new tiles
+   * are default-constructed.
+   *
+   * @param n New number of tiles.
+   */
+  void resize(size_t n);
+
+  /**
+   * @brief Replaces a tile without duplicating the previous one, even if it is
+   * shared.
+   *
+   * @param k    Tile index.
+   * @param tile New tile.
+   */
+  void set(size_t k, Tile tile);
+
+  /**
+   * @brief Returns the number of tiles.
+   *
+   * @return size_t Number of tiles.
+   */
+  size_t size() const { return this->ntiles; }
+
+private:
+  /**
+   * @brief Reference-counted tile, `nslots` counts the TileVector slots
+   * referencing it (retired references excluded).
+   */
+  struct SharedTile
+  {
+    explicit SharedTile(Tile tile) : tile(std::move(tile)) {}
+
+    Tile             tile;
+    std::atomic<int> nslots = 1;
+  };
+
+  void detach(size_t k);
+
+  void release();
+
+  void update_slots();
+
+  std::vector<std::shared_ptr<SharedTile>> refs; ///< Tiles owned by the slots.
+  std::vector<std::shared_ptr<SharedTile>> retired; ///< Detached tiles.
+  std::unique_ptr<std::atomic<SharedTile *>[]>
+                     tile_ptrs; ///< Lock-free view of `refs` for the accessors.
+  size_t             ntiles = 0; ///< Number of tiles.
+  mutable std::mutex mtx;        ///< Protects `refs` and `retired`.
+};
+
 /**
  * @brief HeightMap class, to manipulate heightmap (with contextual
  * informations).
@@ -165,9 +334,10 @@ public:
   float overlap = 0.f;
 
   /**
-   * @brief Tile storage.
+   * @brief Tile storage (copy-on-write, copying an heightmap does not copy
+   * the tile data).
    */
-  std::vector<Tile> tiles = {};
+  TileVector tiles;
 
   Heightmap(Vec2<int> shape, Vec2<int> tiling,
             float overlap); ///< @overload
@@ -294,7 +464,7 @@ public:
   /**
    * @brief Print some informations about the object.
    */
-  void infos();
+  void infos() const;
 
   /**
    * @brief Inverse the heightmap values (max - values).
@@ -306,21 +476,21 @@ public:
    *
    * @return float
    */
-  float max();
+  float max() const;
 
   /**
    * @brief Return the mean of the heightmap data.
    *
    * @return float
    */
-  float mean();
+  float mean() const;
 
   /**
    * @brief Return the value of the smallest element in the heightmap data.
    *
    * @return float
    */
-  float min();
+  float min() const;
 
   /**
    * @brief Remap heightmap elements from a starting range to a target range.
@@ -351,7 +521,7 @@ public:
    *
    * @return float
    */
-  float sum();
+  float sum() const;
 
   /**
    * @brief Return the heightmap as an array.
@@ -369,18 +539,18 @@ public:
    * @return A `std::vector<uint16_t>` containing the 16-bit grayscale image
    * data.
    */
-  std::vector<uint16_t> to_grayscale_image_16bit();
+  std::vector<uint16_t> to_grayscale_image_16bit() const;
 
-  std::vector<uint16_t> to_grayscale_image_16bit_multithread();
+  std::vector<uint16_t> to_grayscale_image_16bit_multithread() const;
 
-  std::vector<uint8_t> to_grayscale_image_8bit();
+  std::vector<uint8_t> to_grayscale_image_8bit() const;
 
   /**
    * @brief Returns the unique elements of the heightmap.
    *
    * @return std::vector<float> Unique values.
    */
-  std::vector<float> unique_values();
+  std::vector<float> unique_values() const;
 
   /**
    * @brief Update tile parameters.
@@ -472,13 +642,13 @@ struct HeightmapRGB
    * @param  shape_img Resulting image shape.
    * @return           Image data.
    */
-  std::vector<uint8_t> to_img_8bit(Vec2<int> shape_img = {0, 0});
+  std::vector<uint8_t> to_img_8bit(Vec2<int> shape_img = {0, 0}) const;
 
   /**
    * @brief Export the RGB heightmap to a 16bit png file.
    * @param fname File name.
    */
-  void to_png(const std::string &fname, int depth = CV_8U);
+  void to_png(const std::string &fname, int depth = CV_8U) const;
 
   /**
    * @brief Mix two RGB heightmap using linear interpolation.
@@ -579,7 +749,7 @@ struct HeightmapRGBA
    * @brief Export the RGB heightmap to a 8bit png file.
    * @param fname File name.
    */
-  void to_png(const std::string &fname, int depth = CV_8U);
+  void to_png(const std::string &fname, int depth = CV_8U) const;
 
   /**
    * @brief Fill RGB heightmap components based on a colormap and an input
@@ -643,7 +813,7 @@ struct HeightmapRGBA
    * @see    https://stackoverflow.com/questions/596216 for details on the
    *         luminance calculation.
    */
-  Heightmap luminance();
+  Heightmap luminance() const;
 
   /**
    * @brief Mix two RGBA heightmap using alpha compositing ("over").
@@ -889,15 +1059,77 @@ HeightmapRGBA mix_normal_map_rgba(HeightmapRGBA          &nmap_base,
  * transformation parameters.
  * @param transform_mode The mode of transformation to be applied. Default is
  *                       TransformMode::DISTRIBUTED.
+ * @param halo_radius    Stencil radius of the operator (in cells), only used
+ *                       by TransformMode::HALO. If negative (stencil not
+ *                       declared), TransformMode::HALO falls back to
+ *                       TransformMode::DISTRIBUTED.
+ * @param iterations     Number of times the operator is applied. With
+ *                       TransformMode::HALO, the ghost cells are exchanged
+ *                       before each application.
+ *
+ * With TransformMode::HALO, the domain is partitioned into the tile cores
+ * (tiles without their overlap buffers). For each tile, the operator is
+ * applied to an array made of the tile core padded with `halo_radius` cells
+ * copied from the neighboring cores, then the tiles (overlap buffers
+ * included) are updated from the cores of the results. For an operator
+ * reading its input within `halo_radius` cells, the result is then exactly
+ * the one obtained with TransformMode::SINGLE_ARRAY, and the overlap buffers
+ * of the tiles are consistent (no blending is required). Operators without a
+ * bounded stencil (flow accumulation for instance) still require
+ * TransformMode::SINGLE_ARRAY.
+ *
+ * @note All the heightmaps are accessed for writing: a tile shared with a
+ * copy (see TileVector) is detached, even if the operator only reads it. Use
+ * the overload with separate read-only inputs to avoid this.
  */
 void transform(std::vector<Heightmap *>                     p_hmaps,
                std::function<void(const std::vector<Array *>,
                                   const hmap::Vec2<int>,
                                   const hmap::Vec4<float>)> op,
-               TransformMode transform_mode = TransformMode::DISTRIBUTED);
+               TransformMode transform_mode = TransformMode::DISTRIBUTED,
+               int           halo_radius = -1,
+               int           iterations = 1);
+
+/**
+ * @brief Applies a transformation operation to a collection of output
+ * heightmaps, with read-only input heightmaps.
+ *
+ * Same as the overload above, except that the input heightmaps are only
+ * accessed through const references: their shared tiles are not detached and
+ * they are never written back.
+ *
+ * @param p_hmaps_out    Heightmaps written by the operator.
+ * @param p_hmaps_in     Heightmaps only read by the operator (can contain
+ *                       nullptr).
+ * @param op             Operator taking the output and the input arrays
+ *                       pointers, the array shape and its bounding box.
+ * @param transform_mode The mode of transformation to be applied.
+ * @param halo_radius    Stencil radius of the operator (in cells), only used
+ *                       by TransformMode::HALO.
+ * @param iterations     Number of times the operator is applied.
+ */
+void transform(std::vector<Heightmap *>                     p_hmaps_out,
+               std::vector<const Heightmap *>               p_hmaps_in,
+               std::function<void(const std::vector<Array *>,
+                                  const std::vector<const Array *>,
+                                  const hmap::Vec2<int>,
+                                  const hmap::Vec4<float>)> op,
+               TransformMode transform_mode = TransformMode::DISTRIBUTED,
+               int           halo_radius = -1,
+               int           iterations = 1);
 
 void transform(std::vector<Heightmap *>                        p_hmaps,
                std::function<void(const std::vector<Array *>)> op,
-               TransformMode transform_mode = TransformMode::DISTRIBUTED);
+               TransformMode transform_mode = TransformMode::DISTRIBUTED,
+               int           halo_radius = -1,
+               int           iterations = 1); ///< @overload
+
+void transform(std::vector<Heightmap *>                     p_hmaps_out,
+               std::vector<const Heightmap *>               p_hmaps_in,
+               std::function<void(const std::vector<Array *>,
+                                  const std::vector<const Array *>)> op,
+               TransformMode transform_mode = TransformMode::DISTRIBUTED,
+               int           halo_radius = -1,
+               int           iterations = 1); ///< @overload
 
 } // namespace hmap
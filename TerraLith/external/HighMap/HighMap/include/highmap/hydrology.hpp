@@ -159,15 +159,13 @@ Array flooding_from_point(const Array            &z,
  *
  * This function identifies depressions in a terrain elevation model and
  * simulates the flooding of these areas to produce a lake system. It uses a
- * rough depression-filling algorithm to compute the water surface, then
+ * depression-filling algorithm to compute the water surface, then
  * subtracts the original elevations to obtain the water depth at each cell.
  *
  * @param  z                 Input 2D array representing terrain elevations
  *                           (height field).
- * @param  iterations        Maximum number of iterations allowed for the
- *                           depression-filling algorithm.
- * @param  epsilon           Convergence tolerance for the depression-filling
- *                           step.
+ * @param  epsilon           Minimum slope of the filled water surface, see
+ *                           depression_filling.
  * @param  surface_threshold The minimum number of pixels a component must have
  *                           to be retained. Components smaller than this
  *                           threshold will be removed. The default value is 0
@@ -186,10 +184,21 @@ Array flooding_from_point(const Array            &z,
  * @image html ex_flooding_lake_system.png
  */
 Array flooding_lake_system(const Array &z,
-                           int          iterations = 500,
                            float        epsilon = 1e-3f,
                            float        surface_threshold = 0);
 
+/**
+ * @brief Former signature, the priority-flood depression filling has no
+ * iteration count: 'iterations' is ignored. Kept so that the calls passing it
+ * do not silently bind it to 'epsilon'.
+ */
+[[deprecated("the iteration count is ignored, use flooding_lake_system(z, "
+             "epsilon, surface_threshold)")]] Array
+flooding_lake_system(const Array &z,
+                     int          iterations,
+                     float        epsilon = 1e-3f,
+                     float        surface_threshold = 0);
+
 /**
  * @brief Computes the flow accumulation for each cell using the D8 flow
  * direction model.
@@ -303,6 +312,11 @@ Array flow_direction_dinf_angle(const Array &z, float talus_ref);
  *                             function (default: 2.0).
  * @param  upward_penalization Penalty factor for upward elevation changes
  *                             (default: 100.0).
+ * @param  fill_depressions    Whether the path is searched on the heightmap
+ *                             with its depressions filled (see
+ *                             depression_filling), so that the stream never
+ *                             has to climb out of a local minimum (default:
+ *                             false).
  * @return                     A Path object representing the optimal flow path
  *                             with normalized x and y coordinates and
  *                             corresponding elevations.
@@ -322,7 +336,8 @@ Path flow_stream(const Array    &z,
                  const Vec2<int> ij_start,
                  const float     elevation_ratio = 0.5f,
                  const float     distance_exponent = 2.f,
-                 const float     upward_penalization = 100.f);
+                 const float     upward_penalization = 100.f,
+                 const bool      fill_depressions = false);
 
 /**
  * @brief Generates a 2D array representing a riverbed based on a specified
@@ -406,9 +421,9 @@ Array merge_water_depths(const Array &depth1,
  *
  * This function estimates the water depth above a terrain surface by solving a
  * Laplace equation on the domain defined by @p mask. The solution is obtained
- * using the harmonic interpolation method with Successive Over-Relaxation
- * (SOR). The resulting water depth is given by the difference between the
- * interpolated surface and the original terrain elevation.
+ * using the harmonic interpolation method (multigrid solver). The resulting
+ * water depth is given by the difference between the interpolated surface and
+ * the original terrain elevation.
  *
  * @param  z              Input 2D array representing the terrain elevations
  *                        (height field).
@@ -418,13 +433,12 @@ Array merge_water_depths(const Array &depth1,
  *                        fixed terrain.
  * @param  mask_threshold Threshold used to convert @p mask into a binary field
  *                        (0 or 1) for identifying water/terrain boundaries.
- * @param  iterations_max Maximum number of SOR iterations used in the harmonic
- *                        interpolation.
- * @param  tolerance      Convergence criterion: the algorithm stops if the
- *                        maximum absolute update between iterations is less
- *                        than this value.
- * @param  omega          Relaxation factor for the SOR solver (1 < omega < 2
- *                        recommended).
+ * @param  iterations_max Maximum number of multigrid V-cycles used in the
+ *                        harmonic interpolation.
+ * @param  tolerance      Convergence criterion: the algorithm stops once the
+ *                        maximum absolute residual has been reduced by this
+ *                        factor.
+ * @param  omega          Deprecated, unused, kept for source compatibility.
  *
  * @return                A 2D array containing the computed water depth at each
  *                        grid cell. Depth values are non-negative where water
@@ -441,8 +455,8 @@ Array merge_water_depths(const Array &depth1,
 Array water_depth_from_mask(const Array &z,
                             const Array &mask,
                             float        mask_threshold = 0.f,
-                            int          iterations_max = 10000,
-                            float        tolerance = 1e-2f,
+                            int          iterations_max = 50,
+                            float        tolerance = 1e-4f,
                             float        omega = 1.8f);
 
 /**
@@ -0,0 +1,45 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+   Public License. The full license is in the file LICENSE, distributed with
+   this software. */
+
+/**
+ * @file horizon_sweep.hpp
+ * @author  Otto Link (otto.link.bv@gmail.com)
+ * @brief Horizon elevation of a heightmap along a direction, used for the cast
+ * shadows, the ambient occlusion and the sky-view factor.
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#pragma once
+
+#include "highmap/array.hpp"
+
+// horizon tangent of the cells without any terrain ahead (finite so that it
+// can be safely interpolated)
+#define HMAP_HORIZON_NONE -1e30f
+
+namespace hmap
+{
+
+/**
+ * @brief Returns the tangent of the horizon elevation angle of each cell,
+ * looking in the direction `(cos(theta), sin(theta))` of the array index frame.
+ *
+ * The terrain is swept along parallel lines spaced by one cell. Along each
+ * line, the horizon of every sample is exactly obtained from the upper convex
+ * hull of the samples ahead of it (amortized O(1) per sample), the lines being
+ * processed in parallel. The horizon of a cell is then linearly interpolated
+ * between the two lines surrounding it (see shadow_heightmap for the resulting
+ * accuracy, pinned by test_horizon_sweep).
+ *
+ * @param  z         Input heightmap.
+ * @param  theta     Direction angle (in radians).
+ * @param  cell_size Horizontal size of a cell, in the units of the heightmap
+ *                   values.
+ * @return           Horizon tangent, HMAP_HORIZON_NONE where there is no
+ *                   terrain ahead (array borders).
+ */
+Array horizon_tangent(const Array &z, float theta, float cell_size);
+
+} // namespace hmap
@@ -0,0 +1,104 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+   Public License. The full license is in the file LICENSE, distributed with
+   this software. */
+
+/**
+ * @file segment_grid.hpp
+ * @author  Otto Link (otto.link.bv@gmail.com)
+ * @brief Uniform grid spatial index over 2D segments, used for the exact
+ * distance fields of points, polylines and graphs.
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#pragma once
+#include <vector>
+
+#include "highmap/algebra.hpp"
+#include "highmap/array.hpp"
+
+namespace hmap
+{
+
+/**
+ * @brief Uniform grid over a set of 2D segments (a point being a segment of
+ * zero length) for exact nearest-segment queries.
+ *
+ * Each segment is registered in the cells overlapped by its bounding box. The
+ * nearest segment of a query point is found by visiting the cells by rings of
+ * increasing radius around the cell of the point, until the distance to the
+ * next ring exceeds the current minimum distance. The segments are also
+ * registered by grid rows to count the crossings of an horizontal ray
+ * (inside/outside test of a closed polyline).
+ */
+class SegmentGrid
+{
+public:
+  /**
+   * @brief Constructor.
+   * @param xa, ya Start point coordinates of the segments.
+   * @param xb, yb End point coordinates of the segments.
+   * @param bbox_domain Bounding box of the query points, the grid covers both
+   * the segments and this domain.
+   */
+  SegmentGrid(const std::vector<float> &xa,
+              const std::vector<float> &ya,
+              const std::vector<float> &xb,
+              const std::vector<float> &yb,
+              Vec4<float>               bbox_domain);
+
+  /**
+   * @brief Returns the squared distance between the point (x, y) and the
+   * nearest segment.
+   */
+  float get_distance2(float x, float y) const;
+
+  /**
+   * @brief Returns the distance field on the grid of an array.
+   * @param shape Array shape.
+   * @param bbox_array Array bounding box.
+   * @param p_noise_x, p_noise_y Optional domain warping of the array
+   * coordinates.
+   * @param signed_distance Whether the distance is negative inside the closed
+   * polyline formed by the segments (even-odd rule).
+   */
+  Array get_distance_array(Vec2<int>    shape,
+                           Vec4<float>  bbox_array,
+                           const Array *p_noise_x,
+                           const Array *p_noise_y,
+                           bool         signed_distance = false) const;
+
+  /**
+   * @brief Returns true if an horizontal ray starting at (x, y) crosses the
+   * segments an odd number of times (point inside the closed polyline).
+   */
+  bool is_inside(float x, float y) const;
+
+private:
+  struct Segment
+  {
+    float ax, ay; ///< Start point.
+    float ex, ey; ///< Segment vector.
+    float by;     ///< End point ordinate (exact, for the crossing test).
+    float inv_ee; ///< Inverse of the squared length (0 for a point).
+  };
+
+  std::vector<Segment> segments;
+
+  Vec2<int>   nc;  ///< Number of cells.
+  Vec2<float> o;   ///< Grid origin.
+  Vec2<float> h;   ///< Cell size.
+  Vec2<float> ih;  ///< Inverse of the cell size.
+
+  // segment indices by cell (compressed storage, cell k = i + j * nc.x)
+  std::vector<size_t> cell_offsets;
+  std::vector<int>    cell_segments;
+
+  // segment indices by grid row (compressed storage)
+  std::vector<size_t> row_offsets;
+  std::vector<int>    row_segments;
+
+  float segment_distance2(int k, float x, float y) const;
+};
+
+} // namespace hmap
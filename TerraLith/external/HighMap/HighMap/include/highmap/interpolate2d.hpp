@@ -85,27 +85,27 @@ inline float cubic_interpolate(float p[4], float x)
 }
 
 /**
- * @brief Perform harmonic interpolation on a 2D array using the Successive
- * Over-Relaxation (SOR) method.
+ * @brief Perform harmonic interpolation on a 2D array using a multigrid
+ * Laplace solver.
  *
- * This function solves the discrete Laplace equation on a regular grid by
- * iteratively updating the values of an input array. Values marked as fixed in
- * the @p mask_fixed_values remain unchanged throughout the process. The
- * algorithm stops when either the maximum number of iterations is reached or
- * the change between successive iterations falls below the specified tolerance.
+ * This function solves the discrete Laplace equation on a regular grid, see
+ * solve_poisson_multigrid. Values marked as fixed in the @p mask_fixed_values
+ * and the array borders remain unchanged. The algorithm stops when either the
+ * maximum number of V-cycles is reached or the residual has been reduced by
+ * the specified tolerance.
  *
- * @param  array             Input 2D array providing the initial guess for the
- *                           solution.
+ * @param  array             Input 2D array providing the fixed values and the
+ *                           initial guess for the solution.
  * @param  mask_fixed_values Mask of the same shape as @p array. Cells with a
  *                           value greater than zero indicate fixed points that
  *                           must remain unchanged during interpolation.
- * @param  iterations_max    Maximum number of SOR iterations to perform.
- * @param  tolerance         Convergence criterion: the algorithm stops if the
- *                           maximum absolute update between iterations is less
- *                           than this value.
- * @param  omega             Relaxation factor (1 < omega < 2 recommended).
- *                           Values closer to 2 accelerate convergence, but
- *                           overly large values may cause divergence.
+ * @param  iterations_max    Maximum number of multigrid V-cycles.
+ * @param  tolerance         Convergence criterion: the algorithm stops once the
+ *                           maximum absolute residual has been reduced by this
+ *                           factor.
+ * @param  omega             Deprecated, unused, kept for source compatibility
+ *                           (the multigrid solver does not rely on
+ *                           over-relaxation).
  *
  * @return                   A new 2D array containing the interpolated
  *                           solution.
@@ -114,13 +114,11 @@ inline float cubic_interpolate(float p[4], float x)
  *  - The algorithm updates only the interior points (indices `[1..nx-2,
  * 1..ny-2]`).
  *  - Cells where `mask_fixed_values(i, j) > 0` remain unchanged.
- *  - A relaxation factor of 1 corresponds to the standard Jacobi/Gauss-Seidel
- * update.
  */
 Array harmonic_interpolation(const Array &array,
                              const Array &mask_fixed_values,
-                             int          iterations_max = 10000,
-                             float        tolerance = 1e-3f,
+                             int          iterations_max = 50,
+                             float        tolerance = 1e-4f,
                              float        omega = 1.8f);
 
 /**
@@ -191,6 +189,11 @@ Array interpolate2d_nearest(Vec2<int>                 shape,
  * triangulation of the input points and interpolating the values within each
  * triangle.
  *
+ * Without noise nor stretching, the triangles are scan-converted onto the
+ * output grid. Otherwise, each displaced query position is located by walking
+ * through the triangulation from the triangle of the previous cell. Cells
+ * outside the convex hull of the input points are set to zero.
+ *
  * @param  shape        Output array shape.
  * @param  x            x coordinates of the input values.
  * @param  y            y coordinates of the input values.
@@ -23,6 +23,8 @@
 namespace hmap
 {
 
+class Function; // from highmap/functions.hpp
+
 /**
  * @brief Add a kernel to a specified position in an array.
  *
@@ -201,6 +203,36 @@ void fill_array_using_xy_function(
     const Array                              *p_stretching,
     std::function<float(float, float, float)> fct_xy);
 
+/**
+ * @brief Fill an array using a function object based on (x, y) coordinates.
+ *
+ * Same as above, but the function is evaluated by rows using its batched
+ * evaluation `Function::get_values` and the rows are processed in parallel
+ * (the function evaluation must be thread-safe, which is the case for all the
+ * HighMap functions). The overload taking a `std::function` delegate processes
+ * the rows sequentially.
+ *
+ * @param array        The array to be filled with computed values.
+ * @param bbox         The bounding box of the domain specified as {xmin, xmax,
+ *                     ymin, ymax}.
+ * @param p_ctrl_param Pointer to an array of control parameters affecting the
+ *                     scalar function (set to 1 if nullptr).
+ * @param p_noise_x    Pointer to an array of noise values along the x-direction
+ *                     for domain warping.
+ * @param p_noise_y    Pointer to an array of noise values along the y-direction
+ *                     for domain warping.
+ * @param p_stretching Pointer to an array of local wavenumber multipliers for
+ *                     adjusting the function.
+ * @param fct          The function object.
+ */
+void fill_array_using_xy_function(Array          &array,
+                                  Vec4<float>     bbox,
+                                  const Array    *p_ctrl_param,
+                                  const Array    *p_noise_x,
+                                  const Array    *p_noise_y,
+                                  const Array    *p_stretching,
+                                  const Function &fct); ///< @overload
+
 /**
  * @brief Fill an array using a scalar function based on (x, y) coordinates with
  * subsampling.
@@ -10,8 +10,8 @@
  *
  * This header file defines functions for computing various types of shadow and
  * shading effects from heightmap data. These functions include shaded relief
- * (hillshading), shadow intensity based on grid and heightmap techniques, and
- * topographic shading.
+ * (hillshading), shadow intensity based on grid and heightmap techniques,
+ * ambient occlusion, sky-view factor and topographic shading.
  *
  * @copyright Copyright (c) 2023 Otto Link
  */
@@ -68,22 +68,96 @@ Array hillshade(const Array &z,
 Array shadow_grid(const Array &z, float shadow_talus);
 
 /**
- * @brief Compute crude shadows from a heightmap.
- *
- * This function generates crude shadow effects from the input heightmap using
- * the specified light azimuth, zenith, and distance. The method is based on the
- * technique described in https://www.shadertoy.com/view/Xlsfzl.
+ * @brief Compute the cast shadows of a heightmap.
+ *
+ * A cell is lit if the light elevation is above the horizon of the cell in the
+ * light direction. The horizon is computed exactly along sweep lines parallel
+ * to the light direction (upper convex hull of the terrain ahead of each
+ * cell), for a cost proportional to the number of cells.
+ *
+ * The sweep lines are one cell apart and the horizon of a cell is linearly
+ * interpolated between the two lines around it. It is exact for the axis and
+ * diagonal directions. For the other directions the error depends on the
+ * terrain roughness at the cell scale: against a search along the line
+ * through each cell, on a fractal noise (unit amplitude over the array width),
+ * the median error is about 0.001 rad and the 99th percentile about 0.1 rad at
+ * 256 x 256 (0.04 rad at 1024 x 1024), with isolated errors of a fraction of
+ * a radian right behind steep occluders.
  *
  * @param  z        Input array representing the heightmap.
- * @param  azimuth  Light azimuth (direction) in degrees. Default is 180.f.
- * @param  zenith   Light zenith (elevation) in degrees. Default is 45.f.
- * @param  distance Light distance. Default is 0.2f.
- * @return          Array Resulting crude shadow map.
+ * @param  azimuth  Light azimuth (direction) in degrees. Default is 180.f
+ *                  (light from the west).
+ * @param  zenith   Light elevation angle in degrees. Default is 45.f.
+ * @param  penumbra Angular width of the shadow edge in degrees, 0 for hard
+ *                  shadows. Default is 1.f.
+ * @param  zscale   Vertical scaling of the heightmap, the horizontal extent of
+ *                  the array width being 1. Default is 1.f.
+ * @return          Array Resulting shadow map, 1 for lit cells and 0 for
+ *                  shadowed cells.
+ *
+ * **Example**
+ * @include ex_shadow_heightmap.cpp
+ *
+ * **Result**
+ * @image html ex_shadow_heightmap.png
+ *
+ * @see             {@link ambient_occlusion}, {@link sky_view_factor}
  */
 Array shadow_heightmap(const Array &z,
                        float        azimuth = 180.f,
                        float        zenith = 45.f,
-                       float        distance = 0.2f);
+                       float        penumbra = 1.f,
+                       float        zscale = 1.f);
+
+/**
+ * @brief Compute the ambient occlusion of a heightmap.
+ *
+ * The ambient occlusion is the cosine-weighted fraction of the sky hemisphere
+ * which is not hidden by the terrain horizon, averaged over a set of
+ * directions (see shadow_heightmap for the horizon computation).
+ *
+ * @param  z           Input array representing the heightmap.
+ * @param  ndirections Number of horizon directions.
+ * @param  zscale      Vertical scaling of the heightmap, the horizontal extent
+ *                     of the array width being 1.
+ * @return             Array Resulting ambient occlusion, in [0, 1] (1 for an
+ *                     unoccluded cell).
+ *
+ * **Example**
+ * @include ex_shadow_heightmap.cpp
+ *
+ * **Result**
+ * @image html ex_shadow_heightmap.png
+ */
+Array ambient_occlusion(const Array &z,
+                        int          ndirections = 16,
+                        float        zscale = 1.f);
+
+/**
+ * @brief Compute the sky-view factor of a heightmap.
+ *
+ * The sky-view factor is the fraction of the sky visible from each cell,
+ * computed from the horizon elevation angles `h` in a set of directions as `1
+ * - mean(sin(h))`.
+ *
+ * @param  z           Input array representing the heightmap.
+ * @param  ndirections Number of horizon directions.
+ * @param  zscale      Vertical scaling of the heightmap, the horizontal extent
+ *                     of the array width being 1.
+ * @return             Array Resulting sky-view factor, in [0, 1].
+ *
+ * @note Zakšek, K., Oštir, K., Kokalj, Ž. (2011). Sky-view factor as a relief
+ * visualization technique. Remote Sensing, 3(2), 398-415.
+ *
+ * **Example**
+ * @include ex_shadow_heightmap.cpp
+ *
+ * **Result**
+ * @image html ex_shadow_heightmap.png
+ */
+Array sky_view_factor(const Array &z,
+                      int          ndirections = 16,
+                      float        zscale = 1.f);
 
 /**
  * @brief Compute the topographic shadow intensity in the range [-1, 1].
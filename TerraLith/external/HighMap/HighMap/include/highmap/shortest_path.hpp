@@ -26,6 +26,10 @@ namespace hmap
  * elevation and elevation change. The path is determined by minimizing the
  * combined cost function.
  *
+ * The search uses a binary heap and an A* lower bound based on the elevation
+ * of the endpoints (which does not change the resulting paths), and stops as
+ * soon as all the endpoints have been reached.
+ *
  * @see                       @cite Dijkstra1971 and
  *                            https://math.stackexchange.com/questions/3088292
  *
@@ -0,0 +1,198 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+   Public License. The full license is in the file LICENSE, distributed with
+   this software. */
+
+/**
+ * @file thread_pool.hpp
+ * @author  Otto Link (otto.link.bv@gmail.com)
+ * @brief Header file for the process-wide work-stealing thread pool used by the
+ * tile-parallel operations.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hmap
+{
+
+/**
+ * @brief The ThreadPool class is a singleton managing a fixed number of worker
+ * threads, each with its own task queue.
+ *
+ * Tasks submitted from a worker thread are pushed to the queue of this worker
+ * (and popped in LIFO order), tasks submitted from any other thread are pushed
+ * to a shared injection queue. Idle workers steal tasks from the other queues
+ * (in FIFO order). A thread waiting for a task group keeps executing pending
+ * tasks while waiting, so that task groups can be nested (for instance a tiled
+ * transform within a node computed by a parallel graph scheduler) without
+ * deadlock nor oversubscription.
+ *
+ * Tasks are usually not submitted directly but through a `TaskGroup` or the
+ * `parallel_for` helper.
+ *
+ * ### Usage Example:
+ *
+ * @code
+ * // once, at startup (0 = hardware concurrency)
+ * hmap::ThreadPool::get_instance().set_nthreads(8);
+ *
+ * hmap::TaskGroup group;
+ * for (size_t k = 0; k < n; ++k)
+ *   group.run([k]() { do_something(k); });
+ * group.wait();
+ * @endcode
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Gets the singleton instance of the ThreadPool class. The workers
+   * are started on first use, with a count equal to the hardware concurrency.
+   *
+   * @return ThreadPool& Reference to the singleton instance.
+   */
+  static ThreadPool &get_instance();
+
+  /**
+   * @brief Returns the number of worker threads.
+   *
+   * @return size_t Number of workers.
+   */
+  size_t get_nthreads() const;
+
+  /**
+   * @brief Returns true if the calling thread is one of the pool workers.
+   *
+   * @return bool Worker status.
+   */
+  bool is_worker_thread() const;
+
+  /**
+   * @brief Sets the number of worker threads. The workers are restarted, this
+   * must not be called while tasks are pending.
+   *
+   * @param new_nthreads Number of workers (0 for the hardware concurrency).
+   */
+  void set_nthreads(size_t new_nthreads);
+
+  /**
+   * @brief Submits a task to the pool.
+   *
+   * @param task Task to be executed.
+   */
+  void submit(std::function<void()> task);
+
+  /**
+   * @brief Executes, in the calling thread, one pending task if any.
+   *
+   * @return bool True if a task has been executed.
+   */
+  bool try_run_pending_task();
+
+  /**
+   * @brief Blocks until the predicate is true, executing pending tasks in the
+   * meantime. The predicate is re-evaluated each time `notify_all` is called.
+   *
+   * @param done Completion predicate.
+   */
+  void wait_until(const std::function<bool()> &done);
+
+  /**
+   * @brief Wakes up the threads sleeping in the pool (idle workers and
+   * waiting threads).
+   */
+  void notify_all();
+
+private:
+  /**
+   * @brief Task queue of a worker (or the injection queue).
+   */
+  struct WorkQueue
+  {
+    std::mutex                        mtx;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  ThreadPool();
+
+  ~ThreadPool();
+
+  bool pop_task(std::function<void()> &task);
+
+  void start(size_t nthreads);
+
+  void stop();
+
+  void worker_loop(size_t index);
+
+  // Deleting the copy constructor and assignment operator to enforce singleton
+  // pattern.
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+private:
+  std::vector<std::thread> workers; ///< Worker threads.
+  std::vector<std::unique_ptr<WorkQueue>>
+      queues; ///< One queue per worker, plus the injection queue (last one).
+  std::atomic<size_t> ntasks_pending = 0; ///< Number of queued tasks.
+  std::mutex          sleep_mtx;          ///< Mutex for the sleeping threads.
+  std::condition_variable cv;             ///< Wake-up condition.
+  bool                    stop_requested = false; ///< Workers shutdown flag.
+};
+
+/**
+ * @brief The TaskGroup class gathers tasks submitted to the thread pool and
+ * waits for their completion.
+ *
+ * If a task throws an exception, the first exception is rethrown by `wait`.
+ */
+class TaskGroup
+{
+public:
+  TaskGroup() = default;
+
+  /**
+   * @brief Destroys the TaskGroup object, waiting for the pending tasks (any
+   * exception is discarded).
+   */
+  ~TaskGroup();
+
+  /**
+   * @brief Submits a task to the thread pool.
+   *
+   * @param task Task to be executed.
+   */
+  void run(std::function<void()> task);
+
+  /**
+   * @brief Waits for all the tasks of the group, executing pending tasks of
+   * the pool in the meantime.
+   */
+  void wait();
+
+private:
+  std::atomic<size_t> npending = 0; ///< Number of unfinished tasks.
+  std::mutex          error_mtx;    ///< Protects the exception pointer.
+  std::exception_ptr  error = nullptr; ///< First exception thrown.
+};
+
+/**
+ * @brief Executes `fct(k)` for each `k` in [0, n[ using the thread pool, and
+ * waits for completion.
+ *
+ * @param n Number of iterations.
+ * @param fct Function executed for each iteration.
+ */
+void parallel_for(size_t n, const std::function<void(size_t)> &fct);
+
+} // namespace hmap
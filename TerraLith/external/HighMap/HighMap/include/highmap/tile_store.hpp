@@ -0,0 +1,275 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+   Public License. The full license is in the file LICENSE, distributed with
+   this software. */
+
+/**
+ * @file tile_store.hpp
+ * @author  Otto Link (otto.link.bv@gmail.com)
+ * @brief Out-of-core tile storage, for heightmaps larger than the available
+ * memory.
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "highmap/heightmap.hpp"
+
+namespace hmap
+{
+
+/**
+ * @brief TileStore class, tiles of an heightmap kept in a scratch file and
+ * paged in memory on demand, within a RAM budget.
+ *
+ * The tiles have the same layout as the tiles of an hmap::Heightmap with the
+ * same shape, tiling and overlap. A tile is loaded when it is acquired and
+ * stays in memory at least as long as the returned pointer is held. When the
+ * memory used by the resident tiles exceeds the budget, the least recently
+ * used tiles which are not held anymore are evicted, and written back to the
+ * scratch file if they have been acquired for writing. Tiles which have never
+ * been written are filled with zeros.
+ *
+ * The file accesses are serialized, the tiles can be acquired concurrently.
+ * The RAM budget is a soft limit, the tiles held at a given time are never
+ * evicted.
+ *
+ * ### Usage Example:
+ *
+ * @code
+ * hmap::TileStore store({32768, 32768}, {16, 16}, 0.f, "scratch.bin", 4 << 30);
+ *
+ * hmap::fill(store, [](hmap::Vec2<int> shape, hmap::Vec4<float> bbox)
+ *            { return hmap::noise(hmap::NoiseType::PERLIN, shape, {16.f,
+ *                                 16.f}, 0, nullptr, nullptr, nullptr, bbox);
+ *            });
+ *
+ * hmap::write_raw_16bit("out.raw", store);
+ * @endcode
+ */
+class TileStore
+{
+public:
+  /**
+   * @brief Construct a new TileStore object. The scratch file is created (or
+   * truncated) and removed when the store is destroyed.
+   *
+   * @param shape         Global shape.
+   * @param tiling        Tiling.
+   * @param overlap       Tile overlap (see hmap::Heightmap).
+   * @param scratch_fname Scratch file name.
+   * @param ram_budget    Memory budget for the resident tiles, in bytes.
+   */
+  TileStore(Vec2<int>          shape,
+            Vec2<int>          tiling,
+            float              overlap,
+            const std::string &scratch_fname,
+            size_t             ram_budget);
+
+  ~TileStore();
+
+  TileStore(const TileStore &) = delete;
+  TileStore &operator=(const TileStore &) = delete;
+
+  /**
+   * @brief Global shape.
+   */
+  Vec2<int> shape;
+
+  /**
+   * @brief Tiling.
+   */
+  Vec2<int> tiling;
+
+  /**
+   * @brief Tile overlap.
+   */
+  float overlap;
+
+  /**
+   * @brief Returns a tile, loading it from the scratch file if needed. The
+   * tile cannot be evicted while the returned pointer (or a copy of it) is
+   * alive.
+   *
+   * @param  k     Tile index.
+   * @param  write Whether the tile is going to be modified, in which case it is
+   *               written back to the scratch file when evicted.
+   * @return       std::shared_ptr<Tile> Tile.
+   */
+  std::shared_ptr<Tile> acquire(size_t k, bool write = true);
+
+  /**
+   * @brief Writes the modified resident tiles to the scratch file, and evicts
+   * the tiles exceeding the budget. The tiles still held are skipped, they
+   * remain modified.
+   */
+  void flush();
+
+  /**
+   * @brief Returns the global index of the first cell of the tile (overlap
+   * buffers included).
+   *
+   * @param  k Tile index.
+   * @return   Vec2<int> Index.
+   */
+  Vec2<int> get_tile_offset(size_t k) const;
+
+  /**
+   * @brief Returns the global index range {i1, i2, j1, j2} (upper bounds
+   * excluded) of the tile core, i.e. the tile without its overlap buffers.
+   * The cores of the tiles are a partition of the domain.
+   *
+   * @param  k Tile index.
+   * @return   Vec4<int> Index range.
+   */
+  Vec4<int> get_tile_core(size_t k) const;
+
+  /**
+   * @brief Returns the tile index from the tile indices in each direction.
+   *
+   * @param  i Tile index in the first direction.
+   * @param  j Tile index in the second direction.
+   * @return   int Tile index.
+   */
+  int get_tile_index(int i, int j) const;
+
+  /**
+   * @brief Returns the number of tiles.
+   *
+   * @return size_t Number of tiles.
+   */
+  size_t get_ntiles() const;
+
+  /**
+   * @brief Returns the memory used by the resident tiles, in bytes.
+   *
+   * @return size_t Memory.
+   */
+  size_t get_resident_bytes() const;
+
+  /**
+   * @brief Returns the maximum value, over the tile cores (tiles are streamed
+   * one after the other).
+   *
+   * @return float Maximum.
+   */
+  float max();
+
+  /**
+   * @brief Returns the minimum value, over the tile cores (tiles are streamed
+   * one after the other).
+   *
+   * @return float Minimum.
+   */
+  float min();
+
+  /**
+   * @brief Copies the tiles of an heightmap with the same shape, tiling and
+   * overlap.
+   *
+   * @param h Input heightmap.
+   */
+  void from_heightmap(const Heightmap &h);
+
+  /**
+   * @brief Returns an in-memory heightmap with the tiles of the store.
+   *
+   * @return Heightmap Heightmap.
+   */
+  Heightmap to_heightmap();
+
+private:
+  struct Slot
+  {
+    Vec2<int>             shape; ///< Tile shape.
+    Vec2<float>           shift; ///< Tile shift.
+    Vec2<float>           scale; ///< Tile scale.
+    Vec4<float>           bbox;  ///< Tile bounding box.
+    std::shared_ptr<Tile> tile;  ///< Resident tile, or nullptr.
+    bool                  dirty = false;   ///< Modified since last write.
+    bool                  on_disk = false; ///< Written at least once.
+    uint64_t              last_use = 0;    ///< Access counter at last use.
+    uint64_t              file_offset = 0; ///< Position in the scratch file.
+  };
+
+  void evict_over_budget();
+
+  void write_slot(Slot &slot);
+
+  std::vector<Slot>  tile_slots;
+  std::string        scratch_fname;
+  std::fstream       file;
+  size_t             ram_budget;
+  size_t             resident_bytes = 0;
+  uint64_t           use_counter = 0;
+  mutable std::mutex mtx; ///< Protects the tile slots and the scratch file.
+};
+
+/**
+ * @brief Fills the tiles of a store, streaming them through the memory.
+ *
+ * @param store      Tile store.
+ * @param nullary_op Function returning the tile values, given the tile shape
+ *                   and bounding box.
+ */
+void fill(TileStore                                   &store,
+          std::function<Array(Vec2<int>, Vec4<float>)> nullary_op);
+
+/**
+ * @brief Applies an operator to the tiles of a collection of stores sharing
+ * the same layout, the tiles being processed in parallel and streamed through
+ * the memory (equivalent to hmap::TransformMode::DISTRIBUTED).
+ *
+ * @param p_stores Stores (nullptr entries are passed as nullptr arrays).
+ * @param op       Operator, taking the tiles, the tile shape and the tile
+ *                 bounding box.
+ * @param is_write Access intent of each store: only the tiles of the stores
+ *                 flagged `true` are written back to the scratch files, the
+ *                 modifications of the other tiles are lost when they are
+ *                 evicted. If empty, every store is acquired for writing.
+ *
+ * **Example**
+ * @code
+ * // 'out' is written, 'in' is only read
+ * hmap::transform({&out, &in}, op, {true, false});
+ * @endcode
+ */
+void transform(std::vector<TileStore *>                     p_stores,
+               std::function<void(const std::vector<Array *>,
+                                  const hmap::Vec2<int>,
+                                  const hmap::Vec4<float>)> op,
+               const std::vector<bool>                     &is_write = {});
+
+/**
+ * @brief Exports a tile store to a 16-bit 'raw' file, streaming the rows of
+ * tiles without assembling the full-resolution array.
+ *
+ * The file layout is the one of hmap::write_raw_16bit.
+ *
+ * @param fname Output file name.
+ * @param store Tile store.
+ */
+void write_raw_16bit(const std::string &fname, TileStore &store);
+
+/**
+ * @brief Exports a tile store as a set of grayscale PNG images, one per tile
+ * core, named `<fname_radical>_<i>_<j>.png`.
+ *
+ * @param fname_radical Base name for output image files.
+ * @param store         Tile store.
+ * @param leading_zeros Number of digits used to pad the tile indices.
+ * @param depth         Bit depth of the output PNG images (CV_8U or CV_16U).
+ */
+void export_tiled(const std::string &fname_radical,
+                  TileStore         &store,
+                  int                leading_zeros = 0,
+                  int                depth = CV_8U);
+
+} // namespace hmap
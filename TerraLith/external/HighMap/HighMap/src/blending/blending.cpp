@@ -65,6 +65,36 @@ Array blend_overlay(const Array &array1, const Array &array2)
   return array_out;
 }
 
+Array blend_poisson(const Array &array1,
+                    const Array &array2,
+                    const Array *p_mask,
+                    int          cycles_max,
+                    float        tolerance)
+{
+  // u such that laplacian(u) = laplacian(array2), with the values of
+  // array1 on the borders and outside the mask
+  Array u = array1;
+  Array rhs = laplacian(array2);
+
+  if (p_mask)
+  {
+    Array mask_fixed(array1.shape);
+
+    for (size_t k = 0; k < mask_fixed.vector.size(); k++)
+      mask_fixed.vector[k] = p_mask->vector[k] > 0.f ? 0.f : 1.f;
+
+    solve_poisson_multigrid(rhs, u, &mask_fixed, cycles_max, tolerance);
+
+    // smooth transition for soft masks
+    return lerp(array1, u, *p_mask);
+  }
+  else
+  {
+    solve_poisson_multigrid(rhs, u, nullptr, cycles_max, tolerance);
+    return u;
+  }
+}
+
 Array blend_soft(const Array &array1, const Array &array2)
 {
   Array array_out = Array(array1.shape);
@@ -2,43 +2,147 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 
+#include <algorithm>
 #include <cmath>
 
+#include <opencv2/core.hpp>
+
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
 #include "highmap/boundary.hpp"
 #include "highmap/convolve.hpp"
 
+// kernel size above which the 1D convolutions are computed with the
+// FFT
+#define CONVOLVE_FFT_MIN_KERNEL_SIZE 64
+
+// width of the column strips of the direct convolution along 'j'
+#define CONVOLVE_STRIP_WIDTH 512
+
 namespace hmap
 {
 
+// reflected index, same padding as the former implementation (mirror
+// without repeating the first cell, with the last cell repeated)
+static inline int helper_reflect(int k, int n)
+{
+  if (k < 0)
+    k = -k;
+  else if (k > n - 1)
+    k = 2 * n - 1 - k;
+  return std::clamp(k, 0, n - 1);
+}
+
+// correlation of each row of 'rows' (nrows x nfft, with the padded rows
+// stored in the first n + nk - 1 columns) with the kernel, using the
+// FFT. The n first values of each row are overwritten by the result
+static void helper_correlate_rows_fft(std::vector<float>       &rows,
+                                      int                       nrows,
+                                      int                       nfft,
+                                      int                       n,
+                                      const std::vector<float> &kernel)
+{
+  const int nk = (int)kernel.size();
+
+  // correlation recast as a convolution with the reversed kernel, the
+  // linear convolution is recovered from the circular one since nfft >=
+  // n + nk - 1 (the outputs of interest start at nk - 1)
+  std::vector<float> kernel_r(nfft, 0.f);
+  for (int p = 0; p < nk; p++)
+    kernel_r[p] = kernel[nk - 1 - p];
+
+  cv::Mat kernel_mat(1, nfft, CV_32FC1, kernel_r.data());
+  cv::Mat kernel_hat;
+  cv::dft(kernel_mat, kernel_hat, cv::DFT_COMPLEX_OUTPUT);
+
+  cv::Mat rows_mat(nrows, nfft, CV_32FC1, rows.data());
+  cv::Mat rows_hat;
+  cv::dft(rows_mat, rows_hat, cv::DFT_ROWS | cv::DFT_COMPLEX_OUTPUT);
+
+  // spectrum product (interleaved real and imaginary parts)
+  const float *kh = kernel_hat.ptr<float>(0);
+
+  for (int r = 0; r < nrows; r++)
+  {
+    float *rh = rows_hat.ptr<float>(r);
+
+    for (int m = 0; m < 2 * nfft; m += 2)
+    {
+      float re = rh[m] * kh[m] - rh[m + 1] * kh[m + 1];
+      float im = rh[m] * kh[m + 1] + rh[m + 1] * kh[m];
+      rh[m] = re;
+      rh[m + 1] = im;
+    }
+  }
+
+  cv::Mat rows_conv;
+  cv::dft(rows_hat,
+          rows_conv,
+          cv::DFT_INVERSE | cv::DFT_ROWS | cv::DFT_SCALE |
+              cv::DFT_REAL_OUTPUT);
+
+  for (int r = 0; r < nrows; r++)
+  {
+    const float *rc = rows_conv.ptr<float>(r) + nk - 1;
+    std::copy(rc, rc + n, &rows[(size_t)r * nfft]);
+  }
+}
+
 Array convolve1d_i(const Array              &array,
                    const std::vector<float> &kernel) // private
 {
   Array array_out = Array(array.shape);
 
   // padding extent
+  const int nx = array.shape.x;
   const int nk = (int)kernel.size();
   const int i1 = (int)ceil(0.5f * (float)nk);
+  const int np = nx + nk - 1; // padded row length
 
-  for (int p = 0; p < nk; p++)
+  if (nk > CONVOLVE_FFT_MIN_KERNEL_SIZE)
   {
-    for (int i = 0; i < array.shape.x; i++)
+    const int          nfft = cv::getOptimalDFTSize(np);
+    std::vector<float> rows((size_t)array.shape.y * nfft, 0.f);
+
+    for (int j = 0; j < array.shape.y; j++)
     {
-      int ii;
-      // east - west
-      if (i + p - i1 < 0)
-        ii = -(i + p - i1);
-      else if (i + p - i1 > array.shape.x - 1)
-        ii = 2 * array.shape.x - 1 - (i + p - i1);
-      else
-        ii = i + p - i1;
-
-      ii = std::clamp(ii, 0, array.shape.x - 1);
-
-      for (int j = 0; j < array.shape.y; j++)
-        array_out(i, j) += array(ii, j) * kernel[p];
+      const float *row = &array.vector[j * nx];
+      float       *row_p = &rows[(size_t)j * nfft];
+
+      for (int m = 0; m < np; m++)
+        row_p[m] = row[helper_reflect(m - i1, nx)];
+    }
+
+    helper_correlate_rows_fft(rows, array.shape.y, nfft, nx, kernel);
+
+    for (int j = 0; j < array.shape.y; j++)
+      std::copy(&rows[(size_t)j * nfft],
+                &rows[(size_t)j * nfft] + nx,
+                &array_out.vector[j * nx]);
+
+    return array_out;
+  }
+
+  // direct convolution, the row is padded once and all the loops over
+  // the taps are contiguous
+  std::vector<float> row_p(np);
+
+  for (int j = 0; j < array.shape.y; j++)
+  {
+    const float *row = &array.vector[j * nx];
+    float       *row_out = &array_out.vector[j * nx];
+
+    for (int m = 0; m < np; m++)
+      row_p[m] = row[helper_reflect(m - i1, nx)];
+
+    for (int p = 0; p < nk; p++)
+    {
+      const float  kp = kernel[p];
+      const float *src = &row_p[p];
+
+      for (int i = 0; i < nx; i++)
+        row_out[i] += kp * src[i];
     }
   }
 
@@ -51,27 +155,55 @@ Array convolve1d_j(const Array              &array,
   Array array_out = Array(array.shape);
 
   // padding extent
+  const int nx = array.shape.x;
+  const int ny = array.shape.y;
   const int nk = (int)kernel.size();
   const int j1 = (int)ceil(0.5f * (float)nk);
 
-  for (int q = 0; q < nk; q++)
+  if (nk > CONVOLVE_FFT_MIN_KERNEL_SIZE)
   {
-    for (int j = 0; j < array.shape.y; j++)
+    // columns are transposed to rows for the FFT
+    const int          np = ny + nk - 1;
+    const int          nfft = cv::getOptimalDFTSize(np);
+    std::vector<float> rows((size_t)nx * nfft, 0.f);
+
+    for (int m = 0; m < np; m++)
     {
-      int jj;
+      const float *row = &array.vector[helper_reflect(m - j1, ny) * nx];
+
+      for (int i = 0; i < nx; i++)
+        rows[(size_t)i * nfft + m] = row[i];
+    }
 
-      // north - south
-      if (j + q - j1 < 0)
-        jj = -(j + q - j1);
-      else if (j + q - j1 > array.shape.y - 1)
-        jj = 2 * array.shape.y - 1 - (j + q - j1);
-      else
-        jj = j + q - j1;
+    helper_correlate_rows_fft(rows, nx, nfft, ny, kernel);
 
-      jj = std::clamp(jj, 0, array.shape.y - 1);
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        array_out.vector[j * nx + i] = rows[(size_t)i * nfft + j];
 
-      for (int i = 0; i < array.shape.x; i++)
-        array_out(i, j) += array(i, jj) * kernel[q];
+    return array_out;
+  }
+
+  // direct convolution, whole rows are accumulated (contiguous inner
+  // loop) by strips of columns so that the nk input rows used for an
+  // output row stay in cache
+  for (int i0 = 0; i0 < nx; i0 += CONVOLVE_STRIP_WIDTH)
+  {
+    const int ni = std::min(CONVOLVE_STRIP_WIDTH, nx - i0);
+
+    for (int j = 0; j < ny; j++)
+    {
+      float *row_out = &array_out.vector[j * nx + i0];
+
+      for (int q = 0; q < nk; q++)
+      {
+        const float  kq = kernel[q];
+        const float *src = &array.vector[helper_reflect(j + q - j1, ny) * nx +
+                                         i0];
+
+        for (int i = 0; i < ni; i++)
+          row_out[i] += kq * src[i];
+      }
     }
   }
 
@@ -96,11 +228,28 @@ Array convolve2d_truncated(const Array &array, const Array &kernel)
   Array array_out = Array(Vec2<int>(array.shape.x - kernel.shape.x,
                                     array.shape.y - kernel.shape.y));
 
+  // loops ordered so that the innermost one runs along the rows of
+  // both the input and the output arrays
+  const int nx = array_out.shape.x;
+
   for (int j = 0; j < array_out.shape.y; j++)
-    for (int i = 0; i < array_out.shape.x; i++)
-      for (int q = 0; q < kernel.shape.y; q++)
-        for (int p = 0; p < kernel.shape.x; p++)
-          array_out(i, j) += array(i + p, j + q) * kernel(p, q);
+  {
+    float *row_out = &array_out.vector[j * nx];
+
+    for (int q = 0; q < kernel.shape.y; q++)
+    {
+      const float *row = &array.vector[(j + q) * array.shape.x];
+
+      for (int p = 0; p < kernel.shape.x; p++)
+      {
+        const float  kpq = kernel(p, q);
+        const float *src = row + p;
+
+        for (int i = 0; i < nx; i++)
+          row_out[i] += kpq * src[i];
+      }
+    }
+  }
 
   return array_out;
 }
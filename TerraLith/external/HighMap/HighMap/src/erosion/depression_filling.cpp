@@ -1,61 +1,100 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
-#include <cmath>
+#include <queue>
 
 #include "highmap/array.hpp"
-#include "highmap/boundary.hpp"
-#include "highmap/math.hpp"
-
-// neighbor pattern search
-// 6 2 8
-// 1 . 4
-// 5 3 7
-// clang-format off
-#define DI {-1, 0, 0, 1, -1, -1, 1, 1}
-#define DJ {0, 1, -1, 0, -1, 1, -1, 1}
-#define C  {1.f, 1.f, 1.f, 1.f, M_SQRT2, M_SQRT2, M_SQRT2, M_SQRT2}
-// clang-format on
+#include "highmap/erosion.hpp"
+#include "highmap/execution_context.hpp"
+
+// number of filled cells between two polls of the execution context
+#define DEPRESSION_FILLING_POLL_PERIOD 65536
 
 namespace hmap
 {
 
-void depression_filling(Array &z, int iterations, float epsilon)
+struct FloodCell
+{
+  float z;
+  int   i;
+  int   j;
+
+  bool operator>(const FloodCell &other) const { return this->z > other.z; }
+};
+
+using FloodQueue = std::priority_queue<FloodCell,
+                                       std::vector<FloodCell>,
+                                       std::greater<FloodCell>>;
+
+// fill the cells of 'z' not closed yet, starting from the cells
+// already in the queue. Only the cells lying in a depression (not
+// above the cell they have been reached from) are raised, 'epsilon'
+// (times the neighbor distance) above that cell, the other cells are
+// left untouched
+static void priority_flood(Array             &z,
+                           std::vector<char> &closed,
+                           FloodQueue        &queue,
+                           float              epsilon)
+{
+  const std::vector<int>   di = DI;
+  const std::vector<int>   dj = DJ;
+  const std::vector<float> c = CD;
+
+  // each cell is queued once
+  size_t npopped = 0;
+
+  while (!queue.empty())
+  {
+    if (++npopped % DEPRESSION_FILLING_POLL_PERIOD == 0)
+      poll_execution_context((float)npopped / (float)z.size());
+
+    FloodCell cell = queue.top();
+    queue.pop();
+
+    for (size_t k = 0; k < di.size(); k++)
+    {
+      int p = cell.i + di[k];
+      int q = cell.j + dj[k];
+
+      if (p < 0 || p >= z.shape.x || q < 0 || q >= z.shape.y) continue;
+
+      int r = q * z.shape.x + p;
+      if (closed[r]) continue;
+      closed[r] = 1;
+
+      if (z(p, q) <= cell.z) z(p, q) = cell.z + epsilon * c[k];
+      queue.push({z(p, q), p, q});
+    }
+  }
+}
+
+void depression_filling(Array &z, float epsilon)
 {
-  std::vector<int>   di = DI;
-  std::vector<int>   dj = DJ;
-  std::vector<float> c = C;
-  const uint         nb = di.size();
+  std::vector<char> closed(z.size(), 0);
+  FloodQueue        queue;
 
-  Array z_new = z;
-  z_new.set_slice({1, z.shape.x - 1, 1, z.shape.y - 1}, 1e6f);
+  // the domain borders are the outlets
+  auto seed = [&](int i, int j)
+  {
+    int r = j * z.shape.x + i;
+    if (closed[r]) return;
+    closed[r] = 1;
+    queue.push({z(i, j), i, j});
+  };
 
-  for (int it = 0; it < iterations; it++)
+  for (int i = 0; i < z.shape.x; i++)
   {
-    for (int j = 1; j < z.shape.y - 1; j++)
-      for (int i = 1; i < z.shape.x - 1; i++)
-      {
-        if (z_new(i, j) > z(i, j))
-        {
-          for (uint k = 0; k < nb; k++)
-          {
-            int p = i + di[k];
-            int q = j + dj[k];
-
-            if (z(i, j) >= z_new(p, q) + epsilon * c[k])
-            {
-              z_new(i, j) = z(i, j);
-              break;
-            }
-
-            if (z_new(i, j) > z_new(p, q) + epsilon * c[k])
-              z_new(i, j) = z_new(p, q) + epsilon * c[k];
-          }
-        }
-      }
+    seed(i, 0);
+    seed(i, z.shape.y - 1);
   }
-  extrapolate_borders(z_new);
-  z = z_new;
+
+  for (int j = 0; j < z.shape.y; j++)
+  {
+    seed(0, j);
+    seed(z.shape.x - 1, j);
+  }
+
+  priority_flood(z, closed, queue, epsilon);
 }
 
 } // namespace hmap
@@ -1,28 +1,35 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <algorithm>
+
+#include "highmap/execution_context.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/math.hpp"
 #include "highmap/opencl/gpu_opencl.hpp"
 #include "highmap/range.hpp"
 
+// number of particles launched by a single kernel run, the execution context
+// is polled between the runs
+#define HYDRAULIC_PARTICLE_GPU_BATCH_SIZE 65536
+
 namespace hmap::gpu
 {
 
-void hydraulic_particle(Array &z,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock,
-                        Array *p_moisture_map,
-                        Array *p_erosion_map,
-                        Array *p_deposition_map,
-                        float  c_capacity,
-                        float  c_erosion,
-                        float  c_deposition,
-                        float  c_inertia,
-                        float  drag_rate,
-                        float  evap_rate,
-                        bool   post_filtering)
+void hydraulic_particle(Array       &z,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock,
+                        const Array *p_moisture_map,
+                        Array       *p_erosion_map,
+                        Array       *p_deposition_map,
+                        float        c_capacity,
+                        float        c_erosion,
+                        float        c_deposition,
+                        float        c_inertia,
+                        float        drag_rate,
+                        float        evap_rate,
+                        bool         post_filtering)
 {
   Array z_bckp = Array();
   if ((p_erosion_map != nullptr) | (p_deposition_map != nullptr)) z_bckp = z;
@@ -46,11 +53,24 @@ void hydraulic_particle(Array &z,
                      drag_rate,
                      evap_rate,
                      p_bedrock ? 1 : 0,
-                     p_moisture_map ? 1 : 0);
+                     p_moisture_map ? 1 : 0,
+                     0); // id_offset
 
   run.write_buffer("z");
 
-  run.execute(nparticles);
+  // the particles are run by batches, with the same particle ids (and
+  // random seeds) as a single run
+  for (int offset = 0; offset < nparticles;
+       offset += HYDRAULIC_PARTICLE_GPU_BATCH_SIZE)
+  {
+    int count = std::min(HYDRAULIC_PARTICLE_GPU_BATCH_SIZE,
+                         nparticles - offset);
+
+    run.set_argument(15, offset);
+    run.execute(count);
+
+    poll_execution_context((float)(offset + count) / (float)nparticles);
+  }
 
   run.read_buffer("z");
 
@@ -76,21 +96,21 @@ void hydraulic_particle(Array &z,
   }
 }
 
-void hydraulic_particle(Array &z,
-                        Array *p_mask,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock,
-                        Array *p_moisture_map,
-                        Array *p_erosion_map,
-                        Array *p_deposition_map,
-                        float  c_capacity,
-                        float  c_erosion,
-                        float  c_deposition,
-                        float  c_inertia,
-                        float  drag_rate,
-                        float  evap_rate,
-                        bool   post_filtering)
+void hydraulic_particle(Array       &z,
+                        const Array *p_mask,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock,
+                        const Array *p_moisture_map,
+                        Array       *p_erosion_map,
+                        Array       *p_deposition_map,
+                        float        c_capacity,
+                        float        c_erosion,
+                        float        c_deposition,
+                        float        c_inertia,
+                        float        drag_rate,
+                        float        evap_rate,
+                        bool         post_filtering)
 {
   if (!p_mask)
     gpu::hydraulic_particle(z,
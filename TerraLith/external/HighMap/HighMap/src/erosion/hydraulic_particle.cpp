@@ -1,19 +1,34 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
-#include <random>
+
+/* Particles are advanced by batches of a few steps. Before each batch, the
+ * active particles are bucketed by the square tile containing them and the
+ * tiles are split into 4 colors according to the parity of their indices.
+ * Since a particle moves by at most one cell per step, all the cells read
+ * or written by the particles of a tile during a batch remain within a
+ * margin of the tile smaller than a tile, the tiles of a given color are
+ * then processed in parallel without any conflict. The colors are processed
+ * one after the other and the particles of a tile in their index order, the
+ * result is then independent of the number of threads. */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
 #include "highmap/boundary.hpp"
 #include "highmap/erosion.hpp"
+#include "highmap/execution_context.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/geometry/point_sampling.hpp"
 #include "highmap/kernels.hpp"
 #include "highmap/math.hpp"
 #include "highmap/primitives.hpp"
 #include "highmap/range.hpp"
+#include "highmap/thread_pool.hpp"
 
 #include "highmap/geometry/cloud.hpp"
 
@@ -22,34 +37,111 @@
 #define HMAP_EROSION_DT 1.f
 #define HMAP_EROSION_VOLUME_MIN 0.01f
 
+// tile size (cells) of the particle buckets, must be larger than twice the
+// distance traveled during a batch plus the particle stencil
+#define HYDRAULIC_PARTICLE_TILE_SIZE 32
+
+// number of steps performed by a particle between two bucketings
+#define HYDRAULIC_PARTICLE_BATCH_STEPS 8
+
+// below this number of active particles, the tiles are processed serially
+// (same schedule, no threading overhead)
+#define HYDRAULIC_PARTICLE_PARALLEL_MIN 2048
+
 namespace hmap
 {
 
+//----------------------------------------------------------------------
+// Helper(s)
+//----------------------------------------------------------------------
+
+// move the particle by one step, eroding or deposing sediment at its
+// previous position
+static void helper_particle_step(Particle    &particle,
+                                 Array       &z,
+                                 const Array *p_bedrock,
+                                 float        dt,
+                                 float        evap_rate)
+{
+  const int ni = z.shape.x;
+  const int nj = z.shape.y;
+
+  float z_prev = z.get_value_bilinear_at(particle.pos.i,
+                                         particle.pos.j,
+                                         particle.pos.u,
+                                         particle.pos.v);
+  Pos   pos_prev = particle.pos;
+
+  particle.move(z, dt);
+
+  if (!particle.is_active) return;
+
+  if ((particle.pos.i < 1) or (particle.pos.i > ni - 2) or
+      (particle.pos.j < 1) or (particle.pos.j > nj - 2))
+  {
+    particle.is_active = false;
+    return;
+  }
+
+  float z_next = z.get_value_bilinear_at(particle.pos.i,
+                                         particle.pos.j,
+                                         particle.pos.u,
+                                         particle.pos.v);
+
+  // particle sediment capacity
+  float dz = z_prev - z_next;
+  float sc = particle.c_capacity * particle.volume * particle.vnorm * dz;
+  float delta_sc = dt * (sc - particle.sediment);
+  float amount;
+
+  if (delta_sc > 0.f)
+    amount = particle.c_erosion * delta_sc; // erosion
+  else
+    amount = particle.c_deposition * delta_sc; // deposition
+
+  particle.sediment += amount;
+
+  z.depose_amount_bilinear_at(pos_prev.i,
+                              pos_prev.j,
+                              pos_prev.u,
+                              pos_prev.v,
+                              -amount);
+
+  // make sure bedrock is not eroded
+  if (p_bedrock)
+    z(pos_prev.i, pos_prev.j) = std::max(z(pos_prev.i, pos_prev.j),
+                                         (*p_bedrock)(pos_prev.i, pos_prev.j));
+
+  particle.volume *= (1 - dt * evap_rate);
+
+  if (particle.volume < HMAP_EROSION_VOLUME_MIN) particle.is_active = false;
+}
+
 //----------------------------------------------------------------------
 // Main operator(s)
 //----------------------------------------------------------------------
 
-void hydraulic_particle(Array &z,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock,
-                        Array *p_moisture_map,
-                        Array *p_erosion_map,
-                        Array *p_deposition_map,
-                        float  c_capacity,
-                        float  c_erosion,
-                        float  c_deposition,
-                        float  c_inertia,
-                        float  drag_rate,
-                        float  evap_rate,
-                        bool   post_filtering)
+void hydraulic_particle(Array       &z,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock,
+                        const Array *p_moisture_map,
+                        Array       *p_erosion_map,
+                        Array       *p_deposition_map,
+                        float        c_capacity,
+                        float        c_erosion,
+                        float        c_deposition,
+                        float        c_inertia,
+                        float        drag_rate,
+                        float        evap_rate,
+                        bool         post_filtering,
+                        int          nthreads)
 {
   const int ni = z.shape.x;
   const int nj = z.shape.y;
   float     dt = HMAP_EROSION_DT;
 
-  std::mt19937                          gen(seed);
-  std::uniform_real_distribution<float> dis(0, 1);
+  auto t0 = std::chrono::steady_clock::now();
 
   // --- initialization
 
@@ -82,75 +174,115 @@ void hydraulic_particle(Array &z,
     particles.push_back(p);
   }
 
+  // --- tiles and their colors
+
+  const int ntx = (ni + HYDRAULIC_PARTICLE_TILE_SIZE - 1) /
+                  HYDRAULIC_PARTICLE_TILE_SIZE;
+  const int nty = (nj + HYDRAULIC_PARTICLE_TILE_SIZE - 1) /
+                  HYDRAULIC_PARTICLE_TILE_SIZE;
+  const int ntiles = ntx * nty;
+
+  std::vector<std::vector<int>> color_tiles(4);
+
+  for (int tj = 0; tj < nty; tj++)
+    for (int ti = 0; ti < ntx; ti++)
+      color_tiles[(tj % 2) * 2 + ti % 2].push_back(tj * ntx + ti);
+
+  const int nworkers = nthreads > 0
+                           ? nthreads
+                           : (int)ThreadPool::get_instance().get_nthreads();
+
   // --- main loop
 
-  // keep track of the number of active particles
-  int n_active_particles = nparticles;
+  // indices of the active particles (in increasing order), and particle
+  // indices sorted by tile
+  std::vector<int> active(nparticles);
+  std::vector<int> sorted(nparticles);
+  std::vector<int> tile_start(ntiles + 1);
+
+  for (int ip = 0; ip < nparticles; ip++)
+    active[ip] = ip;
 
-  // loop over particles
-  while (n_active_particles > 0)
+  while (!active.empty())
   {
-    for (auto &particle : particles)
+    poll_execution_context(1.f - (float)active.size() / (float)nparticles);
+
+    // bucket the active particles by tile (stable counting sort)
+    std::fill(tile_start.begin(), tile_start.end(), 0);
+
+    auto tile_of = [&](const Particle &p)
     {
-      if (particle.is_active)
-      {
-        float z_prev = z.get_value_bilinear_at(particle.pos.i,
-                                               particle.pos.j,
-                                               particle.pos.u,
-                                               particle.pos.v);
-        Pos   pos_prev = particle.pos;
+      return (p.pos.j / HYDRAULIC_PARTICLE_TILE_SIZE) * ntx +
+             p.pos.i / HYDRAULIC_PARTICLE_TILE_SIZE;
+    };
 
-        particle.move(z, dt);
+    for (int ip : active)
+      tile_start[tile_of(particles[ip]) + 1]++;
 
-        if ((particle.pos.i < 1) or (particle.pos.i > ni - 2) or
-            (particle.pos.j < 1) or (particle.pos.j > nj - 2))
-        {
-          particle.is_active = false;
-        }
-        else
+    for (int t = 0; t < ntiles; t++)
+      tile_start[t + 1] += tile_start[t];
+
+    {
+      std::vector<int> pos(tile_start.begin(), tile_start.end() - 1);
+      for (int ip : active)
+        sorted[pos[tile_of(particles[ip])]++] = ip;
+    }
+
+    // advance the particles of a tile
+    auto fct_tile = [&](int t)
+    {
+      for (int k = tile_start[t]; k < tile_start[t + 1]; k++)
+      {
+        Particle &particle = particles[sorted[k]];
+
+        for (int s = 0; s < HYDRAULIC_PARTICLE_BATCH_STEPS; s++)
         {
-          float z_next = z.get_value_bilinear_at(particle.pos.i,
-                                                 particle.pos.j,
-                                                 particle.pos.u,
-                                                 particle.pos.v);
-
-          // particle sediment capacity
-          float dz = z_prev - z_next;
-          float sc = particle.c_capacity * particle.volume * particle.vnorm *
-                     dz;
-          float delta_sc = dt * (sc - particle.sediment);
-          float amount;
-
-          if (delta_sc > 0.f)
-            amount = particle.c_erosion * delta_sc; // erosion
-          else
-            amount = particle.c_deposition * delta_sc; // deposition
-
-          particle.sediment += amount;
-
-          z.depose_amount_bilinear_at(pos_prev.i,
-                                      pos_prev.j,
-                                      pos_prev.u,
-                                      pos_prev.v,
-                                      -amount);
-
-          // make sure bedrock is not eroded
-          if (p_bedrock)
-            z(pos_prev.i,
-              pos_prev.j) = std::max(z(pos_prev.i, pos_prev.j),
-                                     (*p_bedrock)(pos_prev.i, pos_prev.j));
-
-          particle.volume *= (1 - dt * evap_rate);
-
-          if (particle.volume < HMAP_EROSION_VOLUME_MIN)
-            particle.is_active = false;
+          helper_particle_step(particle, z, p_bedrock, dt, evap_rate);
+          if (!particle.is_active) break;
         }
+      }
+    };
 
-        if (!particle.is_active) n_active_particles--;
+    const bool run_parallel = nworkers > 1 && (int)active.size() >=
+                                                  HYDRAULIC_PARTICLE_PARALLEL_MIN;
+
+    for (auto &tiles : color_tiles)
+    {
+      if (!run_parallel)
+      {
+        for (int t : tiles)
+          fct_tile(t);
+        continue;
       }
+
+      // the workers pick the tiles one after the other, the order does
+      // not matter since the tiles of a color are independent
+      std::atomic<size_t> next = 0;
+
+      parallel_for(std::min((size_t)nworkers, tiles.size()),
+                   [&](size_t)
+                   {
+                     size_t k;
+                     while ((k = next.fetch_add(1)) < tiles.size())
+                       fct_tile(tiles[k]);
+                   });
     }
+
+    // keep the active particles
+    active.erase(std::remove_if(active.begin(),
+                                active.end(),
+                                [&](int ip) { return !particles[ip].is_active; }),
+                 active.end());
   }
 
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - t0)
+                       .count();
+
+  LOG_DEBUG("hydraulic_particle: %d particles, %.0f particles/s",
+            nparticles,
+            elapsed > 0.0 ? (double)nparticles / elapsed : 0.0);
+
   extrapolate_borders(z);
 
   // last pass for bedrock
@@ -181,21 +313,22 @@ void hydraulic_particle(Array &z,
   }
 }
 
-void hydraulic_particle(Array &z,
-                        Array *p_mask,
-                        int    nparticles,
-                        int    seed,
-                        Array *p_bedrock,
-                        Array *p_moisture_map,
-                        Array *p_erosion_map,
-                        Array *p_deposition_map,
-                        float  c_capacity,
-                        float  c_erosion,
-                        float  c_deposition,
-                        float  c_inertia,
-                        float  drag_rate,
-                        float  evap_rate,
-                        bool   post_filtering)
+void hydraulic_particle(Array       &z,
+                        const Array *p_mask,
+                        int          nparticles,
+                        int          seed,
+                        const Array *p_bedrock,
+                        const Array *p_moisture_map,
+                        Array       *p_erosion_map,
+                        Array       *p_deposition_map,
+                        float        c_capacity,
+                        float        c_erosion,
+                        float        c_deposition,
+                        float        c_inertia,
+                        float        drag_rate,
+                        float        evap_rate,
+                        bool         post_filtering,
+                        int          nthreads)
 {
   if (!p_mask)
     hydraulic_particle(z,
@@ -211,7 +344,8 @@ void hydraulic_particle(Array &z,
                        c_inertia,
                        drag_rate,
                        evap_rate,
-                       post_filtering);
+                       post_filtering,
+                       nthreads);
   else
   {
     Array z_f = z;
@@ -228,7 +362,8 @@ void hydraulic_particle(Array &z,
                        c_inertia,
                        drag_rate,
                        evap_rate,
-                       post_filtering);
+                       post_filtering,
+                       nthreads);
     z = lerp(z, z_f, *(p_mask));
   }
 }
@@ -157,7 +157,7 @@ void hydraulic_procedural(Array         &z,
                           bool           rotate90,
                           bool           use_default_mask,
                           float          talus_mask,
-                          Array         *p_mask,
+                          const Array   *p_mask,
                           Array         *p_ridge_mask,
                           float          vmin,
                           float          vmax)
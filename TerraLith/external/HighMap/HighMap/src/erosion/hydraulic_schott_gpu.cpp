@@ -79,7 +79,7 @@ void hydraulic_schott(Array       &z,
 void hydraulic_schott(Array       &z,
                       int          iterations,
                       const Array &talus,
-                      Array       *p_mask,
+                      const Array *p_mask,
                       float        c_erosion,
                       float        c_thermal,
                       float        c_deposition,
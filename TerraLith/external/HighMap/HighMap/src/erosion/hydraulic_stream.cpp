@@ -6,6 +6,7 @@
 #include "highmap/array.hpp"
 #include "highmap/blending.hpp"
 #include "highmap/convolve.hpp"
+#include "highmap/erosion.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/gradient.hpp"
 #include "highmap/hydrology.hpp"
@@ -17,14 +18,15 @@
 namespace hmap
 {
 
-void hydraulic_stream(Array &z,
-                      float  c_erosion,
-                      float  talus_ref,
-                      Array *p_bedrock,
-                      Array *p_moisture_map,
-                      Array *p_erosion_map,
-                      int    ir,
-                      float  clipping_ratio)
+void hydraulic_stream(Array       &z,
+                      float        c_erosion,
+                      float        talus_ref,
+                      const Array *p_bedrock,
+                      const Array *p_moisture_map,
+                      Array       *p_erosion_map,
+                      int          ir,
+                      float        clipping_ratio,
+                      bool         fill_depressions)
 {
   // keep a backup of the input if the erosion / deposition maps need
   // to be computed
@@ -32,7 +34,16 @@ void hydraulic_stream(Array &z,
   if (p_erosion_map) z_bckp = z;
 
   // use flow accumulation to determine erosion intensity
-  Array facc = flow_accumulation_dinf(z, talus_ref);
+  Array facc;
+
+  if (fill_depressions)
+  {
+    Array z_filled = z;
+    depression_filling(z_filled);
+    facc = flow_accumulation_dinf(z_filled, talus_ref);
+  }
+  else
+    facc = flow_accumulation_dinf(z, talus_ref);
 
   // clip large flow accumulation values using a value loosely based
   // on the standard deviation (of an equivalent symetric
@@ -63,15 +74,16 @@ void hydraulic_stream(Array &z,
   }
 }
 
-void hydraulic_stream(Array &z,
-                      Array *p_mask,
-                      float  c_erosion,
-                      float  talus_ref,
-                      Array *p_moisture_map,
-                      Array *p_bedrock,
-                      Array *p_erosion_map,
-                      int    ir,
-                      float  clipping_ratio)
+void hydraulic_stream(Array       &z,
+                      const Array *p_mask,
+                      float        c_erosion,
+                      float        talus_ref,
+                      const Array *p_moisture_map,
+                      const Array *p_bedrock,
+                      Array       *p_erosion_map,
+                      int          ir,
+                      float        clipping_ratio,
+                      bool         fill_depressions)
 {
   if (!p_mask)
     hydraulic_stream(z,
@@ -81,7 +93,8 @@ void hydraulic_stream(Array &z,
                      p_moisture_map,
                      p_erosion_map,
                      ir,
-                     clipping_ratio);
+                     clipping_ratio,
+                     fill_depressions);
   else
   {
     Array z_f = z;
@@ -92,25 +105,26 @@ void hydraulic_stream(Array &z,
                      p_moisture_map,
                      p_erosion_map,
                      ir,
-                     clipping_ratio);
+                     clipping_ratio,
+                     fill_depressions);
     z = lerp(z, z_f, *(p_mask));
   }
 }
 
-void hydraulic_stream_log(Array &z,
-                          float  c_erosion,
-                          float  talus_ref,
-                          int    deposition_ir,
-                          float  deposition_scale_ratio,
-                          float  gradient_power,
-                          float  gradient_scaling_ratio,
-                          int    gradient_prefilter_ir,
-                          float  saturation_ratio,
-                          Array *p_bedrock,
-                          Array *p_moisture_map,
-                          Array *p_erosion_map,
-                          Array *p_deposition_map,
-                          Array *p_flow_map)
+void hydraulic_stream_log(Array       &z,
+                          float        c_erosion,
+                          float        talus_ref,
+                          int          deposition_ir,
+                          float        deposition_scale_ratio,
+                          float        gradient_power,
+                          float        gradient_scaling_ratio,
+                          int          gradient_prefilter_ir,
+                          float        saturation_ratio,
+                          const Array *p_bedrock,
+                          const Array *p_moisture_map,
+                          Array       *p_erosion_map,
+                          Array       *p_deposition_map,
+                          Array       *p_flow_map)
 {
   // keep a backup of the input if the erosion / deposition maps need
   // to be computed
@@ -167,21 +181,21 @@ void hydraulic_stream_log(Array &z,
   if (p_flow_map) *p_flow_map = facc;
 }
 
-void hydraulic_stream_log(Array &z,
-                          float  c_erosion,
-                          float  talus_ref,
-                          Array *p_mask,
-                          int    deposition_ir,
-                          float  deposition_scale_ratio,
-                          float  gradient_power,
-                          float  gradient_scaling_ratio,
-                          int    gradient_prefilter_ir,
-                          float  saturation_ratio,
-                          Array *p_moisture_map,
-                          Array *p_bedrock,
-                          Array *p_erosion_map,
-                          Array *p_deposition_map,
-                          Array *p_flow_map)
+void hydraulic_stream_log(Array       &z,
+                          float        c_erosion,
+                          float        talus_ref,
+                          const Array *p_mask,
+                          int          deposition_ir,
+                          float        deposition_scale_ratio,
+                          float        gradient_power,
+                          float        gradient_scaling_ratio,
+                          int          gradient_prefilter_ir,
+                          float        saturation_ratio,
+                          const Array *p_moisture_map,
+                          const Array *p_bedrock,
+                          Array       *p_erosion_map,
+                          Array       *p_deposition_map,
+                          Array       *p_flow_map)
 {
   if (!p_mask)
     hydraulic_stream_log(z,
@@ -1,276 +1,515 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+
+/* Each iteration of the solver is made of 4 passes over the rows of the
+ * array, processed in parallel by bands:
+ * - fluxes: outflow fluxes updated in place and normalized,
+ * - transport: water height after transport, flow velocities and water
+ *   surface elevation,
+ * - erosion: slope of the water surface, erosion and deposition,
+ * - advection: semi-Lagrangian advection of the suspended sediment and
+ *   evaporation.
+ * The borders are filled with their nearest interior values, the border rows
+ * by the band processing the first or the last interior row. */
+
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
-#include "highmap/boundary.hpp"
-#include "highmap/filters.hpp"
-#include "highmap/gradient.hpp"
+#include "highmap/erosion.hpp"
+#include "highmap/execution_context.hpp"
 #include "highmap/math.hpp"
-#include "highmap/primitives.hpp"
 #include "highmap/range.hpp"
+#include "highmap/thread_pool.hpp"
 
 #define EPS 1e-6f
 
+// rows per band processed by a single task
+#define VPIPES_BAND_HEIGHT 32
+
+// checkpoint file signature (8 characters) and format version
+#define VPIPES_CHECKPOINT_MAGIC "HMVPIPES"
+#define VPIPES_CHECKPOINT_VERSION 1
+
+// largest checkpoint shape accepted by the loader, along each axis
+#define VPIPES_CHECKPOINT_MAX_SIZE 65536
+
 namespace hmap
 {
 
 //----------------------------------------------------------------------
-// Main operator(s)
+// Helper(s)
 //----------------------------------------------------------------------
 
-void hydraulic_vpipes(Array &z,
-                      int    iterations,
-                      Array *p_bedrock,
-                      Array *p_moisture_map,
-                      Array *p_erosion_map,
-                      Array *p_deposition_map,
-                      float  water_height,
-                      float  c_capacity,
-                      float  c_erosion,
-                      float  c_deposition,
-                      float  rain_rate,
-                      float  evap_rate)
+// apply 'fct(j)' to the rows [j1, j2[, by bands processed in parallel,
+// and return the elapsed time (in ms)
+template <typename F> static float helper_for_rows(int j1, int j2, F fct)
 {
-  float dt = 0.5f;
-  float g = 1.f;
-  float pipe_length = 1.f;
+  auto t0 = std::chrono::high_resolution_clock::now();
 
-  // local
-  int ni = z.shape.x;
-  int nj = z.shape.y;
+  const int nbands = (j2 - j1 + VPIPES_BAND_HEIGHT - 1) / VPIPES_BAND_HEIGHT;
 
-  Array rain_map = Array(z.shape);
-  if (p_moisture_map)
-    rain_map = water_height * (*p_moisture_map);
-  else
-    rain_map = water_height;
+  parallel_for(nbands,
+               [&](size_t b)
+               {
+                 int jb1 = j1 + (int)b * VPIPES_BAND_HEIGHT;
+                 int jb2 = std::min(jb1 + VPIPES_BAND_HEIGHT, j2);
 
-  Array d = rain_map;       // water height
-  Array s = Array(z.shape); // sediment height
+                 for (int j = jb1; j < jb2; j++)
+                   fct(j);
+               });
 
-  Array fL = Array(z.shape);
-  Array fR = Array(z.shape);
-  Array fT = Array(z.shape);
-  Array fB = Array(z.shape);
-
-  float talus_scaling = (float)std::min(z.shape.x, z.shape.y);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<float, std::milli>(t1 - t0).count();
+}
 
-  // keep a backup of the input if the erosion / deposition maps need
-  // to be computed
-  Array z_bckp = Array();
-  if ((p_erosion_map != nullptr) | (p_deposition_map != nullptr)) z_bckp = z;
+// border rows of the interior row j (first or last interior row), i.e. the
+// rows that are copies of the row j
+static int helper_border_rows(int j, int nj, int *rows)
+{
+  int n = 0;
+  if (j == 1) rows[n++] = 0;
+  if (j == nj - 2) rows[n++] = nj - 1;
+  return n;
+}
 
-  for (int it = 0; it < iterations; it++)
-  {
-    if (it % 10 == 0) LOG_DEBUG("iteration: %d", it);
+static void helper_fill_row(Array &array, int j, int j_from)
+{
+  const int ni = array.shape.x;
+  std::copy_n(&array.vector[(size_t)j_from * ni],
+              ni,
+              &array.vector[(size_t)j * ni]);
+}
 
-    // --- water increase
-    Array d1 = (1.f - dt * rain_rate) * d + dt * rain_rate * rain_map;
+static void helper_fill_cols(Array &array, int j)
+{
+  const int ni = array.shape.x;
+  float    *row = &array.vector[(size_t)j * ni];
+  row[0] = row[1];
+  row[ni - 1] = row[ni - 2];
+}
 
-    // --- flow simulation
-    Array d2 = d1;
-    Array u = Array(z.shape); // flow velocities
-    Array v = Array(z.shape);
+//----------------------------------------------------------------------
+// Main operator(s)
+//----------------------------------------------------------------------
 
-    {
-      Array fL_next = Array(z.shape);
-      Array fR_next = Array(z.shape);
-      Array fT_next = Array(z.shape);
-      Array fB_next = Array(z.shape);
+void hydraulic_vpipes(Array         &z,
+                      VpipesState   &state,
+                      int            iterations,
+                      Array         *p_bedrock,
+                      Array         *p_moisture_map,
+                      float          water_height,
+                      float          c_capacity,
+                      float          c_erosion,
+                      float          c_deposition,
+                      float          rain_rate,
+                      float          evap_rate,
+                      VpipesTimings *p_timings)
+{
+  constexpr float dt = 0.5f;
+  constexpr float g = 1.f;
+  constexpr float pipe_length = 1.f;
 
-      for (int j = 0; j < nj; j++)
-        for (int i = 1; i < ni; i++)
-        {
-          float dh = z(i, j) + d1(i, j) - z(i - 1, j) - d1(i - 1, j);
-          fL_next(i, j) = std::max(0.f, fL(i, j) + dt * g * dh / pipe_length);
-        }
+  // local
+  const int ni = z.shape.x;
+  const int nj = z.shape.y;
 
-      for (int j = 0; j < nj; j++)
-        for (int i = 0; i < ni - 1; i++)
-        {
-          float dh = z(i, j) + d1(i, j) - z(i + 1, j) - d1(i + 1, j);
-          fR_next(i, j) = std::max(0.f, fR(i, j) + dt * g * dh / pipe_length);
-        }
+  if (ni < 3 || nj < 3) return;
 
-      for (int j = 0; j < nj - 1; j++)
-        for (int i = 0; i < ni; i++)
-        {
-          float dh = z(i, j) + d1(i, j) - z(i, j + 1) - d1(i, j + 1);
-          fT_next(i, j) = std::max(0.f, fT(i, j) + dt * g * dh / pipe_length);
-        }
+  Array rain_map = Array(z.shape);
+  if (p_moisture_map)
+    rain_map = water_height * (*p_moisture_map);
+  else
+    rain_map = water_height;
 
-      for (int j = 1; j < nj; j++)
-        for (int i = 0; i < ni; i++)
-        {
-          float dh = z(i, j) + d1(i, j) - z(i, j - 1) - d1(i, j - 1);
-          fB_next(i, j) = std::max(0.f, fB(i, j) + dt * g * dh / pipe_length);
-        }
+  if (state.d.shape != z.shape)
+  {
+    state.d = rain_map; // water height
+    state.s = Array(z.shape);
+    state.fl = Array(z.shape);
+    state.fr = Array(z.shape);
+    state.ft = Array(z.shape);
+    state.fb = Array(z.shape);
+    state.iteration = 0;
+  }
 
-      fill_borders(fL_next);
-      fill_borders(fR_next);
-      fill_borders(fT_next);
-      fill_borders(fB_next);
+  const float talus_scaling = (float)std::min(z.shape.x, z.shape.y);
+
+  // local copies of the coefficients (not reloaded in the inner loops)
+  const float dmean_min = 0.5f * water_height * dt;
+  const float cc = c_capacity;
+  const float ce = c_erosion;
+  const float cd = c_deposition;
+  const float evap = 1.f - dt * evap_rate;
+
+  // work arrays: water height after transport, flow velocities, water
+  // surface elevation, water surface slope, sediment height after erosion
+  Array d2 = Array(z.shape);
+  Array u = Array(z.shape);
+  Array v = Array(z.shape);
+  Array w = Array(z.shape);
+  Array talus = Array(z.shape);
+  Array s1 = Array(z.shape);
+
+  // water height before transport
+  Array &d1 = state.d;
+  Array &s = state.s;
+  Array &fl = state.fl;
+  Array &fr = state.fr;
+  Array &ft = state.ft;
+  Array &fb = state.fb;
+
+  VpipesTimings timings;
+
+  auto row = [ni](Array &array, int j) { return &array.vector[(size_t)j * ni]; };
+
+  for (int it = 0; it < iterations; it++, state.iteration++)
+  {
+    if (state.iteration % 10 == 0)
+      LOG_DEBUG("iteration: %d", state.iteration);
 
-      // normalize
-      for (int j = 0; j < nj; j++)
-        for (int i = 0; i < ni; i++)
-        {
-          float k = d1(i, j) * pipe_length * pipe_length /
-                    (fL_next(i, j) + fR_next(i, j) + fT_next(i, j) +
-                     fB_next(i, j) + EPS) /
-                    dt;
-          k = std::min(1.f, k);
-
-          fL_next(i, j) *= k;
-          fR_next(i, j) *= k;
-          fT_next(i, j) *= k;
-          fB_next(i, j) *= k;
-        }
+    // the state is consistent between two iterations, the erosion can be
+    // resumed after a cancellation
+    poll_execution_context((float)it / (float)iterations);
 
-      fL = fL_next;
-      fR = fR_next;
-      fT = fT_next;
-      fB = fB_next;
+    // --- water increase
 
-      // water transport
-      for (int j = 1; j < nj - 1; j++)
-        for (int i = 1; i < ni - 1; i++)
+    if (rain_rate != 0.f)
+      timings.flux += helper_for_rows(
+          0,
+          nj,
+          [&](int j)
+          {
+            for (int i = 0; i < ni; i++)
+              d1(i, j) = (1.f - dt * rain_rate) * d1(i, j) +
+                         dt * rain_rate * rain_map(i, j);
+          });
+
+    // --- outflow fluxes
+
+    timings.flux += helper_for_rows(
+        1,
+        nj - 1,
+        [&](int j)
         {
-          float dv = dt *
-                     (fR(i - 1, j) + fT(i, j - 1) + fL(i + 1, j) +
-                      fB(i, j + 1) - fL(i, j) - fR(i, j) - fT(i, j) - fB(i, j));
-          d2(i, j) = d1(i, j) + dv / (pipe_length * pipe_length);
-        }
-
+          const float *z0 = row(z, j), *zb = row(z, j - 1), *zt = row(z, j + 1);
+          const float *d0 = row(d1, j), *d_b = row(d1, j - 1),
+                      *d_t = row(d1, j + 1);
+          float *pl = row(fl, j), *pr = row(fr, j), *pt = row(ft, j),
+                *pb = row(fb, j);
+
+          for (int i = 1; i < ni - 1; i++)
+          {
+            float h = z0[i] + d0[i];
+
+            float dh = h - z0[i - 1] - d0[i - 1];
+            pl[i] = std::max(0.f, pl[i] + dt * g * dh / pipe_length);
+
+            dh = h - z0[i + 1] - d0[i + 1];
+            pr[i] = std::max(0.f, pr[i] + dt * g * dh / pipe_length);
+
+            dh = h - zt[i] - d_t[i];
+            pt[i] = std::max(0.f, pt[i] + dt * g * dh / pipe_length);
+
+            dh = h - zb[i] - d_b[i];
+            pb[i] = std::max(0.f, pb[i] + dt * g * dh / pipe_length);
+          }
+
+          int rows[3] = {j};
+          int nrows = 1 + helper_border_rows(j, nj, &rows[1]);
+
+          for (Array *p_f : {&fl, &fr, &ft, &fb})
+          {
+            helper_fill_cols(*p_f, j);
+            for (int r = 1; r < nrows; r++)
+              helper_fill_row(*p_f, rows[r], j);
+          }
+
+          // normalize
+          for (int r = 0; r < nrows; r++)
+          {
+            const float *dq = row(d1, rows[r]);
+            float *ql = row(fl, rows[r]), *qr = row(fr, rows[r]),
+                  *qt = row(ft, rows[r]), *qb = row(fb, rows[r]);
+
+            for (int i = 0; i < ni; i++)
+            {
+              float k = dq[i] * pipe_length * pipe_length /
+                        (ql[i] + qr[i] + qt[i] + qb[i] + EPS) / dt;
+              k = std::min(1.f, k);
+
+              ql[i] *= k;
+              qr[i] *= k;
+              qt[i] *= k;
+              qb[i] *= k;
+            }
+          }
+        });
+
+    // --- water transport and flow velocities
+
+    auto transport_row = [&](int j)
+    {
+      auto fct_d2 = [&](int i)
       {
-        int i = 0;
-        for (int j = 1; j < nj - 1; j++)
-        {
-          float dv = dt * (fT(i, j - 1) + fL(i + 1, j) + fB(i, j + 1) -
-                           fL(i, j) - fR(i, j) - fT(i, j) - fB(i, j));
-          d2(i, j) = d1(i, j) + dv / (pipe_length * pipe_length);
-        }
-      }
-
+        float f_in = (i > 0 ? fr(i - 1, j) : 0.f) +
+                     (j > 0 ? ft(i, j - 1) : 0.f) +
+                     (i < ni - 1 ? fl(i + 1, j) : 0.f) +
+                     (j < nj - 1 ? fb(i, j + 1) : 0.f);
+        float dv = dt * (f_in - fl(i, j) - fr(i, j) - ft(i, j) - fb(i, j));
+        d2(i, j) = d1(i, j) + dv / (pipe_length * pipe_length);
+      };
+
+      // the corners are defined afterwards
+      if (j > 0 && j < nj - 1)
       {
-        int i = ni - 1;
-        for (int j = 1; j < nj - 1; j++)
-        {
-          float dv = dt * (fR(i - 1, j) + fT(i, j - 1) + fB(i, j + 1) -
-                           fL(i, j) - fR(i, j) - fT(i, j) - fB(i, j));
-          d2(i, j) = d1(i, j) + dv / (pipe_length * pipe_length);
-        }
+        fct_d2(0);
+        fct_d2(ni - 1);
       }
 
+      if (j > 0 && j < nj - 1)
       {
-        int j = 0;
-        for (int i = 1; i < ni - 1; i++)
-        {
-          float dv = dt * (fR(i - 1, j) + fL(i + 1, j) + fB(i, j + 1) -
-                           fL(i, j) - fR(i, j) - fT(i, j) - fB(i, j));
-          d2(i, j) = d1(i, j) + dv / (pipe_length * pipe_length);
-        }
-      }
+        const float *pl = row(fl, j), *pr = row(fr, j), *pt = row(ft, j),
+                    *pb = row(fb, j), *ptb = row(ft, j - 1),
+                    *pbt = row(fb, j + 1), *d0 = row(d1, j);
+        float *d20 = row(d2, j);
 
-      {
-        int j = nj - 1;
         for (int i = 1; i < ni - 1; i++)
         {
-          float dv = dt * (fR(i - 1, j) + fT(i, j - 1) + fL(i + 1, j) +
-                           -fL(i, j) - fR(i, j) - fT(i, j) - fB(i, j));
-          d2(i, j) = d1(i, j) + dv / (pipe_length * pipe_length);
+          float dv = dt * (pr[i - 1] + ptb[i] + pl[i + 1] + pbt[i] - pl[i] -
+                           pr[i] - pt[i] - pb[i]);
+          d20[i] = d0[i] + dv / (pipe_length * pipe_length);
         }
       }
-
-      d2(0, 0) = 0.5f * (d2(1, 0) + d2(0, 1));
-      d2(ni - 1, 0) = 0.5f * (d2(ni - 2, 0) + d2(ni - 1, 1));
-      d2(ni - 1, nj - 1) = 0.5f * (d2(ni - 1, nj - 2) + d2(ni - 2, nj - 1));
-      d2(0, nj - 1) = 0.5f * (d2(0, nj - 2) + d2(1, nj - 1));
-
-      // flow velocities
-      for (int j = 1; j < nj - 1; j++)
+      else
         for (int i = 1; i < ni - 1; i++)
-        {
-          u(i, j) = 0.5f * (fR(i - 1, j) - fL(i, j) + fR(i, j) - fL(i + 1, j));
-          v(i, j) = 0.5f * (fT(i, j - 1) - fB(i, j) + fT(i, j) - fB(i, j + 1));
+          fct_d2(i);
 
-          float dmean = std::max(0.5f * water_height * dt,
-                                 0.5f * (d1(i, j) + d2(i, j)));
-          u(i, j) /= dmean;
-          v(i, j) /= dmean;
-        }
+      const float *z0 = row(z, j), *d0 = row(d1, j), *d20 = row(d2, j);
+      float       *w0 = row(w, j);
 
-      fill_borders(u);
-      fill_borders(v);
+      for (int i = 0; i < ni; i++)
+        w0[i] = z0[i] + 0.5f * (d0[i] + d20[i]);
+    };
 
-    } // flow sim
+    timings.transport += helper_for_rows(
+        1,
+        nj - 1,
+        [&](int j)
+        {
+          int rows[2];
+          int nrows = helper_border_rows(j, nj, rows);
+
+          for (int r = 0; r < nrows; r++)
+            transport_row(rows[r]);
+          transport_row(j);
+
+          const float *pl = row(fl, j), *pr = row(fr, j), *pt = row(ft, j),
+                      *pb = row(fb, j), *ptb = row(ft, j - 1),
+                      *pbt = row(fb, j + 1), *d0 = row(d1, j),
+                      *d20 = row(d2, j);
+          float *u0 = row(u, j), *v0 = row(v, j);
+
+          for (int i = 1; i < ni - 1; i++)
+          {
+            float dmean = std::max(dmean_min, 0.5f * (d0[i] + d20[i]));
+
+            u0[i] = 0.5f * (pr[i - 1] - pl[i] + pr[i] - pl[i + 1]) / dmean;
+            v0[i] = 0.5f * (ptb[i] - pb[i] + pt[i] - pbt[i]) / dmean;
+          }
+
+          for (Array *p_a : {&u, &v})
+          {
+            helper_fill_cols(*p_a, j);
+            for (int r = 0; r < nrows; r++)
+              helper_fill_row(*p_a, rows[r], j);
+          }
+        });
+
+    d2(0, 0) = 0.5f * (d2(1, 0) + d2(0, 1));
+    d2(ni - 1, 0) = 0.5f * (d2(ni - 2, 0) + d2(ni - 1, 1));
+    d2(ni - 1, nj - 1) = 0.5f * (d2(ni - 1, nj - 2) + d2(ni - 2, nj - 1));
+    d2(0, nj - 1) = 0.5f * (d2(0, nj - 2) + d2(1, nj - 1));
+
+    for (int j : {0, nj - 1})
+      for (int i : {0, ni - 1})
+        w(i, j) = z(i, j) + 0.5f * (d1(i, j) + d2(i, j));
 
     // --- erosion and deposition
-    Array s1 = s;
-    Array talus = talus_scaling * gradient_norm(z + 0.5f * (d1 + d2));
-    laplace(talus, 0.25f, 1);
-
-    // smooth_cpulse(talus, 16);
-
-    for (int j = 1; j < nj - 1; j++)
-      for (int i = 1; i < ni - 1; i++)
-      {
-        // sin(alpha), sin of tilt angle
-        float salpha = std::max(0.001f,
-                                talus(i, j) / approx_hypot(1.f, talus(i, j)));
-        float sc = c_capacity * approx_hypot(u(i, j), v(i, j)) * salpha;
-
-        float delta_sc = dt * (sc - s(i, j));
-        float amount;
-
-        if (delta_sc > 0.f)
-          amount = c_erosion * delta_sc; // erosion
-        else
-          amount = c_deposition * delta_sc; // deposition
 
-        s1(i, j) += amount;
-        z(i, j) -= amount;
-      }
-
-    fill_borders(s1);
-    fill_borders(z);
-
-    // bedrock pass
-    if (p_bedrock)
-      for (int j = 0; j < z.shape.y; j++)
-        for (int i = 0; i < z.shape.x; i++)
-          z(i, j) = std::max(z(i, j), (*p_bedrock)(i, j));
-
-    // --- sediment transport
-    for (int j = 1; j < nj - 1; j++)
-      for (int i = 1; i < ni - 1; i++)
-      {
-        // sediment convection
-        float x = (float)i - dt * u(i, j);
-        float y = (float)j - dt * v(i, j);
+    // water surface slope (centered differences, one-sided at the borders)
+    timings.erosion += helper_for_rows(
+        0,
+        nj,
+        [&](int j)
+        {
+          const float  cy = (j == 0 || j == nj - 1) ? 1.f : 0.5f;
+          const float *w0 = row(w, j);
+          const float *wb = row(w, std::max(j - 1, 0));
+          const float *wt = row(w, std::min(j + 1, nj - 1));
+          float       *t0 = row(talus, j);
+
+          auto slope = [&](float dx, float dy)
+          { return talus_scaling * std::sqrt(dx * dx + dy * dy); };
+
+          for (int i = 1; i < ni - 1; i++)
+            t0[i] = slope(0.5f * (w0[i + 1] - w0[i - 1]), cy * (wt[i] - wb[i]));
+
+          t0[0] = slope(w0[1] - w0[0], cy * (wt[0] - wb[0]));
+          t0[ni - 1] = slope(w0[ni - 1] - w0[ni - 2],
+                             cy * (wt[ni - 1] - wb[ni - 1]));
+        });
+
+    timings.erosion += helper_for_rows(
+        1,
+        nj - 1,
+        [&](int j)
+        {
+          const float *t0 = row(talus, j), *tb = row(talus, j - 1),
+                      *tt = row(talus, j + 1), *u0 = row(u, j), *v0 = row(v, j),
+                      *s0 = row(s, j);
+          float *s10 = row(s1, j), *z0 = row(z, j);
+
+          for (int i = 1; i < ni - 1; i++)
+          {
+            // slope smoothing (one Laplace filtering iteration)
+            float sum = tb[i - 1] + tb[i] + tb[i + 1] + t0[i - 1] + t0[i + 1] +
+                        tt[i - 1] + tt[i] + tt[i + 1];
+            float ts = t0[i] + 0.25f * (sum - 8.f * t0[i]);
+
+            // sin(alpha), sin of tilt angle
+            float salpha = std::max(0.001f, ts / approx_hypot(1.f, ts));
+            float sc = cc * approx_hypot(u0[i], v0[i]) * salpha;
+
+            float delta_sc = dt * (sc - s0[i]);
+            float amount = (delta_sc > 0.f ? ce   // erosion
+                                           : cd) * // deposition
+                           delta_sc;
+
+            s10[i] = s0[i] + amount;
+            z0[i] -= amount;
+          }
+
+          int rows[3] = {j};
+          int nrows = 1 + helper_border_rows(j, nj, &rows[1]);
+
+          for (Array *p_a : {&s1, &z})
+          {
+            helper_fill_cols(*p_a, j);
+            for (int r = 1; r < nrows; r++)
+              helper_fill_row(*p_a, rows[r], j);
+          }
+
+          // bedrock
+          if (p_bedrock)
+            for (int r = 0; r < nrows; r++)
+              for (int i = 0; i < ni; i++)
+                z(i, rows[r]) = std::max(z(i, rows[r]),
+                                         (*p_bedrock)(i, rows[r]));
+        });
+
+    // --- sediment transport and flow evaporation
+
+    timings.advection += helper_for_rows(
+        1,
+        nj - 1,
+        [&](int j)
+        {
+          const float *u0 = row(u, j), *v0 = row(v, j);
+          float       *s0 = row(s, j);
+
+          for (int i = 1; i < ni - 1; i++)
+          {
+            // sediment convection (backtracking kept within the array)
+            float x = std::clamp((float)i - dt * u0[i], 0.f, (float)(ni - 1));
+            float y = std::clamp((float)j - dt * v0[i], 0.f, (float)(nj - 1));
+
+            // bilinear interpolation parameters (the last row and column
+            // use the previous cell)
+            int   ip = std::min((int)x, ni - 2);
+            int   jp = std::min((int)y, nj - 2);
+            float a = x - (float)ip;
+            float b = y - (float)jp;
+
+            const float *q = row(s1, jp) + ip;
+            float a10 = q[1] - q[0];
+            float a01 = q[ni] - q[0];
+            float a11 = q[ni + 1] - q[1] - q[ni] + q[0];
+
+            s0[i] = q[0] + a10 * a + a01 * b + a11 * a * b;
+          }
+
+          int rows[3] = {j};
+          int nrows = 1 + helper_border_rows(j, nj, &rows[1]);
+
+          helper_fill_cols(s, j);
+          for (int r = 1; r < nrows; r++)
+            helper_fill_row(s, rows[r], j);
+
+          for (int r = 0; r < nrows; r++)
+            for (int i = 0; i < ni; i++)
+            {
+              int q = rows[r];
+              s(i, q) = std::max(s(i, q), 0.f);
+              d1(i, q) = std::max(d2(i, q) * evap, 0.f);
+            }
+        });
 
-        // bilinear interpolation parameters
-        int   ip = (int)x;
-        int   jp = (int)y;
-        float u = x - (float)ip;
-        float v = y - (float)jp;
+  } // it
 
-        s(i, j) = s1.get_value_bilinear_at(ip, jp, u, v);
-      }
+  LOG_DEBUG("timings [ms]: flux %f, transport %f, erosion %f, advection %f",
+            timings.flux,
+            timings.transport,
+            timings.erosion,
+            timings.advection);
 
-    fill_borders(s);
+  if (p_timings)
+  {
+    p_timings->flux += timings.flux;
+    p_timings->transport += timings.transport;
+    p_timings->erosion += timings.erosion;
+    p_timings->advection += timings.advection;
+  }
+}
 
-    // --- flow evaporation
-    d = d2 * (1.f - dt * evap_rate);
+void hydraulic_vpipes(Array &z,
+                      int    iterations,
+                      Array *p_bedrock,
+                      Array *p_moisture_map,
+                      Array *p_erosion_map,
+                      Array *p_deposition_map,
+                      float  water_height,
+                      float  c_capacity,
+                      float  c_erosion,
+                      float  c_deposition,
+                      float  rain_rate,
+                      float  evap_rate)
+{
+  // keep a backup of the input if the erosion / deposition maps need
+  // to be computed
+  Array z_bckp = Array();
+  if ((p_erosion_map != nullptr) | (p_deposition_map != nullptr)) z_bckp = z;
 
-    clamp_min(d, 0.f);
-    clamp_min(s, 0.f);
+  VpipesState state;
 
-  } // it
+  hydraulic_vpipes(z,
+                   state,
+                   iterations,
+                   p_bedrock,
+                   p_moisture_map,
+                   water_height,
+                   c_capacity,
+                   c_erosion,
+                   c_deposition,
+                   rain_rate,
+                   evap_rate);
 
   // splatmaps
   if (p_erosion_map)
@@ -332,4 +571,113 @@ void hydraulic_vpipes(Array &z,
   }
 }
 
+//----------------------------------------------------------------------
+// Checkpoints
+//----------------------------------------------------------------------
+
+bool VpipesState::from_file(const std::string &fname, Array &z)
+{
+  std::ifstream f(fname, std::ios::binary | std::ios::ate);
+  if (!f.is_open())
+  {
+    LOG_ERROR("could not open file: %s", fname.c_str());
+    return false;
+  }
+
+  const std::streamoff fsize = f.tellg();
+  f.seekg(0);
+
+  char    magic[8];
+  int32_t header[4]; // version, shape.x, shape.y, iteration
+
+  if (!f.read(magic, sizeof(magic)) ||
+      !f.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+      std::memcmp(magic, VPIPES_CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+      header[0] != VPIPES_CHECKPOINT_VERSION)
+  {
+    LOG_ERROR("not a valid virtual pipes checkpoint: %s", fname.c_str());
+    return false;
+  }
+
+  // the header is not trusted before allocating: bounded shape, and a file
+  // size matching it exactly
+  if (header[1] <= 0 || header[1] > VPIPES_CHECKPOINT_MAX_SIZE ||
+      header[2] <= 0 || header[2] > VPIPES_CHECKPOINT_MAX_SIZE ||
+      header[3] < 0)
+  {
+    LOG_ERROR("invalid virtual pipes checkpoint header (shape: %d x %d, "
+              "iteration: %d): %s",
+              header[1],
+              header[2],
+              header[3],
+              fname.c_str());
+    return false;
+  }
+
+  const std::streamoff data_size = (std::streamoff)header[1] * header[2] *
+                                   7 * sizeof(float);
+
+  if (fsize != (std::streamoff)(sizeof(magic) + sizeof(header)) + data_size)
+  {
+    LOG_ERROR("virtual pipes checkpoint size does not match its header: %s",
+              fname.c_str());
+    return false;
+  }
+
+  const Vec2<int> shape = {header[1], header[2]};
+
+  std::vector<Array> arrays(7, Array(shape)); // z, d, s, fl, fr, ft, fb
+
+  for (auto &a : arrays)
+    if (!f.read(reinterpret_cast<char *>(a.vector.data()),
+                a.vector.size() * sizeof(float)))
+    {
+      LOG_ERROR("truncated virtual pipes checkpoint: %s", fname.c_str());
+      return false;
+    }
+
+  // nothing is modified before the whole checkpoint has been read
+  z = std::move(arrays[0]);
+  this->d = std::move(arrays[1]);
+  this->s = std::move(arrays[2]);
+  this->fl = std::move(arrays[3]);
+  this->fr = std::move(arrays[4]);
+  this->ft = std::move(arrays[5]);
+  this->fb = std::move(arrays[6]);
+  this->iteration = header[3];
+
+  return true;
+}
+
+bool VpipesState::to_file(const std::string &fname, const Array &z) const
+{
+  if (this->d.shape != z.shape)
+  {
+    LOG_ERROR("state and heightmap shapes do not match");
+    return false;
+  }
+
+  std::ofstream f(fname, std::ios::binary);
+  if (!f.is_open())
+  {
+    LOG_ERROR("could not open file: %s", fname.c_str());
+    return false;
+  }
+
+  const int32_t header[4] = {VPIPES_CHECKPOINT_VERSION,
+                             z.shape.x,
+                             z.shape.y,
+                             this->iteration};
+
+  f.write(VPIPES_CHECKPOINT_MAGIC, 8);
+  f.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+  for (const Array *p_a :
+       {&z, &this->d, &this->s, &this->fl, &this->fr, &this->ft, &this->fb})
+    f.write(reinterpret_cast<const char *>(p_a->vector.data()),
+            p_a->vector.size() * sizeof(float));
+
+  return (bool)f;
+}
+
 } // namespace hmap
@@ -17,7 +17,7 @@ namespace hmap
 void stratify(Array             &z,
               std::vector<float> hs,
               std::vector<float> gamma,
-              Array             *p_noise)
+              const Array       *p_noise)
 {
 
   for (int j = 0; j < z.shape.y; j++)
@@ -44,10 +44,10 @@ void stratify(Array             &z,
 }
 
 void stratify(Array             &z,
-              Array             *p_mask,
+              const Array       *p_mask,
               std::vector<float> hs,
               std::vector<float> gamma,
-              Array             *p_noise)
+              const Array       *p_noise)
 {
   if (!p_mask)
     stratify(z, hs, gamma, p_noise);
@@ -128,7 +128,10 @@ void stratify_multiscale(Array             &z,
   }
 }
 
-void stratify(Array &z, std::vector<float> hs, float gamma, Array *p_noise)
+void stratify(Array             &z,
+              std::vector<float> hs,
+              float              gamma,
+              const Array       *p_noise)
 {
   // float to vector
   std::vector<float> gs(hs.size() - 1);
@@ -138,18 +141,18 @@ void stratify(Array &z, std::vector<float> hs, float gamma, Array *p_noise)
   stratify(z, hs, gs, p_noise);
 }
 
-void stratify(Array &z,
-              Array &partition,
-              int    nstrata,
-              float  strata_noise,
-              float  gamma,
-              float  gamma_noise,
-              int    npartitions,
-              uint   seed,
-              float  mixing_gain_factor,
-              Array *p_noise,
-              float  vmin,
-              float  vmax)
+void stratify(Array       &z,
+              Array       &partition,
+              int          nstrata,
+              float        strata_noise,
+              float        gamma,
+              float        gamma_noise,
+              int          npartitions,
+              uint         seed,
+              float        mixing_gain_factor,
+              const Array *p_noise,
+              float        vmin,
+              float        vmax)
 {
   // redefine min/max if sentinels values are detected
   if (vmax < vmin)
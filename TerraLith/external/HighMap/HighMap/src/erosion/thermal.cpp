@@ -3,17 +3,28 @@
  * this software. */
 
 #include <algorithm>
+#include <cmath>
 
 #include "highmap/array.hpp"
 #include "highmap/boundary.hpp"
 #include "highmap/erosion.hpp"
+#include "highmap/execution_context.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/gradient.hpp"
 #include "highmap/math.hpp"
 #include "highmap/range.hpp"
+#include "highmap/thread_pool.hpp"
 
 #include "macrologger.h"
 
+// fraction of the excess height difference exchanged with a neighbor
+#define THERMAL_RATE 0.2f
+
+// rows (of a given color) per band processed by a single task, and
+// minimum number of cells for the updates to be parallelized
+#define THERMAL_BAND_HEIGHT 16
+#define THERMAL_PARALLEL_MIN_CELLS 65536
+
 namespace hmap
 {
 
@@ -24,7 +35,7 @@ namespace hmap
 float helper_thermal_exchange(float self, float other, float dist, float talus)
 {
   float max_dif = dist * talus;
-  float rate = 0.2f;
+  float rate = THERMAL_RATE;
 
   if (self > other)
   {
@@ -42,117 +53,198 @@ float helper_thermal_exchange(float self, float other, float dist, float talus)
   }
 }
 
-void thermal(Array       &z,
-             const Array &talus,
-             int          iterations,
-             Array       *p_bedrock,
-             Array       *p_deposition_map)
+// branch-free version of helper_thermal_exchange (vectorizable)
+static inline float helper_thermal_flux(float self,
+                                        float other,
+                                        float inv_dist,
+                                        float max_dif)
+{
+  float d = other - self;
+  float excess = std::max(std::abs(d) - max_dif, 0.f);
+  return std::copysign(THERMAL_RATE * inv_dist * excess, d);
+}
+
+// serial in-place sweep, the sweep and neighbor orders rotate at each
+// iteration (reference implementation)
+static void helper_thermal_legacy(Array       &z,
+                                  const Array &talus,
+                                  int          iterations,
+                                  const Array *p_bedrock)
 {
   std::vector<int>   di = DI;
   std::vector<int>   dj = DJ;
   std::vector<float> c = CD;
-  const uint         nb = di.size();
-
-  // keep a backup of the input if the erosion / deposition maps need
-  // to be computed
-  Array z_bckp = Array();
-  if (p_deposition_map != nullptr) z_bckp = z;
 
-  // main loop
   for (int it = 0; it < iterations; it++)
   {
+    poll_execution_context((float)it / (float)iterations);
+
     // modify neighbor search at each iterations to limit numerical
     // artifacts
     std::rotate(di.begin(), di.begin() + 1, di.end());
     std::rotate(dj.begin(), dj.begin() + 1, dj.end());
     std::rotate(c.begin(), c.begin() + 1, c.end());
 
-    if (p_bedrock) // with bedrock
-    {
-      for (int q = 1; q < z.shape.y - 1; q++)
-        for (int p = 1; p < z.shape.x - 1; p++)
+    for (int q = 1; q < z.shape.y - 1; q++)
+      for (int p = 1; p < z.shape.x - 1; p++)
+      {
+        int i, j;
+
+        // alternate row / col order to limit artifacts
+        if (it % 4 == 0)
         {
-          int i, j;
-
-          // alternate row / col order to limit artifacts
-          if (it % 4 == 0)
-          {
-            i = z.shape.x - 1 - p;
-            j = q;
-          }
-          else if (it % 4 == 1)
-          {
-            i = p;
-            j = z.shape.y - 1 - q;
-          }
-          else if (it % 4 == 2)
-          {
-            i = z.shape.x - 1 - p;
-            j = z.shape.y - 1 - q;
-          }
-          else
-          {
-            i = p;
-            j = q;
-          }
-
-          if (z(i, j) >= (*p_bedrock)(i, j))
-          {
-            std::vector<float> dz(nb);
-            float              amount = 0.f;
-
-            for (int k = 0; k < 8; k++)
-              amount += helper_thermal_exchange(z(i, j),
-                                                z(i + di[k], j + dj[k]),
-                                                c[k],
-                                                talus(i, j));
-
-            z(i, j) += amount;
-          }
+          i = z.shape.x - 1 - p;
+          j = q;
         }
-    }
-    else // no bedrock
-    {
-      for (int q = 1; q < z.shape.y - 1; q++)
-        for (int p = 1; p < z.shape.x - 1; p++)
+        else if (it % 4 == 1)
         {
-          int i, j;
-
-          // alternate row / col order to limit artifacts
-          if (it % 4 == 0)
-          {
-            i = z.shape.x - 1 - p;
-            j = q;
-          }
-          else if (it % 4 == 1)
-          {
-            i = p;
-            j = z.shape.y - 1 - q;
-          }
-          else if (it % 4 == 2)
-          {
-            i = z.shape.x - 1 - p;
-            j = z.shape.y - 1 - q;
-          }
-          else
-          {
-            i = p;
-            j = q;
-          }
+          i = p;
+          j = z.shape.y - 1 - q;
+        }
+        else if (it % 4 == 2)
+        {
+          i = z.shape.x - 1 - p;
+          j = z.shape.y - 1 - q;
+        }
+        else
+        {
+          i = p;
+          j = q;
+        }
+
+        if (p_bedrock && z(i, j) < (*p_bedrock)(i, j)) continue;
 
-          std::vector<float> dz(nb);
-          float              amount = 0.f;
+        float amount = 0.f;
 
-          for (int k = 0; k < 8; k++)
-            amount += helper_thermal_exchange(z(i, j),
-                                              z(i + di[k], j + dj[k]),
-                                              c[k],
-                                              talus(i, j));
+        for (int k = 0; k < 8; k++)
+          amount += helper_thermal_exchange(z(i, j),
+                                            z(i + di[k], j + dj[k]),
+                                            c[k],
+                                            talus(i, j));
+
+        z(i, j) += amount;
+      }
+  }
+}
+
+// update of the cells i = i0, i0 + 2, ... of a row
+template <bool with_bedrock>
+static void helper_thermal_row(float       *row,
+                               const float *dn,
+                               const float *up,
+                               const float *tl,
+                               const float *br,
+                               int          i0,
+                               int          nx)
+{
+  const float inv_sqrt2 = 1.f / (float)M_SQRT2;
+
+  for (int i = i0; i < nx - 1; i += 2)
+  {
+    const float self = row[i];
+    const float md = tl[i];
+    const float md_diag = (float)M_SQRT2 * tl[i];
+
+    float amount = helper_thermal_flux(self, row[i - 1], 1.f, md) +
+                   helper_thermal_flux(self, row[i + 1], 1.f, md) +
+                   helper_thermal_flux(self, dn[i], 1.f, md) +
+                   helper_thermal_flux(self, up[i], 1.f, md) +
+                   helper_thermal_flux(self, dn[i - 1], inv_sqrt2, md_diag) +
+                   helper_thermal_flux(self, dn[i + 1], inv_sqrt2, md_diag) +
+                   helper_thermal_flux(self, up[i - 1], inv_sqrt2, md_diag) +
+                   helper_thermal_flux(self, up[i + 1], inv_sqrt2, md_diag);
+
+    if constexpr (with_bedrock) amount = self < br[i] ? 0.f : amount;
+
+    row[i] = self + amount;
+  }
+}
 
-          z(i, j) += amount;
+// in-place updates scheduled by the 4 colors of the cell index parities:
+// the 8 neighbors of a cell all have another color, the cells of a color
+// are updated concurrently (by row bands) and see the latest values of
+// the other colors, like a Gauss-Seidel sweep. The color order rotates at
+// each iteration to limit the artifacts
+static void helper_thermal_colored(Array       &z,
+                                   const Array &talus,
+                                   int          iterations,
+                                   const Array *p_bedrock)
+{
+  const int nx = z.shape.x;
+  const int ny = z.shape.y;
+
+  if (nx < 3 || ny < 3) return;
+
+  // rows of a given parity, by bands
+  const int  nrows = (ny - 1) / 2;
+  const int  nbands = (nrows + THERMAL_BAND_HEIGHT - 1) / THERMAL_BAND_HEIGHT;
+  const bool parallel = (size_t)nx * ny >= THERMAL_PARALLEL_MIN_CELLS;
+
+  for (int it = 0; it < iterations; it++)
+  {
+    poll_execution_context((float)it / (float)iterations);
+
+    for (int ic = 0; ic < 4; ic++)
+    {
+      const int color = (ic + it) % 4;
+      const int pi = 1 + color % 2; // first column and row of the color
+      const int pj = 1 + color / 2;
+
+      auto fct_band = [&](size_t b)
+      {
+        const int j1 = pj + 2 * (int)b * THERMAL_BAND_HEIGHT;
+        const int j2 = std::min(j1 + 2 * THERMAL_BAND_HEIGHT, ny - 1);
+
+        for (int j = j1; j < j2; j += 2)
+        {
+          float       *row = &z.vector[(size_t)j * nx];
+          const float *tl = &talus.vector[(size_t)j * nx];
+
+          if (p_bedrock)
+            helper_thermal_row<true>(row,
+                                     row - nx,
+                                     row + nx,
+                                     tl,
+                                     &p_bedrock->vector[(size_t)j * nx],
+                                     pi,
+                                     nx);
+          else
+            helper_thermal_row<false>(row,
+                                      row - nx,
+                                      row + nx,
+                                      tl,
+                                      nullptr,
+                                      pi,
+                                      nx);
         }
+      };
+
+      if (parallel)
+        parallel_for(nbands, fct_band);
+      else
+        for (int b = 0; b < nbands; b++)
+          fct_band(b);
     }
   }
+}
+
+void thermal(Array       &z,
+             const Array &talus,
+             int          iterations,
+             const Array *p_bedrock,
+             Array       *p_deposition_map,
+             bool         legacy_sweep)
+{
+  // keep a backup of the input if the erosion / deposition maps need
+  // to be computed
+  Array z_bckp = Array();
+  if (p_deposition_map != nullptr) z_bckp = z;
+
+  // main loop
+  if (legacy_sweep)
+    helper_thermal_legacy(z, talus, iterations, p_bedrock);
+  else
+    helper_thermal_colored(z, talus, iterations, p_bedrock);
 
   // clean-up: fix boundaries, remove spurious oscillations and make
   // sure final elevation is not lower than the bedrock
@@ -172,31 +264,33 @@ void thermal(Array       &z,
 //----------------------------------------------------------------------
 
 void thermal(Array       &z,
-             Array       *p_mask,
+             const Array *p_mask,
              const Array &talus,
              int          iterations,
-             Array       *p_bedrock,
-             Array       *p_deposition_map)
+             const Array *p_bedrock,
+             Array       *p_deposition_map,
+             bool         legacy_sweep)
 {
   if (!p_mask)
-    thermal(z, talus, iterations, p_bedrock, p_deposition_map);
+    thermal(z, talus, iterations, p_bedrock, p_deposition_map, legacy_sweep);
   else
   {
     Array z_f = z;
-    thermal(z_f, talus, iterations, p_bedrock, p_deposition_map);
+    thermal(z_f, talus, iterations, p_bedrock, p_deposition_map, legacy_sweep);
     z = lerp(z, z_f, *(p_mask));
   }
 }
 
 // uniform talus limit, no bedrock
-void thermal(Array &z,
-             float  talus,
-             int    iterations,
-             Array *p_bedrock,
-             Array *p_deposition_map)
+void thermal(Array       &z,
+             float        talus,
+             int          iterations,
+             const Array *p_bedrock,
+             Array       *p_deposition_map,
+             bool         legacy_sweep)
 {
   Array talus_map(z.shape, talus);
-  thermal(z, talus_map, iterations, p_bedrock, p_deposition_map);
+  thermal(z, talus_map, iterations, p_bedrock, p_deposition_map, legacy_sweep);
 }
 
 //----------------------------------------------------------------------
@@ -250,11 +344,11 @@ void thermal_auto_bedrock(Array &z,
   thermal_auto_bedrock(z, talus_map, iterations, p_deposition_map);
 }
 
-void thermal_auto_bedrock(Array &z,
-                          Array *p_mask,
-                          float  talus,
-                          int    iterations,
-                          Array *p_deposition_map)
+void thermal_auto_bedrock(Array       &z,
+                          const Array *p_mask,
+                          float        talus,
+                          int          iterations,
+                          Array       *p_deposition_map)
 {
   if (!p_mask)
     thermal_auto_bedrock(z, talus, iterations, p_deposition_map);
@@ -13,7 +13,7 @@ namespace hmap::gpu
 void thermal(Array       &z,
              const Array &talus,
              int          iterations,
-             Array       *p_bedrock,
+             const Array *p_bedrock,
              Array       *p_deposition_map)
 {
   Array z_bckp = Array();
@@ -68,10 +68,10 @@ void thermal(Array       &z,
 }
 
 void thermal(Array       &z,
-             Array       *p_mask,
+             const Array *p_mask,
              const Array &talus,
              int          iterations,
-             Array       *p_bedrock,
+             const Array *p_bedrock,
              Array       *p_deposition_map)
 {
   if (!p_mask)
@@ -84,11 +84,11 @@ void thermal(Array       &z,
   }
 }
 
-void thermal(Array &z,
-             float  talus,
-             int    iterations,
-             Array *p_bedrock,
-             Array *p_deposition_map)
+void thermal(Array       &z,
+             float        talus,
+             int          iterations,
+             const Array *p_bedrock,
+             Array       *p_deposition_map)
 {
   Array talus_map(z.shape, talus);
   gpu::thermal(z, talus_map, iterations, p_bedrock, p_deposition_map);
@@ -138,7 +138,7 @@ void thermal_auto_bedrock(Array &z,
 }
 
 void thermal_auto_bedrock(Array       &z,
-                          Array       *p_mask,
+                          const Array *p_mask,
                           const Array &talus,
                           int          iterations,
                           Array       *p_deposition_map)
@@ -2,15 +2,21 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 
+#include <algorithm>
+
 #include "highmap/array.hpp"
 #include "highmap/boundary.hpp"
 #include "highmap/erosion.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/math.hpp"
 #include "highmap/range.hpp"
+#include "highmap/thread_pool.hpp"
 
 #include "macrologger.h"
 
+// rows per band processed by a single task
+#define THERMAL_RIB_BAND_HEIGHT 32
+
 namespace hmap
 {
 
@@ -23,19 +29,33 @@ void thermal_rib(Array &z, int iterations, Array *p_bedrock)
   const std::vector<float> c = CD;
   const uint               nb = di.size();
 
+  // interior rows, by bands processed in parallel
+  const int nbands = (z.shape.y - 2 + THERMAL_RIB_BAND_HEIGHT - 1) /
+                     THERMAL_RIB_BAND_HEIGHT;
+
   for (int it = 0; it < iterations; it++)
   {
-    for (int j = 1; j < z.shape.y - 1; j++)
-      for (int i = 1; i < z.shape.x - 1; i++)
-      {
-        float delta_min = std::numeric_limits<float>::max();
-        for (size_t k = 0; k < nb; k++)
+    parallel_for(
+        std::max(nbands, 0),
+        [&](size_t b)
         {
-          float delta = std::abs(z(i, j) - z(i + di[k], j + dj[k])) / c[k];
-          delta_min = std::min(delta_min, delta);
-        }
-        de(i, j) = delta_min;
-      }
+          int j1 = 1 + (int)b * THERMAL_RIB_BAND_HEIGHT;
+          int j2 = std::min(j1 + THERMAL_RIB_BAND_HEIGHT, z.shape.y - 1);
+
+          for (int j = j1; j < j2; j++)
+            for (int i = 1; i < z.shape.x - 1; i++)
+            {
+              float delta_min = std::numeric_limits<float>::max();
+              for (size_t k = 0; k < nb; k++)
+              {
+                float delta = std::abs(z(i, j) - z(i + di[k], j + dj[k])) /
+                              c[k];
+                delta_min = std::min(delta_min, delta);
+              }
+              de(i, j) = delta_min;
+            }
+        });
+
     fill_borders(de);
     median_3x3(de);
     z -= de;
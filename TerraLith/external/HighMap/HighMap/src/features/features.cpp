@@ -1,9 +1,10 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <cmath>
+
 #include "highmap/features.hpp"
 #include "highmap/array.hpp"
-#include "highmap/convolve.hpp"
 #include "highmap/curvature.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/math.hpp"
@@ -22,16 +23,9 @@ Array local_median_deviation(const Array &array, int ir)
 
 Array mean_local(const Array &array, int ir)
 {
-  Array array_out = Array(array.shape);
-
-  std::vector<float> k1d(2 * ir + 1);
-  for (auto &v : k1d)
-    v = 1.f / (float)(2 * ir + 1);
-
-  array_out = convolve1d_i(array, k1d);
-  array_out = convolve1d_j(array_out, k1d);
-
-  return array_out;
+  Array mean;
+  local_stats(array, ir, &mean);
+  return mean;
 }
 
 Array relative_elevation(const Array &array, int ir)
@@ -47,29 +41,9 @@ Array relative_elevation(const Array &array, int ir)
 
 Array ruggedness(const Array &array, int ir)
 {
-  Array rg(array.shape);
-
-  for (int j = 0; j < array.shape.y; j++)
-    for (int i = 0; i < array.shape.x; i++)
-    {
-      int i1 = std::max(i - ir, 0);
-      int i2 = std::min(i + ir + 1, array.shape.x);
-      int j1 = std::max(j - ir, 0);
-      int j2 = std::min(j + ir + 1, array.shape.y);
-
-      for (int p = i1; p < i2; p++)
-        for (int q = j1; q < j2; q++)
-        {
-          float delta = array(i, j) - array(p, q);
-          rg(i, j) += delta * delta;
-        }
-    }
-
-  for (int j = 0; j < array.shape.y; j++)
-    for (int i = 0; i < array.shape.x; i++)
-      rg(i, j) = std::sqrt(rg(i, j));
-
-  return rg;
+  Array rg;
+  local_stats(array, ir, nullptr, nullptr, nullptr, &rg);
+  return sqrt(rg);
 }
 
 Array rugosity(const Array &z, int ir, bool convex)
@@ -117,17 +91,9 @@ Array rugosity(const Array &z, int ir, bool convex)
 
 Array std_local(const Array &array, int ir)
 {
-  // NB - use Gaussian windowing instead of a real arithmetic averaging
-  Array mean = array;
-  smooth_cpulse(mean, ir);
-
-  // use mean to store (array - mean)^2
-  mean -= array;
-  mean *= mean;
-  smooth_cpulse(mean, ir);
-  Array std = sqrt(mean);
-
-  return std;
+  Array variance;
+  local_stats(array, ir, nullptr, &variance);
+  return sqrt(variance);
 }
 
 Array valley_width(const Array &z, int ir, bool ridge_select)
@@ -145,17 +111,18 @@ Array valley_width(const Array &z, int ir, bool ridge_select)
 
 Array z_score(const Array &array, int ir)
 {
-  // NB - use Gaussian windowing instead of a real arithmetic averaging
-  Array mean = array;
-  smooth_cpulse(mean, ir);
+  Array mean, variance;
+  local_stats(array, ir, &mean, &variance);
+
+  Array z(array.shape);
 
-  // use mean to store (array - mean)^2
-  mean -= array;
-  mean *= mean;
-  smooth_cpulse(mean, ir);
-  Array std = sqrt(mean);
+  for (size_t k = 0; k < z.vector.size(); k++)
+  {
+    float std = std::sqrt(variance.vector[k]);
+    z.vector[k] = std > 0.f ? (array.vector[k] - mean.vector[k]) / std : 0.f;
+  }
 
-  return (array - mean) / std;
+  return z;
 }
 
 } // namespace hmap
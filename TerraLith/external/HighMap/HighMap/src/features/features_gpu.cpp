@@ -1,6 +1,8 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <cmath>
+
 #include "highmap/features.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/math.hpp"
@@ -124,13 +126,20 @@ Array z_score(const Array &array, int ir)
   Array mean = array;
   gpu::smooth_cpulse(mean, ir);
 
-  // use mean to store (array - mean)^2
-  mean -= array;
-  mean *= mean;
-  gpu::smooth_cpulse(mean, ir);
-  Array std = sqrt(mean);
+  Array variance = array - mean;
+  variance *= variance;
+  gpu::smooth_cpulse(variance, ir);
+
+  // same convention as the CPU version, zero where the std is zero
+  Array z(array.shape);
+
+  for (size_t k = 0; k < z.vector.size(); k++)
+  {
+    float std = std::sqrt(variance.vector[k]);
+    z.vector[k] = std > 0.f ? (array.vector[k] - mean.vector[k]) / std : 0.f;
+  }
 
-  return (array - mean) / std;
+  return z;
 }
 
 } // namespace hmap::gpu
@@ -1,185 +1,381 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
-#include <stdint.h>
 
-#include "macrologger.h"
+/* The maximum and minimum slopes of each direction are computed along the
+ * lines of the array (rows, columns and diagonals) shared by all their
+ * cells, copied to contiguous buffers. For the large radii, the search
+ * window of a cell, [i + irmin, i + irmax] along the line, is split in a
+ * suffix of a block of length irmax - irmin + 1 and a prefix of the next
+ * block. The upper hull of each part is updated incrementally from one
+ * cell to the next (amortized O(1)), and the maximum slope is the tangent
+ * from the cell to these hulls, i.e. a cost almost independent of the
+ * radius instead of O(irmax) per cell and direction. */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 #include "highmap/array.hpp"
 #include "highmap/features.hpp"
+#include "highmap/thread_pool.hpp"
+
+// number of lines processed by a single task
+#define GEOMORPHONS_BLOCK_SIZE 64
+
+// window length up to which the slopes are searched directly
+#define GEOMORPHONS_DIRECT_WINDOW 48
+
+// number of ternary patterns (3^8)
+#define GEOMORPHONS_NPATTERNS 6561
 
 namespace hmap
 {
 
-Array geomorphons(const Array &array, int irmin, int irmax, float epsilon)
+// geomorphon label of a signature packed with HMAP_PACK8 (see "Geomorphons -
+// a new approach to classification of landforms")
+static float helper_geomorphon_label(int code)
 {
-  float epsilon_normed = epsilon / (float)array.shape.x;
+  // https://geomorphometry.org/wp-content/uploads/2021/07/StepinskiJasiewicz2011geomorphometry.pdf
 
-  // output array containing the geomorphon labels
-  Array gm = Array(array.shape);
+  switch (code)
+  {
+  case HMAP_PACK8(0, 0, 0, 0, 0, 0, 0, 0): // FLAT A
+                                           //
+  case HMAP_PACK8(1, 0, 0, 0, 0, 0, 0, 0): // FLAT B
+  case HMAP_PACK8(0, 1, 0, 0, 0, 0, 0, 0):
+  case HMAP_PACK8(0, 0, 1, 0, 0, 0, 0, 0):
+  case HMAP_PACK8(0, 0, 0, 1, 0, 0, 0, 0):
+  case HMAP_PACK8(0, 0, 0, 0, 1, 0, 0, 0):
+  case HMAP_PACK8(0, 0, 0, 0, 0, 1, 0, 0):
+  case HMAP_PACK8(0, 0, 0, 0, 0, 0, 1, 0):
+  case HMAP_PACK8(0, 0, 0, 0, 0, 0, 0, 1): return 1.f;
+
+  case HMAP_PACK8(-1, -1, -1, -1, -1, -1, -1, -1): // PEAK
+    return 2.f;
+
+  case HMAP_PACK8(1, 1, 1, 1, 1, 1, 1, 1): // PIT
+    return 10.f;
+
+  case HMAP_PACK8(0, -1, -1, -1, 0, -1, -1, -1): // RIDGE
+  case HMAP_PACK8(-1, 0, -1, -1, -1, 0, -1, -1):
+  case HMAP_PACK8(-1, -1, 0, -1, -1, -1, 0, -1):
+  case HMAP_PACK8(-1, -1, -1, 0, -1, -1, -1, 0):
+    //
+    return 3.f;
 
-  // neighborhood search
-  const std::vector<int> di = {-1, -1, 0, 1, 1, 1, 0, -1};
-  const std::vector<int> dj = {0, 1, 1, 1, 0, -1, -1, -1};
-  const uint             nb = di.size();
+  case HMAP_PACK8(0, 1, 1, 1, 0, 1, 1, 1): // VALLEY
+  case HMAP_PACK8(1, 0, 1, 1, 1, 0, 1, 1):
+  case HMAP_PACK8(1, 1, 0, 1, 1, 1, 0, 1):
+  case HMAP_PACK8(1, 1, 1, 0, 1, 1, 1, 0):
+    //
+    return 9.f;
 
-  const int dr_max = irmax - irmin + 1;
+  case HMAP_PACK8(1, 1, 1, 0, -1, -1, -1, 0): // SLOPE A
+  case HMAP_PACK8(0, 1, 1, 1, 0, -1, -1, -1):
+  case HMAP_PACK8(-1, 0, 1, 1, 1, 0, -1, -1):
+  case HMAP_PACK8(-1, -1, 0, 1, 1, 1, 0, -1):
+  case HMAP_PACK8(-1, -1, -1, 0, 1, 1, 1, 0):
+  case HMAP_PACK8(0, -1, -1, -1, 0, 1, 1, 1):
+  case HMAP_PACK8(1, 0, -1, -1, -1, 0, 1, 1):
+  case HMAP_PACK8(1, 1, 0, -1, -1, -1, 0, 1):
+    //
+  case HMAP_PACK8(1, 1, 1, 1, -1, -1, -1, -1): // SLOPE C
+  case HMAP_PACK8(-1, 1, 1, 1, 1, -1, -1, -1):
+  case HMAP_PACK8(-1, -1, 1, 1, 1, 1, -1, -1):
+  case HMAP_PACK8(-1, -1, -1, 1, 1, 1, 1, -1):
+  case HMAP_PACK8(-1, -1, -1, -1, 1, 1, 1, 1):
+  case HMAP_PACK8(1, -1, -1, -1, -1, 1, 1, 1):
+  case HMAP_PACK8(1, 1, -1, -1, -1, -1, 1, 1):
+  case HMAP_PACK8(1, 1, 1, -1, -1, -1, -1, 1): return 6.f;
 
-  Mat<int> code = Mat<int>(array.shape);
+  case HMAP_PACK8(1, 1, 1, 1, 1, -1, -1, -1): // SPUR
+  case HMAP_PACK8(-1, 1, 1, 1, 1, 1, -1, -1):
+  case HMAP_PACK8(-1, -1, 1, 1, 1, 1, 1, -1):
+  case HMAP_PACK8(-1, -1, -1, 1, 1, 1, 1, 1):
+  case HMAP_PACK8(1, -1, -1, -1, 1, 1, 1, 1):
+  case HMAP_PACK8(1, 1, -1, -1, -1, 1, 1, 1):
+  case HMAP_PACK8(1, 1, 1, -1, -1, -1, 1, 1):
+  case HMAP_PACK8(1, 1, 1, 1, -1, -1, -1, 1):
+    //
+    return 5.f;
 
-  for (int j = 0; j < array.shape.y; j++)
-    for (int i = 0; i < array.shape.x; i++)
+  case HMAP_PACK8(-1, -1, -1, -1, -1, 1, 1, 1): // HOLLOW
+  case HMAP_PACK8(1, -1, -1, -1, -1, -1, 1, 1):
+  case HMAP_PACK8(1, 1, -1, -1, -1, -1, -1, 1):
+  case HMAP_PACK8(1, 1, 1, -1, -1, -1, -1, -1):
+  case HMAP_PACK8(-1, 1, 1, 1, -1, -1, -1, -1):
+  case HMAP_PACK8(-1, -1, 1, 1, 1, -1, -1, -1):
+  case HMAP_PACK8(-1, -1, -1, 1, 1, 1, -1, -1):
+  case HMAP_PACK8(-1, -1, -1, -1, 1, 1, 1, -1):
+    //
+    return 7.f;
+
+  case HMAP_PACK8(1, 1, 1, 0, 0, 0, 0, 0): // FOOTSLOPE A
+  case HMAP_PACK8(0, 1, 1, 1, 0, 0, 0, 0):
+  case HMAP_PACK8(0, 0, 1, 1, 1, 0, 0, 0):
+  case HMAP_PACK8(0, 0, 0, 1, 1, 1, 0, 0):
+  case HMAP_PACK8(0, 0, 0, 0, 1, 1, 1, 0):
+  case HMAP_PACK8(0, 0, 0, 0, 0, 1, 1, 1):
+  case HMAP_PACK8(1, 0, 0, 0, 0, 0, 1, 1):
+  case HMAP_PACK8(1, 1, 0, 0, 0, 0, 0, 1): return 8.f;
+
+  case HMAP_PACK8(-1, -1, -1, 0, 0, 0, 0, 0): // SHOULDER
+  case HMAP_PACK8(0, -1, -1, -1, 0, 0, 0, 0):
+  case HMAP_PACK8(0, 0, -1, -1, -1, 0, 0, 0):
+  case HMAP_PACK8(0, 0, 0, -1, -1, -1, 0, 0):
+  case HMAP_PACK8(0, 0, 0, 0, -1, -1, -1, 0):
+  case HMAP_PACK8(0, 0, 0, 0, 0, -1, -1, -1):
+  case HMAP_PACK8(-1, 0, 0, 0, 0, 0, -1, -1):
+  case HMAP_PACK8(-1, -1, 0, 0, 0, 0, 0, -1): return 4.f;
+
+  default: // unknown patterns are classified as SLOPEs
+    return 6.f;
+  }
+}
+
+// label of each ternary pattern code
+static const std::array<float, GEOMORPHONS_NPATTERNS> &helper_label_table()
+{
+  static const std::array<float, GEOMORPHONS_NPATTERNS> table = []()
+  {
+    std::array<float, GEOMORPHONS_NPATTERNS> t;
+
+    for (int code = 0; code < GEOMORPHONS_NPATTERNS; code++)
     {
-      std::vector<int> signature(nb);
+      int s[8];
+      for (int k = 0, c = code; k < 8; k++, c /= 3)
+        s[k] = c % 3 - 1;
 
-      for (size_t k = 0; k < nb; k++)
-      {
-        float slope_up = 0.f;
-        float slope_dw = 0.f;
+      t[code] = helper_geomorphon_label(
+          HMAP_PACK8(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7]));
+    }
+    return t;
+  }();
 
-        for (int dr = 1; dr < dr_max; dr++)
-        {
-          int ip = i + di[k] * dr;
-          int jp = j + dj[k] * dr;
+  return table;
+}
 
-          if ((ip > -1) && (ip < array.shape.x) && (jp > -1) &&
-              (jp < array.shape.y))
-          {
-            float slope = (array(ip, jp) - array(i, j)) / (float)dr;
+// maximum of the slopes (h[q] - h[i]) / (q - i) for q in [i + d1, i + d2]
+// (-inf if the window is empty), 'hull' is a scratch buffer of size m
+static void helper_window_max_slope(const float *h,
+                                    int          m,
+                                    int          d1,
+                                    int          d2,
+                                    float       *out,
+                                    int         *hull)
+{
+  const int w = d2 - d1 + 1;
 
-            if (slope > 0.f)
-              slope_up = std::max(slope_up, slope);
-            else
-              slope_dw = std::min(slope_dw, slope);
-          }
-        }
+  auto slope = [&](int i, int q) { return (h[q] - h[i]) / (float)(q - i); };
 
-        if (slope_up > -slope_dw && slope_up > epsilon_normed) signature[k] = 1;
-        if (slope_up < -slope_dw && slope_dw < -epsilon_normed)
-          signature[k] = -1;
-      }
+  std::fill(out, out + m, -std::numeric_limits<float>::max());
 
-      code(i, j) = HMAP_PACK8(signature[0],
-                              signature[1],
-                              signature[2],
-                              signature[3],
-                              signature[4],
-                              signature[5],
-                              signature[6],
-                              signature[7]);
+  // short windows, direct search (contiguous and vectorizable inner loop)
+  if (w <= GEOMORPHONS_DIRECT_WINDOW)
+  {
+    for (int dr = d1; dr <= d2; dr++)
+    {
+      const float fdr = (float)dr;
+      for (int i = 0; i < m - dr; i++)
+        out[i] = std::max(out[i], (h[i + dr] - h[i]) / fdr);
     }
+    return;
+  }
 
-  // determine geomorphon ids (see "Geomorphons - a new approach to
-  // classification of landforms")
+  // slope(i, b) > slope(i, a), for a, b > i
+  auto steeper = [&](int i, int a, int b)
+  { return (h[b] - h[i]) * (float)(a - i) > (h[a] - h[i]) * (float)(b - i); };
 
-  // https://geomorphometry.org/wp-content/uploads/2021/07/StepinskiJasiewicz2011geomorphometry.pdf
+  // (b - a) x (c - a) >= 0, i.e. b not above the segment [a, c]
+  auto not_above = [&](int a, int b, int c)
+  {
+    return (float)(b - a) * (h[c] - h[a]) - (h[b] - h[a]) * (float)(c - a) >=
+           0.f;
+  };
 
-  for (int j = 0; j < array.shape.y; j++)
-    for (int i = 0; i < array.shape.x; i++)
+  // tangent from i to the hull vertices v(0), ..., v(n - 1) ordered by
+  // increasing index (unimodal slopes). The tangency point is usually
+  // among the nearest vertices, a linear walk is faster than a binary
+  // search in practice
+  auto tangent = [&](int i, int n, auto v)
+  {
+    int k = 0;
+    while (k < n - 1 && steeper(i, v(k), v(k + 1)))
+      k++;
+    return slope(i, v(k));
+  };
+
+  for (int b1 = d1 / w; b1 * w < m; b1++)
+  {
+    const int q1 = b1 * w;                     // block start
+    const int q2 = std::min(q1 + w, m) - 1;    // block end
+    const int i1 = std::max(q1 - d1, 0);       // cells whose window
+    const int i2 = std::min(q2 - d1, m - 1);   // starts in the block
+
+    // suffix [i + d1, q2] of the block, from the block end backwards (the
+    // stack top is the nearest vertex)
+    int n = 0;
+
+    for (int i = i2; i >= i1; i--)
     {
-      switch (code(i, j))
+      const int q = i + d1;
+
+      while (n >= 2 && not_above(q, hull[n - 1], hull[n - 2]))
+        n--;
+      hull[n++] = q;
+
+      out[i] = std::max(out[i],
+                        tangent(i, n, [&](int k) { return hull[n - 1 - k]; }));
+    }
+
+    // prefix [q2 + 1, i + d2] of the next block (clipped to the line end),
+    // forwards
+    n = 0;
+
+    for (int i = i1, p = q2 + 1; i <= i2; i++)
+    {
+      const int q = std::min(i + d2, m - 1);
+
+      if (q <= q2) continue;
+
+      for (; p <= q; p++)
       {
-      case HMAP_PACK8(0, 0, 0, 0, 0, 0, 0, 0): // FLAT A
-                                               //
-      case HMAP_PACK8(1, 0, 0, 0, 0, 0, 0, 0): // FLAT B
-      case HMAP_PACK8(0, 1, 0, 0, 0, 0, 0, 0):
-      case HMAP_PACK8(0, 0, 1, 0, 0, 0, 0, 0):
-      case HMAP_PACK8(0, 0, 0, 1, 0, 0, 0, 0):
-      case HMAP_PACK8(0, 0, 0, 0, 1, 0, 0, 0):
-      case HMAP_PACK8(0, 0, 0, 0, 0, 1, 0, 0):
-      case HMAP_PACK8(0, 0, 0, 0, 0, 0, 1, 0):
-      case HMAP_PACK8(0, 0, 0, 0, 0, 0, 0, 1): gm(i, j) = 1.f; break;
-
-      case HMAP_PACK8(-1, -1, -1, -1, -1, -1, -1, -1): // PEAK
-        gm(i, j) = 2.f;
-        break;
-
-      case HMAP_PACK8(1, 1, 1, 1, 1, 1, 1, 1): // PIT
-        gm(i, j) = 10.f;
-        break;
-
-      case HMAP_PACK8(0, -1, -1, -1, 0, -1, -1, -1): // RIDGE
-      case HMAP_PACK8(-1, 0, -1, -1, -1, 0, -1, -1):
-      case HMAP_PACK8(-1, -1, 0, -1, -1, -1, 0, -1):
-      case HMAP_PACK8(-1, -1, -1, 0, -1, -1, -1, 0):
-        //
-        gm(i, j) = 3.f;
-        break;
-
-      case HMAP_PACK8(0, 1, 1, 1, 0, 1, 1, 1): // VALLEY
-      case HMAP_PACK8(1, 0, 1, 1, 1, 0, 1, 1):
-      case HMAP_PACK8(1, 1, 0, 1, 1, 1, 0, 1):
-      case HMAP_PACK8(1, 1, 1, 0, 1, 1, 1, 0):
-        //
-        gm(i, j) = 9.f;
-        break;
-
-      case HMAP_PACK8(1, 1, 1, 0, -1, -1, -1, 0): // SLOPE A
-      case HMAP_PACK8(0, 1, 1, 1, 0, -1, -1, -1):
-      case HMAP_PACK8(-1, 0, 1, 1, 1, 0, -1, -1):
-      case HMAP_PACK8(-1, -1, 0, 1, 1, 1, 0, -1):
-      case HMAP_PACK8(-1, -1, -1, 0, 1, 1, 1, 0):
-      case HMAP_PACK8(0, -1, -1, -1, 0, 1, 1, 1):
-      case HMAP_PACK8(1, 0, -1, -1, -1, 0, 1, 1):
-      case HMAP_PACK8(1, 1, 0, -1, -1, -1, 0, 1):
-        //
-      case HMAP_PACK8(1, 1, 1, 1, -1, -1, -1, -1): // SLOPE C
-      case HMAP_PACK8(-1, 1, 1, 1, 1, -1, -1, -1):
-      case HMAP_PACK8(-1, -1, 1, 1, 1, 1, -1, -1):
-      case HMAP_PACK8(-1, -1, -1, 1, 1, 1, 1, -1):
-      case HMAP_PACK8(-1, -1, -1, -1, 1, 1, 1, 1):
-      case HMAP_PACK8(1, -1, -1, -1, -1, 1, 1, 1):
-      case HMAP_PACK8(1, 1, -1, -1, -1, -1, 1, 1):
-      case HMAP_PACK8(1, 1, 1, -1, -1, -1, -1, 1): gm(i, j) = 6.f; break;
-
-      case HMAP_PACK8(1, 1, 1, 1, 1, -1, -1, -1): // SPUR
-      case HMAP_PACK8(-1, 1, 1, 1, 1, 1, -1, -1):
-      case HMAP_PACK8(-1, -1, 1, 1, 1, 1, 1, -1):
-      case HMAP_PACK8(-1, -1, -1, 1, 1, 1, 1, 1):
-      case HMAP_PACK8(1, -1, -1, -1, 1, 1, 1, 1):
-      case HMAP_PACK8(1, 1, -1, -1, -1, 1, 1, 1):
-      case HMAP_PACK8(1, 1, 1, -1, -1, -1, 1, 1):
-      case HMAP_PACK8(1, 1, 1, 1, -1, -1, -1, 1):
-        //
-        gm(i, j) = 5.f;
-        break;
-
-      case HMAP_PACK8(-1, -1, -1, -1, -1, 1, 1, 1): // HOLLOW
-      case HMAP_PACK8(1, -1, -1, -1, -1, -1, 1, 1):
-      case HMAP_PACK8(1, 1, -1, -1, -1, -1, -1, 1):
-      case HMAP_PACK8(1, 1, 1, -1, -1, -1, -1, -1):
-      case HMAP_PACK8(-1, 1, 1, 1, -1, -1, -1, -1):
-      case HMAP_PACK8(-1, -1, 1, 1, 1, -1, -1, -1):
-      case HMAP_PACK8(-1, -1, -1, 1, 1, 1, -1, -1):
-      case HMAP_PACK8(-1, -1, -1, -1, 1, 1, 1, -1):
-        //
-        gm(i, j) = 7.f;
-        break;
-
-      case HMAP_PACK8(1, 1, 1, 0, 0, 0, 0, 0): // FOOTSLOPE A
-      case HMAP_PACK8(0, 1, 1, 1, 0, 0, 0, 0):
-      case HMAP_PACK8(0, 0, 1, 1, 1, 0, 0, 0):
-      case HMAP_PACK8(0, 0, 0, 1, 1, 1, 0, 0):
-      case HMAP_PACK8(0, 0, 0, 0, 1, 1, 1, 0):
-      case HMAP_PACK8(0, 0, 0, 0, 0, 1, 1, 1):
-      case HMAP_PACK8(1, 0, 0, 0, 0, 0, 1, 1):
-      case HMAP_PACK8(1, 1, 0, 0, 0, 0, 0, 1): gm(i, j) = 8.f; break;
-
-      case HMAP_PACK8(-1, -1, -1, 0, 0, 0, 0, 0): // SHOULDER
-      case HMAP_PACK8(0, -1, -1, -1, 0, 0, 0, 0):
-      case HMAP_PACK8(0, 0, -1, -1, -1, 0, 0, 0):
-      case HMAP_PACK8(0, 0, 0, -1, -1, -1, 0, 0):
-      case HMAP_PACK8(0, 0, 0, 0, -1, -1, -1, 0):
-      case HMAP_PACK8(0, 0, 0, 0, 0, -1, -1, -1):
-      case HMAP_PACK8(-1, 0, 0, 0, 0, 0, -1, -1):
-      case HMAP_PACK8(-1, -1, 0, 0, 0, 0, 0, -1): gm(i, j) = 4.f; break;
-
-      default: // unknown patterns are classified as SLOPEs
-        gm(i, j) = 6.f;
+        while (n >= 2 && not_above(hull[n - 2], hull[n - 1], p))
+          n--;
+        hull[n++] = p;
       }
+
+      out[i] = std::max(out[i],
+                        tangent(i, n, [&](int k) { return hull[k]; }));
     }
+  }
+}
+
+Array geomorphons(const Array &array,
+                  int          irmin,
+                  int          irmax,
+                  float        epsilon,
+                  Array       *p_pattern_code)
+{
+  const int nx = array.shape.x;
+  const int ny = array.shape.y;
+
+  float epsilon_normed = epsilon / (float)nx;
+
+  irmin = std::max(irmin, 1);
+  irmax = std::max(irmax, irmin);
+
+  // ternary pattern code of each cell, sum of (signature[k] + 1) * 3^k
+  std::vector<uint16_t> code(array.vector.size(), 0);
+
+  // neighborhood search, the directions k and k + 4 share the same lines
+  const std::array<int, 8> di = {-1, -1, 0, 1, 1, 1, 0, -1};
+  const std::array<int, 8> dj = {0, 1, 1, 1, 0, -1, -1, -1};
+  const std::array<int, 8> pow3 = {1, 3, 9, 27, 81, 243, 729, 2187};
+
+  for (int k = 4; k < 8; k++)
+  {
+    // start cells of the lines of direction k
+    std::vector<int> starts;
+
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+      {
+        int ip = i - di[k];
+        int jp = j - dj[k];
+        if (ip < 0 || ip >= nx || jp < 0 || jp >= ny)
+          starts.push_back(j * nx + i);
+      }
+
+    const int nlines = (int)starts.size();
+    const int nblocks = (nlines + GEOMORPHONS_BLOCK_SIZE - 1) /
+                        GEOMORPHONS_BLOCK_SIZE;
+
+    parallel_for(
+        nblocks,
+        [&](size_t b)
+        {
+          const int l1 = (int)b * GEOMORPHONS_BLOCK_SIZE;
+          const int l2 = std::min(l1 + GEOMORPHONS_BLOCK_SIZE, nlines);
+          const int mmax = std::max(nx, ny);
+
+          // line cells and heights (forward, backward and negated),
+          // slopes and hull scratch buffer
+          std::vector<int>   idx(mmax), hull(mmax);
+          std::vector<float> h(mmax), hr(mmax), hneg(mmax);
+          std::vector<float> smax(mmax), smin(mmax);
+
+          for (int l = l1; l < l2; l++)
+          {
+            int m = 0;
+            int i = starts[l] % nx;
+            int j = starts[l] / nx;
+
+            for (; i >= 0 && i < nx && j >= 0 && j < ny;
+                 i += di[k], j += dj[k], m++)
+            {
+              idx[m] = j * nx + i;
+              h[m] = array.vector[idx[m]];
+            }
+
+            // both directions of the line: k (forward) and k - 4
+            // (backward)
+            for (int dir = 0; dir < 2; dir++)
+            {
+              const int kd = dir == 0 ? k : k - 4;
+
+              for (int r = 0; r < m; r++)
+                hr[r] = dir == 0 ? h[r] : h[m - 1 - r];
+              for (int r = 0; r < m; r++)
+                hneg[r] = -hr[r];
+
+              helper_window_max_slope(hr.data(),
+                                      m,
+                                      irmin,
+                                      irmax,
+                                      smax.data(),
+                                      hull.data());
+              helper_window_max_slope(hneg.data(),
+                                      m,
+                                      irmin,
+                                      irmax,
+                                      smin.data(),
+                                      hull.data());
+
+              for (int r = 0; r < m; r++)
+              {
+                float slope_up = std::max(0.f, smax[r]);
+                float slope_dw = std::min(0.f, -smin[r]);
+                int   s = 0;
+
+                if (slope_up > -slope_dw && slope_up > epsilon_normed) s = 1;
+                if (slope_up < -slope_dw && slope_dw < -epsilon_normed) s = -1;
+
+                int cell = dir == 0 ? idx[r] : idx[m - 1 - r];
+                code[cell] += (uint16_t)((s + 1) * pow3[kd]);
+              }
+            }
+          }
+        });
+  }
+
+  // labels
+  const std::array<float, GEOMORPHONS_NPATTERNS> &labels = helper_label_table();
+
+  Array gm = Array(array.shape);
+
+  for (size_t r = 0; r < code.size(); r++)
+    gm.vector[r] = labels[code[r]];
 
-  gm.infos();
+  if (p_pattern_code)
+  {
+    *p_pattern_code = Array(array.shape);
+    for (size_t r = 0; r < code.size(); r++)
+      p_pattern_code->vector[r] = (float)code[r];
+  }
 
   return gm;
 }
@@ -0,0 +1,162 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/* Local statistics over square windows (clipped at the array borders) from
+ * summed-area tables (integral images) of the values and of their squares:
+ * the sums over any window are then obtained from four table lookups, i.e. in
+ * O(1) per cell whatever the radius. The tables are accumulated in double
+ * precision on values shifted by the array mean to avoid the cancellation of
+ * the variance on large arrays. */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "highmap/array.hpp"
+#include "highmap/features.hpp"
+#include "highmap/thread_pool.hpp"
+
+namespace
+{
+
+// number of rows (or columns) processed by a single task
+constexpr int LOCAL_STATS_BLOCK_SIZE = 64;
+
+} // namespace
+
+namespace hmap
+{
+
+void local_stats(const Array &array,
+                 int          ir,
+                 Array       *p_mean,
+                 Array       *p_variance,
+                 Array       *p_sum_squares,
+                 Array       *p_sum_squared_diff)
+{
+  const int nx = array.shape.x;
+  const int ny = array.shape.y;
+
+  if (p_mean) *p_mean = Array(array.shape);
+  if (p_variance) *p_variance = Array(array.shape);
+  if (p_sum_squares) *p_sum_squares = Array(array.shape);
+  if (p_sum_squared_diff) *p_sum_squared_diff = Array(array.shape);
+
+  if (nx == 0 || ny == 0) return;
+
+  ir = std::max(ir, 0);
+
+  // the sums of the squares are only needed beyond the mean
+  const bool with_squares = p_variance || p_sum_squares || p_sum_squared_diff;
+
+  double shift = 0.0;
+  for (float v : array.vector)
+    shift += (double)v;
+  shift /= (double)array.vector.size();
+
+  // summed-area tables, (nx + 1) x (ny + 1) with a leading row and column of
+  // zeros: s(i, j) is the sum over the cells [0, i) x [0, j). The sums of the
+  // values and of their squares are interleaved, they are read together
+  const size_t        sx = (size_t)nx + 1;
+  const size_t        ns = with_squares ? 2 : 1;
+  std::vector<double> s(ns * sx * (ny + 1), 0.0);
+
+  const size_t nby = (ny + LOCAL_STATS_BLOCK_SIZE - 1) / LOCAL_STATS_BLOCK_SIZE;
+  const size_t nbx = (nx + LOCAL_STATS_BLOCK_SIZE - 1) / LOCAL_STATS_BLOCK_SIZE;
+
+  // prefix sums along i (rows are independent)...
+  parallel_for(nby,
+               [&](size_t b)
+               {
+                 const int j0 = (int)b * LOCAL_STATS_BLOCK_SIZE;
+                 const int j1 = std::min(j0 + LOCAL_STATS_BLOCK_SIZE, ny);
+
+                 for (int j = j0; j < j1; j++)
+                 {
+                   const float *row = &array.vector[(size_t)j * nx];
+                   double      *r = &s[(j + 1) * sx * ns];
+
+                   for (int i = 0; i < nx; i++)
+                   {
+                     double v = (double)row[i] - shift;
+                     r[(i + 1) * ns] = r[i * ns] + v;
+                     if (with_squares)
+                       r[(i + 1) * ns + 1] = r[i * ns + 1] + v * v;
+                   }
+                 }
+               });
+
+  // ...then along j (columns are independent)
+  parallel_for(nbx,
+               [&](size_t b)
+               {
+                 const size_t k0 = ((size_t)b * LOCAL_STATS_BLOCK_SIZE + 1) * ns;
+                 const size_t k1 = std::min((size_t)b * LOCAL_STATS_BLOCK_SIZE +
+                                                LOCAL_STATS_BLOCK_SIZE + 1,
+                                            sx) *
+                                   ns;
+
+                 for (int j = 1; j <= ny; j++)
+                 {
+                   double       *r = &s[j * sx * ns];
+                   const double *r_prev = r - sx * ns;
+
+                   for (size_t k = k0; k < k1; k++)
+                     r[k] += r_prev[k];
+                 }
+               });
+
+  // window sums, four lookups per cell
+  parallel_for(
+      nby,
+      [&](size_t b)
+      {
+        const int j0 = (int)b * LOCAL_STATS_BLOCK_SIZE;
+        const int j1 = std::min(j0 + LOCAL_STATS_BLOCK_SIZE, ny);
+
+        for (int j = j0; j < j1; j++)
+        {
+          const double *ra = &s[std::max(j - ir, 0) * sx * ns];
+          const double *rb = &s[(std::min(j + ir, ny - 1) + 1) * sx * ns];
+          const int     cy = std::min(j + ir, ny - 1) - std::max(j - ir, 0) + 1;
+
+          for (int i = 0; i < nx; i++)
+          {
+            const size_t pa = (size_t)std::max(i - ir, 0) * ns;
+            const size_t pb = ((size_t)std::min(i + ir, nx - 1) + 1) * ns;
+            const int    cx = (int)((pb - pa) / ns);
+
+            const size_t k = (size_t)j * nx + i;
+            const double n = (double)(cx * cy);
+            const double w1 = rb[pb] - ra[pb] - rb[pa] + ra[pa];
+            const double mean = w1 / n;
+
+            if (p_mean) p_mean->vector[k] = (float)(mean + shift);
+
+            if (!with_squares) continue;
+
+            const double w2 = rb[pb + 1] - ra[pb + 1] - rb[pa + 1] + ra[pa + 1];
+
+            if (p_variance)
+              p_variance->vector[k] = (float)std::max(w2 / n - mean * mean,
+                                                      0.0);
+
+            if (p_sum_squares)
+              p_sum_squares->vector[k] = (float)(w2 + 2.0 * shift * w1 +
+                                                 n * shift * shift);
+
+            if (p_sum_squared_diff)
+            {
+              // sum of (x - x_q)^2 = n * x^2 - 2 * x * w1 + w2 (shifted)
+              double d = (double)array.vector[k] - shift;
+              p_sum_squared_diff->vector[k] = (float)std::max(
+                  n * d * d - 2.0 * d * w1 + w2,
+                  0.0);
+            }
+          }
+        }
+      });
+}
+
+} // namespace hmap
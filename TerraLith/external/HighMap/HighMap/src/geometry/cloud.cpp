@@ -18,6 +18,7 @@
 #include "highmap/geometry/cloud.hpp"
 #include "highmap/geometry/graph.hpp"
 #include "highmap/geometry/grids.hpp"
+#include "highmap/internal/segment_grid.hpp"
 #include "highmap/interpolate2d.hpp"
 #include "highmap/operator.hpp"
 
@@ -491,23 +492,16 @@ Array Cloud::to_array_sdf(Vec2<int>   shape,
     yp[k] = (yp[k] - bbox.c) / (bbox.d - bbox.c);
   }
 
-  // fill heightmap
-  auto distance_fct = [&xp, &yp](float x, float y, float)
-  {
-    float d = std::numeric_limits<float>::max();
-    for (size_t i = 0; i < xp.size(); i++)
-      d = std::min(d, std::hypot(x - xp[i], y - yp[i]));
-    return std::sqrt(d);
-  };
-
-  Array z = Array(shape);
-  fill_array_using_xy_function(z,
-                               bbox_array,
-                               nullptr,
-                               p_noise_x,
-                               p_noise_y,
-                               nullptr,
-                               distance_fct);
+  // points indexed as zero-length segments
+  SegmentGrid grid(xp, yp, xp, yp, bbox_array);
+
+  Array z = grid.get_distance_array(shape, bbox_array, p_noise_x, p_noise_y);
+
+  // square root of the distance, as returned by the former per-point
+  // evaluation
+  for (auto &v : z.vector)
+    v = std::sqrt(v);
+
   return z;
 }
 
@@ -6,78 +6,80 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
-#include <list>
+#include <queue>
 
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
 #include "highmap/geometry/graph.hpp"
 #include "highmap/geometry/path.hpp"
+#include "highmap/internal/segment_grid.hpp"
 #include "highmap/operator.hpp"
 
 namespace hmap
 {
 
-std::vector<int> Graph::dijkstra(int source_point_index, int target_point_index)
+std::vector<int> Graph::dijkstra(int   source_point_index,
+                                 int   target_point_index,
+                                 float astar_weight)
 {
-  std::vector<float> dist(this->get_npoints());
-  std::vector<int>   prev(this->get_npoints());
+  if (this->is_csr_outdated ||
+      this->csr_offsets.size() != this->get_npoints() + 1)
+    this->update_csr_adjacency();
 
-  // --- Dijkstra's algo
-  std::list<int> queue = {};
+  std::vector<float> dist(this->get_npoints(),
+                          std::numeric_limits<float>::max());
+  std::vector<int>   prev(this->get_npoints(), -1);
+  std::vector<char>  settled(this->get_npoints(), 0);
 
-  for (size_t i = 0; i < this->get_npoints(); i++)
+  auto heuristic = [this, target_point_index, astar_weight](int k)
   {
-    dist[i] = std::numeric_limits<float>::max();
-    prev[i] = -1;
-    queue.push_back((int)i);
-  }
+    if (astar_weight == 0.f) return 0.f;
+    return astar_weight * distance(this->points[k],
+                                   this->points[target_point_index]);
+  };
+
+  // --- Dijkstra's algo (binary heap, stale entries are skipped)
+  using Item = std::pair<float, int>; // (distance + heuristic, point)
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+
   dist[source_point_index] = 0.f;
+  queue.push({heuristic(source_point_index), source_point_index});
 
-  while (queue.size() > 0)
+  while (!queue.empty())
   {
-    // find closest point, within the queue
-    int   i = 0;
-    float dmax = std::numeric_limits<float>::max();
-    for (auto &k : queue)
-      if (dist[k] < dmax)
-      {
-        dmax = dist[k];
-        i = k;
-      }
+    int i = queue.top().second;
+    queue.pop();
 
-    if (i == target_point_index) break;
+    if (settled[i]) continue;
+    settled[i] = 1;
 
-    queue.remove(i);
+    if (i == target_point_index) break;
 
     // loop over point i neighbors
-    for (int &k : this->connectivity[i])
+    for (int r = this->csr_offsets[i]; r < this->csr_offsets[i + 1]; r++)
     {
-      // check if the neighbor is in the queue
-      bool found = (std::find(queue.begin(), queue.end(), k) != queue.end());
+      int k = this->csr_neighbors[r];
+      if (settled[k]) continue;
 
-      if (found)
+      float alt = dist[i] + this->csr_weights[r];
+      if (alt < dist[k]) // alternative route is better
       {
-        float alt = dist[i] + this->adjacency_matrix[{i, k}];
-        if (alt < dist[k]) // alternative route is better
-        {
-          dist[k] = alt;
-          prev[k] = i;
-        }
+        dist[k] = alt;
+        prev[k] = i;
+        queue.push({alt + heuristic(k), k});
       }
     }
   }
 
+  if (!settled[target_point_index]) return {};
+
   // --- backward rebuild the complete path
-  int              i = target_point_index;
-  std::vector<int> path = {i};
+  std::vector<int> path = {};
 
-  while (prev[i] > 0)
-  {
-    i = prev[i];
+  for (int i = target_point_index; i >= 0; i = prev[i])
     path.push_back(i);
-  }
-  path.push_back(source_point_index);
+
   std::reverse(path.begin(), path.end());
 
   return path;
@@ -141,6 +143,17 @@ size_t Graph::get_nedges()
   return this->edges.size();
 }
 
+const std::map<std::pair<int, int>, float> &Graph::get_adjacency_matrix() const
+{
+  return this->adjacency_matrix;
+}
+
+float Graph::get_adjacency_weight(int i, int j) const
+{
+  auto it = this->adjacency_matrix.find({i, j});
+  return it != this->adjacency_matrix.end() ? it->second : 0.f;
+}
+
 Graph Graph::minimum_spanning_tree_prim()
 {
   std::vector<int>   parent(this->get_npoints());
@@ -173,12 +186,15 @@ Graph Graph::minimum_spanning_tree_prim()
 
     for (size_t p = 0; p < this->get_npoints(); p++)
     {
-      if ((this->adjacency_matrix[{k, p}] > 0.f) and
-          (is_point_in_mst[p] == false) and
-          (this->adjacency_matrix[{k, p}] < key[p]))
+      // find, not operator[], which would insert zero-weight entries
+      auto it = this->adjacency_matrix.find({k, (int)p});
+      if (it == this->adjacency_matrix.end()) continue;
+
+      if ((it->second > 0.f) and (is_point_in_mst[p] == false) and
+          (it->second < key[p]))
       {
         parent[p] = k;
-        key[p] = this->adjacency_matrix[{k, p}];
+        key[p] = it->second;
       }
     }
   }
@@ -260,6 +276,13 @@ Graph Graph::remove_orphan_points()
   return graph_out;
 }
 
+void Graph::set_adjacency_weight(int i, int j, float weight)
+{
+  this->adjacency_matrix[{i, j}] = weight;
+  this->adjacency_matrix[{j, i}] = weight;
+  this->is_csr_outdated = true;
+}
+
 void Graph::to_array(Array &array, Vec4<float> bbox, bool color_by_edge_weight)
 {
   if (color_by_edge_weight)
@@ -328,32 +351,20 @@ Array Graph::to_array_sdf(Vec2<int>   shape,
     yp[k] = (yp[k] - bbox.c) / (bbox.d - bbox.c);
   }
 
-  // fill heightmap
-  auto distance_fct = [&xp, &yp](float x, float y, float)
+  // edges, spatially indexed
+  std::vector<float> xa, ya, xb, yb;
+
+  for (size_t k = 0; k + 1 < xp.size(); k += 2)
   {
-    float d = std::numeric_limits<float>::max();
+    xa.push_back(xp[k]);
+    ya.push_back(yp[k]);
+    xb.push_back(xp[k + 1]);
+    yb.push_back(yp[k + 1]);
+  }
 
-    for (size_t i = 0; i < xp.size() - 1; i += 2)
-    {
-      size_t      j = i + 1;
-      Vec2<float> e = {xp[j] - xp[i], yp[j] - yp[i]};
-      Vec2<float> w = {x - xp[i], y - yp[i]};
-      float       coeff = std::clamp(dot(w, e) / dot(e, e), 0.f, 1.f);
-      Vec2<float> b = {w.x - e.x * coeff, w.y - e.y * coeff};
-      d = std::min(d, dot(b, b));
-    }
-    return std::sqrt(d);
-  };
+  SegmentGrid grid(xa, ya, xb, yb, bbox_array);
 
-  Array z = Array(shape);
-  fill_array_using_xy_function(z,
-                               bbox_array,
-                               nullptr,
-                               p_noise_x,
-                               p_noise_y,
-                               nullptr,
-                               distance_fct);
-  return z;
+  return grid.get_distance_array(shape, bbox_array, p_noise_x, p_noise_y);
 }
 
 void Graph::to_csv(std::string fname_xy, std::string fname_adjacency)
@@ -370,10 +381,7 @@ void Graph::to_csv(std::string fname_xy, std::string fname_adjacency)
   {
     for (int j = 0; j < (int)this->get_npoints(); j++)
     {
-      float v = 0.f;
-      if (this->adjacency_matrix.count({i, j}))
-        v = this->adjacency_matrix[{i, j}];
-      f << v;
+      f << this->get_adjacency_weight(i, j);
 
       if (j < (int)this->get_npoints() - 1) f << ",";
     }
@@ -402,6 +410,37 @@ void Graph::update_adjacency_matrix()
     this->adjacency_matrix[{this->edges[k][1], this->edges[k][0]}] =
         this->weights[k];
   }
+
+  this->update_csr_adjacency();
+}
+
+void Graph::update_csr_adjacency()
+{
+  size_t npoints = this->get_npoints();
+
+  this->csr_offsets.assign(npoints + 1, 0);
+  this->csr_neighbors.clear();
+  this->csr_weights.clear();
+  this->csr_neighbors.reserve(this->adjacency_matrix.size());
+  this->csr_weights.reserve(this->adjacency_matrix.size());
+
+  // the matrix keys are sorted by (row, column), rows are therefore
+  // filled one after the other
+  for (auto &[ij, w] : this->adjacency_matrix)
+  {
+    if (ij.first < 0 || ij.first >= (int)npoints || ij.second < 0 ||
+        ij.second >= (int)npoints)
+      continue;
+
+    this->csr_offsets[ij.first + 1]++;
+    this->csr_neighbors.push_back(ij.second);
+    this->csr_weights.push_back(w);
+  }
+
+  for (size_t i = 0; i < npoints; i++)
+    this->csr_offsets[i + 1] += this->csr_offsets[i];
+
+  this->is_csr_outdated = false;
 }
 
 void Graph::update_connectivity()
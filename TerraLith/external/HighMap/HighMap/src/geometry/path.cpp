@@ -12,6 +12,7 @@
 #include "highmap/features.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/geometry/path.hpp"
+#include "highmap/internal/segment_grid.hpp"
 #include "highmap/internal/vector_utils.hpp"
 #include "highmap/interpolate_curve.hpp"
 #include "highmap/morphology.hpp"
@@ -867,25 +868,34 @@ Array Path::to_array_sdf(Vec2<int>   shape,
     yp[k] = (yp[k] - bbox.c) / (bbox.d - bbox.c);
   }
 
-  // fill heightmap
-  std::function<float(float, float, float)> distance_fct;
+  // segments (including the closing one), spatially indexed
+  std::vector<float> xa, ya, xb, yb;
 
   if (this->closed)
-    distance_fct = [this](float x, float y, float)
-    { return this->sdf_closed(x, y); };
+    for (size_t i = 0, j = xp.size() - 1; i < xp.size(); j = i, i++)
+    {
+      xa.push_back(xp[i]);
+      ya.push_back(yp[i]);
+      xb.push_back(xp[j]);
+      yb.push_back(yp[j]);
+    }
   else
-    distance_fct = [this](float x, float y, float)
-    { return this->sdf_open(x, y); };
-
-  Array z = Array(shape);
-  fill_array_using_xy_function(z,
-                               bbox_array,
-                               nullptr,
-                               p_noise_x,
-                               p_noise_y,
-                               nullptr,
-                               distance_fct);
-  return z;
+    for (size_t i = 0; i + 1 < xp.size(); i++)
+    {
+      xa.push_back(xp[i]);
+      ya.push_back(yp[i]);
+      xb.push_back(xp[i + 1]);
+      yb.push_back(yp[i + 1]);
+    }
+
+  // negative inside a closed path
+  SegmentGrid grid(xa, ya, xb, yb, bbox_array);
+
+  return grid.get_distance_array(shape,
+                                 bbox_array,
+                                 p_noise_x,
+                                 p_noise_y,
+                                 this->closed);
 }
 
 void Path::to_png(std::string fname, Vec2<int> shape)
@@ -33,12 +33,13 @@ void kernel hydraulic_particle(global float *z_in,
                                const float   drag_rate,
                                const float   evap_rate,
                                const int     has_bedrock,
-                               const int     has_moisture_map)
+                               const int     has_moisture_map,
+                               const int     id_offset)
 {
   float dt = 1.f;
 
-  int id = get_global_id(0); // particle id
-  if (id > nparticles) return;
+  int id = get_global_id(0) + id_offset; // particle id
+  if (id >= nparticles) return;
 
   uint rng_state = wang_hash(seed + id);
 
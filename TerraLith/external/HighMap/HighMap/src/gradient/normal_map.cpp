@@ -64,7 +64,7 @@ Array normal_map_to_heightmap(const Tensor &nmap)
 
 Array normal_map_to_heightmap_poisson(const Tensor &nmap,
                                       int           iterations,
-                                      float         omega)
+                                      [[maybe_unused]] float omega)
 {
   Vec2<int> shape(nmap.shape.x, nmap.shape.y);
   Array     z1(shape);
@@ -83,7 +83,7 @@ Array normal_map_to_heightmap_poisson(const Tensor &nmap,
   Array rhs = divergence_from_gradients(dx, dy);
 
   Array out(shape);
-  solve_poisson_gauss_seidel(rhs, out, iterations, omega);
+  solve_poisson_multigrid(rhs, out, nullptr, iterations);
 
   return out;
 }
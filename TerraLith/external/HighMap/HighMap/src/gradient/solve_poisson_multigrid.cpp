@@ -0,0 +1,332 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/* Geometric multigrid solver of the Poisson equation (5-point Laplacian
+ * with a unit grid spacing on the finest level): V-cycles with red-black
+ * Gauss-Seidel smoothing, full-weighting restriction of the residual
+ * and bilinear prolongation of the coarse corrections. The coarse level
+ * node (I, J) coincides with the fine node (2 * I, 2 * J). The array
+ * borders and the masked cells are Dirichlet cells: their values are
+ * never modified (their corrections are zero on the coarse levels). */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "macrologger.h"
+
+#include "highmap/array.hpp"
+#include "highmap/gradient.hpp"
+#include "highmap/thread_pool.hpp"
+
+// coarsening stops when one of the level dimensions is below this size
+#define MULTIGRID_MIN_SIZE 8
+
+// number of smoothing sweeps used as the solver of the coarsest level
+#define MULTIGRID_COARSEST_SWEEPS 50
+
+// rows per band processed by a single task, and minimum number of
+// cells of a level for its sweeps to be parallelized
+#define MULTIGRID_BAND_HEIGHT 32
+#define MULTIGRID_PARALLEL_MIN_CELLS 65536
+
+// the cycles stop when the residual is not reduced at least by this
+// factor (floating-point accuracy reached)
+#define MULTIGRID_STAGNATION_RATIO 0.95f
+
+namespace hmap
+{
+
+struct MultigridLevel
+{
+  int                  nx, ny;
+  float                h2;    // squared grid spacing
+  std::vector<float>   u;     // solution (finest level) or correction
+  std::vector<float>   f;     // right-hand side
+  std::vector<float>   r;     // residual
+  std::vector<uint8_t> fixed; // Dirichlet cells
+};
+
+// apply 'fct(j1, j2)' to the interior rows [1, ny - 1[ of a level, by
+// bands processed in parallel for the large levels
+template <typename F>
+static void helper_for_rows(const MultigridLevel &lvl, F fct)
+{
+  const int nrows = lvl.ny - 2;
+  const int nbands = (nrows + MULTIGRID_BAND_HEIGHT - 1) /
+                     MULTIGRID_BAND_HEIGHT;
+
+  auto fct_band = [&](size_t b)
+  {
+    int j1 = 1 + (int)b * MULTIGRID_BAND_HEIGHT;
+    int j2 = std::min(j1 + MULTIGRID_BAND_HEIGHT, lvl.ny - 1);
+    fct(j1, j2);
+  };
+
+  if ((size_t)lvl.nx * lvl.ny >= MULTIGRID_PARALLEL_MIN_CELLS)
+    parallel_for(nbands, fct_band);
+  else
+    for (int b = 0; b < nbands; b++)
+      fct_band(b);
+}
+
+// red-black Gauss-Seidel sweeps (the cells of one color only depend on
+// the cells of the other color, the rows are updated concurrently)
+static void helper_smooth(MultigridLevel &lvl, int sweeps)
+{
+  const int nx = lvl.nx;
+
+  for (int s = 0; s < sweeps; s++)
+    for (int color = 0; color < 2; color++)
+      helper_for_rows(lvl,
+                      [&](int j1, int j2)
+                      {
+                        for (int j = j1; j < j2; j++)
+                        {
+                          const int i0 = 1 + (1 + j + color) % 2;
+
+                          for (int i = i0; i < nx - 1; i += 2)
+                          {
+                            const int k = j * nx + i;
+                            if (lvl.fixed[k]) continue;
+
+                            lvl.u[k] = 0.25f * (lvl.u[k - 1] + lvl.u[k + 1] +
+                                                lvl.u[k - nx] + lvl.u[k + nx] -
+                                                lvl.h2 * lvl.f[k]);
+                          }
+                        }
+                      });
+}
+
+// residual r = f - L(u), zero on the Dirichlet cells, returns its
+// maximum absolute value
+static float helper_residual(MultigridLevel &lvl)
+{
+  const int          nx = lvl.nx;
+  const float        ih2 = 1.f / lvl.h2;
+  std::vector<float> band_max(lvl.ny, 0.f);
+
+  std::fill(lvl.r.begin(), lvl.r.end(), 0.f);
+
+  helper_for_rows(lvl,
+                  [&](int j1, int j2)
+                  {
+                    float rmax = 0.f;
+
+                    for (int j = j1; j < j2; j++)
+                      for (int i = 1; i < nx - 1; i++)
+                      {
+                        const int k = j * nx + i;
+                        if (lvl.fixed[k]) continue;
+
+                        float lap = lvl.u[k - 1] + lvl.u[k + 1] +
+                                    lvl.u[k - nx] + lvl.u[k + nx] -
+                                    4.f * lvl.u[k];
+                        lvl.r[k] = lvl.f[k] - ih2 * lap;
+                        rmax = std::max(rmax, std::abs(lvl.r[k]));
+                      }
+
+                    band_max[j1] = rmax;
+                  });
+
+  return *std::max_element(band_max.begin(), band_max.end());
+}
+
+// coarse level of a fine level (without the right-hand side)
+static MultigridLevel helper_coarsen(const MultigridLevel &fine)
+{
+  MultigridLevel coarse;
+
+  coarse.nx = fine.nx / 2 + 1;
+  coarse.ny = fine.ny / 2 + 1;
+  coarse.h2 = 4.f * fine.h2;
+
+  const size_t n = (size_t)coarse.nx * coarse.ny;
+
+  coarse.u.resize(n);
+  coarse.f.resize(n);
+  coarse.r.resize(n);
+  coarse.fixed.assign(n, 1);
+
+  // a coarse cell is a Dirichlet cell if any of the fine cells of its
+  // restriction stencil is (borders excepted, the coarse borders remain
+  // fixed). Plain injection misses the thin masked structures and
+  // stalls the convergence
+  for (int j = 1; j < coarse.ny - 1; j++)
+    for (int i = 1; i < coarse.nx - 1; i++)
+    {
+      uint8_t fixed = 0;
+
+      for (int q = -1; q <= 1 && !fixed; q++)
+        for (int p = -1; p <= 1 && !fixed; p++)
+        {
+          const int ii = std::min(2 * i + p, fine.nx - 1);
+          const int jj = std::min(2 * j + q, fine.ny - 1);
+
+          if (ii == 0 || jj == 0 || ii == fine.nx - 1 || jj == fine.ny - 1)
+            continue;
+
+          fixed = fine.fixed[jj * fine.nx + ii];
+        }
+
+      coarse.fixed[j * coarse.nx + i] = fixed;
+    }
+
+  return coarse;
+}
+
+// full-weighting restriction of the fine residual to the coarse
+// right-hand side
+static void helper_restrict(const MultigridLevel &fine, MultigridLevel &coarse)
+{
+  const int nx = fine.nx;
+
+  std::fill(coarse.f.begin(), coarse.f.end(), 0.f);
+
+  helper_for_rows(
+      coarse,
+      [&](int j1, int j2)
+      {
+        for (int jc = j1; jc < j2; jc++)
+          for (int ic = 1; ic < coarse.nx - 1; ic++)
+          {
+            const int kc = jc * coarse.nx + ic;
+            if (coarse.fixed[kc]) continue;
+
+            // the fine node (2 * ic, 2 * jc) is interior, its right
+            // and top neighbors may be outside the fine grid
+            const int i = 2 * ic;
+            const int j = 2 * jc;
+            const int ip = std::min(i + 1, nx - 1);
+            const int jp = std::min(j + 1, fine.ny - 1);
+
+            auto r = [&](int p, int q) { return fine.r[q * nx + p]; };
+
+            coarse.f[kc] = 0.0625f *
+                           (4.f * r(i, j) +
+                            2.f * (r(i - 1, j) + r(ip, j) + r(i, j - 1) +
+                                   r(i, jp)) +
+                            r(i - 1, j - 1) + r(ip, j - 1) + r(i - 1, jp) +
+                            r(ip, jp));
+          }
+      });
+}
+
+// bilinear prolongation of the coarse correction, added to the fine
+// solution
+static void helper_prolongate(const MultigridLevel &coarse, MultigridLevel &fine)
+{
+  const int nx = fine.nx;
+
+  helper_for_rows(fine,
+                  [&](int j1, int j2)
+                  {
+                    for (int j = j1; j < j2; j++)
+                    {
+                      const int    jc = j / 2;
+                      const int    jc1 = std::min(jc + 1, coarse.ny - 1);
+                      const float  v = (j % 2) ? 0.5f : 0.f;
+                      const float *c0 = &coarse.u[jc * coarse.nx];
+                      const float *c1 = &coarse.u[jc1 * coarse.nx];
+
+                      for (int i = 1; i < nx - 1; i++)
+                      {
+                        const int k = j * nx + i;
+                        if (fine.fixed[k]) continue;
+
+                        const int   ic = i / 2;
+                        const int   ic1 = std::min(ic + 1, coarse.nx - 1);
+                        const float u = (i % 2) ? 0.5f : 0.f;
+
+                        fine.u[k] += (1.f - v) * ((1.f - u) * c0[ic] +
+                                                  u * c0[ic1]) +
+                                     v * ((1.f - u) * c1[ic] + u * c1[ic1]);
+                      }
+                    }
+                  });
+}
+
+static void helper_vcycle(std::vector<MultigridLevel> &levels,
+                          size_t                       l,
+                          int                          sweeps)
+{
+  MultigridLevel &lvl = levels[l];
+
+  if (l == levels.size() - 1)
+  {
+    helper_smooth(lvl, MULTIGRID_COARSEST_SWEEPS);
+    return;
+  }
+
+  MultigridLevel &coarse = levels[l + 1];
+
+  helper_smooth(lvl, sweeps);
+  helper_residual(lvl);
+  helper_restrict(lvl, coarse);
+
+  std::fill(coarse.u.begin(), coarse.u.end(), 0.f);
+  helper_vcycle(levels, l + 1, sweeps);
+
+  helper_prolongate(coarse, lvl);
+  helper_smooth(lvl, sweeps);
+}
+
+void solve_poisson_multigrid(const Array &rhs,
+                             Array       &h,
+                             const Array *p_mask_fixed,
+                             int          cycles_max,
+                             float        tolerance,
+                             int          sweeps)
+{
+  if (h.shape.x < 3 || h.shape.y < 3) return;
+
+  // finest level
+  std::vector<MultigridLevel> levels(1);
+  MultigridLevel             &fine = levels[0];
+
+  const size_t n = h.vector.size();
+
+  fine.nx = h.shape.x;
+  fine.ny = h.shape.y;
+  fine.h2 = 1.f;
+  fine.u = h.vector;
+  fine.f = rhs.vector;
+  fine.r.resize(n);
+  fine.fixed.assign(n, 0);
+
+  for (int j = 0; j < fine.ny; j++)
+    for (int i = 0; i < fine.nx; i++)
+    {
+      bool border = i == 0 || j == 0 || i == fine.nx - 1 || j == fine.ny - 1;
+      bool masked = p_mask_fixed && (*p_mask_fixed)(i, j) > 0.f;
+      fine.fixed[j * fine.nx + i] = border || masked;
+    }
+
+  // coarse levels
+  while (std::min(levels.back().nx, levels.back().ny) > MULTIGRID_MIN_SIZE)
+    levels.push_back(helper_coarsen(levels.back()));
+
+  // V-cycles
+  float res0 = helper_residual(levels[0]);
+  float res = res0;
+
+  for (int it = 0; it < cycles_max; it++)
+  {
+    if (res <= tolerance * res0 || res == 0.f) break;
+
+    helper_vcycle(levels, 0, sweeps);
+
+    float res_prev = res;
+    res = helper_residual(levels[0]);
+
+    LOG_DEBUG("cycle: %d, residual: %e", it, res);
+
+    if (res > MULTIGRID_STAGNATION_RATIO * res_prev) break;
+  }
+
+  h.vector = std::move(levels[0].u);
+}
+
+} // namespace hmap
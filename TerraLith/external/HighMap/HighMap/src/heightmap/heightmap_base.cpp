@@ -1,9 +1,7 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
-#include <future>
 #include <iostream>
-#include <thread>
 
 #include "macrologger.h"
 
@@ -11,6 +9,7 @@
 #include "highmap/interpolate2d.hpp"
 #include "highmap/operator.hpp"
 #include "highmap/range.hpp"
+#include "highmap/thread_pool.hpp"
 
 #include "highmap/internal/vector_utils.hpp"
 
@@ -108,41 +107,23 @@ void Heightmap::from_array_interp(Array &array)
 
 void Heightmap::from_array_interp_bicubic(Array &array)
 {
-  std::vector<std::future<void>> futures(this->get_ntiles());
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i] = std::async(&Tile::from_array_interp_bicubic,
-                            std::ref(tiles[i]),
-                            std::ref(array));
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i].get();
+  parallel_for(this->get_ntiles(),
+               [this, &array](size_t i)
+               { this->tiles[i].from_array_interp_bicubic(array); });
 }
 
 void Heightmap::from_array_interp_bilinear(Array &array)
 {
-  std::vector<std::future<void>> futures(this->get_ntiles());
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i] = std::async(&Tile::from_array_interp,
-                            std::ref(tiles[i]),
-                            std::ref(array));
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i].get();
+  parallel_for(this->get_ntiles(),
+               [this, &array](size_t i)
+               { this->tiles[i].from_array_interp(array); });
 }
 
 void Heightmap::from_array_interp_nearest(Array &array)
 {
-  std::vector<std::future<void>> futures(this->get_ntiles());
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i] = std::async(&Tile::from_array_interp_nearest,
-                            std::ref(tiles[i]),
-                            std::ref(array));
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i].get();
+  parallel_for(this->get_ntiles(),
+               [this, &array](size_t i)
+               { this->tiles[i].from_array_interp_nearest(array); });
 }
 
 float Heightmap::get_value_bilinear(float x, float y) const
@@ -251,7 +232,7 @@ float Heightmap::get_value_nearest(float x, float y) const
   return this->tiles[k](i, j);
 }
 
-void Heightmap::infos()
+void Heightmap::infos() const
 {
   std::cout << "Heightmap, ";
   std::cout << "address: " << this << ", ";
@@ -283,16 +264,13 @@ void Heightmap::inverse()
       TransformMode::DISTRIBUTED);
 }
 
-float Heightmap::max()
+float Heightmap::max() const
 {
-  std::vector<float>              max_tiles(this->get_ntiles());
-  std::vector<std::future<float>> futures(this->get_ntiles());
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i] = std::async(&Tile::max, tiles[i]);
+  std::vector<float> max_tiles(this->get_ntiles());
 
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    max_tiles[i] = futures[i].get();
+  parallel_for(this->get_ntiles(),
+               [this, &max_tiles](size_t i)
+               { max_tiles[i] = this->tiles[i].max(); });
 
   return *std::max_element(max_tiles.begin(), max_tiles.end());
 }
@@ -302,58 +280,81 @@ void Heightmap::smooth_overlap_buffers()
   int delta_buffer_i = (int)(this->overlap * this->shape.x / this->tiling.x);
   int delta_buffer_j = (int)(this->overlap * this->shape.y / this->tiling.y);
 
-  // i-direction pass
-  for (int it = 0; it < tiling.x - 1; it++)
-    for (int jt = 0; jt < tiling.y; jt++)
-    {
-      int k = this->get_tile_index(it, jt);
-      int kn = this->get_tile_index(it + 1, jt);
-
-      for (int p = 0; p < delta_buffer_i; p++)
-        for (int q = 0; q < tiles[k].shape.y; q++)
-        {
-          float r = (float)p / (float)(delta_buffer_i - 1);
-          r = (r * (r * 6.f - 15.f) + 10.f) * r * r * r;
-          int pbuf = tiles[k].shape.x - 2 * delta_buffer_i + p;
-          tiles[kn](p, q) = (1.f - r) * tiles[k](pbuf, q) + r * tiles[kn](p, q);
-          tiles[k](pbuf, q) = tiles[kn](p, q);
-        }
-    }
-
-  // j-direction
-  for (int it = 0; it < tiling.x; it++)
-    for (int jt = 0; jt < tiling.y - 1; jt++)
+  // blending weights across the buffers
+  auto weights = [](int n)
+  {
+    std::vector<float> w(n);
+    for (int p = 0; p < n; p++)
     {
-      int k = this->get_tile_index(it, jt);
-      int kn = this->get_tile_index(it, jt + 1);
-
-      for (int p = 0; p < tiles[k].shape.x; p++)
-        for (int q = 0; q < delta_buffer_j; q++)
-        {
-          float r = (float)q / (float)(delta_buffer_j - 1);
-          r = (r * (r * 6.f - 15.f) + 10.f) * r * r * r;
-          int qbuf = tiles[k].shape.y - 2 * delta_buffer_j + q;
-          tiles[kn](p, q) = (1.f - r) * tiles[k](p, qbuf) + r * tiles[kn](p, q);
-          tiles[k](p, qbuf) = tiles[kn](p, q);
-        }
+      float r = (float)p / (float)(n - 1);
+      w[p] = (r * (r * 6.f - 15.f) + 10.f) * r * r * r;
     }
-}
-
-float Heightmap::min()
-{
-  std::vector<float>              min_tiles(this->get_ntiles());
-  std::vector<std::future<float>> futures(this->get_ntiles());
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i] = std::async(&Tile::min, tiles[i]);
+    return w;
+  };
 
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    min_tiles[i] = futures[i].get();
+  std::vector<float> wi = weights(delta_buffer_i);
+  std::vector<float> wj = weights(delta_buffer_j);
+
+  // i-direction pass, the rows of tiles are independent
+  parallel_for(this->tiling.y,
+               [&](size_t jt)
+               {
+                 for (int it = 0; it < tiling.x - 1; it++)
+                 {
+                   Tile &tile = this->tiles[this->get_tile_index(it, (int)jt)];
+                   Tile &tile_n = this->tiles[this->get_tile_index(it + 1,
+                                                                   (int)jt)];
+
+                   for (int q = 0; q < tile.shape.y; q++)
+                     for (int p = 0; p < delta_buffer_i; p++)
+                     {
+                       float r = wi[p];
+                       int   pbuf = tile.shape.x - 2 * delta_buffer_i + p;
+                       tile_n(p, q) = (1.f - r) * tile(pbuf, q) +
+                                      r * tile_n(p, q);
+                       tile(pbuf, q) = tile_n(p, q);
+                     }
+                 }
+               });
+
+  // j-direction, the columns of tiles are independent
+  parallel_for(this->tiling.x,
+               [&](size_t it)
+               {
+                 for (int jt = 0; jt < tiling.y - 1; jt++)
+                 {
+                   Tile &tile = this->tiles[this->get_tile_index((int)it, jt)];
+                   Tile &tile_n = this->tiles[this->get_tile_index((int)it,
+                                                                   jt + 1)];
+
+                   for (int q = 0; q < delta_buffer_j; q++)
+                   {
+                     float r = wj[q];
+                     int   qbuf = tile.shape.y - 2 * delta_buffer_j + q;
+
+                     for (int p = 0; p < tile.shape.x; p++)
+                     {
+                       tile_n(p, q) = (1.f - r) * tile(p, qbuf) +
+                                      r * tile_n(p, q);
+                       tile(p, qbuf) = tile_n(p, q);
+                     }
+                   }
+                 }
+               });
+}
+
+float Heightmap::min() const
+{
+  std::vector<float> min_tiles(this->get_ntiles());
+
+  parallel_for(this->get_ntiles(),
+               [this, &min_tiles](size_t i)
+               { min_tiles[i] = this->tiles[i].min(); });
 
   return *std::min_element(min_tiles.begin(), min_tiles.end());
 }
 
-float Heightmap::mean()
+float Heightmap::mean() const
 {
   float mean = this->sum() / (float)(this->shape.x * this->shape.y);
   return mean;
@@ -390,16 +391,13 @@ void Heightmap::remap(float vmin, float vmax, float from_min, float from_max)
       TransformMode::DISTRIBUTED);
 }
 
-float Heightmap::sum()
+float Heightmap::sum() const
 {
-  std::vector<float>              sum_tiles(this->get_ntiles());
-  std::vector<std::future<float>> futures(this->get_ntiles());
+  std::vector<float> sum_tiles(this->get_ntiles());
 
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i] = std::async(&Tile::sum, tiles[i]);
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    sum_tiles[i] = futures[i].get();
+  parallel_for(this->get_ntiles(),
+               [this, &sum_tiles](size_t i)
+               { sum_tiles[i] = this->tiles[i].sum(); });
 
   float sum = 0.f;
   for (auto &v : sum_tiles)
@@ -448,7 +446,7 @@ Array Heightmap::to_array(Vec2<int> shape_export) const
   return array;
 }
 
-std::vector<uint8_t> Heightmap::to_grayscale_image_8bit()
+std::vector<uint8_t> Heightmap::to_grayscale_image_8bit() const
 {
   std::vector<uint8_t> img(this->shape.x * this->shape.y);
 
@@ -485,7 +483,7 @@ std::vector<uint8_t> Heightmap::to_grayscale_image_8bit()
   return img;
 }
 
-std::vector<uint16_t> Heightmap::to_grayscale_image_16bit()
+std::vector<uint16_t> Heightmap::to_grayscale_image_16bit() const
 {
   std::vector<uint16_t> img(this->shape.x * this->shape.y);
 
@@ -522,7 +520,7 @@ std::vector<uint16_t> Heightmap::to_grayscale_image_16bit()
   return img;
 }
 
-std::vector<uint16_t> Heightmap::to_grayscale_image_16bit_multithread()
+std::vector<uint16_t> Heightmap::to_grayscale_image_16bit_multithread() const
 {
   std::vector<uint16_t> img(this->shape.x * this->shape.y);
 
@@ -530,8 +528,6 @@ std::vector<uint16_t> Heightmap::to_grayscale_image_16bit_multithread()
   float vmax = this->max();
   float inv_vptp = vmin != vmax ? 1.f / (this->max() - vmin) : 0.f;
 
-  std::vector<std::future<void>> futures;
-
   // --- function to compute for each tile
 
   auto lambda = [this, &img, vmin, inv_vptp](int it, int jt)
@@ -559,19 +555,16 @@ std::vector<uint16_t> Heightmap::to_grayscale_image_16bit_multithread()
 
   // --- distribute
 
-  for (int it = 0; it < tiling.x; it++)
-    for (int jt = 0; jt < tiling.y; jt++)
-      futures.push_back(std::async(lambda, it, jt));
-
-  for (auto &f : futures)
-    f.get();
+  parallel_for(this->get_ntiles(),
+               [this, &lambda](size_t k)
+               { lambda((int)k / this->tiling.y, (int)k % this->tiling.y); });
 
   return img;
 }
 
 void Heightmap::update_tile_parameters()
 {
-  tiles.resize(this->tiling.x * this->tiling.y);
+  this->tiles.resize(this->tiling.x * this->tiling.y);
 
   // what the buffers extent to the tile domain at both frontiers
   // (added two times for the tile surrounded by other tiles)
@@ -612,21 +605,18 @@ void Heightmap::update_tile_parameters()
                                    shift.y,
                                    shift.y + scale.y);
 
-      tiles[k] = Tile(tile_shape, shift, scale, tile_bbox);
+      this->tiles.set(k, Tile(tile_shape, shift, scale, tile_bbox));
     }
 }
 
-std::vector<float> Heightmap::unique_values()
+std::vector<float> Heightmap::unique_values() const
 {
   std::vector<std::vector<float>> tile_unique_values(this->get_ntiles());
-  std::vector<std::future<std::vector<float>>> futures(this->get_ntiles());
-  std::vector<float>                           hmap_unique_values = {};
-
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    futures[i] = std::async(&Tile::unique_values, tiles[i]);
+  std::vector<float>              hmap_unique_values = {};
 
-  for (decltype(futures)::size_type i = 0; i < this->get_ntiles(); ++i)
-    tile_unique_values[i] = futures[i].get();
+  parallel_for(this->get_ntiles(),
+               [this, &tile_unique_values](size_t i)
+               { tile_unique_values[i] = this->tiles[i].unique_values(); });
 
   // fill heightmap vector values
   for (size_t i = 0; i < this->get_ntiles(); ++i)
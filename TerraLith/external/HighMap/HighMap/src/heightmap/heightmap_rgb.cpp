@@ -2,8 +2,6 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include <functional>
-#include <future>
-#include <thread>
 
 #include "macrologger.h"
 
@@ -13,6 +11,7 @@
 #include "highmap/math.hpp"
 #include "highmap/operator.hpp"
 #include "highmap/tensor.hpp"
+#include "highmap/thread_pool.hpp"
 
 namespace hmap
 {
@@ -72,17 +71,11 @@ void HeightmapRGB::colorize(Heightmap                      &h,
   // apply to the each rgb heightmaps
   for (size_t kc = 0; kc < this->rgb.size(); kc++)
   {
-    size_t                         nthreads = this->rgb[kc].get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i] = std::async(lambda,
-                              std::ref(h.tiles[i]),
-                              std::ref(this->rgb[kc].tiles[i]),
-                              kc);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i].get();
+    parallel_for(this->rgb[kc].get_ntiles(),
+                 [&](size_t i)
+                 {
+                   lambda(h.tiles[i], this->rgb[kc].tiles[i], kc);
+                 });
   }
 }
 
@@ -107,7 +100,7 @@ void HeightmapRGB::normalize()
     channel.remap(0.f, 1.f, min, max);
 }
 
-std::vector<uint8_t> HeightmapRGB::to_img_8bit(Vec2<int> shape_img)
+std::vector<uint8_t> HeightmapRGB::to_img_8bit(Vec2<int> shape_img) const
 {
   if (shape_img.x * shape_img.y == 0) shape_img = this->shape;
 
@@ -129,7 +122,7 @@ std::vector<uint8_t> HeightmapRGB::to_img_8bit(Vec2<int> shape_img)
   return img;
 }
 
-void HeightmapRGB::to_png(const std::string &fname, int depth)
+void HeightmapRGB::to_png(const std::string &fname, int depth) const
 {
   Tensor col3 = Tensor(this->shape, 3);
   for (int ch = 0; ch < col3.shape.z; ch++)
@@ -153,18 +146,14 @@ HeightmapRGB mix_heightmap_rgb(HeightmapRGB &rgb1,
   // apply to the each rgb heightmaps
   for (size_t kc = 0; kc < rgb1.rgb.size(); kc++)
   {
-    size_t                         nthreads = rgb1.rgb[kc].get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i] = std::async(lambda,
-                              std::ref(rgb_out.rgb[kc].tiles[i]),
-                              std::ref(rgb1.rgb[kc].tiles[i]),
-                              std::ref(rgb2.rgb[kc].tiles[i]),
-                              std::ref(t.tiles[i]));
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i].get();
+    parallel_for(rgb1.rgb[kc].get_ntiles(),
+                 [&](size_t i)
+                 {
+                   lambda(rgb_out.rgb[kc].tiles[i],
+                          rgb1.rgb[kc].tiles[i],
+                          rgb2.rgb[kc].tiles[i],
+                          t.tiles[i]);
+                 });
   }
 
   return rgb_out;
@@ -182,17 +171,13 @@ HeightmapRGB mix_heightmap_rgb(HeightmapRGB &rgb1, HeightmapRGB &rgb2, float t)
   // apply to the each rgb heightmaps
   for (size_t kc = 0; kc < rgb1.rgb.size(); kc++)
   {
-    size_t                         nthreads = rgb1.rgb[kc].get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i] = std::async(lambda,
-                              std::ref(rgb_out.rgb[kc].tiles[i]),
-                              std::ref(rgb1.rgb[kc].tiles[i]),
-                              std::ref(rgb2.rgb[kc].tiles[i]));
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i].get();
+    parallel_for(rgb1.rgb[kc].get_ntiles(),
+                 [&](size_t i)
+                 {
+                   lambda(rgb_out.rgb[kc].tiles[i],
+                          rgb1.rgb[kc].tiles[i],
+                          rgb2.rgb[kc].tiles[i]);
+                 });
   }
 
   return rgb_out;
@@ -212,18 +197,14 @@ HeightmapRGB mix_heightmap_rgb_sqrt(HeightmapRGB &rgb1,
   // apply to the each rgb heightmaps
   for (size_t kc = 0; kc < rgb1.rgb.size(); kc++)
   {
-    size_t                         nthreads = rgb1.rgb[kc].get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i] = std::async(lambda,
-                              std::ref(rgb_out.rgb[kc].tiles[i]),
-                              std::ref(rgb1.rgb[kc].tiles[i]),
-                              std::ref(rgb2.rgb[kc].tiles[i]),
-                              std::ref(t.tiles[i]));
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i].get();
+    parallel_for(rgb1.rgb[kc].get_ntiles(),
+                 [&](size_t i)
+                 {
+                   lambda(rgb_out.rgb[kc].tiles[i],
+                          rgb1.rgb[kc].tiles[i],
+                          rgb2.rgb[kc].tiles[i],
+                          t.tiles[i]);
+                 });
   }
 
   return rgb_out;
@@ -243,17 +224,13 @@ HeightmapRGB mix_heightmap_rgb_sqrt(HeightmapRGB &rgb1,
   // apply to the each rgb heightmaps
   for (size_t kc = 0; kc < rgb1.rgb.size(); kc++)
   {
-    size_t                         nthreads = rgb1.rgb[kc].get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i] = std::async(lambda,
-                              std::ref(rgb_out.rgb[kc].tiles[i]),
-                              std::ref(rgb1.rgb[kc].tiles[i]),
-                              std::ref(rgb2.rgb[kc].tiles[i]));
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i].get();
+    parallel_for(rgb1.rgb[kc].get_ntiles(),
+                 [&](size_t i)
+                 {
+                   lambda(rgb_out.rgb[kc].tiles[i],
+                          rgb1.rgb[kc].tiles[i],
+                          rgb2.rgb[kc].tiles[i]);
+                 });
   }
 
   return rgb_out;
@@ -2,8 +2,6 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include <functional>
-#include <future>
-#include <thread>
 
 #include "macrologger.h"
 
@@ -15,6 +13,7 @@
 #include "highmap/operator.hpp"
 #include "highmap/primitives.hpp"
 #include "highmap/tensor.hpp"
+#include "highmap/thread_pool.hpp"
 
 namespace hmap
 {
@@ -49,7 +48,7 @@ HeightmapRGBA::HeightmapRGBA(Vec2<int> shape, Vec2<int> tiling, float overlap)
   this->set_sto(shape, tiling, overlap);
 }
 
-Heightmap HeightmapRGBA::luminance()
+Heightmap HeightmapRGBA::luminance() const
 {
   // https://stackoverflow.com/questions/596216
   Heightmap out = Heightmap(this->rgba[0].shape,
@@ -57,15 +56,15 @@ Heightmap HeightmapRGBA::luminance()
                             this->rgba[0].overlap);
 
   transform(
-      {&out, &this->rgba[0], &this->rgba[1], &this->rgba[2]},
-      [](std::vector<hmap::Array *> p_arrays,
-         hmap::Vec2<int>,
-         hmap::Vec4<float>)
+      {&out},
+      {&this->rgba[0], &this->rgba[1], &this->rgba[2]},
+      [](std::vector<hmap::Array *>       p_arrays_out,
+         std::vector<const hmap::Array *> p_arrays_in)
       {
-        hmap::Array *pa_l = p_arrays[0];
-        hmap::Array *pa_r = p_arrays[1];
-        hmap::Array *pa_g = p_arrays[2];
-        hmap::Array *pa_b = p_arrays[3];
+        hmap::Array       *pa_l = p_arrays_out[0];
+        const hmap::Array *pa_r = p_arrays_in[0];
+        const hmap::Array *pa_g = p_arrays_in[1];
+        const hmap::Array *pa_b = p_arrays_in[2];
 
         *pa_l = 0.299f * (*pa_r) + 0.587f * (*pa_g) + 0.114f * (*pa_b);
       },
@@ -161,22 +160,17 @@ void HeightmapRGBA::colorize(Heightmap                      &color_level,
   // apply to the each rgb heightmaps (but not the alpha channel)
   for (size_t kc = 0; kc < 3; kc++)
   {
-    size_t                         nthreads = this->rgba[kc].get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    {
-      Array *p_n = (p_noise == nullptr) ? nullptr : &p_noise->tiles[i];
-
-      futures[i] = std::async(lambda,
-                              std::ref(color_level.tiles[i]),
-                              std::ref(this->rgba[kc].tiles[i]),
-                              p_n,
-                              kc);
-    }
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i].get();
+    parallel_for(this->rgba[kc].get_ntiles(),
+                 [&](size_t i)
+                 {
+                   Array *p_n = (p_noise == nullptr) ? nullptr
+                                                     : &p_noise->tiles[i];
+
+                   lambda(color_level.tiles[i],
+                          this->rgba[kc].tiles[i],
+                          p_n,
+                          kc);
+                 });
   }
 
   // alpha channel
@@ -273,18 +267,14 @@ HeightmapRGBA mix_heightmap_rgba(HeightmapRGBA &rgba1,
   // apply mixing
   for (size_t kc = 0; kc < 3; kc++)
   {
-    size_t                         nthreads = rgba1.rgba[kc].get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i] = std::async(lambda,
-                              std::ref(rgba_out.rgba[kc].tiles[i]),
-                              std::ref(rgba1.rgba[kc].tiles[i]),
-                              std::ref(rgba2.rgba[kc].tiles[i]),
-                              std::ref(t.tiles[i]));
-
-    for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-      futures[i].get();
+    parallel_for(rgba1.rgba[kc].get_ntiles(),
+                 [&](size_t i)
+                 {
+                   lambda(rgba_out.rgba[kc].tiles[i],
+                          rgba1.rgba[kc].tiles[i],
+                          rgba2.rgba[kc].tiles[i],
+                          t.tiles[i]);
+                 });
   }
 
   // alpha channel
@@ -470,7 +460,7 @@ void HeightmapRGBA::normalize()
       this->rgba[k].remap(0.f, 1.f, min, max); // RGB
 }
 
-void HeightmapRGBA::to_png(const std::string &fname, int depth)
+void HeightmapRGBA::to_png(const std::string &fname, int depth) const
 {
   Tensor col3 = Tensor(this->shape, 4);
   for (int ch = 0; ch < col3.shape.z; ch++)
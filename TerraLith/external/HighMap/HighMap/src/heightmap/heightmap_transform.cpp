@@ -2,39 +2,29 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include <functional>
-#include <future>
-#include <thread>
 
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
 #include "highmap/heightmap.hpp"
+#include "highmap/thread_pool.hpp"
 
 namespace hmap
 {
 
 void fill(Heightmap &h, std::function<Array(Vec2<int>)> nullary_op)
 {
-  size_t                          nthreads = h.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(nullary_op, h.tiles[i].shape);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h.tiles[i] = futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i) { h.tiles[i] = nullary_op(h.tiles[i].shape); });
 }
 
 void fill(Heightmap &h, std::function<Array(Vec2<int>, Vec4<float>)> nullary_op)
 {
-  size_t                          nthreads = h.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(nullary_op, h.tiles[i].shape, h.tiles[i].bbox);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h.tiles[i] = futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 h.tiles[i] = nullary_op(h.tiles[i].shape, h.tiles[i].bbox);
+               });
 }
 
 void fill(
@@ -44,23 +34,19 @@ void fill(
     std::function<Array(Vec2<int>, Vec4<float>, hmap::Array *, hmap::Array *)>
         nullary_op)
 {
-  size_t                          nthreads = h.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_nx = (p_noise_x == nullptr) ? nullptr : &p_noise_x->tiles[i];
-    Array *p_ny = (p_noise_y == nullptr) ? nullptr : &p_noise_y->tiles[i];
-
-    futures[i] = std::async(nullary_op,
-                            h.tiles[i].shape,
-                            h.tiles[i].bbox,
-                            p_nx,
-                            p_ny);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h.tiles[i] = futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_nx = (p_noise_x == nullptr) ? nullptr
+                                                      : &p_noise_x->tiles[i];
+                 Array *p_ny = (p_noise_y == nullptr) ? nullptr
+                                                      : &p_noise_y->tiles[i];
+
+                 h.tiles[i] = nullary_op(h.tiles[i].shape,
+                                         h.tiles[i].bbox,
+                                         p_nx,
+                                         p_ny);
+               });
 }
 
 void fill(Heightmap                          &h,
@@ -73,24 +59,20 @@ void fill(Heightmap                          &h,
                               hmap::Array *,
                               hmap::Array *)> unary_op)
 {
-  size_t                          nthreads = h.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_nx = (p_noise_x == nullptr) ? nullptr : &p_noise_x->tiles[i];
-    Array *p_ny = (p_noise_y == nullptr) ? nullptr : &p_noise_y->tiles[i];
-
-    futures[i] = std::async(unary_op,
-                            std::ref(hin.tiles[i]),
-                            h.tiles[i].shape,
-                            h.tiles[i].bbox,
-                            p_nx,
-                            p_ny);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h.tiles[i] = futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_nx = (p_noise_x == nullptr) ? nullptr
+                                                      : &p_noise_x->tiles[i];
+                 Array *p_ny = (p_noise_y == nullptr) ? nullptr
+                                                      : &p_noise_y->tiles[i];
+
+                 h.tiles[i] = unary_op(hin.tiles[i],
+                                       h.tiles[i].shape,
+                                       h.tiles[i].bbox,
+                                       p_nx,
+                                       p_ny);
+               });
 }
 
 void fill(Heightmap                          &h,
@@ -103,25 +85,23 @@ void fill(Heightmap                          &h,
                               hmap::Array *,
                               hmap::Array *)> nullary_op)
 {
-  size_t                          nthreads = h.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_nx = (p_noise_x == nullptr) ? nullptr : &p_noise_x->tiles[i];
-    Array *p_ny = (p_noise_y == nullptr) ? nullptr : &p_noise_y->tiles[i];
-    Array *p_s = (p_stretching == nullptr) ? nullptr : &p_stretching->tiles[i];
-
-    futures[i] = std::async(nullary_op,
-                            h.tiles[i].shape,
-                            h.tiles[i].bbox,
-                            p_nx,
-                            p_ny,
-                            p_s);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h.tiles[i] = futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_nx = (p_noise_x == nullptr) ? nullptr
+                                                      : &p_noise_x->tiles[i];
+                 Array *p_ny = (p_noise_y == nullptr) ? nullptr
+                                                      : &p_noise_y->tiles[i];
+                 Array *p_s = (p_stretching == nullptr)
+                                  ? nullptr
+                                  : &p_stretching->tiles[i];
+
+                 h.tiles[i] = nullary_op(h.tiles[i].shape,
+                                         h.tiles[i].bbox,
+                                         p_nx,
+                                         p_ny,
+                                         p_s);
+               });
 }
 
 void fill(
@@ -129,32 +109,24 @@ void fill(
     Heightmap                                                  *p_noise,
     std::function<Array(Vec2<int>, Vec4<float>, hmap::Array *)> nullary_op)
 {
-  size_t                          nthreads = h.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_n = (p_noise == nullptr) ? nullptr : &p_noise->tiles[i];
-
-    futures[i] = std::async(nullary_op, h.tiles[i].shape, h.tiles[i].bbox, p_n);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h.tiles[i] = futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_n = (p_noise == nullptr) ? nullptr
+                                                   : &p_noise->tiles[i];
+
+                 h.tiles[i] = nullary_op(h.tiles[i].shape,
+                                         h.tiles[i].bbox,
+                                         p_n);
+               });
 }
 
 void transform(Heightmap                    &h_out,
                Heightmap                    &h1,
                std::function<Array(Array &)> unary_op)
 {
-  size_t                          nthreads = h1.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(unary_op, std::ref(h1.tiles[i]));
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h_out.tiles[i] = futures[i].get();
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i) { h_out.tiles[i] = unary_op(h1.tiles[i]); });
 }
 
 void transform(Heightmap                             &h_out,
@@ -162,61 +134,37 @@ void transform(Heightmap                             &h_out,
                Heightmap                             &h2,
                std::function<Array(Array &, Array &)> binary_op)
 {
-  size_t                          nthreads = h1.get_ntiles();
-  std::vector<std::future<Array>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(binary_op,
-                            std::ref(h1.tiles[i]),
-                            std::ref(h2.tiles[i]));
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    h_out.tiles[i] = futures[i].get();
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i)
+               {
+                 h_out.tiles[i] = binary_op(h1.tiles[i], h2.tiles[i]);
+               });
 }
 
 void transform(Heightmap &h, std::function<void(Array &)> unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(unary_op, std::ref(h.tiles[i]));
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i) { unary_op(h.tiles[i]); });
 }
 
 void transform(Heightmap &h, std::function<void(Array &, Vec4<float>)> unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(unary_op, std::ref(h.tiles[i]), h.tiles[i].bbox);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i) { unary_op(h.tiles[i], h.tiles[i].bbox); });
 }
 
 void transform(Heightmap                                         &h,
                Heightmap                                         *p_noise_x,
                std::function<void(Array &, Vec4<float>, Array *)> unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_nx = (p_noise_x == nullptr) ? nullptr : &p_noise_x->tiles[i];
-
-    futures[i] = std::async(unary_op,
-                            std::ref(h.tiles[i]),
-                            h.tiles[i].bbox,
-                            p_nx);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_nx = (p_noise_x == nullptr) ? nullptr
+                                                      : &p_noise_x->tiles[i];
+
+                 unary_op(h.tiles[i], h.tiles[i].bbox, p_nx);
+               });
 }
 
 void transform(
@@ -225,40 +173,30 @@ void transform(
     Heightmap                                                  *p_noise_y,
     std::function<void(Array &, Vec4<float>, Array *, Array *)> unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_nx = (p_noise_x == nullptr) ? nullptr : &p_noise_x->tiles[i];
-    Array *p_ny = (p_noise_y == nullptr) ? nullptr : &p_noise_y->tiles[i];
-
-    futures[i] = std::async(unary_op,
-                            std::ref(h.tiles[i]),
-                            h.tiles[i].bbox,
-                            p_nx,
-                            p_ny);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_nx = (p_noise_x == nullptr) ? nullptr
+                                                      : &p_noise_x->tiles[i];
+                 Array *p_ny = (p_noise_y == nullptr) ? nullptr
+                                                      : &p_noise_y->tiles[i];
+
+                 unary_op(h.tiles[i], h.tiles[i].bbox, p_nx, p_ny);
+               });
 }
 
 void transform(Heightmap                            &h,
                Heightmap                            *p_mask,
                std::function<void(Array &, Array *)> unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_mask_array = (p_mask == nullptr) ? nullptr : &p_mask->tiles[i];
-    futures[i] = std::async(unary_op, std::ref(h.tiles[i]), p_mask_array);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_mask_array = (p_mask == nullptr) ? nullptr
+                                                           : &p_mask->tiles[i];
+
+                 unary_op(h.tiles[i], p_mask_array);
+               });
 }
 
 void transform(Heightmap                                              &h,
@@ -267,24 +205,15 @@ void transform(Heightmap                                              &h,
                hmap::Heightmap                                        *p_3,
                std::function<void(Array &, Array *, Array *, Array *)> unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_1_array = (p_1 == nullptr) ? nullptr : &p_1->tiles[i];
-    Array *p_2_array = (p_2 == nullptr) ? nullptr : &p_2->tiles[i];
-    Array *p_3_array = (p_3 == nullptr) ? nullptr : &p_3->tiles[i];
-
-    futures[i] = std::async(unary_op,
-                            std::ref(h.tiles[i]),
-                            p_1_array,
-                            p_2_array,
-                            p_3_array);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_1_array = (p_1 == nullptr) ? nullptr : &p_1->tiles[i];
+                 Array *p_2_array = (p_2 == nullptr) ? nullptr : &p_2->tiles[i];
+                 Array *p_3_array = (p_3 == nullptr) ? nullptr : &p_3->tiles[i];
+
+                 unary_op(h.tiles[i], p_1_array, p_2_array, p_3_array);
+               });
 }
 
 void transform(
@@ -297,28 +226,22 @@ void transform(
     std::function<void(Array &, Array *, Array *, Array *, Array *, Array *)>
         unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_1_array = (p_1 == nullptr) ? nullptr : &p_1->tiles[i];
-    Array *p_2_array = (p_2 == nullptr) ? nullptr : &p_2->tiles[i];
-    Array *p_3_array = (p_3 == nullptr) ? nullptr : &p_3->tiles[i];
-    Array *p_4_array = (p_4 == nullptr) ? nullptr : &p_4->tiles[i];
-    Array *p_5_array = (p_5 == nullptr) ? nullptr : &p_5->tiles[i];
-
-    futures[i] = std::async(unary_op,
-                            std::ref(h.tiles[i]),
-                            p_1_array,
-                            p_2_array,
-                            p_3_array,
-                            p_4_array,
-                            p_5_array);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_1_array = (p_1 == nullptr) ? nullptr : &p_1->tiles[i];
+                 Array *p_2_array = (p_2 == nullptr) ? nullptr : &p_2->tiles[i];
+                 Array *p_3_array = (p_3 == nullptr) ? nullptr : &p_3->tiles[i];
+                 Array *p_4_array = (p_4 == nullptr) ? nullptr : &p_4->tiles[i];
+                 Array *p_5_array = (p_5 == nullptr) ? nullptr : &p_5->tiles[i];
+
+                 unary_op(h.tiles[i],
+                          p_1_array,
+                          p_2_array,
+                          p_3_array,
+                          p_4_array,
+                          p_5_array);
+               });
 }
 
 void transform(Heightmap                                     &h,
@@ -326,55 +249,33 @@ void transform(Heightmap                                     &h,
                hmap::Heightmap                               *p_2,
                std::function<void(Array &, Array *, Array *)> unary_op)
 {
-  size_t                         nthreads = h.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-  {
-    Array *p_1_array = (p_1 == nullptr) ? nullptr : &p_1->tiles[i];
-    Array *p_2_array = (p_2 == nullptr) ? nullptr : &p_2->tiles[i];
-
-    futures[i] = std::async(unary_op,
-                            std::ref(h.tiles[i]),
-                            p_1_array,
-                            p_2_array);
-  }
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h.get_ntiles(),
+               [&](size_t i)
+               {
+                 Array *p_1_array = (p_1 == nullptr) ? nullptr : &p_1->tiles[i];
+                 Array *p_2_array = (p_2 == nullptr) ? nullptr : &p_2->tiles[i];
+
+                 unary_op(h.tiles[i], p_1_array, p_2_array);
+               });
 }
 
 void transform(Heightmap                            &h1,
                Heightmap                            &h2,
                std::function<void(Array &, Array &)> binary_op)
 {
-  size_t                         nthreads = h1.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(binary_op,
-                            std::ref(h1.tiles[i]),
-                            std::ref(h2.tiles[i]));
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i) { binary_op(h1.tiles[i], h2.tiles[i]); });
 }
 
 void transform(Heightmap                                         &h1,
                Heightmap                                         &h2,
                std::function<void(Array &, Array &, Vec4<float>)> binary_op)
 {
-  size_t                         nthreads = h1.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(binary_op,
-                            std::ref(h1.tiles[i]),
-                            std::ref(h2.tiles[i]),
-                            h1.tiles[i].bbox);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i)
+               {
+                 binary_op(h1.tiles[i], h2.tiles[i], h1.tiles[i].bbox);
+               });
 }
 
 void transform(Heightmap                                     &h1,
@@ -382,17 +283,11 @@ void transform(Heightmap                                     &h1,
                Heightmap                                     &h3,
                std::function<void(Array &, Array &, Array &)> ternary_op)
 {
-  size_t                         nthreads = h1.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(ternary_op,
-                            std::ref(h1.tiles[i]),
-                            std::ref(h2.tiles[i]),
-                            std::ref(h3.tiles[i]));
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i)
+               {
+                 ternary_op(h1.tiles[i], h2.tiles[i], h3.tiles[i]);
+               });
 }
 
 void transform(
@@ -401,18 +296,14 @@ void transform(
     Heightmap                                                  &h3,
     std::function<void(Array &, Array &, Array &, Vec4<float>)> ternary_op)
 {
-  size_t                         nthreads = h1.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(ternary_op,
-                            std::ref(h1.tiles[i]),
-                            std::ref(h2.tiles[i]),
-                            std::ref(h3.tiles[i]),
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i)
+               {
+                 ternary_op(h1.tiles[i],
+                            h2.tiles[i],
+                            h3.tiles[i],
                             h1.tiles[i].bbox);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+               });
 }
 
 void transform(
@@ -422,18 +313,14 @@ void transform(
     Heightmap                                              &h4,
     std::function<void(Array &, Array &, Array &, Array &)> quaternary_op)
 {
-  size_t                         nthreads = h1.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(quaternary_op,
-                            std::ref(h1.tiles[i]),
-                            std::ref(h2.tiles[i]),
-                            std::ref(h3.tiles[i]),
-                            std::ref(h4.tiles[i]));
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i)
+               {
+                 quaternary_op(h1.tiles[i],
+                               h2.tiles[i],
+                               h3.tiles[i],
+                               h4.tiles[i]);
+               });
 }
 
 void transform(
@@ -446,20 +333,16 @@ void transform(
     std::function<void(Array &, Array &, Array &, Array &, Array &, Array &)>
         op)
 {
-  size_t                         nthreads = h1.get_ntiles();
-  std::vector<std::future<void>> futures(nthreads);
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i] = std::async(op,
-                            std::ref(h1.tiles[i]),
-                            std::ref(h2.tiles[i]),
-                            std::ref(h3.tiles[i]),
-                            std::ref(h4.tiles[i]),
-                            std::ref(h5.tiles[i]),
-                            std::ref(h6.tiles[i]));
-
-  for (decltype(futures)::size_type i = 0; i < nthreads; ++i)
-    futures[i].get();
+  parallel_for(h1.get_ntiles(),
+               [&](size_t i)
+               {
+                 op(h1.tiles[i],
+                    h2.tiles[i],
+                    h3.tiles[i],
+                    h4.tiles[i],
+                    h5.tiles[i],
+                    h6.tiles[i]);
+               });
 }
 
 } // namespace hmap
@@ -0,0 +1,428 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+#include <opencv2/imgcodecs.hpp>
+
+#include "macrologger.h"
+
+#include "highmap/internal/string_utils.hpp"
+#include "highmap/thread_pool.hpp"
+#include "highmap/tile_store.hpp"
+
+namespace hmap
+{
+
+TileStore::TileStore(Vec2<int>          shape,
+                     Vec2<int>          tiling,
+                     float              overlap,
+                     const std::string &scratch_fname,
+                     size_t             ram_budget)
+    : shape(shape), tiling(tiling), overlap(overlap),
+      scratch_fname(scratch_fname), ram_budget(ram_budget)
+{
+  // same tile geometry as the heightmap tiles (see
+  // Heightmap::update_tile_parameters), the tiles are not allocated
+  const int delta_i = (int)(overlap * shape.x / tiling.x);
+  const int delta_j = (int)(overlap * shape.y / tiling.y);
+
+  this->tile_slots.resize(tiling.x * tiling.y);
+
+  uint64_t offset = 0;
+
+  for (int jt = 0; jt < tiling.y; jt++)
+    for (int it = 0; it < tiling.x; it++)
+    {
+      int buffer_i = (it > 0 ? delta_i : 0) + (it < tiling.x - 1 ? delta_i : 0);
+      int buffer_j = (jt > 0 ? delta_j : 0) + (jt < tiling.y - 1 ? delta_j : 0);
+
+      Vec2<int> tile_shape(shape.x / tiling.x + buffer_i,
+                           shape.y / tiling.y + buffer_j);
+
+      Vec2<float> shift((float)it / (float)tiling.x,
+                        (float)jt / (float)tiling.y);
+
+      if (it > 0) shift.x -= (float)delta_i / (float)shape.x;
+      if (jt > 0) shift.y -= (float)delta_j / (float)shape.y;
+
+      Vec2<float> scale((float)tile_shape.x / (float)shape.x,
+                        (float)tile_shape.y / (float)shape.y);
+
+      Slot &slot = this->tile_slots[this->get_tile_index(it, jt)];
+
+      slot.shape = tile_shape;
+      slot.shift = shift;
+      slot.scale = scale;
+      slot.bbox = Vec4<float>(shift.x,
+                              shift.x + scale.x,
+                              shift.y,
+                              shift.y + scale.y);
+      slot.file_offset = offset;
+
+      offset += (uint64_t)tile_shape.x * tile_shape.y * sizeof(float);
+    }
+
+  this->file.open(scratch_fname,
+                  std::ios::binary | std::ios::in | std::ios::out |
+                      std::ios::trunc);
+
+  if (!this->file.is_open())
+    LOG_ERROR("could not open scratch file: %s", scratch_fname.c_str());
+}
+
+TileStore::~TileStore()
+{
+  this->file.close();
+  std::remove(this->scratch_fname.c_str());
+}
+
+std::shared_ptr<Tile> TileStore::acquire(size_t k, bool write)
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+
+  Slot &slot = this->tile_slots[k];
+
+  if (!slot.tile)
+  {
+    slot.tile = std::make_shared<Tile>(slot.shape,
+                                       slot.shift,
+                                       slot.scale,
+                                       slot.bbox);
+
+    if (slot.on_disk)
+    {
+      this->file.seekg((std::streamoff)slot.file_offset);
+      this->file.read(reinterpret_cast<char *>(slot.tile->vector.data()),
+                      slot.tile->vector.size() * sizeof(float));
+
+      if (!this->file)
+      {
+        LOG_ERROR("could not read tile %zu from scratch file: %s",
+                  k,
+                  this->scratch_fname.c_str());
+        this->file.clear();
+      }
+    }
+
+    this->resident_bytes += slot.tile->vector.size() * sizeof(float);
+  }
+
+  slot.dirty = slot.dirty || write;
+  slot.last_use = ++this->use_counter;
+
+  std::shared_ptr<Tile> tile = slot.tile;
+
+  this->evict_over_budget();
+
+  return tile;
+}
+
+void TileStore::evict_over_budget()
+{
+  while (this->resident_bytes > this->ram_budget)
+  {
+    // least recently used tile which is not held outside of the store
+    Slot *p_lru = nullptr;
+
+    for (auto &slot : this->tile_slots)
+      if (slot.tile && slot.tile.use_count() == 1 &&
+          (!p_lru || slot.last_use < p_lru->last_use))
+        p_lru = &slot;
+
+    if (!p_lru) return;
+
+    if (p_lru->dirty) this->write_slot(*p_lru);
+
+    this->resident_bytes -= p_lru->tile->vector.size() * sizeof(float);
+    p_lru->tile.reset();
+  }
+}
+
+void TileStore::flush()
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+
+  // tiles held outside of the store may be being written, they stay dirty
+  // and are written back by a later flush or when evicted
+  for (auto &slot : this->tile_slots)
+    if (slot.tile && slot.dirty && slot.tile.use_count() == 1)
+      this->write_slot(slot);
+
+  this->file.flush();
+  this->evict_over_budget();
+}
+
+Vec2<int> TileStore::get_tile_offset(size_t k) const
+{
+  Vec4<int> core = this->get_tile_core(k);
+  int       it = (int)k % this->tiling.x;
+  int       jt = (int)k / this->tiling.x;
+
+  const int delta_i = (int)(this->overlap * this->shape.x / this->tiling.x);
+  const int delta_j = (int)(this->overlap * this->shape.y / this->tiling.y);
+
+  return Vec2<int>(it > 0 ? core.a - delta_i : core.a,
+                   jt > 0 ? core.c - delta_j : core.c);
+}
+
+Vec4<int> TileStore::get_tile_core(size_t k) const
+{
+  int it = (int)k % this->tiling.x;
+  int jt = (int)k / this->tiling.x;
+  int wi = this->shape.x / this->tiling.x;
+  int wj = this->shape.y / this->tiling.y;
+
+  return Vec4<int>(it * wi, (it + 1) * wi, jt * wj, (jt + 1) * wj);
+}
+
+int TileStore::get_tile_index(int i, int j) const
+{
+  return i + j * this->tiling.x;
+}
+
+size_t TileStore::get_ntiles() const
+{
+  return this->tile_slots.size();
+}
+
+size_t TileStore::get_resident_bytes() const
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+  return this->resident_bytes;
+}
+
+float TileStore::max()
+{
+  float vmax = -std::numeric_limits<float>::max();
+
+  for (size_t k = 0; k < this->get_ntiles(); k++)
+  {
+    std::shared_ptr<Tile> tile = this->acquire(k, false);
+    Vec4<int>             core = this->get_tile_core(k);
+    Vec2<int>             ij0 = this->get_tile_offset(k);
+
+    for (int j = core.c; j < core.d; j++)
+      for (int i = core.a; i < core.b; i++)
+        vmax = std::max(vmax, (*tile)(i - ij0.x, j - ij0.y));
+  }
+
+  return vmax;
+}
+
+float TileStore::min()
+{
+  float vmin = std::numeric_limits<float>::max();
+
+  for (size_t k = 0; k < this->get_ntiles(); k++)
+  {
+    std::shared_ptr<Tile> tile = this->acquire(k, false);
+    Vec4<int>             core = this->get_tile_core(k);
+    Vec2<int>             ij0 = this->get_tile_offset(k);
+
+    for (int j = core.c; j < core.d; j++)
+      for (int i = core.a; i < core.b; i++)
+        vmin = std::min(vmin, (*tile)(i - ij0.x, j - ij0.y));
+  }
+
+  return vmin;
+}
+
+void TileStore::from_heightmap(const Heightmap &h)
+{
+  if (h.shape != this->shape || h.tiling != this->tiling ||
+      h.overlap != this->overlap)
+  {
+    LOG_ERROR("heightmap and tile store layouts do not match");
+    return;
+  }
+
+  for (size_t k = 0; k < this->get_ntiles(); k++)
+  {
+    std::shared_ptr<Tile> tile = this->acquire(k);
+    tile->vector = h.tiles[k].vector;
+  }
+}
+
+Heightmap TileStore::to_heightmap()
+{
+  Heightmap h(this->shape, this->tiling, this->overlap);
+
+  for (size_t k = 0; k < this->get_ntiles(); k++)
+    h.tiles[k].vector = this->acquire(k, false)->vector;
+
+  return h;
+}
+
+void TileStore::write_slot(Slot &slot)
+{
+  this->file.seekp((std::streamoff)slot.file_offset);
+  this->file.write(reinterpret_cast<const char *>(slot.tile->vector.data()),
+                   slot.tile->vector.size() * sizeof(float));
+
+  if (!this->file)
+  {
+    LOG_ERROR("could not write to scratch file: %s",
+              this->scratch_fname.c_str());
+    this->file.clear();
+    return;
+  }
+
+  slot.dirty = false;
+  slot.on_disk = true;
+}
+
+//----------------------------------------------------------------------
+// Functions
+//----------------------------------------------------------------------
+
+void fill(TileStore                                   &store,
+          std::function<Array(Vec2<int>, Vec4<float>)> nullary_op)
+{
+  parallel_for(store.get_ntiles(),
+               [&](size_t k)
+               {
+                 std::shared_ptr<Tile> tile = store.acquire(k);
+                 *tile = nullary_op(tile->shape, tile->bbox);
+               });
+}
+
+void transform(std::vector<TileStore *>                     p_stores,
+               std::function<void(const std::vector<Array *>,
+                                  const hmap::Vec2<int>,
+                                  const hmap::Vec4<float>)> op,
+               const std::vector<bool>                     &is_write)
+{
+  if (!p_stores.size() || !p_stores[0])
+  {
+    LOG_ERROR("the first hmap::TileStore pointer is empty, nothing to do here");
+    return;
+  }
+
+  if (!is_write.empty() && is_write.size() != p_stores.size())
+  {
+    LOG_ERROR("the access intents and the stores have different sizes");
+    return;
+  }
+
+  parallel_for(p_stores[0]->get_ntiles(),
+               [&](size_t k)
+               {
+                 // held until the operator is done
+                 std::vector<std::shared_ptr<Tile>> tiles(p_stores.size());
+                 std::vector<Array *>               p_arrays(p_stores.size());
+
+                 for (size_t m = 0; m < p_stores.size(); m++)
+                   if (p_stores[m])
+                   {
+                     tiles[m] = p_stores[m]->acquire(
+                         k,
+                         is_write.empty() || is_write[m]);
+                     p_arrays[m] = tiles[m].get();
+                   }
+
+                 op(p_arrays, tiles[0]->shape, tiles[0]->bbox);
+               });
+}
+
+void write_raw_16bit(const std::string &fname, TileStore &store)
+{
+  const float vmin = store.min();
+  const float vmax = store.max();
+  float       a = 0.f;
+  float       b = 0.f;
+  if (vmin != vmax)
+  {
+    a = 1.f / (vmax - vmin);
+    b = -vmin / (vmax - vmin);
+  }
+
+  a *= 65535.f;
+  b *= 65535.f;
+
+  std::ofstream f(fname, std::ios::binary);
+
+  if (!f.is_open())
+  {
+    LOG_ERROR("could not open file: %s", fname.c_str());
+    return;
+  }
+
+  std::vector<uint16_t> row(store.shape.x);
+
+  // rows are written from the top, one row of tiles at a time
+  for (int jt = store.tiling.y - 1; jt > -1; jt--)
+  {
+    std::vector<std::shared_ptr<Tile>> tiles(store.tiling.x);
+    for (int it = 0; it < store.tiling.x; it++)
+      tiles[it] = store.acquire(store.get_tile_index(it, jt), false);
+
+    Vec4<int> core_j = store.get_tile_core(store.get_tile_index(0, jt));
+
+    for (int j = core_j.d - 1; j >= core_j.c; j--)
+    {
+      for (int it = 0; it < store.tiling.x; it++)
+      {
+        size_t    k = store.get_tile_index(it, jt);
+        Vec4<int> core = store.get_tile_core(k);
+        Vec2<int> ij0 = store.get_tile_offset(k);
+
+        for (int i = core.a; i < core.b; i++)
+          row[i] = (uint16_t)(uint32_t)(a * (*tiles[it])(i - ij0.x,
+                                                         j - ij0.y) +
+                                        b);
+      }
+
+      f.write(reinterpret_cast<const char *>(row.data()),
+              row.size() * sizeof(uint16_t));
+    }
+  }
+
+  if (!f) LOG_ERROR("could not write file: %s", fname.c_str());
+}
+
+void export_tiled(const std::string &fname_radical,
+                  TileStore         &store,
+                  int                leading_zeros,
+                  int                depth)
+{
+  const float vmin = store.min();
+  const float vmax = store.max();
+  const float a = vmin != vmax ? 1.f / (vmax - vmin) : 0.f;
+
+  parallel_for(store.get_ntiles(),
+               [&](size_t k)
+               {
+                 std::shared_ptr<Tile> tile = store.acquire(k, false);
+                 Vec4<int>             core = store.get_tile_core(k);
+                 Vec2<int>             ij0 = store.get_tile_offset(k);
+
+                 // tile core normalized with the global range
+                 Array array(Vec2<int>(core.b - core.a, core.d - core.c));
+
+                 for (int j = core.c; j < core.d; j++)
+                   for (int i = core.a; i < core.b; i++)
+                     array(i - core.a, j - core.c) =
+                         a * ((*tile)(i - ij0.x, j - ij0.y) - vmin);
+
+                 cv::Mat mat = array.to_cv_mat();
+                 int     scale_factor = (depth == CV_8U) ? 255 : 65535;
+                 mat.convertTo(mat, depth, scale_factor);
+                 cv::flip(mat, mat, 0); // flipud
+
+                 std::string str_it = zfill(
+                     std::to_string(k % store.tiling.x),
+                     leading_zeros);
+                 std::string str_jt = zfill(
+                     std::to_string(k / store.tiling.x),
+                     leading_zeros);
+
+                 cv::imwrite(fname_radical + "_" + str_it + "_" + str_jt +
+                                 ".png",
+                             mat);
+               });
+}
+
+} // namespace hmap
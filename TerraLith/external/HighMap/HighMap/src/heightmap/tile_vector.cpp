@@ -0,0 +1,159 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include "highmap/heightmap.hpp"
+
+namespace hmap
+{
+
+TileVector::TileVector(const TileVector &other)
+{
+  std::lock_guard<std::mutex> lock(other.mtx);
+
+  this->refs = other.refs;
+  for (auto &r : this->refs)
+    r->nslots++;
+
+  this->update_slots();
+}
+
+TileVector::TileVector(TileVector &&other) noexcept
+{
+  std::lock_guard<std::mutex> lock(other.mtx);
+
+  this->refs = std::move(other.refs);
+  this->retired = std::move(other.retired);
+  this->tile_ptrs = std::move(other.tile_ptrs);
+  this->ntiles = other.ntiles;
+
+  other.refs.clear();
+  other.retired.clear();
+  other.ntiles = 0;
+}
+
+TileVector::~TileVector() { this->release(); }
+
+TileVector &TileVector::operator=(const TileVector &other)
+{
+  if (this != &other) *this = TileVector(other);
+  return *this;
+}
+
+TileVector &TileVector::operator=(TileVector &&other) noexcept
+{
+  if (this == &other) return *this;
+
+  std::scoped_lock lock(this->mtx, other.mtx);
+
+  this->release();
+
+  this->refs = std::move(other.refs);
+  this->retired = std::move(other.retired);
+  this->tile_ptrs = std::move(other.tile_ptrs);
+  this->ntiles = other.ntiles;
+
+  other.refs.clear();
+  other.retired.clear();
+  other.ntiles = 0;
+
+  return *this;
+}
+
+Tile &TileVector::operator[](size_t k)
+{
+  if (this->tile_ptrs[k].load()->nslots.load() > 1) this->detach(k);
+  return this->tile_ptrs[k].load()->tile;
+}
+
+const Tile &TileVector::operator[](size_t k) const
+{
+  return this->tile_ptrs[k].load()->tile;
+}
+
+void TileVector::detach(size_t k)
+{
+  std::shared_ptr<SharedTile> source;
+  {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    source = this->refs[k];
+  }
+
+  if (source->nslots.load() <= 1) return;
+
+  // duplicate outside the lock, tiles are detached concurrently by
+  // the tile-parallel operations
+  auto copy = std::make_shared<SharedTile>(source->tile);
+
+  std::lock_guard<std::mutex> lock(this->mtx);
+
+  // already detached by another thread in the meantime
+  if (this->refs[k] != source) return;
+
+  source->nslots--;
+  this->retired.push_back(source);
+  this->refs[k] = copy;
+  this->tile_ptrs[k].store(copy.get());
+}
+
+bool TileVector::is_shared(size_t k) const
+{
+  return this->tile_ptrs[k].load()->nslots.load() > 1;
+}
+
+void TileVector::collect()
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+  this->retired.clear();
+}
+
+size_t TileVector::get_nretired() const
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+  return this->retired.size();
+}
+
+void TileVector::release()
+{
+  for (auto &r : this->refs)
+    r->nslots--;
+
+  this->refs.clear();
+  this->retired.clear();
+  this->tile_ptrs.reset();
+  this->ntiles = 0;
+}
+
+void TileVector::resize(size_t n)
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+
+  for (size_t k = n; k < this->refs.size(); ++k)
+    this->refs[k]->nslots--;
+
+  this->refs.resize(n);
+  for (size_t k = 0; k < n; ++k)
+    if (!this->refs[k]) this->refs[k] = std::make_shared<SharedTile>(Tile());
+
+  this->retired.clear();
+  this->update_slots();
+}
+
+void TileVector::set(size_t k, Tile tile)
+{
+  std::lock_guard<std::mutex> lock(this->mtx);
+
+  this->refs[k]->nslots--;
+  this->refs[k] = std::make_shared<SharedTile>(std::move(tile));
+  this->tile_ptrs[k].store(this->refs[k].get());
+}
+
+void TileVector::update_slots()
+{
+  this->ntiles = this->refs.size();
+  this->tile_ptrs = std::make_unique<std::atomic<SharedTile *>[]>(this->ntiles);
+
+  for (size_t k = 0; k < this->ntiles; ++k)
+    this->tile_ptrs[k].store(this->refs[k].get());
+}
+
+} // namespace hmap
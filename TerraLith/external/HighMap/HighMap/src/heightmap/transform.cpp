@@ -1,54 +1,271 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <algorithm>
 #include <functional>
-#include <future>
-#include <thread>
+#include <utility>
 
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
 #include "highmap/geometry/point.hpp"
 #include "highmap/heightmap.hpp"
+#include "highmap/thread_pool.hpp"
 
 namespace hmap
 {
 
-void transform(std::vector<Heightmap *>                     p_hmaps,
-               std::function<void(const std::vector<Array *>,
-                                  const hmap::Vec2<int>,
-                                  const hmap::Vec4<float>)> op,
-               TransformMode                                transform_mode)
+// index ranges [i1, i2[ x [j1, j2[ within the global array
+struct HaloRect
+{
+  int i1, i2, j1, j2;
+};
+
+// extent of a tile (including its overlap buffers) and of its core, the part
+// of the domain it owns, the cores being a partition of the domain
+struct HaloTile
+{
+  HaloRect extent;
+  HaloRect core;
+};
+
+static std::vector<HaloTile> helper_halo_tiles(const Heightmap &h)
+{
+  const int wi = h.shape.x / h.tiling.x;
+  const int wj = h.shape.y / h.tiling.y;
+  const int delta_i = (int)(h.overlap * h.shape.x / h.tiling.x);
+  const int delta_j = (int)(h.overlap * h.shape.y / h.tiling.y);
+
+  std::vector<HaloTile> tiles(h.get_ntiles());
+
+  for (int jt = 0; jt < h.tiling.y; jt++)
+    for (int it = 0; it < h.tiling.x; it++)
+    {
+      const Tile &tile = h.tiles[h.get_tile_index(it, jt)];
+      HaloTile   &ht = tiles[h.get_tile_index(it, jt)];
+
+      ht.core = {it * wi, (it + 1) * wi, jt * wj, (jt + 1) * wj};
+
+      ht.extent.i1 = it > 0 ? ht.core.i1 - delta_i : ht.core.i1;
+      ht.extent.j1 = jt > 0 ? ht.core.j1 - delta_j : ht.core.j1;
+      ht.extent.i2 = ht.extent.i1 + tile.shape.x;
+      ht.extent.j2 = ht.extent.j1 + tile.shape.y;
+    }
+
+  return tiles;
+}
+
+// copy the values of the global rectangle 'rect' from 'src' (global origin
+// {si0, sj0}) to 'dst' (global origin {di0, dj0})
+static void helper_halo_copy(Array       &dst,
+                             int          di0,
+                             int          dj0,
+                             const Array &src,
+                             int          si0,
+                             int          sj0,
+                             HaloRect     rect)
+{
+  for (int j = rect.j1; j < rect.j2; j++)
+    std::copy(&src(rect.i1 - si0, j - sj0),
+              &src(rect.i1 - si0, j - sj0) + (rect.i2 - rect.i1),
+              &dst(rect.i1 - di0, j - dj0));
+}
+
+static HaloRect helper_halo_intersect(HaloRect a, HaloRect b)
+{
+  return {std::max(a.i1, b.i1),
+          std::min(a.i2, b.i2),
+          std::max(a.j1, b.j1),
+          std::min(a.j2, b.j2)};
+}
+
+// exact copy of a full-domain array to the tiles (overlap buffers included)
+static void helper_scatter_array(Heightmap &h, const Array &array)
+{
+  std::vector<HaloTile> halo_tiles = helper_halo_tiles(h);
+
+  parallel_for(h.get_ntiles(),
+               [&](size_t k)
+               {
+                 const HaloRect &ek = halo_tiles[k].extent;
+                 helper_halo_copy(h.tiles[k], ek.i1, ek.j1, array, 0, 0, ek);
+               });
+}
+
+static void helper_transform_halo(
+    std::vector<Heightmap *>                     p_hmaps,
+    size_t                                       nout,
+    std::function<void(const std::vector<Array *>,
+                       const hmap::Vec2<int>,
+                       const hmap::Vec4<float>)> op,
+    int                                          halo_radius,
+    int                                          iterations)
+{
+  const Heightmap &h0 = *p_hmaps[0];
+  const size_t     ntiles = h0.get_ntiles();
+  const size_t     nmaps = p_hmaps.size();
+
+  std::vector<HaloTile> halo_tiles = helper_halo_tiles(h0);
+
+  // domain covered by the tiles
+  const int ni = h0.tiling.x * (h0.shape.x / h0.tiling.x);
+  const int nj = h0.tiling.y * (h0.shape.y / h0.tiling.y);
+
+  // tile cores extended by the halo (clipped to the domain)
+  std::vector<HaloRect> padded(ntiles);
+
+  for (size_t k = 0; k < ntiles; k++)
+  {
+    const HaloRect &c = halo_tiles[k].core;
+    padded[k] = {std::max(c.i1 - halo_radius, 0),
+                 std::min(c.i2 + halo_radius, ni),
+                 std::max(c.j1 - halo_radius, 0),
+                 std::min(c.j2 + halo_radius, nj)};
+  }
+
+  // padded arrays, for each tile and each heightmap
+  std::vector<std::vector<Array>> arrays(ntiles, std::vector<Array>(nmaps));
+
+  for (int it = 0; it < iterations; it++)
+  {
+    // gather the exact ghost cells from the cores of the neighboring tiles
+    // and apply the operator, the heightmaps are not modified until all the
+    // tiles are done
+    parallel_for(
+        ntiles,
+        [&](size_t k)
+        {
+          const HaloRect      &pk = padded[k];
+          std::vector<Array *> p_arrays(nmaps, nullptr);
+
+          for (size_t m = 0; m < nmaps; m++)
+          {
+            if (!p_hmaps[m]) continue;
+
+            const Heightmap &h = *p_hmaps[m];
+            Array           &a = arrays[k][m];
+
+            a.set_shape(Vec2<int>(pk.i2 - pk.i1, pk.j2 - pk.j1));
+
+            for (size_t s = 0; s < ntiles; s++)
+            {
+              HaloRect r = helper_halo_intersect(pk, halo_tiles[s].core);
+              if (r.i1 >= r.i2 || r.j1 >= r.j2) continue;
+
+              helper_halo_copy(a,
+                               pk.i1,
+                               pk.j1,
+                               h.tiles[s],
+                               halo_tiles[s].extent.i1,
+                               halo_tiles[s].extent.j1,
+                               r);
+            }
+
+            p_arrays[m] = &a;
+          }
+
+          Vec4<float> bbox((float)pk.i1 / (float)h0.shape.x,
+                           (float)pk.i2 / (float)h0.shape.x,
+                           (float)pk.j1 / (float)h0.shape.y,
+                           (float)pk.j2 / (float)h0.shape.y);
+
+          op(p_arrays, Vec2<int>(pk.i2 - pk.i1, pk.j2 - pk.j1), bbox);
+        });
+
+    // scatter the results back to the tiles, overlap buffers included, each
+    // cell being taken from the tile owning it
+    parallel_for(
+        ntiles,
+        [&](size_t k)
+        {
+          const HaloRect &ek = halo_tiles[k].extent;
+
+          // read-only heightmaps are not written back
+          for (size_t m = 0; m < nout; m++)
+          {
+            if (!p_hmaps[m]) continue;
+
+            Tile &tile = p_hmaps[m]->tiles[k];
+
+            for (size_t s = 0; s < ntiles; s++)
+            {
+              HaloRect r = helper_halo_intersect(ek, halo_tiles[s].core);
+              if (r.i1 >= r.i2 || r.j1 >= r.j2) continue;
+
+              helper_halo_copy(tile,
+                               ek.i1,
+                               ek.j1,
+                               arrays[s][m],
+                               padded[s].i1,
+                               padded[s].j1,
+                               r);
+            }
+          }
+        });
+  }
+}
+
+// the heightmaps from index 'nout' are only read: their tiles are accessed
+// through const references (no copy-on-write detach) and they are never
+// written back
+static void helper_transform(
+    std::vector<Heightmap *>                     p_hmaps,
+    size_t                                       nout,
+    std::function<void(const std::vector<Array *>,
+                       const hmap::Vec2<int>,
+                       const hmap::Vec4<float>)> op,
+    TransformMode                                transform_mode,
+    int                                          halo_radius,
+    int                                          iterations)
 {
-  if (!p_hmaps.size())
+  if (!p_hmaps.size() || !p_hmaps[0])
   {
     LOG_ERROR("the list of hmap::Heightmap pointers provided is empty, nothing "
               "to do here");
     return;
   }
 
-  switch (transform_mode)
+  // tile pointers, read-only tiles are passed as is to the operator
+  auto get_tile_ptr = [&p_hmaps, nout](size_t m, size_t i) -> Array *
   {
-  case TransformMode::DISTRIBUTED:
-  {
-    size_t                         nthreads = p_hmaps[0]->get_ntiles();
-    std::vector<std::future<void>> futures(nthreads);
+    Heightmap *p_h = p_hmaps[m];
+    if (!p_h) return nullptr;
+    if (m < nout) return &p_h->tiles[i];
+    return const_cast<Array *>(
+        static_cast<const Array *>(&std::as_const(p_h->tiles)[i]));
+  };
 
-    for (size_t i = 0; i < nthreads; ++i)
+  // the tiled modes without halo exchange, and the single array mode,
+  // simply apply the operator several times
+  if (iterations > 1 && transform_mode != TransformMode::HALO)
+  {
+    auto op_iter = [op, iterations](const std::vector<Array *> p_arrays,
+                                    const hmap::Vec2<int>      shape,
+                                    const hmap::Vec4<float>    bbox)
     {
-      // fill-in arrays pointers
-      std::vector<Array *> p_arrays = {};
-      for (auto p_h : p_hmaps)
-        p_arrays.push_back((p_h == nullptr) ? nullptr : &p_h->tiles[i]);
+      for (int it = 0; it < iterations; it++)
+        op(p_arrays, shape, bbox);
+    };
 
-      futures[i] = std::async(op,
-                              p_arrays,
-                              p_hmaps[0]->tiles[i].shape,
-                              p_hmaps[0]->tiles[i].bbox);
-    }
+    helper_transform(p_hmaps, nout, op_iter, transform_mode, -1, 1);
+    return;
+  }
+
+  switch (transform_mode)
+  {
+  case TransformMode::DISTRIBUTED:
+  {
+    parallel_for(p_hmaps[0]->get_ntiles(),
+                 [&p_hmaps, &op, &get_tile_ptr](size_t i)
+                 {
+                   // fill-in arrays pointers
+                   std::vector<Array *> p_arrays = {};
+                   for (size_t m = 0; m < p_hmaps.size(); m++)
+                     p_arrays.push_back(get_tile_ptr(m, i));
 
-    for (size_t i = 0; i < nthreads; ++i)
-      futures[i].get();
+                   const Tile &tile0 = std::as_const(p_hmaps[0]->tiles)[i];
+                   op(p_arrays, tile0.shape, tile0.bbox);
+                 });
   }
   break;
   //
@@ -57,10 +274,11 @@ void transform(std::vector<Heightmap *>                     p_hmaps,
     for (size_t i = 0; i < p_hmaps[0]->get_ntiles(); ++i)
     {
       std::vector<Array *> p_arrays = {};
-      for (auto p_h : p_hmaps)
-        p_arrays.push_back((p_h == nullptr) ? nullptr : &p_h->tiles[i]);
+      for (size_t m = 0; m < p_hmaps.size(); m++)
+        p_arrays.push_back(get_tile_ptr(m, i));
 
-      op(p_arrays, p_hmaps[0]->tiles[i].shape, p_hmaps[0]->tiles[i].bbox);
+      const Tile &tile0 = std::as_const(p_hmaps[0]->tiles)[i];
+      op(p_arrays, tile0.shape, tile0.bbox);
     }
   }
   break;
@@ -87,9 +305,41 @@ void transform(std::vector<Heightmap *>                     p_hmaps,
     Vec4<float> bbox = unit_square_bbox();
     op(p_arrays, p_hmaps[0]->shape, bbox);
 
-    // convert back to heightmaps from arrays
-    for (size_t k = 0; k < p_hmaps.size(); k++)
-      if (p_hmaps[k]) p_hmaps[k]->from_array_interp_nearest(arrays[k]);
+    // convert back to heightmaps from arrays (exact copy if the operator
+    // kept the heightmap shape), read-only heightmaps excluded
+    for (size_t k = 0; k < nout; k++)
+    {
+      if (!p_hmaps[k]) continue;
+
+      if (arrays[k].shape == p_hmaps[k]->shape)
+        helper_scatter_array(*p_hmaps[k], arrays[k]);
+      else
+        p_hmaps[k]->from_array_interp_nearest(arrays[k]);
+    }
+  }
+  break;
+  //
+  case TransformMode::HALO:
+  {
+    // the stencil of the operator is unknown, the ghost cells cannot be
+    // sized: plain distributed mode
+    if (halo_radius < 0)
+    {
+      LOG_DEBUG("no halo radius provided, falling back to distributed mode");
+      helper_transform(p_hmaps,
+                       nout,
+                       op,
+                       TransformMode::DISTRIBUTED,
+                       -1,
+                       iterations);
+      return;
+    }
+
+    helper_transform_halo(p_hmaps,
+                          nout,
+                          op,
+                          halo_radius,
+                          std::max(iterations, 1));
   }
   break;
   //
@@ -97,16 +347,91 @@ void transform(std::vector<Heightmap *>                     p_hmaps,
   }
 }
 
+void transform(std::vector<Heightmap *>                     p_hmaps,
+               std::function<void(const std::vector<Array *>,
+                                  const hmap::Vec2<int>,
+                                  const hmap::Vec4<float>)> op,
+               TransformMode                                transform_mode,
+               int                                          halo_radius,
+               int                                          iterations)
+{
+  helper_transform(p_hmaps,
+                   p_hmaps.size(),
+                   op,
+                   transform_mode,
+                   halo_radius,
+                   iterations);
+}
+
+void transform(std::vector<Heightmap *>                        p_hmaps_out,
+               std::vector<const Heightmap *>                  p_hmaps_in,
+               std::function<void(const std::vector<Array *>,
+                                  const std::vector<const Array *>,
+                                  const hmap::Vec2<int>,
+                                  const hmap::Vec4<float>)>    op,
+               TransformMode                                   transform_mode,
+               int                                             halo_radius,
+               int                                             iterations)
+{
+  const size_t nout = p_hmaps_out.size();
+
+  // the inputs are only accessed through const references by
+  // helper_transform
+  std::vector<Heightmap *> p_hmaps = p_hmaps_out;
+  for (auto p_h : p_hmaps_in)
+    p_hmaps.push_back(const_cast<Heightmap *>(p_h));
+
+  auto op_split = [op, nout](const std::vector<Array *> p_arrays,
+                             const hmap::Vec2<int>      shape,
+                             const hmap::Vec4<float>    bbox)
+  {
+    std::vector<Array *>       p_out(p_arrays.begin(), p_arrays.begin() + nout);
+    std::vector<const Array *> p_in(p_arrays.begin() + nout, p_arrays.end());
+    op(p_out, p_in, shape, bbox);
+  };
+
+  helper_transform(p_hmaps,
+                   nout,
+                   op_split,
+                   transform_mode,
+                   halo_radius,
+                   iterations);
+}
+
 void transform(std::vector<Heightmap *>                        p_hmaps,
                std::function<void(const std::vector<Array *>)> op,
-               TransformMode                                   transform_mode)
+               TransformMode                                   transform_mode,
+               int                                             halo_radius,
+               int                                             iterations)
 {
   // use a pass-through wrapper
   auto op_wrap = [op](const std::vector<Array *> p_arrays,
                       const hmap::Vec2<int>,
                       const hmap::Vec4<float>) { op(p_arrays); };
 
-  transform(p_hmaps, op_wrap, transform_mode);
+  transform(p_hmaps, op_wrap, transform_mode, halo_radius, iterations);
+}
+
+void transform(std::vector<Heightmap *>                     p_hmaps_out,
+               std::vector<const Heightmap *>               p_hmaps_in,
+               std::function<void(const std::vector<Array *>,
+                                  const std::vector<const Array *>)> op,
+               TransformMode                                transform_mode,
+               int                                          halo_radius,
+               int                                          iterations)
+{
+  // use a pass-through wrapper
+  auto op_wrap = [op](const std::vector<Array *>       p_arrays_out,
+                      const std::vector<const Array *> p_arrays_in,
+                      const hmap::Vec2<int>,
+                      const hmap::Vec4<float>) { op(p_arrays_out, p_arrays_in); };
+
+  transform(p_hmaps_out,
+            p_hmaps_in,
+            op_wrap,
+            transform_mode,
+            halo_radius,
+            iterations);
 }
 
 } // namespace hmap
@@ -7,12 +7,16 @@
 
 #include "highmap/array.hpp"
 #include "highmap/erosion.hpp"
+#include "highmap/execution_context.hpp"
 #include "highmap/features.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/hydrology.hpp"
 #include "highmap/interpolate2d.hpp"
 #include "highmap/range.hpp"
 
+// number of flooded cells between two polls of the execution context
+#define FLOODING_POLL_PERIOD 65536
+
 namespace hmap
 {
 
@@ -124,8 +128,12 @@ Array flooding_from_point(const Array &z,
   // loop around the starting point, anything with elevation lower
   // than the reference elevation is water. If not, the cell is
   // outside the "water" mask
+  size_t npopped = 0;
+
   while (queue.size() > 0)
   {
+    if (++npopped % FLOODING_POLL_PERIOD == 0) poll_execution_context();
+
     Vec2<int> ij = queue.back();
     queue.pop_back();
 
@@ -156,21 +164,24 @@ Array flooding_from_point(const Array            &z,
   Array water_depth(z.shape);
 
   for (size_t k = 0; k < i.size(); k++)
+  {
+    poll_execution_context((float)k / (float)i.size());
+
     water_depth = maximum(water_depth,
                           flooding_from_point(z, i[k], j[k], depth_min));
+  }
 
   return water_depth;
 }
 
 Array flooding_lake_system(const Array &z,
-                           int          iterations,
                            float        epsilon,
                            float        surface_threshold)
 {
   Array water_depth = z;
 
-  // use a rough depression filling algo to get the lake zones and depths
-  depression_filling(water_depth, iterations, epsilon);
+  // fill the depressions to get the lake zones and depths
+  depression_filling(water_depth, epsilon);
 
   for (int j = 0; j < z.shape.y; j++)
     for (int i = 0; i < z.shape.x; i++)
@@ -189,6 +200,14 @@ Array flooding_lake_system(const Array &z,
   return water_depth;
 }
 
+Array flooding_lake_system(const Array &z,
+                           [[maybe_unused]] int iterations,
+                           float                epsilon,
+                           float                surface_threshold)
+{
+  return flooding_lake_system(z, epsilon, surface_threshold);
+}
+
 Array merge_water_depths(const Array &depth1,
                          const Array &depth2,
                          float        k_smooth)
@@ -238,7 +257,7 @@ Array water_depth_from_mask(const Array &z,
                             float        mask_threshold,
                             int          iterations_max,
                             float        tolerance,
-                            float        omega)
+                            [[maybe_unused]] float omega)
 {
   Array water_depth(z.shape);
 
@@ -250,8 +269,7 @@ Array water_depth_from_mask(const Array &z,
   water_depth = harmonic_interpolation(z,
                                        mask_t,
                                        iterations_max,
-                                       tolerance,
-                                       omega) -
+                                       tolerance) -
                 z;
 
   return water_depth;
@@ -299,6 +317,8 @@ Array water_depth_increase(const Array &water_depth,
 
   while (queue.size() > 0 && it < max_it)
   {
+    if ((it + 1) % FLOODING_POLL_PERIOD == 0) poll_execution_context();
+
     Vec2<int> ij = queue.back();
     queue.pop_back();
 
@@ -353,6 +373,8 @@ Array water_depth_increase(const Array &water_depth,
 
   while (queue.size() > 0 && it < max_it)
   {
+    if ((it + 1) % FLOODING_POLL_PERIOD == 0) poll_execution_context();
+
     Vec2<int> ij = queue.back();
     queue.pop_back();
 
@@ -4,6 +4,7 @@
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
+#include "highmap/erosion.hpp"
 #include "highmap/filters.hpp"
 #include "highmap/geometry/path.hpp"
 #include "highmap/shortest_path.hpp"
@@ -43,12 +44,25 @@ void helper_find_up_downslope(const Array     &z,
     }
 }
 
-Path flow_stream(const Array    &z,
+Path flow_stream(const Array    &z_input,
                  const Vec2<int> ij_start,
                  const float     elevation_ratio = 0.5f,
                  const float     distance_exponent = 2.f,
-                 const float     upward_penalization = 100.f)
+                 const float     upward_penalization = 100.f,
+                 const bool      fill_depressions = false)
 {
+  // with the depressions filled, there is a downward path from any
+  // cell to the boundaries and the stream does not climb out of the
+  // local minima (the path elevations are still taken from the input)
+  Array z_filled;
+
+  if (fill_depressions)
+  {
+    z_filled = z_input;
+    depression_filling(z_filled);
+  }
+
+  const Array &z = fill_depressions ? z_filled : z_input;
 
   // --
 
@@ -108,7 +122,7 @@ Path flow_stream(const Array    &z,
   {
     x[r] = (float)i_path_list[kmin][r] / (shape.x - 1.f);
     y[r] = (float)j_path_list[kmin][r] / (shape.y - 1.f);
-    v[r] = z(i_path_list[kmin][r], j_path_list[kmin][r]);
+    v[r] = z_input(i_path_list[kmin][r], j_path_list[kmin][r]);
   }
 
   Path path(x, y, v);
@@ -1,14 +1,18 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <algorithm>
+
 #include "delaunator-cpp.hpp"
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
 #include "highmap/functions.hpp"
+#include "highmap/geometry/grids.hpp"
 #include "highmap/interpolate2d.hpp"
 #include "highmap/operator.hpp"
 #include "highmap/primitives.hpp"
+#include "highmap/thread_pool.hpp"
 
 namespace hmap
 {
@@ -87,6 +91,80 @@ Array interpolate2d_nearest(Vec2<int>                 shape,
   return array_out;
 }
 
+// rows per band of output array processed by a single task
+#define DELAUNAY_BAND_HEIGHT 32
+
+// relative tolerance of the inside-triangle tests, so that the pixels
+// lying on the shared edges are not missed because of round-off errors
+#define DELAUNAY_EPSILON 1e-5f
+
+// barycentric coordinates (s, t) of a triangle as affine functions of
+// (x, y), i.e. s = s0 + sx * x + sy * y
+struct DelaunayTriangle
+{
+  float s0, sx, sy;
+  float t0, tx, ty;
+  float v0, dv1, dv2; // interpolated value v0 + s * dv1 + t * dv2
+  float xmin, xmax, ymin, ymax;
+};
+
+// walking point location (visibility walk): starting from triangle
+// 'kt', move across the edges separating the current triangle from the
+// point until the triangle containing the point is found. Returns false
+// if the point lies outside the convex hull of the triangulation
+static bool helper_delaunay_walk(const delaunator::Delaunator<float> &d,
+                                 const std::vector<DelaunayTriangle> &tri,
+                                 float                                xq,
+                                 float                                yq,
+                                 size_t                              &kt)
+{
+  const size_t ntri = tri.size();
+
+  for (size_t it = 0; it < ntri; it++)
+  {
+    const DelaunayTriangle &tr = tri[kt];
+
+    float s = tr.s0 + tr.sx * xq + tr.sy * yq;
+    float t = tr.t0 + tr.tx * xq + tr.ty * yq;
+    float u = 1.f - s - t;
+
+    if (s >= -DELAUNAY_EPSILON && t >= -DELAUNAY_EPSILON &&
+        u >= -DELAUNAY_EPSILON)
+      return true;
+
+    // cross the edge opposite to the most negative barycentric
+    // coordinate (u: edge p1-p2, s: edge p2-p0, t: edge p0-p1, the
+    // half-edge 3 * kt + k going from vertex k to vertex k + 1)
+    size_t e;
+    if (u <= s && u <= t)
+      e = 3 * kt + 1;
+    else if (s <= t)
+      e = 3 * kt + 2;
+    else
+      e = 3 * kt;
+
+    size_t e_opp = d.halfedges[e];
+    if (e_opp == delaunator::INVALID_INDEX) return false;
+    kt = e_opp / 3;
+  }
+
+  // no convergence (degenerate triangles), exhaustive search
+  for (kt = 0; kt < ntri; kt++)
+  {
+    const DelaunayTriangle &tr = tri[kt];
+
+    float s = tr.s0 + tr.sx * xq + tr.sy * yq;
+    float t = tr.t0 + tr.tx * xq + tr.ty * yq;
+
+    if (s >= -DELAUNAY_EPSILON && t >= -DELAUNAY_EPSILON &&
+        s + t <= 1.f + DELAUNAY_EPSILON)
+      return true;
+  }
+
+  kt = 0;
+  return false;
+}
+
 Array interpolate2d_delaunay(Vec2<int>                 shape,
                              const std::vector<float> &x,
                              const std::vector<float> &y,
@@ -96,6 +174,10 @@ Array interpolate2d_delaunay(Vec2<int>                 shape,
                              const Array              *p_stretching,
                              Vec4<float>               bbox)
 {
+  Array array_out = Array(shape);
+
+  if (x.size() < 3) return array_out;
+
   // triangulate
   std::vector<float> coords(2 * x.size());
 
@@ -107,58 +189,147 @@ Array interpolate2d_delaunay(Vec2<int>                 shape,
 
   delaunator::Delaunator<float> d(coords);
 
-  // compute and store triangles area
-  std::vector<float> area(d.triangles.size());
+  // barycentric coordinates of each triangle
+  // https://stackoverflow.com/questions/2049582
+  std::vector<DelaunayTriangle> tri(d.triangles.size() / 3);
 
-  for (size_t k = 0; k < d.triangles.size(); k += 3)
+  for (size_t kt = 0; kt < tri.size(); kt++)
   {
-    int p0 = d.triangles[k];
-    int p1 = d.triangles[k + 1];
-    int p2 = d.triangles[k + 2];
+    size_t p0 = d.triangles[3 * kt];
+    size_t p1 = d.triangles[3 * kt + 1];
+    size_t p2 = d.triangles[3 * kt + 2];
+
+    float area2 = -y[p1] * x[p2] + y[p0] * (-x[p1] + x[p2]) +
+                  x[p0] * (y[p1] - y[p2]) + x[p1] * y[p2];
+    float inv = area2 != 0.f ? 1.f / area2 : 0.f;
+
+    DelaunayTriangle &tr = tri[kt];
+
+    tr.s0 = inv * (y[p0] * x[p2] - x[p0] * y[p2]);
+    tr.sx = inv * (y[p2] - y[p0]);
+    tr.sy = inv * (x[p0] - x[p2]);
+    tr.t0 = inv * (x[p0] * y[p1] - y[p0] * x[p1]);
+    tr.tx = inv * (y[p0] - y[p1]);
+    tr.ty = inv * (x[p1] - x[p0]);
 
-    // true area
-    area[k] = 0.5f * (-y[p1] * x[p2] + y[p0] * (-x[p1] + x[p2]) +
-                      x[p0] * (y[p1] - y[p2]) + x[p1] * y[p2]);
+    // degenerate triangles are never inside
+    if (area2 == 0.f) tr.s0 = tr.t0 = -1.f;
 
-    // but stored like this to avoid doing it at each evaluation while
-    // interpolating
-    area[k] = 1.f / (2.f * area[k]);
+    tr.v0 = values[p0];
+    tr.dv1 = values[p1] - values[p0];
+    tr.dv2 = values[p2] - values[p0];
+
+    tr.xmin = std::min({x[p0], x[p1], x[p2]});
+    tr.xmax = std::max({x[p0], x[p1], x[p2]});
+    tr.ymin = std::min({y[p0], y[p1], y[p2]});
+    tr.ymax = std::max({y[p0], y[p1], y[p2]});
   }
 
-  auto itp_fct = [&x, &y, &values, &d, &area](float x_, float y_, float)
+  std::vector<float> xg, yg;
+  grid_xy_vector(xg, yg, shape, bbox, false);
+
+  const int nbands = (shape.y + DELAUNAY_BAND_HEIGHT - 1) /
+                     DELAUNAY_BAND_HEIGHT;
+
+  if (!p_noise_x && !p_noise_y && !p_stretching)
   {
-    // https://stackoverflow.com/questions/2049582
+    // regular grid: each triangle is scan-converted over the cells of
+    // its bounding box, the rows are processed by bands in parallel
+    // (triangles binned by band)
+    const float dx = (bbox.b - bbox.a) / (float)shape.x;
+    const float dy = (bbox.d - bbox.c) / (float)shape.y;
 
-    // compute barycentric coordinates to find in which triangle the
-    // point (x_, y_) is inside
-    for (size_t k = 0; k < d.triangles.size(); k += 3)
+    auto to_index = [](float v, float v0, float dv, int n, bool lower)
     {
-      int p0 = d.triangles[k];
-      int p1 = d.triangles[k + 1];
-      int p2 = d.triangles[k + 2];
-
-      float s = area[k] * (y[p0] * x[p2] - x[p0] * y[p2] +
-                           (y[p2] - y[p0]) * x_ + (x[p0] - x[p2]) * y_);
-      float t = area[k] * (x[p0] * y[p1] - y[p0] * x[p1] +
-                           (y[p0] - y[p1]) * x_ + (x[p1] - x[p0]) * y_);
-
-      if (s >= 0.f && t >= 0.f && s + t <= 1.f)
-        return values[p0] + s * (values[p1] - values[p0]) +
-               t * (values[p2] - values[p0]);
+      float r = (v - v0) / dv;
+      int   k = lower ? (int)std::ceil(r) - 1 : (int)std::floor(r) + 1;
+      return std::clamp(k, 0, n - 1);
+    };
+
+    std::vector<std::vector<size_t>> bands(nbands);
+
+    for (size_t kt = 0; kt < tri.size(); kt++)
+    {
+      int j1 = to_index(tri[kt].ymin, bbox.c, dy, shape.y, true);
+      int j2 = to_index(tri[kt].ymax, bbox.c, dy, shape.y, false);
+
+      for (int b = j1 / DELAUNAY_BAND_HEIGHT; b <= j2 / DELAUNAY_BAND_HEIGHT;
+           b++)
+        bands[b].push_back(kt);
     }
 
-    return 0.f;
-  };
+    parallel_for(
+        nbands,
+        [&](size_t b)
+        {
+          int jb1 = (int)b * DELAUNAY_BAND_HEIGHT;
+          int jb2 = std::min(jb1 + DELAUNAY_BAND_HEIGHT, shape.y) - 1;
 
-  Array array_out = Array(shape);
+          for (size_t kt : bands[b])
+          {
+            const DelaunayTriangle &tr = tri[kt];
 
-  fill_array_using_xy_function(array_out,
-                               bbox,
-                               nullptr,
-                               p_noise_x,
-                               p_noise_y,
-                               p_stretching,
-                               itp_fct);
+            int i1 = to_index(tr.xmin, bbox.a, dx, shape.x, true);
+            int i2 = to_index(tr.xmax, bbox.a, dx, shape.x, false);
+            int j1 = std::max(jb1,
+                              to_index(tr.ymin, bbox.c, dy, shape.y, true));
+            int j2 = std::min(jb2,
+                              to_index(tr.ymax, bbox.c, dy, shape.y, false));
+
+            // incremental barycentric coordinates along the rows
+            const float ds = tr.sx * dx;
+            const float dt = tr.tx * dx;
+
+            for (int j = j1; j <= j2; j++)
+            {
+              float s = tr.s0 + tr.sx * xg[i1] + tr.sy * yg[j];
+              float t = tr.t0 + tr.tx * xg[i1] + tr.ty * yg[j];
+              float *row = &array_out.vector[j * shape.x];
+
+              for (int i = i1; i <= i2; i++, s += ds, t += dt)
+                if (s >= -DELAUNAY_EPSILON && t >= -DELAUNAY_EPSILON &&
+                    s + t <= 1.f + DELAUNAY_EPSILON)
+                  row[i] = tr.v0 + s * tr.dv1 + t * tr.dv2;
+            }
+          }
+        });
+  }
+  else
+  {
+    // displaced query positions: point location by walking from the
+    // triangle found for the previous cell (coherent positions)
+    parallel_for(
+        nbands,
+        [&](size_t b)
+        {
+          int    jb1 = (int)b * DELAUNAY_BAND_HEIGHT;
+          int    jb2 = std::min(jb1 + DELAUNAY_BAND_HEIGHT, shape.y);
+          size_t kt = 0;
+
+          for (int j = jb1; j < jb2; j++)
+            for (int i = 0; i < shape.x; i++)
+            {
+              float xq = xg[i];
+              float yq = yg[j];
+
+              if (p_stretching)
+              {
+                xq *= (*p_stretching)(i, j);
+                yq *= (*p_stretching)(i, j);
+              }
+              if (p_noise_x) xq += (*p_noise_x)(i, j);
+              if (p_noise_y) yq += (*p_noise_y)(i, j);
+
+              if (!helper_delaunay_walk(d, tri, xq, yq, kt)) continue;
+
+              const DelaunayTriangle &tr = tri[kt];
+
+              float s = tr.s0 + tr.sx * xq + tr.sy * yq;
+              float t = tr.t0 + tr.tx * xq + tr.ty * yq;
+              array_out(i, j) = tr.v0 + s * tr.dv1 + t * tr.dv2;
+            }
+        });
+  }
 
   return array_out;
 }
@@ -135,6 +135,18 @@ void interpolate_heightmap(const hmap::Heightmap &h_source,
                            const CoordFrame      &t_source,
                            const CoordFrame      &t_target)
 {
+  // same frames and same layout, the interpolation is the identity and
+  // the tiles are shared instead (copy-on-write)
+  if (h_source.shape == h_target.shape && h_source.tiling == h_target.tiling &&
+      h_source.overlap == h_target.overlap &&
+      t_source.get_origin() == t_target.get_origin() &&
+      t_source.get_size() == t_target.get_size() &&
+      t_source.get_rotation_angle() == t_target.get_rotation_angle())
+  {
+    h_target = h_source;
+    return;
+  }
+
   for (size_t k = 0; k < h_target.tiles.size(); k++)
   {
     Vec4<float> bbox = h_target.tiles[k].bbox;
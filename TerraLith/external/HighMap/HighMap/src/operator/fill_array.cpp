@@ -1,99 +1,131 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <algorithm>
+
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
+#include "highmap/functions.hpp"
 #include "highmap/geometry/grids.hpp"
+#include "highmap/operator.hpp"
+#include "highmap/thread_pool.hpp"
 
 namespace hmap
 {
 
-void fill_array_using_xy_function(
-    Array                                    &array,
-    Vec4<float>                               bbox,
-    const Array                              *p_ctrl_param,
-    const Array                              *p_noise_x,
-    const Array                              *p_noise_y,
-    const Array                              *p_stretching,
-    std::function<float(float, float, float)> fct_xy)
+// rows per band of output array processed by a single task
+#define FILL_ARRAY_BAND_HEIGHT 32
+
+// the function is evaluated by rows, the coordinates of each row being
+// gathered in contiguous buffers for the batched evaluation
+static void helper_fill_array_by_rows(Array          &array,
+                                      Vec4<float>     bbox,
+                                      const Array    *p_ctrl_param,
+                                      const Array    *p_noise_x,
+                                      const Array    *p_noise_y,
+                                      const Array    *p_stretching,
+                                      const Function &fct,
+                                      bool            parallel)
 {
   Vec2<int>          shape = array.shape;
   std::vector<float> x, y;
   grid_xy_vector(x, y, shape, bbox, false);
 
-  Array ctrl_array = p_ctrl_param == nullptr ? Array(shape, 1.f)
-                                             : *p_ctrl_param;
+  // default control parameter
+  std::vector<float> ctrl_default(shape.x, 1.f);
 
-  if (p_stretching) // with stretching
-  {
-    if ((!p_noise_x) and (!p_noise_y))
-    {
-      for (int j = 0; j < shape.y; j++)
-        for (int i = 0; i < shape.x; i++)
-          array(i, j) = fct_xy(x[i] * (*p_stretching)(i, j),
-                               y[j] * (*p_stretching)(i, j),
-                               ctrl_array(i, j));
-    }
-    else if (p_noise_x and (!p_noise_y))
-    {
-      for (int j = 0; j < shape.y; j++)
-        for (int i = 0; i < shape.x; i++)
-          array(i,
-                j) = fct_xy(x[i] * (*p_stretching)(i, j) + (*p_noise_x)(i, j),
-                            y[j] * (*p_stretching)(i, j),
-                            ctrl_array(i, j));
-    }
-    else if ((!p_noise_x) and p_noise_y)
-    {
-      for (int j = 0; j < shape.y; j++)
-        for (int i = 0; i < shape.x; i++)
-          array(i,
-                j) = fct_xy(x[i] * (*p_stretching)(i, j),
-                            y[j] * (*p_stretching)(i, j) + (*p_noise_y)(i, j),
-                            ctrl_array(i, j));
-    }
-    else if (p_noise_x and p_noise_y)
-    {
-      for (int j = 0; j < shape.y; j++)
-        for (int i = 0; i < shape.x; i++)
-          array(i,
-                j) = fct_xy(x[i] * (*p_stretching)(i, j) + (*p_noise_x)(i, j),
-                            y[j] * (*p_stretching)(i, j) + (*p_noise_y)(i, j),
-                            ctrl_array(i, j));
-    }
-  }
-  else // without stretching
+  const int nbands = (shape.y + FILL_ARRAY_BAND_HEIGHT - 1) /
+                     FILL_ARRAY_BAND_HEIGHT;
+
+  auto fill_band = [&](size_t b)
   {
-    if ((!p_noise_x) and (!p_noise_y))
-    {
-      for (int j = 0; j < shape.y; j++)
-        for (int i = 0; i < shape.x; i++)
-          array(i, j) = fct_xy(x[i], y[j], ctrl_array(i, j));
-    }
-    else if (p_noise_x and (!p_noise_y))
+    int j1 = (int)b * FILL_ARRAY_BAND_HEIGHT;
+    int j2 = std::min(j1 + FILL_ARRAY_BAND_HEIGHT, shape.y);
+
+    std::vector<float> xr(shape.x), yr(shape.x);
+
+    for (int j = j1; j < j2; j++)
     {
-      for (int j = 0; j < shape.y; j++)
+      const size_t r = (size_t)j * shape.x;
+
+      std::copy(x.begin(), x.end(), xr.begin());
+      std::fill(yr.begin(), yr.end(), y[j]);
+
+      if (p_stretching)
+      {
+        const float *s = &p_stretching->vector[r];
         for (int i = 0; i < shape.x; i++)
-          array(i,
-                j) = fct_xy(x[i] + (*p_noise_x)(i, j), y[j], ctrl_array(i, j));
-    }
-    else if ((!p_noise_x) and p_noise_y)
-    {
-      for (int j = 0; j < shape.y; j++)
+        {
+          xr[i] *= s[i];
+          yr[i] *= s[i];
+        }
+      }
+
+      if (p_noise_x)
+      {
+        const float *dx = &p_noise_x->vector[r];
         for (int i = 0; i < shape.x; i++)
-          array(i,
-                j) = fct_xy(x[i], y[j] + (*p_noise_y)(i, j), ctrl_array(i, j));
-    }
-    else if (p_noise_x and p_noise_y)
-    {
-      for (int j = 0; j < shape.y; j++)
+          xr[i] += dx[i];
+      }
+
+      if (p_noise_y)
+      {
+        const float *dy = &p_noise_y->vector[r];
         for (int i = 0; i < shape.x; i++)
-          array(i, j) = fct_xy(x[i] + (*p_noise_x)(i, j),
-                               y[j] + (*p_noise_y)(i, j),
-                               ctrl_array(i, j));
+          yr[i] += dy[i];
+      }
+
+      const float *ctrl = p_ctrl_param ? &p_ctrl_param->vector[r]
+                                       : ctrl_default.data();
+
+      fct.get_values(xr.data(), yr.data(), ctrl, &array.vector[r], shape.x);
     }
-  }
+  };
+
+  if (parallel)
+    parallel_for(nbands, fill_band);
+  else
+    for (int b = 0; b < nbands; b++)
+      fill_band(b);
+}
+
+void fill_array_using_xy_function(Array          &array,
+                                  Vec4<float>     bbox,
+                                  const Array    *p_ctrl_param,
+                                  const Array    *p_noise_x,
+                                  const Array    *p_noise_y,
+                                  const Array    *p_stretching,
+                                  const Function &fct)
+{
+  helper_fill_array_by_rows(array,
+                            bbox,
+                            p_ctrl_param,
+                            p_noise_x,
+                            p_noise_y,
+                            p_stretching,
+                            fct,
+                            true);
+}
+
+void fill_array_using_xy_function(
+    Array                                    &array,
+    Vec4<float>                               bbox,
+    const Array                              *p_ctrl_param,
+    const Array                              *p_noise_x,
+    const Array                              *p_noise_y,
+    const Array                              *p_stretching,
+    std::function<float(float, float, float)> fct_xy)
+{
+  // arbitrary delegates are not assumed to be thread-safe
+  helper_fill_array_by_rows(array,
+                            bbox,
+                            p_ctrl_param,
+                            p_noise_x,
+                            p_noise_y,
+                            p_stretching,
+                            Function(std::move(fct_xy)),
+                            false);
 }
 
 void fill_array_using_xy_function(
@@ -1,14 +1,67 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <array>
 #include <cmath>
 
 #include "highmap/functions.hpp"
 #include "highmap/math.hpp"
 
+// number of points evaluated together by the fractal layering functions
+// (size of the work buffers, on the stack)
+#define FRACTAL_CHUNK_SIZE 64
+
 namespace hmap
 {
 
+typedef std::array<float, FRACTAL_CHUNK_SIZE> ChunkBuffer;
+
+// octave weight, with a control parameter equal to 0 if not provided
+static inline float helper_local_weight(const float *ctrl_param,
+                                        size_t       k,
+                                        float        weight)
+{
+  float c = ctrl_param ? ctrl_param[k] : 0.f;
+  return (1.f - c) + weight * c;
+}
+
+// base noise value and gradient (finite differences) at (xw, yw)
+static void helper_value_gradient(const NoiseFunction &base,
+                                  const float         *xw,
+                                  const float         *yw,
+                                  float               *value,
+                                  float               *dvdx,
+                                  float               *dvdy,
+                                  size_t               n,
+                                  uint                 seed)
+{
+  ChunkBuffer xs, ys, vp, vm;
+
+  base.get_values_seeded(xw, yw, nullptr, value, n, seed);
+
+  for (size_t r = 0; r < n; r++)
+    xs[r] = xw[r] + HMAP_GRADIENT_OFFSET;
+  base.get_values_seeded(xs.data(), yw, nullptr, vp.data(), n, seed);
+
+  for (size_t r = 0; r < n; r++)
+    xs[r] = xw[r] - HMAP_GRADIENT_OFFSET;
+  base.get_values_seeded(xs.data(), yw, nullptr, vm.data(), n, seed);
+
+  for (size_t r = 0; r < n; r++)
+    dvdx[r] = (vp[r] - vm[r]) / HMAP_GRADIENT_OFFSET;
+
+  for (size_t r = 0; r < n; r++)
+    ys[r] = yw[r] + HMAP_GRADIENT_OFFSET;
+  base.get_values_seeded(xw, ys.data(), nullptr, vp.data(), n, seed);
+
+  for (size_t r = 0; r < n; r++)
+    ys[r] = yw[r] - HMAP_GRADIENT_OFFSET;
+  base.get_values_seeded(xw, ys.data(), nullptr, vm.data(), n, seed);
+
+  for (size_t r = 0; r < n; r++)
+    dvdy[r] = (vp[r] - vm[r]) / HMAP_GRADIENT_OFFSET;
+}
+
 FbmFunction::FbmFunction(std::unique_ptr<NoiseFunction> p_base,
                          int                            octaves,
                          float                          weight,
@@ -20,31 +73,61 @@ FbmFunction::FbmFunction(std::unique_ptr<NoiseFunction> p_base,
                              persistence,
                              lacunarity)
 {
-  this->set_delegate(
-      [this](float x, float y, float ctrl_param)
+}
+
+void FbmFunction::get_values_seeded(const float *x,
+                                    const float *y,
+                                    const float *ctrl_param,
+                                    float       *out,
+                                    size_t       n,
+                                    uint         seed) const
+{
+  ChunkBuffer xk, yk, value, amp, local_weight;
+
+  for (size_t k0 = 0; k0 < n; k0 += FRACTAL_CHUNK_SIZE)
+  {
+    const size_t nc = std::min(n - k0, (size_t)FRACTAL_CHUNK_SIZE);
+    float       *sum = out + k0;
+
+    for (size_t r = 0; r < nc; r++)
+    {
+      sum[r] = 0.f;
+      amp[r] = this->amp0;
+      local_weight[r] = helper_local_weight(ctrl_param, k0 + r, this->weight);
+    }
+
+    float ki = 1.f;
+    float kj = 1.f;
+    uint  kseed = seed;
+
+    for (int k = 0; k < this->octaves; k++)
+    {
+      for (size_t r = 0; r < nc; r++)
       {
-        float sum = 0.f;
-        float amp = this->amp0;
-        float ki = 1.f;
-        float kj = 1.f;
-        int   kseed = this->seed;
-        float local_weight = (1.f - ctrl_param) + this->weight * ctrl_param;
-
-        for (int k = 0; k < this->octaves; k++)
-        {
-          this->p_base->set_seed(kseed);
-          float value = this->p_base->get_value(ki * x, kj * y, 0.f);
-          sum += value * amp;
-          amp *= (1.f - local_weight) +
-                 local_weight * std::min(value + 1.f, 2.f) * 0.5f;
-
-          ki *= this->lacunarity;
-          kj *= this->lacunarity;
-          amp *= this->persistence;
-          kseed++;
-        }
-        return sum;
-      });
+        xk[r] = ki * x[k0 + r];
+        yk[r] = kj * y[k0 + r];
+      }
+
+      this->p_base->get_values_seeded(xk.data(),
+                                      yk.data(),
+                                      nullptr,
+                                      value.data(),
+                                      nc,
+                                      kseed);
+
+      for (size_t r = 0; r < nc; r++)
+      {
+        sum[r] += value[r] * amp[r];
+        amp[r] *= (1.f - local_weight[r]) +
+                  local_weight[r] * std::min(value[r] + 1.f, 2.f) * 0.5f;
+        amp[r] *= this->persistence;
+      }
+
+      ki *= this->lacunarity;
+      kj *= this->lacunarity;
+      kseed++;
+    }
+  }
 }
 
 FbmIqFunction::FbmIqFunction(std::unique_ptr<NoiseFunction> p_base,
@@ -60,53 +143,72 @@ FbmIqFunction::FbmIqFunction(std::unique_ptr<NoiseFunction> p_base,
                              lacunarity),
       gradient_scale(gradient_scale)
 {
-  this->set_delegate(
-      [this](float x, float y, float ctrl_param)
+}
+
+void FbmIqFunction::get_values_seeded(const float *x,
+                                      const float *y,
+                                      const float *ctrl_param,
+                                      float       *out,
+                                      size_t       n,
+                                      uint         seed) const
+{
+  ChunkBuffer xw, yw, value, dvdx, dvdy, dx_sum, dy_sum, amp, local_weight;
+
+  for (size_t k0 = 0; k0 < n; k0 += FRACTAL_CHUNK_SIZE)
+  {
+    const size_t nc = std::min(n - k0, (size_t)FRACTAL_CHUNK_SIZE);
+    float       *sum = out + k0;
+
+    for (size_t r = 0; r < nc; r++)
+    {
+      sum[r] = 0.f;
+      dx_sum[r] = 0.f;
+      dy_sum[r] = 0.f;
+      amp[r] = this->amp0;
+      local_weight[r] = helper_local_weight(ctrl_param, k0 + r, this->weight);
+    }
+
+    float ki = 1.f;
+    float kj = 1.f;
+    uint  kseed = seed;
+
+    for (int k = 0; k < this->octaves; k++)
+    {
+      for (size_t r = 0; r < nc; r++)
       {
-        float sum = 0.f;
-        float dx_sum = 0.f;
-        float dy_sum = 0.f;
-        float amp = this->amp0;
-        float ki = 1.f;
-        float kj = 1.f;
-        int   kseed = this->seed;
-        float local_weight = (1.f - ctrl_param) + this->weight * ctrl_param;
-
-        for (int k = 0; k < this->octaves; k++)
-        {
-          this->p_base->set_seed(kseed);
-
-          float xw = ki * x;
-          float yw = kj * y;
-
-          float value = this->p_base->get_value(xw, yw, 0.f);
-          float dvdx =
-              (this->p_base->get_value(xw + HMAP_GRADIENT_OFFSET, yw, 0.f) -
-               this->p_base->get_value(xw - HMAP_GRADIENT_OFFSET, yw, 0.f)) /
-              HMAP_GRADIENT_OFFSET;
-          float dvdy =
-              (this->p_base->get_value(xw, yw + HMAP_GRADIENT_OFFSET, 0.f) -
-               this->p_base->get_value(xw, yw - HMAP_GRADIENT_OFFSET, 0.f)) /
-              HMAP_GRADIENT_OFFSET;
-
-          value = smoothstep3(0.5f + value);
-
-          dx_sum += dvdx;
-          dy_sum += dvdy;
-
-          sum += value * amp /
-                 (1.f +
-                  this->gradient_scale * (dx_sum * dx_sum + dy_sum * dy_sum));
-          amp *= (1.f - local_weight) +
-                 local_weight * std::min(value + 1.f, 2.f) * 0.5f;
-
-          ki *= this->lacunarity;
-          kj *= this->lacunarity;
-          amp *= this->persistence;
-          kseed++;
-        }
-        return sum;
-      });
+        xw[r] = ki * x[k0 + r];
+        yw[r] = kj * y[k0 + r];
+      }
+
+      helper_value_gradient(*this->p_base,
+                            xw.data(),
+                            yw.data(),
+                            value.data(),
+                            dvdx.data(),
+                            dvdy.data(),
+                            nc,
+                            kseed);
+
+      for (size_t r = 0; r < nc; r++)
+      {
+        float v = smoothstep3(0.5f + value[r]);
+
+        dx_sum[r] += dvdx[r];
+        dy_sum[r] += dvdy[r];
+
+        sum[r] += v * amp[r] /
+                  (1.f + this->gradient_scale * (dx_sum[r] * dx_sum[r] +
+                                                 dy_sum[r] * dy_sum[r]));
+        amp[r] *= (1.f - local_weight[r]) +
+                  local_weight[r] * std::min(v + 1.f, 2.f) * 0.5f;
+        amp[r] *= this->persistence;
+      }
+
+      ki *= this->lacunarity;
+      kj *= this->lacunarity;
+      kseed++;
+    }
+  }
 }
 
 FbmJordanFunction::FbmJordanFunction(std::unique_ptr<NoiseFunction> p_base,
@@ -128,84 +230,105 @@ FbmJordanFunction::FbmJordanFunction(std::unique_ptr<NoiseFunction> p_base,
       warp_scale(warp_scale),
       damp_scale(damp_scale)
 {
-  this->set_delegate(
-      [this](float x, float y, float ctrl_param)
+}
+
+void FbmJordanFunction::get_values_seeded(const float *x,
+                                          const float *y,
+                                          const float *ctrl_param,
+                                          float       *out,
+                                          size_t       n,
+                                          uint         seed) const
+{
+  // based on https://www.decarpentier.nl/scape-procedural-extensions
+  ChunkBuffer xw, yw, value, dvdx, dvdy, amp, amp_damp, local_weight;
+  ChunkBuffer dx_sum_warp, dy_sum_warp, dx_sum_damp, dy_sum_damp;
+
+  for (size_t k0 = 0; k0 < n; k0 += FRACTAL_CHUNK_SIZE)
+  {
+    const size_t nc = std::min(n - k0, (size_t)FRACTAL_CHUNK_SIZE);
+    float       *sum = out + k0;
+
+    float ki = 1.f;
+    float kj = 1.f;
+    uint  kseed = seed;
+
+    // --- 1st octave
+
+    helper_value_gradient(*this->p_base,
+                          x + k0,
+                          y + k0,
+                          value.data(),
+                          dvdx.data(),
+                          dvdy.data(),
+                          nc,
+                          kseed);
+
+    for (size_t r = 0; r < nc; r++)
+    {
+      float v = value[r];
+
+      local_weight[r] = helper_local_weight(ctrl_param, k0 + r, this->weight);
+
+      sum[r] = v * v;
+      dx_sum_warp[r] = this->warp0 * v * dvdx[r];
+      dy_sum_warp[r] = this->warp0 * v * dvdy[r];
+      dx_sum_damp[r] = this->damp0 * v * dvdx[r];
+      dy_sum_damp[r] = this->damp0 * v * dvdy[r];
+
+      amp[r] = this->amp0;
+      amp[r] *= (1.f - local_weight[r]) +
+                local_weight[r] * std::min(v * v + 1.f, 2.f) * 0.5f;
+      amp[r] *= this->persistence;
+      amp_damp[r] = this->amp0 * this->persistence;
+    }
+
+    ki *= this->lacunarity;
+    kj *= this->lacunarity;
+    kseed++;
+
+    // --- other octaves
+
+    for (int k = 0; k < this->octaves; k++)
+    {
+      for (size_t r = 0; r < nc; r++)
       {
-        // based on https://www.decarpentier.nl/scape-procedural-extensions
-        float sum = 0.f;
-        float amp = this->amp0;
-        float amp_damp = this->amp0;
-        float ki = 1.f;
-        float kj = 1.f;
-        int   kseed = this->seed;
-        float local_weight = (1.f - ctrl_param) + this->weight * ctrl_param;
-
-        // --- 1st octave
-
-        this->p_base->set_seed(kseed);
-        float value = this->p_base->get_value(x, y, 0.f);
-        float dvdx =
-            (this->p_base->get_value(x + HMAP_GRADIENT_OFFSET, y, 0.f) -
-             this->p_base->get_value(x - HMAP_GRADIENT_OFFSET, y, 0.f)) /
-            HMAP_GRADIENT_OFFSET;
-        float dvdy =
-            (this->p_base->get_value(x, y + HMAP_GRADIENT_OFFSET, 0.f) -
-             this->p_base->get_value(x, y - HMAP_GRADIENT_OFFSET, 0.f)) /
-            HMAP_GRADIENT_OFFSET;
-
-        sum += value * value;
-        float dx_sum_warp = this->warp0 * value * dvdx;
-        float dy_sum_warp = this->warp0 * value * dvdy;
-        float dx_sum_damp = this->damp0 * value * dvdx;
-        float dy_sum_damp = this->damp0 * value * dvdy;
-
-        amp *= (1.f - local_weight) +
-               local_weight * std::min(value * value + 1.f, 2.f) * 0.5f;
-
-        ki *= this->lacunarity;
-        kj *= this->lacunarity;
-        amp *= this->persistence;
-        amp_damp *= this->persistence;
-        kseed++;
-
-        // --- other octaves
-
-        for (int k = 0; k < this->octaves; k++)
-        {
-          this->p_base->set_seed(kseed);
-
-          float xw = ki * x + this->warp_scale * dx_sum_warp;
-          float yw = kj * y + this->warp_scale * dy_sum_warp;
-
-          float value = this->p_base->get_value(xw, yw, 0.f);
-          float dvdx =
-              (this->p_base->get_value(xw + HMAP_GRADIENT_OFFSET, yw, 0.f) -
-               this->p_base->get_value(xw - HMAP_GRADIENT_OFFSET, yw, 0.f)) /
-              HMAP_GRADIENT_OFFSET;
-          float dvdy =
-              (this->p_base->get_value(xw, yw + HMAP_GRADIENT_OFFSET, 0.f) -
-               this->p_base->get_value(xw, yw - HMAP_GRADIENT_OFFSET, 0.f)) /
-              HMAP_GRADIENT_OFFSET;
-
-          sum += amp_damp * value * value;
-          dx_sum_warp += this->warp0 * value * dvdx;
-          dy_sum_warp += this->warp0 * value * dvdy;
-          dx_sum_damp += this->damp0 * value * dvdx;
-          dy_sum_damp += this->damp0 * value * dvdy;
-
-          amp *= (1.f - local_weight) +
-                 local_weight * std::min(value * value + 1.f, 2.f) * 0.5f;
-
-          ki *= this->lacunarity;
-          kj *= this->lacunarity;
-          amp *= this->persistence;
-          amp_damp = amp * (1.f - this->damp_scale /
-                                      (1.f + dx_sum_damp * dx_sum_damp +
-                                       dy_sum_damp * dy_sum_damp));
-          kseed++;
-        }
-        return sum;
-      });
+        xw[r] = ki * x[k0 + r] + this->warp_scale * dx_sum_warp[r];
+        yw[r] = kj * y[k0 + r] + this->warp_scale * dy_sum_warp[r];
+      }
+
+      helper_value_gradient(*this->p_base,
+                            xw.data(),
+                            yw.data(),
+                            value.data(),
+                            dvdx.data(),
+                            dvdy.data(),
+                            nc,
+                            kseed);
+
+      for (size_t r = 0; r < nc; r++)
+      {
+        float v = value[r];
+
+        sum[r] += amp_damp[r] * v * v;
+        dx_sum_warp[r] += this->warp0 * v * dvdx[r];
+        dy_sum_warp[r] += this->warp0 * v * dvdy[r];
+        dx_sum_damp[r] += this->damp0 * v * dvdx[r];
+        dy_sum_damp[r] += this->damp0 * v * dvdy[r];
+
+        amp[r] *= (1.f - local_weight[r]) +
+                  local_weight[r] * std::min(v * v + 1.f, 2.f) * 0.5f;
+        amp[r] *= this->persistence;
+        amp_damp[r] = amp[r] * (1.f - this->damp_scale /
+                                          (1.f +
+                                           dx_sum_damp[r] * dx_sum_damp[r] +
+                                           dy_sum_damp[r] * dy_sum_damp[r]));
+      }
+
+      ki *= this->lacunarity;
+      kj *= this->lacunarity;
+      kseed++;
+    }
+  }
 }
 
 FbmPingpongFunction::FbmPingpongFunction(std::unique_ptr<NoiseFunction> p_base,
@@ -219,35 +342,65 @@ FbmPingpongFunction::FbmPingpongFunction(std::unique_ptr<NoiseFunction> p_base,
                              persistence,
                              lacunarity)
 {
-  this->set_delegate(
-      [this](float x, float y, float ctrl_param)
+}
+
+void FbmPingpongFunction::get_values_seeded(const float *x,
+                                            const float *y,
+                                            const float *ctrl_param,
+                                            float       *out,
+                                            size_t       n,
+                                            uint         seed) const
+{
+  ChunkBuffer xk, yk, value, amp, local_weight;
+
+  for (size_t k0 = 0; k0 < n; k0 += FRACTAL_CHUNK_SIZE)
+  {
+    const size_t nc = std::min(n - k0, (size_t)FRACTAL_CHUNK_SIZE);
+    float       *sum = out + k0;
+
+    for (size_t r = 0; r < nc; r++)
+    {
+      sum[r] = 0.f;
+      amp[r] = this->amp0;
+      local_weight[r] = helper_local_weight(ctrl_param, k0 + r, this->weight);
+    }
+
+    float ki = 1.f;
+    float kj = 1.f;
+    uint  kseed = seed;
+
+    for (int k = 0; k < this->octaves; k++)
+    {
+      for (size_t r = 0; r < nc; r++)
       {
-        float sum = 0.f;
-        float amp = this->amp0;
-        float ki = 1.f;
-        float kj = 1.f;
-        int   kseed = this->seed;
-        float local_weight = (1.f - ctrl_param) + this->weight * ctrl_param;
-
-        for (int k = 0; k < this->octaves; k++)
-        {
-          this->p_base->set_seed(kseed);
-          float value = (this->p_base->get_value(ki * x, kj * y, 0.f) + 1.f) *
-                        2.f;
-          value -= (int)(value * 0.5f) * 2;
-          value = value < 1 ? value : 2 - value;
-          value = smoothstep5(value);
-
-          sum += (value - 0.5f) * 2.f * amp;
-          amp *= (1.f - local_weight) + local_weight * value;
-
-          ki *= this->lacunarity;
-          kj *= this->lacunarity;
-          amp *= this->persistence;
-          kseed++;
-        }
-        return sum;
-      });
+        xk[r] = ki * x[k0 + r];
+        yk[r] = kj * y[k0 + r];
+      }
+
+      this->p_base->get_values_seeded(xk.data(),
+                                      yk.data(),
+                                      nullptr,
+                                      value.data(),
+                                      nc,
+                                      kseed);
+
+      for (size_t r = 0; r < nc; r++)
+      {
+        float v = (value[r] + 1.f) * 2.f;
+        v -= (int)(v * 0.5f) * 2;
+        v = v < 1 ? v : 2 - v;
+        v = smoothstep5(v);
+
+        sum[r] += (v - 0.5f) * 2.f * amp[r];
+        amp[r] *= (1.f - local_weight[r]) + local_weight[r] * v;
+        amp[r] *= this->persistence;
+      }
+
+      ki *= this->lacunarity;
+      kj *= this->lacunarity;
+      kseed++;
+    }
+  }
 }
 
 FbmRidgedFunction::FbmRidgedFunction(std::unique_ptr<NoiseFunction> p_base,
@@ -263,47 +416,67 @@ FbmRidgedFunction::FbmRidgedFunction(std::unique_ptr<NoiseFunction> p_base,
                              lacunarity),
       k_smoothing(k_smoothing)
 {
-  this->set_delegate(
-      [this](float x, float y, float ctrl_param)
+}
+
+void FbmRidgedFunction::get_values_seeded(const float *x,
+                                          const float *y,
+                                          const float *ctrl_param,
+                                          float       *out,
+                                          size_t       n,
+                                          uint         seed) const
+{
+  ChunkBuffer xk, yk, value, amp, local_weight;
+
+  for (size_t k0 = 0; k0 < n; k0 += FRACTAL_CHUNK_SIZE)
+  {
+    const size_t nc = std::min(n - k0, (size_t)FRACTAL_CHUNK_SIZE);
+    float       *sum = out + k0;
+
+    for (size_t r = 0; r < nc; r++)
+    {
+      sum[r] = 0.f;
+      amp[r] = this->amp0;
+      local_weight[r] = helper_local_weight(ctrl_param, k0 + r, this->weight);
+    }
+
+    float ki = 1.f;
+    float kj = 1.f;
+    uint  kseed = seed;
+
+    for (int k = 0; k < this->octaves; k++)
+    {
+      for (size_t r = 0; r < nc; r++)
       {
-        float sum = 0.f;
-        float amp = this->amp0;
-        float ki = 1.f;
-        float kj = 1.f;
-        int   kseed = this->seed;
-        float local_weight = (1.f - ctrl_param) + this->weight * ctrl_param;
-
-        if (this->k_smoothing == 0.f)
-          for (int k = 0; k < this->octaves; k++)
-          {
-            this->p_base->set_seed(kseed);
-            float value = std::abs(
-                this->p_base->get_value(ki * x, kj * y, 0.f));
-            sum += (1.f - 2.f * value) * amp;
-            amp *= 1.f - local_weight * value;
-
-            ki *= this->lacunarity;
-            kj *= this->lacunarity;
-            amp *= this->persistence;
-            kseed++;
-          }
-        else
-          for (int k = 0; k < this->octaves; k++)
-          {
-            this->p_base->set_seed(kseed);
-            float value = this->p_base->get_value(ki * x, kj * y, 0.f);
-            value = abs_smooth(value, this->k_smoothing);
-            sum += (1.f - 2.f * value) * amp;
-            amp *= 1.f - local_weight * value;
-
-            ki *= this->lacunarity;
-            kj *= this->lacunarity;
-            amp *= this->persistence;
-            kseed++;
-          }
-
-        return sum;
-      });
+        xk[r] = ki * x[k0 + r];
+        yk[r] = kj * y[k0 + r];
+      }
+
+      this->p_base->get_values_seeded(xk.data(),
+                                      yk.data(),
+                                      nullptr,
+                                      value.data(),
+                                      nc,
+                                      kseed);
+
+      if (this->k_smoothing == 0.f)
+        for (size_t r = 0; r < nc; r++)
+          value[r] = std::abs(value[r]);
+      else
+        for (size_t r = 0; r < nc; r++)
+          value[r] = abs_smooth(value[r], this->k_smoothing);
+
+      for (size_t r = 0; r < nc; r++)
+      {
+        sum[r] += (1.f - 2.f * value[r]) * amp[r];
+        amp[r] *= 1.f - local_weight[r] * value[r];
+        amp[r] *= this->persistence;
+      }
+
+      ki *= this->lacunarity;
+      kj *= this->lacunarity;
+      kseed++;
+    }
+  }
 }
 
 FbmSwissFunction::FbmSwissFunction(std::unique_ptr<NoiseFunction> p_base,
@@ -319,52 +492,69 @@ FbmSwissFunction::FbmSwissFunction(std::unique_ptr<NoiseFunction> p_base,
                              lacunarity)
 {
   this->set_warp_scale(warp_scale);
+}
 
-  this->set_delegate(
-      [this](float x, float y, float ctrl_param)
+void FbmSwissFunction::get_values_seeded(const float *x,
+                                         const float *y,
+                                         const float *ctrl_param,
+                                         float       *out,
+                                         size_t       n,
+                                         uint         seed) const
+{
+  // based on https://www.decarpentier.nl/scape-procedural-extensions
+  ChunkBuffer xw, yw, value, dvdx, dvdy, dx_sum, dy_sum, amp, local_weight;
+
+  for (size_t k0 = 0; k0 < n; k0 += FRACTAL_CHUNK_SIZE)
+  {
+    const size_t nc = std::min(n - k0, (size_t)FRACTAL_CHUNK_SIZE);
+    float       *sum = out + k0;
+
+    for (size_t r = 0; r < nc; r++)
+    {
+      sum[r] = 0.f;
+      dx_sum[r] = 0.f;
+      dy_sum[r] = 0.f;
+      amp[r] = this->amp0;
+      local_weight[r] = helper_local_weight(ctrl_param, k0 + r, this->weight);
+    }
+
+    float ki = 1.f;
+    float kj = 1.f;
+    uint  kseed = seed;
+
+    for (int k = 0; k < this->octaves; k++)
+    {
+      for (size_t r = 0; r < nc; r++)
       {
-        // based on https://www.decarpentier.nl/scape-procedural-extensions
-        float sum = 0.f;
-        float amp = this->amp0;
-        float ki = 1.f;
-        float kj = 1.f;
-        int   kseed = this->seed;
-        float local_weight = (1.f - ctrl_param) + this->weight * ctrl_param;
-
-        float dx_sum = 0.f;
-        float dy_sum = 0.f;
-
-        for (int k = 0; k < this->octaves; k++)
-        {
-          this->p_base->set_seed(kseed);
-
-          float xw = ki * x + this->warp_scale_normalized * dx_sum;
-          float yw = kj * y + this->warp_scale_normalized * dy_sum;
-
-          float value = this->p_base->get_value(xw, yw, 0.f);
-          float dvdx =
-              (this->p_base->get_value(xw + HMAP_GRADIENT_OFFSET, yw, 0.f) -
-               this->p_base->get_value(xw - HMAP_GRADIENT_OFFSET, yw, 0.f)) /
-              HMAP_GRADIENT_OFFSET;
-          float dvdy =
-              (this->p_base->get_value(xw, yw + HMAP_GRADIENT_OFFSET, 0.f) -
-               this->p_base->get_value(xw, yw - HMAP_GRADIENT_OFFSET, 0.f)) /
-              HMAP_GRADIENT_OFFSET;
-
-          sum += value * amp;
-          dx_sum += amp * dvdx * -(value + 0.5f);
-          dy_sum += amp * dvdy * -(value + 0.5f);
-
-          amp *= (1.f - local_weight) +
-                 local_weight * std::min(value + 1.f, 2.f) * 0.5f;
-
-          ki *= this->lacunarity;
-          kj *= this->lacunarity;
-          amp *= this->persistence;
-          kseed++;
-        }
-        return sum;
-      });
+        xw[r] = ki * x[k0 + r] + this->warp_scale_normalized * dx_sum[r];
+        yw[r] = kj * y[k0 + r] + this->warp_scale_normalized * dy_sum[r];
+      }
+
+      helper_value_gradient(*this->p_base,
+                            xw.data(),
+                            yw.data(),
+                            value.data(),
+                            dvdx.data(),
+                            dvdy.data(),
+                            nc,
+                            kseed);
+
+      for (size_t r = 0; r < nc; r++)
+      {
+        sum[r] += value[r] * amp[r];
+        dx_sum[r] += amp[r] * dvdx[r] * -(value[r] + 0.5f);
+        dy_sum[r] += amp[r] * dvdy[r] * -(value[r] + 0.5f);
+
+        amp[r] *= (1.f - local_weight[r]) +
+                  local_weight[r] * std::min(value[r] + 1.f, 2.f) * 0.5f;
+        amp[r] *= this->persistence;
+      }
+
+      ki *= this->lacunarity;
+      kj *= this->lacunarity;
+      kseed++;
+    }
+  }
 }
 
 GenericFractalFunction::GenericFractalFunction(
@@ -386,6 +576,16 @@ GenericFractalFunction::GenericFractalFunction(
   this->set_seed(this->p_base->get_seed());
   this->set_kw(this->p_base->get_kw());
   this->update_amp0();
+
+  // the delegate is an adapter to the batched evaluation of the derived
+  // classes (the base noise object is not modified by the evaluation)
+  this->set_delegate(
+      [this](float x, float y, float ctrl_param)
+      {
+        float value;
+        this->get_values_seeded(&x, &y, &ctrl_param, &value, 1, this->seed);
+        return value;
+      });
 }
 
 void GenericFractalFunction::update_amp0()
@@ -45,6 +45,20 @@ float Function::get_value(float x, float y, float ctrl_param) const
   return this->delegate(x, y, ctrl_param);
 }
 
+void Function::get_values(const float *x,
+                          const float *y,
+                          const float *ctrl_param,
+                          float       *out,
+                          size_t       n) const
+{
+  if (ctrl_param)
+    for (size_t k = 0; k < n; k++)
+      out[k] = this->delegate(x[k], y[k], ctrl_param[k]);
+  else
+    for (size_t k = 0; k < n; k++)
+      out[k] = this->delegate(x[k], y[k], 0.f);
+}
+
 void Function::set_delegate(HMAP_FCT_XY_TYPE new_delegate)
 {
   this->delegate = std::move(new_delegate);
@@ -17,6 +17,65 @@
 namespace hmap
 {
 
+// batched evaluation of a delegate
+static void helper_delegate_values(const HMAP_FCT_XY_TYPE &delegate,
+                                   const float            *x,
+                                   const float            *y,
+                                   const float            *ctrl_param,
+                                   float                  *out,
+                                   size_t                  n)
+{
+  if (ctrl_param)
+    for (size_t k = 0; k < n; k++)
+      out[k] = delegate(x[k], y[k], ctrl_param[k]);
+  else
+    for (size_t k = 0; k < n; k++)
+      out[k] = delegate(x[k], y[k], 0.f);
+}
+
+// batched evaluation of a FastNoiseLite generator with a given seed, on
+// a local copy of the generator (the object is not modified and can be
+// shared between threads), 'post' is applied to the raw noise values
+template <typename F>
+static void helper_fnl_values(const FastNoiseLite &noise,
+                              uint                 seed,
+                              Vec2<float>          kw,
+                              const float         *x,
+                              const float         *y,
+                              float               *out,
+                              size_t               n,
+                              F                    post)
+{
+  FastNoiseLite noise_seeded = noise;
+  noise_seeded.SetSeed(seed);
+
+  for (size_t k = 0; k < n; k++)
+    out[k] = post(noise_seeded.GetNoise(kw.x * x[k], kw.y * y[k]));
+}
+
+//----------------------------------------------------------------------
+// NoiseFunction class
+//----------------------------------------------------------------------
+
+void NoiseFunction::get_values(const float *x,
+                               const float *y,
+                               const float *ctrl_param,
+                               float       *out,
+                               size_t       n) const
+{
+  this->get_values_seeded(x, y, ctrl_param, out, n, this->seed);
+}
+
+void NoiseFunction::get_values_seeded(const float *x,
+                                      const float *y,
+                                      const float *ctrl_param,
+                                      float       *out,
+                                      size_t       n,
+                                      uint /* seed */) const
+{
+  helper_delegate_values(this->get_delegate(), x, y, ctrl_param, out, n);
+}
+
 //----------------------------------------------------------------------
 // derived from NoiseFunction class
 //----------------------------------------------------------------------
@@ -33,6 +92,23 @@ PerlinFunction::PerlinFunction(Vec2<float> kw, uint seed)
       { return this->noise.GetNoise(this->kw.x * x, this->kw.y * y); });
 }
 
+void PerlinFunction::get_values_seeded(const float *x,
+                                       const float *y,
+                                       const float *,
+                                       float       *out,
+                                       size_t       n,
+                                       uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return v; });
+}
+
 PerlinBillowFunction::PerlinBillowFunction(Vec2<float> kw, uint seed)
     : NoiseFunction(kw, seed)
 {
@@ -48,6 +124,23 @@ PerlinBillowFunction::PerlinBillowFunction(Vec2<float> kw, uint seed)
       });
 }
 
+void PerlinBillowFunction::get_values_seeded(const float *x,
+                                             const float *y,
+                                             const float *,
+                                             float       *out,
+                                             size_t       n,
+                                             uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return 2.f * std::abs(v) - 1.f; });
+}
+
 PerlinHalfFunction::PerlinHalfFunction(Vec2<float> kw, uint seed, float k)
     : NoiseFunction(kw, seed), k(k)
 {
@@ -63,6 +156,24 @@ PerlinHalfFunction::PerlinHalfFunction(Vec2<float> kw, uint seed, float k)
       });
 }
 
+void PerlinHalfFunction::get_values_seeded(const float *x,
+                                           const float *y,
+                                           const float *,
+                                           float       *out,
+                                           size_t       n,
+                                           uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [this](float v)
+                    { return clamp_min_smooth(v, 0.f, this->k); });
+}
+
 PerlinMixFunction::PerlinMixFunction(Vec2<float> kw, uint seed)
     : NoiseFunction(kw, seed)
 {
@@ -78,6 +189,23 @@ PerlinMixFunction::PerlinMixFunction(Vec2<float> kw, uint seed)
       });
 }
 
+void PerlinMixFunction::get_values_seeded(const float *x,
+                                          const float *y,
+                                          const float *,
+                                          float       *out,
+                                          size_t       n,
+                                          uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return 0.5f * v + std::abs(v) - 0.5f; });
+}
+
 Simplex2Function::Simplex2Function(Vec2<float> kw, uint seed)
     : NoiseFunction(kw, seed)
 {
@@ -90,6 +218,23 @@ Simplex2Function::Simplex2Function(Vec2<float> kw, uint seed)
       { return this->noise.GetNoise(this->kw.x * x, this->kw.y * y); });
 }
 
+void Simplex2Function::get_values_seeded(const float *x,
+                                         const float *y,
+                                         const float *,
+                                         float       *out,
+                                         size_t       n,
+                                         uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return v; });
+}
+
 Simplex2SFunction::Simplex2SFunction(Vec2<float> kw, uint seed)
     : NoiseFunction(kw, seed)
 {
@@ -102,6 +247,23 @@ Simplex2SFunction::Simplex2SFunction(Vec2<float> kw, uint seed)
       { return this->noise.GetNoise(this->kw.x * x, this->kw.y * y); });
 }
 
+void Simplex2SFunction::get_values_seeded(const float *x,
+                                          const float *y,
+                                          const float *,
+                                          float       *out,
+                                          size_t       n,
+                                          uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return v; });
+}
+
 ValueNoiseFunction::ValueNoiseFunction(Vec2<float> kw, uint seed)
     : NoiseFunction(kw, seed)
 {
@@ -114,6 +276,23 @@ ValueNoiseFunction::ValueNoiseFunction(Vec2<float> kw, uint seed)
       { return this->noise.GetNoise(this->kw.x * x, this->kw.y * y); });
 }
 
+void ValueNoiseFunction::get_values_seeded(const float *x,
+                                           const float *y,
+                                           const float *,
+                                           float       *out,
+                                           size_t       n,
+                                           uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return v; });
+}
+
 ValueCubicNoiseFunction::ValueCubicNoiseFunction(Vec2<float> kw, uint seed)
     : NoiseFunction(kw, seed)
 {
@@ -126,6 +305,23 @@ ValueCubicNoiseFunction::ValueCubicNoiseFunction(Vec2<float> kw, uint seed)
       { return 1.43f * this->noise.GetNoise(this->kw.x * x, this->kw.y * y); });
 }
 
+void ValueCubicNoiseFunction::get_values_seeded(const float *x,
+                                                const float *y,
+                                                const float *,
+                                                float       *out,
+                                                size_t       n,
+                                                uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return 1.43f * v; });
+}
+
 ValueDelaunayNoiseFunction::ValueDelaunayNoiseFunction(Vec2<float> kw,
                                                        uint        seed)
     : NoiseFunction(kw, seed)
@@ -135,17 +331,19 @@ ValueDelaunayNoiseFunction::ValueDelaunayNoiseFunction(Vec2<float> kw,
   this->update_interpolation_function();
 }
 
-void ValueDelaunayNoiseFunction::update_interpolation_function()
+// interpolation function of the Delaunay value noise for a given seed
+static HMAP_FCT_XY_TYPE helper_value_delaunay_delegate(Vec2<float> kw,
+                                                       uint        seed)
 {
   // --- generate 'n' random grid points
-  int n = (int)(this->kw.x * this->kw.y);
+  int n = (int)(kw.x * kw.y);
 
   std::vector<float> x(n);
   std::vector<float> y(n);
   std::vector<float> value(n);
 
   auto xy = random_points(n,
-                          this->seed,
+                          seed,
                           PointSamplingMethod::RND_LHS,
                           {0.f, 1.f, 0.f, 1.f});
   x = xy[0];
@@ -209,7 +407,43 @@ void ValueDelaunayNoiseFunction::update_interpolation_function()
     return 1.f;
   };
 
-  this->set_delegate(itp_fct);
+  return itp_fct;
+}
+
+void ValueDelaunayNoiseFunction::update_interpolation_function()
+{
+  this->set_delegate(helper_value_delaunay_delegate(this->kw, this->seed));
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->seeded_delegates.clear();
+}
+
+void ValueDelaunayNoiseFunction::get_values_seeded(const float *x,
+                                                   const float *y,
+                                                   const float *ctrl_param,
+                                                   float       *out,
+                                                   size_t       n,
+                                                   uint         seed) const
+{
+  if (seed == this->seed)
+  {
+    helper_delegate_values(this->get_delegate(), x, y, ctrl_param, out, n);
+    return;
+  }
+
+  const HMAP_FCT_XY_TYPE *p_delegate;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto it = this->seeded_delegates.find(seed);
+    if (it == this->seeded_delegates.end())
+      it = this->seeded_delegates
+               .emplace(seed, helper_value_delaunay_delegate(this->kw, seed))
+               .first;
+    p_delegate = &it->second;
+  }
+
+  helper_delegate_values(*p_delegate, x, y, ctrl_param, out, n);
 }
 
 ValueLinearNoiseFunction::ValueLinearNoiseFunction(Vec2<float> kw, uint seed)
@@ -220,7 +454,8 @@ ValueLinearNoiseFunction::ValueLinearNoiseFunction(Vec2<float> kw, uint seed)
   this->update_interpolation_function();
 }
 
-void ValueLinearNoiseFunction::update_interpolation_function()
+// interpolation function of the linear value noise for a given seed
+static HMAP_FCT_XY_TYPE helper_value_linear_delegate(Vec2<float> kw, uint seed)
 {
   // generate random values on a regular coarse grid (adjust extent
   // according to the input noise in order to avoid "holes" in the
@@ -230,8 +465,8 @@ void ValueLinearNoiseFunction::update_interpolation_function()
   float lx = bbox.b - bbox.a;
   float ly = bbox.d - bbox.c;
 
-  Vec2<int> shape_base = Vec2<int>((int)(this->kw.x * lx) + 1,
-                                   (int)(this->kw.y * ly) + 1);
+  Vec2<int> shape_base = Vec2<int>((int)(kw.x * lx) + 1,
+                                   (int)(kw.y * ly) + 1);
 
   Array value = 2.f * white(shape_base, 0.f, 1.f, seed) - 1.f;
 
@@ -271,7 +506,43 @@ void ValueLinearNoiseFunction::update_interpolation_function()
     return value.get_value_bilinear_at(in, jn, u, v);
   };
 
-  this->set_delegate(itp_fct);
+  return itp_fct;
+}
+
+void ValueLinearNoiseFunction::update_interpolation_function()
+{
+  this->set_delegate(helper_value_linear_delegate(this->kw, this->seed));
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->seeded_delegates.clear();
+}
+
+void ValueLinearNoiseFunction::get_values_seeded(const float *x,
+                                                 const float *y,
+                                                 const float *ctrl_param,
+                                                 float       *out,
+                                                 size_t       n,
+                                                 uint         seed) const
+{
+  if (seed == this->seed)
+  {
+    helper_delegate_values(this->get_delegate(), x, y, ctrl_param, out, n);
+    return;
+  }
+
+  const HMAP_FCT_XY_TYPE *p_delegate;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto it = this->seeded_delegates.find(seed);
+    if (it == this->seeded_delegates.end())
+      it = this->seeded_delegates
+               .emplace(seed, helper_value_linear_delegate(this->kw, seed))
+               .first;
+    p_delegate = &it->second;
+  }
+
+  helper_delegate_values(*p_delegate, x, y, ctrl_param, out, n);
 }
 
 WorleyFunction::WorleyFunction(Vec2<float> kw,
@@ -299,6 +570,23 @@ WorleyFunction::WorleyFunction(Vec2<float> kw,
       });
 }
 
+void WorleyFunction::get_values_seeded(const float *x,
+                                       const float *y,
+                                       const float *,
+                                       float       *out,
+                                       size_t       n,
+                                       uint         seed) const
+{
+  helper_fnl_values(this->noise,
+                    seed,
+                    this->kw,
+                    x,
+                    y,
+                    out,
+                    n,
+                    [](float v) { return 1.66f * (0.4f + v); });
+}
+
 WorleyDoubleFunction::WorleyDoubleFunction(Vec2<float> kw,
                                            uint        seed,
                                            float       ratio,
@@ -329,6 +617,34 @@ WorleyDoubleFunction::WorleyDoubleFunction(Vec2<float> kw,
       });
 }
 
+void WorleyDoubleFunction::get_values_seeded(const float *x,
+                                             const float *y,
+                                             const float *ctrl_param,
+                                             float       *out,
+                                             size_t       n,
+                                             uint         seed) const
+{
+  FastNoiseLite noise1_seeded = this->noise1;
+  FastNoiseLite noise2_seeded = this->noise2;
+  noise1_seeded.SetSeed(seed);
+  noise2_seeded.SetSeed(seed + 1);
+
+  for (size_t k = 0; k < n; k++)
+  {
+    float local_ratio = (ctrl_param ? ctrl_param[k] : 0.f) * this->ratio;
+
+    float w1 = noise1_seeded.GetNoise(this->kw.x * x[k], this->kw.y * y[k]);
+    float w2 = noise2_seeded.GetNoise(this->kw.x * x[k], this->kw.y * y[k]);
+
+    if (this->k)
+      out[k] = maximum_smooth(local_ratio * w1,
+                              (1.f - local_ratio) * w2,
+                              this->k);
+    else
+      out[k] = std::max(local_ratio * w1, (1.f - local_ratio) * w2);
+  }
+}
+
 // --- helper
 
 std::unique_ptr<NoiseFunction> create_noise_function_from_type(
@@ -52,7 +52,7 @@ Array island_land_mask(Vec2<int>          shape,
       float theta = std::atan2(y, x);
 
       float dr = displacement *
-                 f.get_delegate()(std::cos(theta), std::sin(theta), 0.f);
+                 f.get_value(std::cos(theta), std::sin(theta), 0.f);
 
       mask(i, j) = r < radius + dr ? 1.f : 0.f;
     }
@@ -34,7 +34,7 @@ Array noise(NoiseType    noise_type,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               p.get()->get_delegate());
+                               *p);
   return array;
 }
 
@@ -70,7 +70,7 @@ Array noise_fbm(NoiseType    noise_type,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -108,7 +108,7 @@ Array noise_iq(NoiseType    noise_type,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -152,7 +152,7 @@ Array noise_jordan(NoiseType    noise_type,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -187,7 +187,7 @@ Array noise_parberry(Vec2<int>    shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -223,7 +223,7 @@ Array noise_pingpong(NoiseType    noise_type,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -261,7 +261,7 @@ Array noise_ridged(NoiseType    noise_type,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -299,7 +299,7 @@ Array noise_swiss(NoiseType    noise_type,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -34,7 +34,7 @@ Array biquad_pulse(Vec2<int>    shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -56,7 +56,7 @@ Array bump(Vec2<int>    shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -156,7 +156,7 @@ Array disk(Vec2<int>    shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -178,7 +178,7 @@ Array gaussian_pulse(Vec2<int>    shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -243,7 +243,7 @@ Array rectangle(Vec2<int>    shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -272,7 +272,7 @@ Array rift(Vec2<int>         shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -295,7 +295,7 @@ Array slope(Vec2<int>    shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
@@ -348,7 +348,7 @@ Array step(Vec2<int>         shape,
                                p_noise_x,
                                p_noise_y,
                                p_stretching,
-                               f.get_delegate());
+                               f);
   return array;
 }
 
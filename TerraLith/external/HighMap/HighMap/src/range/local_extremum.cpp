@@ -0,0 +1,236 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/* Local maximum / minimum filters, van Herk / Gil-Werman algorithm:
+ * the running extremum over a window of width w = 2 * ir + 1 is
+ * obtained from the prefix and suffix extrema within blocks of width
+ * w, i.e. with 3 comparisons per cell whatever the window radius. The
+ * borders are padded with the identity of the operator so that the
+ * windows are truncated at the array boundaries. */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "highmap/array.hpp"
+#include "highmap/range.hpp"
+
+namespace hmap
+{
+
+struct OpMax
+{
+  static constexpr float identity = -std::numeric_limits<float>::max();
+  float operator()(float a, float b) const { return std::max(a, b); }
+};
+
+struct OpMin
+{
+  static constexpr float identity = std::numeric_limits<float>::max();
+  float operator()(float a, float b) const { return std::min(a, b); }
+};
+
+// running extremum along the rows (contiguous i-direction)
+template <typename Op>
+static Array helper_local_extremum_i(const Array &array, int ir)
+{
+  Op                 op;
+  const int          nx = array.shape.x;
+  const int          w = 2 * ir + 1;
+  const int          np = nx + 2 * ir; // padded length
+  Array              array_out = Array(array.shape);
+  std::vector<float> g(np), h(np), f(np, Op::identity);
+
+  for (int j = 0; j < array.shape.y; j++)
+  {
+    const float *row = &array.vector[j * nx];
+    float       *row_out = &array_out.vector[j * nx];
+
+    std::copy(row, row + nx, f.begin() + ir);
+
+    // prefix / suffix extrema within the blocks
+    for (int p = 0; p < np; p++)
+      g[p] = (p % w == 0) ? f[p] : op(g[p - 1], f[p]);
+
+    h[np - 1] = f[np - 1];
+    for (int p = np - 2; p >= 0; p--)
+      h[p] = ((p + 1) % w == 0) ? f[p] : op(h[p + 1], f[p]);
+
+    for (int i = 0; i < nx; i++)
+      row_out[i] = op(h[i], g[i + w - 1]);
+  }
+
+  return array_out;
+}
+
+// running extremum along the columns, the recurrences are applied to
+// whole rows at once (contiguous and vectorizable inner loops), by
+// strips of columns to keep the work buffers small
+template <typename Op>
+static Array helper_local_extremum_j(const Array &array, int ir)
+{
+  Op        op;
+  const int nx = array.shape.x;
+  const int ny = array.shape.y;
+  const int w = 2 * ir + 1;
+  const int np = ny + 2 * ir; // padded length
+  const int strip = std::min(nx, 256);
+
+  Array              array_out = Array(array.shape);
+  std::vector<float> g((size_t)np * strip), h((size_t)np * strip);
+
+  for (int i0 = 0; i0 < nx; i0 += strip)
+  {
+    const int ni = std::min(strip, nx - i0);
+
+    // input row p (padded index) of the strip, nullptr in the padding
+    auto f_row = [&](int p) -> const float *
+    {
+      int j = p - ir;
+      return (j < 0 || j >= ny) ? nullptr : &array.vector[j * nx + i0];
+    };
+
+    for (int p = 0; p < np; p++)
+    {
+      const float *f = f_row(p);
+      float       *gp = &g[(size_t)p * strip];
+
+      if (p % w == 0)
+      {
+        if (f)
+          std::copy(f, f + ni, gp);
+        else
+          std::fill(gp, gp + ni, Op::identity);
+      }
+      else
+      {
+        const float *gm = gp - strip;
+        if (f)
+          for (int i = 0; i < ni; i++)
+            gp[i] = op(gm[i], f[i]);
+        else
+          std::copy(gm, gm + ni, gp);
+      }
+    }
+
+    for (int p = np - 1; p >= 0; p--)
+    {
+      const float *f = f_row(p);
+      float       *hp = &h[(size_t)p * strip];
+
+      if (p == np - 1 || (p + 1) % w == 0)
+      {
+        if (f)
+          std::copy(f, f + ni, hp);
+        else
+          std::fill(hp, hp + ni, Op::identity);
+      }
+      else
+      {
+        const float *hm = hp + strip;
+        if (f)
+          for (int i = 0; i < ni; i++)
+            hp[i] = op(hm[i], f[i]);
+        else
+          std::copy(hm, hm + ni, hp);
+      }
+    }
+
+    for (int j = 0; j < ny; j++)
+    {
+      const float *hj = &h[(size_t)j * strip];
+      const float *gj = &g[(size_t)(j + w - 1) * strip];
+      float       *row_out = &array_out.vector[j * nx + i0];
+
+      for (int i = 0; i < ni; i++)
+        row_out[i] = op(hj[i], gj[i]);
+    }
+  }
+
+  return array_out;
+}
+
+template <typename Op>
+static Array helper_local_extremum(const Array &array, int ir)
+{
+  if (ir <= 0) return array;
+
+  // larger windows are equivalent to the whole domain
+  int ir_i = std::min(ir, array.shape.x - 1);
+  int ir_j = std::min(ir, array.shape.y - 1);
+
+  Array array_tmp = ir_i > 0 ? helper_local_extremum_i<Op>(array, ir_i)
+                             : array;
+  return ir_j > 0 ? helper_local_extremum_j<Op>(array_tmp, ir_j) : array_tmp;
+}
+
+// exact disk, decomposed in horizontal segments: the disk extremum at
+// (i, j) is the extremum, over the rows j + q, of the segment extrema
+// of half-width floor(sqrt(ir^2 - q^2)) (one running extremum per
+// distinct half-width)
+template <typename Op>
+static Array helper_local_extremum_disk(const Array &array, int ir)
+{
+  if (ir <= 0) return array;
+
+  Op        op;
+  const int nx = array.shape.x;
+  const int ny = array.shape.y;
+
+  Array array_out = Array(array.shape, Op::identity);
+  Array array_seg;
+  int   a_prev = -1;
+
+  for (int q = 0; q <= std::min(ir, ny - 1); q++)
+  {
+    int a = (int)std::floor(std::sqrt((float)(ir * ir - q * q)));
+    a = std::min(a, nx - 1);
+
+    if (a != a_prev)
+    {
+      array_seg = a > 0 ? helper_local_extremum_i<Op>(array, a) : array;
+      a_prev = a;
+    }
+
+    for (int j = 0; j < ny; j++)
+    {
+      float *row_out = &array_out.vector[j * nx];
+
+      for (int jq : {j - q, j + q})
+      {
+        if (jq < 0 || jq >= ny) continue;
+
+        const float *row_seg = &array_seg.vector[jq * nx];
+        for (int i = 0; i < nx; i++)
+          row_out[i] = op(row_out[i], row_seg[i]);
+
+        if (q == 0) break;
+      }
+    }
+  }
+
+  return array_out;
+}
+
+Array maximum_local(const Array &array, int ir)
+{
+  return helper_local_extremum<OpMax>(array, ir);
+}
+
+Array maximum_local_disk(const Array &array, int ir)
+{
+  return helper_local_extremum_disk<OpMax>(array, ir);
+}
+
+Array minimum_local(const Array &array, int ir)
+{
+  return helper_local_extremum<OpMin>(array, ir);
+}
+
+Array minimum_local_disk(const Array &array, int ir)
+{
+  return helper_local_extremum_disk<OpMin>(array, ir);
+}
+
+} // namespace hmap
@@ -89,9 +89,10 @@ Graph generate_network_alpha_model(const std::vector<float> &xc,
       if (j > (int)i)
       {
         float dz = graph.points[i].v - graph.points[j].v;
-        graph.adjacency_matrix[{i, j}] += std::abs(dz) * dz_weight;
-        graph.adjacency_matrix[{i, j}] += local_weight[i] + local_weight[j];
-        graph.adjacency_matrix[{j, i}] = graph.adjacency_matrix[{i, j}];
+        float w = graph.get_adjacency_weight((int)i, j);
+        w += std::abs(dz) * dz_weight;
+        w += local_weight[i] + local_weight[j];
+        graph.set_adjacency_weight((int)i, j, w);
       }
     }
 
@@ -105,6 +106,7 @@ Graph generate_network_alpha_model(const std::vector<float> &xc,
 
     // shortest path between the two cities (i0 and j0)
     std::vector<int> path = graph.dijkstra(i0, j0);
+    if (path.size() < 2) continue;
 
     // update road/non-road status
     for (size_t i = 0; i < path.size() - 1; i++)
@@ -123,8 +125,8 @@ Graph generate_network_alpha_model(const std::vector<float> &xc,
         int j = graph.connectivity[i][r];
         if ((j > (int)i) and (is_road(i, j) == 1))
         {
-          graph.adjacency_matrix[{i, j}] *= alpha;
-          graph.adjacency_matrix[{j, i}] = graph.adjacency_matrix[{i, j}];
+          float w = graph.get_adjacency_weight((int)i, j);
+          graph.set_adjacency_weight((int)i, j, alpha * w);
         }
       }
   }
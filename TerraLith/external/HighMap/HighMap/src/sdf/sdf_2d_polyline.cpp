@@ -6,6 +6,7 @@
 #include "highmap/array.hpp"
 #include "highmap/geometry/grids.hpp"
 #include "highmap/geometry/path.hpp"
+#include "highmap/internal/segment_grid.hpp"
 #include "highmap/math.hpp"
 
 namespace hmap
@@ -23,43 +24,17 @@ Array sdf_2d_polyline(const Path  &path,
     return Array(shape);
   }
 
-  Array sdf2(shape);
-
-  // normalize path nodes coord to unit square
+  // path segments, spatially indexed
   std::vector<float> xp = path.get_x();
   std::vector<float> yp = path.get_y();
 
-  // array cell coordinates
-  std::vector<float> xg(shape.x);
-  std::vector<float> yg(shape.y);
-  grid_xy_vector(xg, yg, shape, bbox, false);
+  SegmentGrid grid(std::vector<float>(xp.begin(), xp.end() - 1),
+                   std::vector<float>(yp.begin(), yp.end() - 1),
+                   std::vector<float>(xp.begin() + 1, xp.end()),
+                   std::vector<float>(yp.begin() + 1, yp.end()),
+                   bbox);
 
-  // compute sdf
-  for (int j = 0; j < shape.y; ++j)
-    for (int i = 0; i < shape.x; ++i)
-    {
-      float dx = p_noise_x ? (*p_noise_x)(i, j) : 0.f;
-      float dy = p_noise_y ? (*p_noise_y)(i, j) : 0.f;
-
-      float x = xg[i] + dx;
-      float y = yg[j] + dy;
-
-      // distance
-      float d = std::numeric_limits<float>::max();
-
-      for (size_t k = 0; k < path.get_npoints() - 1; k++)
-      {
-        size_t      p = k + 1;
-        Vec2<float> e = {xp[p] - xp[k], yp[p] - yp[k]};
-        Vec2<float> w = {x - xp[k], y - yp[k]};
-        float       t = std::clamp(dot(w, e) / dot(e, e), 0.f, 1.f);
-        Vec2<float> b = {w.x - e.x * t, w.y - e.y * t};
-        d = std::min(d, dot(b, b));
-      }
-      sdf2(i, j) = std::sqrt(d);
-    }
-
-  return sdf2;
+  return grid.get_distance_array(shape, bbox, p_noise_x, p_noise_y);
 }
 
 Array sdf_2d_polyline_bezier(const Path  &path,
@@ -0,0 +1,283 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "highmap/geometry/grids.hpp"
+#include "highmap/internal/segment_grid.hpp"
+#include "highmap/thread_pool.hpp"
+
+// maximum number of cells in each direction
+#define SEGMENT_GRID_NMAX 1024
+
+// rows per band of output array processed by a single task
+#define SEGMENT_GRID_BAND_HEIGHT 32
+
+namespace hmap
+{
+
+SegmentGrid::SegmentGrid(const std::vector<float> &xa,
+                         const std::vector<float> &ya,
+                         const std::vector<float> &xb,
+                         const std::vector<float> &yb,
+                         Vec4<float>               bbox_domain)
+{
+  const size_t n = xa.size();
+
+  // segments and grid extent
+  float xmin = std::min(bbox_domain.a, bbox_domain.b);
+  float xmax = std::max(bbox_domain.a, bbox_domain.b);
+  float ymin = std::min(bbox_domain.c, bbox_domain.d);
+  float ymax = std::max(bbox_domain.c, bbox_domain.d);
+  float length_sum = 0.f;
+
+  this->segments.resize(n);
+
+  for (size_t k = 0; k < n; k++)
+  {
+    Segment &s = this->segments[k];
+
+    s.ax = xa[k];
+    s.ay = ya[k];
+    s.ex = xb[k] - xa[k];
+    s.ey = yb[k] - ya[k];
+    s.by = yb[k];
+
+    float ee = s.ex * s.ex + s.ey * s.ey;
+    s.inv_ee = ee > 0.f ? 1.f / ee : 0.f;
+
+    xmin = std::min({xmin, xa[k], xb[k]});
+    xmax = std::max({xmax, xa[k], xb[k]});
+    ymin = std::min({ymin, ya[k], yb[k]});
+    ymax = std::max({ymax, ya[k], yb[k]});
+    length_sum += std::sqrt(ee);
+  }
+
+  // cell size, about one segment per cell but not smaller than the
+  // mean segment length to limit the number of cells per segment
+  float lx = std::max(xmax - xmin, 1e-6f);
+  float ly = std::max(ymax - ymin, 1e-6f);
+  float hc = std::sqrt(lx * ly / (float)std::max(n, (size_t)1));
+
+  if (n > 0) hc = std::max(hc, length_sum / (float)n);
+
+  this->nc.x = std::clamp((int)std::ceil(lx / hc), 1, SEGMENT_GRID_NMAX);
+  this->nc.y = std::clamp((int)std::ceil(ly / hc), 1, SEGMENT_GRID_NMAX);
+  this->o = {xmin, ymin};
+  this->h = {lx / (float)this->nc.x, ly / (float)this->nc.y};
+  this->ih = {1.f / this->h.x, 1.f / this->h.y};
+
+  auto cell_range = [](float v1, float v2, float v0, float iv, int nv)
+  {
+    int k1 = (int)std::floor((std::min(v1, v2) - v0) * iv);
+    int k2 = (int)std::floor((std::max(v1, v2) - v0) * iv);
+    return Vec2<int>(std::clamp(k1, 0, nv - 1), std::clamp(k2, 0, nv - 1));
+  };
+
+  // compressed storage by cells and by rows (count, then fill)
+  const size_t ncells = (size_t)this->nc.x * this->nc.y;
+
+  this->cell_offsets.assign(ncells + 1, 0);
+  this->row_offsets.assign(this->nc.y + 1, 0);
+
+  for (int pass = 0; pass < 2; pass++)
+  {
+    std::vector<size_t> cell_pos, row_pos;
+
+    if (pass == 1)
+    {
+      for (size_t c = 0; c < ncells; c++)
+        this->cell_offsets[c + 1] += this->cell_offsets[c];
+      for (int r = 0; r < this->nc.y; r++)
+        this->row_offsets[r + 1] += this->row_offsets[r];
+
+      this->cell_segments.resize(this->cell_offsets.back());
+      this->row_segments.resize(this->row_offsets.back());
+
+      cell_pos.assign(this->cell_offsets.begin(), this->cell_offsets.end());
+      row_pos.assign(this->row_offsets.begin(), this->row_offsets.end());
+    }
+
+    for (size_t k = 0; k < n; k++)
+    {
+      Vec2<int> ri = cell_range(xa[k],
+                                xb[k],
+                                this->o.x,
+                                this->ih.x,
+                                this->nc.x);
+      Vec2<int> rj = cell_range(ya[k],
+                                yb[k],
+                                this->o.y,
+                                this->ih.y,
+                                this->nc.y);
+
+      for (int j = rj.x; j <= rj.y; j++)
+      {
+        if (pass == 0)
+          this->row_offsets[j + 1]++;
+        else
+          this->row_segments[row_pos[j]++] = (int)k;
+
+        for (int i = ri.x; i <= ri.y; i++)
+        {
+          size_t c = (size_t)j * this->nc.x + i;
+
+          if (pass == 0)
+            this->cell_offsets[c + 1]++;
+          else
+            this->cell_segments[cell_pos[c]++] = (int)k;
+        }
+      }
+    }
+  }
+}
+
+Array SegmentGrid::get_distance_array(Vec2<int>    shape,
+                                      Vec4<float>  bbox_array,
+                                      const Array *p_noise_x,
+                                      const Array *p_noise_y,
+                                      bool         signed_distance) const
+{
+  Array array_out(shape);
+
+  std::vector<float> xg, yg;
+  grid_xy_vector(xg, yg, shape, bbox_array, false);
+
+  const int nbands = (shape.y + SEGMENT_GRID_BAND_HEIGHT - 1) /
+                     SEGMENT_GRID_BAND_HEIGHT;
+
+  parallel_for(nbands,
+               [&](size_t b)
+               {
+                 int j1 = (int)b * SEGMENT_GRID_BAND_HEIGHT;
+                 int j2 = std::min(j1 + SEGMENT_GRID_BAND_HEIGHT, shape.y);
+
+                 for (int j = j1; j < j2; j++)
+                   for (int i = 0; i < shape.x; i++)
+                   {
+                     float x = xg[i] + (p_noise_x ? (*p_noise_x)(i, j) : 0.f);
+                     float y = yg[j] + (p_noise_y ? (*p_noise_y)(i, j) : 0.f);
+
+                     float d = std::sqrt(this->get_distance2(x, y));
+
+                     if (signed_distance && this->is_inside(x, y)) d = -d;
+                     array_out(i, j) = d;
+                   }
+               });
+
+  return array_out;
+}
+
+float SegmentGrid::get_distance2(float x, float y) const
+{
+  float d2 = std::numeric_limits<float>::max();
+
+  if (this->segments.empty()) return d2;
+
+  // cell of the point (clamped for points outside the grid)
+  int ci = std::clamp((int)std::floor((x - this->o.x) * this->ih.x),
+                      0,
+                      this->nc.x - 1);
+  int cj = std::clamp((int)std::floor((y - this->o.y) * this->ih.y),
+                      0,
+                      this->nc.y - 1);
+
+  auto visit_cell = [&](int i, int j)
+  {
+    size_t c = (size_t)j * this->nc.x + i;
+    for (size_t r = this->cell_offsets[c]; r < this->cell_offsets[c + 1]; r++)
+      d2 = std::min(d2, this->segment_distance2(this->cell_segments[r], x, y));
+  };
+
+  const int rmax = std::max(this->nc.x, this->nc.y);
+
+  for (int r = 0; r <= rmax; r++)
+  {
+    if (r > 0)
+    {
+      // the cells of ring r are outside the block of the cells
+      // [ci - r + 1, ci + r - 1] x [cj - r + 1, cj + r - 1], lower bound
+      // of their distance to the point
+      float gap = std::min(
+          {x - (this->o.x + (float)(ci - r + 1) * this->h.x),
+           (this->o.x + (float)(ci + r) * this->h.x) - x,
+           y - (this->o.y + (float)(cj - r + 1) * this->h.y),
+           (this->o.y + (float)(cj + r) * this->h.y) - y});
+
+      if (gap > 0.f && gap * gap >= d2) break;
+    }
+
+    int i1 = ci - r;
+    int i2 = ci + r;
+    int j1 = cj - r;
+    int j2 = cj + r;
+
+    if (i1 < 0 && j1 < 0 && i2 >= this->nc.x && j2 >= this->nc.y) break;
+
+    // bottom and top rows of the ring
+    for (int j : {j1, j2})
+    {
+      if (j < 0 || j >= this->nc.y) continue;
+      for (int i = std::max(i1, 0); i <= std::min(i2, this->nc.x - 1); i++)
+        visit_cell(i, j);
+      if (r == 0) break;
+    }
+
+    // left and right columns (without the corners)
+    for (int i : {i1, i2})
+    {
+      if (r == 0 || i < 0 || i >= this->nc.x) continue;
+      for (int j = std::max(j1 + 1, 0); j <= std::min(j2 - 1, this->nc.y - 1);
+           j++)
+        visit_cell(i, j);
+    }
+  }
+
+  return d2;
+}
+
+bool SegmentGrid::is_inside(float x, float y) const
+{
+  if (this->segments.empty()) return false;
+
+  // only the segments spanning the ordinate y can be crossed, i.e.
+  // those registered in the grid row of y (segments outside the grid
+  // rows are never spanning y)
+  int cj = (int)std::floor((y - this->o.y) * this->ih.y);
+  if (cj < 0 || cj >= this->nc.y) return false;
+
+  bool inside = false;
+
+  for (size_t r = this->row_offsets[cj]; r < this->row_offsets[cj + 1]; r++)
+  {
+    const Segment &s = this->segments[this->row_segments[r]];
+
+    float wx = x - s.ax;
+    float wy = y - s.ay;
+
+    bool c1 = y >= s.ay;
+    bool c2 = y < s.by;
+    bool c3 = s.ex * wy > s.ey * wx;
+
+    if ((c1 && c2 && c3) || (!c1 && !c2 && !c3)) inside = !inside;
+  }
+
+  return inside;
+}
+
+float SegmentGrid::segment_distance2(int k, float x, float y) const
+{
+  const Segment &s = this->segments[k];
+
+  float wx = x - s.ax;
+  float wy = y - s.ay;
+  float t = std::clamp((wx * s.ex + wy * s.ey) * s.inv_ee, 0.f, 1.f);
+  float bx = wx - s.ex * t;
+  float by = wy - s.ey * t;
+
+  return bx * bx + by * by;
+}
+
+} // namespace hmap
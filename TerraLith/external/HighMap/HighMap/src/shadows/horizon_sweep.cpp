@@ -0,0 +1,167 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/* Horizon sweep along a direction. The "major" axis is the array axis the
+ * most aligned with the direction, the lines advance by one cell along it
+ * and by 's' cells along the "minor" axis for each major cell. The line 'c'
+ * goes through the minor coordinate c + s * a at the major coordinate a,
+ * its heights are linearly interpolated along the minor axis. */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "highmap/array.hpp"
+#include "highmap/internal/horizon_sweep.hpp"
+#include "highmap/thread_pool.hpp"
+
+// number of lines (or output rows) processed by a single task
+#define HORIZON_SWEEP_BLOCK_SIZE 32
+
+// tolerance on the minor coordinate of the samples within the array
+#define HORIZON_SWEEP_TOLERANCE 1e-3f
+
+// line samples outside the array
+#define HORIZON_SWEEP_NOT_SAMPLED -2e30f
+
+namespace hmap
+{
+
+Array horizon_tangent(const Array &z, float theta, float cell_size)
+{
+  const int nx = z.shape.x;
+  const int ny = z.shape.y;
+
+  Array out(z.shape, HMAP_HORIZON_NONE);
+
+  if (nx < 2 || ny < 2) return out;
+
+  const float ux = std::cos(theta);
+  const float uy = std::sin(theta);
+  const bool  x_major = std::abs(ux) >= std::abs(uy);
+
+  const int   nmaj = x_major ? nx : ny;
+  const int   nmin = x_major ? ny : nx;
+  const int   sa = (x_major ? ux : uy) > 0.f ? 1 : -1; // major direction
+  const float s = x_major ? uy / ux : ux / uy; // minor shift per major cell
+  const float step = cell_size * std::sqrt(1.f + s * s);
+
+  // stride of the major and minor axes in the array storage
+  const size_t smaj = x_major ? 1 : nx;
+  const size_t smin = x_major ? nx : 1;
+
+  // lines covering the minor coordinates [-1, nmin] for all the major
+  // coordinates (with a margin)
+  const float smax = s * (float)(nmaj - 1);
+  const int   cmin = (int)std::floor(std::min(0.f, -smax)) - 2;
+  const int   cmax = (int)std::ceil((float)nmin + std::max(0.f, -smax)) + 1;
+  const int   nlines = cmax - cmin + 1;
+
+  // horizon of the line samples, stored such that the cells of an array
+  // row read consecutive values
+  std::vector<float> hz((size_t)nlines * nmaj, HORIZON_SWEEP_NOT_SAMPLED);
+
+  auto hz_index = [&](int l, int a) -> size_t
+  { return x_major ? (size_t)l * nmaj + a : (size_t)a * nlines + l; };
+
+  // --- horizon along the lines
+
+  const int nblocks_lines = (nlines + HORIZON_SWEEP_BLOCK_SIZE - 1) /
+                            HORIZON_SWEEP_BLOCK_SIZE;
+
+  parallel_for(
+      nblocks_lines,
+      [&](size_t ib)
+      {
+        const int l1 = (int)ib * HORIZON_SWEEP_BLOCK_SIZE;
+        const int l2 = std::min(l1 + HORIZON_SWEEP_BLOCK_SIZE, nlines);
+
+        // upper convex hull of the samples ahead for each line of the
+        // block, (position along the line in cells, height)
+        std::vector<float>  ht((size_t)(l2 - l1) * nmaj);
+        std::vector<float>  hh((size_t)(l2 - l1) * nmaj);
+        std::vector<size_t> hn(l2 - l1, 0);
+
+        // the lines of the block are advanced together, from the
+        // farthest sample in the sweep direction backwards, to read
+        // neighboring cells
+        for (int k = 0; k < nmaj; k++)
+        {
+          const int   a = sa > 0 ? nmaj - 1 - k : k;
+          const float t = -(float)k;
+
+          for (int l = l1; l < l2; l++)
+          {
+            const float b = (float)(cmin + l) + s * (float)a;
+
+            if (b < -HORIZON_SWEEP_TOLERANCE ||
+                b > (float)(nmin - 1) + HORIZON_SWEEP_TOLERANCE)
+              continue;
+
+            float bc = std::clamp(b, 0.f, (float)(nmin - 1));
+            int   b0 = std::min((int)bc, nmin - 2);
+            float w = bc - (float)b0;
+
+            const float *p = &z.vector[a * smaj + b0 * smin];
+            float        h = (1.f - w) * p[0] + w * p[smin];
+
+            float  *pt = &ht[(size_t)(l - l1) * nmaj];
+            float  *ph = &hh[(size_t)(l - l1) * nmaj];
+            size_t &n = hn[l - l1];
+
+            // drop the hull vertices which can no longer be a tangency
+            // point
+            while (n >= 2 && (ph[n - 1] - h) * (pt[n - 2] - t) <=
+                                 (ph[n - 2] - h) * (pt[n - 1] - t))
+              n--;
+
+            hz[hz_index(l, a)] = n > 0 ? (ph[n - 1] - h) /
+                                             ((pt[n - 1] - t) * step)
+                                       : HMAP_HORIZON_NONE;
+
+            pt[n] = t;
+            ph[n] = h;
+            n++;
+          }
+        }
+      });
+
+  // --- interpolation between the lines surrounding each cell
+
+  const int nblocks_rows = (ny + HORIZON_SWEEP_BLOCK_SIZE - 1) /
+                           HORIZON_SWEEP_BLOCK_SIZE;
+
+  parallel_for(nblocks_rows,
+               [&](size_t ib)
+               {
+                 int j1 = (int)ib * HORIZON_SWEEP_BLOCK_SIZE;
+                 int j2 = std::min(j1 + HORIZON_SWEEP_BLOCK_SIZE, ny);
+
+                 for (int j = j1; j < j2; j++)
+                   for (int i = 0; i < nx; i++)
+                   {
+                     const int a = x_major ? i : j;
+                     const int bm = x_major ? j : i;
+
+                     float yc = (float)bm - s * (float)a;
+                     int   c0 = (int)std::floor(yc);
+                     float w = yc - (float)c0;
+                     int   l = c0 - cmin;
+
+                     float h0 = hz[hz_index(l, a)];
+                     float h1 = hz[hz_index(l + 1, a)];
+
+                     // one of the lines may be outside the array for
+                     // the cells of the array edges
+                     if (h0 == HORIZON_SWEEP_NOT_SAMPLED) h0 = h1;
+                     if (h1 == HORIZON_SWEEP_NOT_SAMPLED) h1 = h0;
+
+                     out(i, j) = (1.f - w) * h0 + w * h1;
+                   }
+               });
+
+  return out;
+}
+
+} // namespace hmap
@@ -1,14 +1,15 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
-#include "highmap/boundary.hpp"
 #include "highmap/gradient.hpp"
+#include "highmap/internal/horizon_sweep.hpp"
 #include "highmap/math.hpp"
 #include "highmap/primitives.hpp"
 
@@ -67,61 +68,77 @@ Array shadow_grid(const Array &z, float shadow_talus)
 Array shadow_heightmap(const Array &z,
                        float        azimuth,
                        float        zenith,
-                       float        distance)
+                       float        penumbra,
+                       float        zscale)
 {
-  // https://www.shadertoy.com/view/Xlsfzl
-  Array sh = Array(z.shape);
+  // the light comes from (cos(-azimuth), sin(-azimuth)) in the array index
+  // frame, azimuth = 180 for a light from the west
   float azimuth_rad = -M_PI * azimuth / 180.f;
   float zenith_rad = M_PI * zenith / 180.f;
-  float vx = distance * std::cos(azimuth_rad) * (float)(z.shape.x - 1);
-  float vy = distance * std::sin(azimuth_rad) * (float)(z.shape.y - 1);
-
-  Vec3<float> light_vector = Vec3<float>(vx, vy, std::sin(zenith_rad));
-
-  for (int j = 1; j < z.shape.y - 1; j++)
-    for (int i = 1; i < z.shape.x - 1; i++)
-    {
-      Vec3<float> normal = z.get_normal_at(i, j);
-      Vec3<float> pos;
-
-      float ndl = -normal.x * light_vector.x - normal.y * light_vector.y +
-                  normal.z * light_vector.z;
-
-      sh(i, j) = 1.f;
-
-      if (ndl > 0.f)
-      {
-        sh(i, j) = std::max(0.f, sh(i, j) - ndl * 0.6f); // diffuse light
-
-        for (float r = 0.f; r <= 1.f; r += 0.01f)
-        {
-          pos = {r * light_vector.x + (float)i,
-                 r * light_vector.y + (float)j,
-                 r * light_vector.z + z(i, j)};
-
-          int ip = (int)pos.x;
-          int jp = (int)pos.y;
-
-          if ((ip > 0) and (jp > 0) and (ip < z.shape.x) and (jp < z.shape.y))
-          {
-            if (pos.z < z(ip, jp) - 0.01f)
-            {
-              // sh(i, j) = 0.f;
-              break;
-            }
-          }
-          else
-            break;
-        }
-      }
-
-      // ambient
-      sh(i, j) += std::max(0.f, 0.3f * normal.z);
-    }
-
-  fill_borders(sh);
+  float penumbra_rad = M_PI * penumbra / 180.f;
+  float cell_size = 1.f / (zscale * (float)z.shape.x);
+
+  Array sh = horizon_tangent(z, azimuth_rad, cell_size);
+
+  for (auto &v : sh.vector)
+  {
+    // elevation of the light above the horizon
+    float delta = zenith_rad - std::atan(v);
+
+    if (penumbra_rad > 0.f)
+      v = std::clamp(0.5f + delta / penumbra_rad, 0.f, 1.f);
+    else
+      v = delta > 0.f ? 1.f : 0.f;
+  }
 
   return sh;
 }
 
+// average over a set of directions of a function of the tangent of the
+// (positive) horizon elevation angle
+template <typename F>
+static Array helper_horizon_average(const Array &z,
+                                    int          ndirections,
+                                    float        zscale,
+                                    F            fct)
+{
+  Array out(z.shape);
+  float cell_size = 1.f / (zscale * (float)z.shape.x);
+
+  ndirections = std::max(1, ndirections);
+
+  for (int k = 0; k < ndirections; k++)
+  {
+    float theta = 2.f * M_PI * (float)k / (float)ndirections;
+    Array hz = horizon_tangent(z, theta, cell_size);
+
+    for (size_t r = 0; r < out.vector.size(); r++)
+      out.vector[r] += fct(std::max(0.f, hz.vector[r]));
+  }
+
+  out *= 1.f / (float)ndirections;
+
+  return out;
+}
+
+Array ambient_occlusion(const Array &z, int ndirections, float zscale)
+{
+  // cosine-weighted fraction of the sky hemisphere which is visible
+  // (horizontal surface), 1 - sin(h)^2 = 1 / (1 + tan(h)^2)
+  return helper_horizon_average(z,
+                                ndirections,
+                                zscale,
+                                [](float t) { return 1.f / (1.f + t * t); });
+}
+
+Array sky_view_factor(const Array &z, int ndirections, float zscale)
+{
+  // Zaksek et al. (2011), 1 - sin(h) = 1 - tan(h) / sqrt(1 + tan(h)^2)
+  return helper_horizon_average(z,
+                                ndirections,
+                                zscale,
+                                [](float t)
+                                { return 1.f - t / std::sqrt(1.f + t * t); });
+}
+
 } // namespace hmap
@@ -1,6 +1,10 @@
 /* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
+#include <algorithm>
+#include <limits>
+#include <queue>
+
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
@@ -30,39 +34,54 @@ void find_path_dijkstra(const Array                   &z,
       {1.f, 1.f, 1.f, 1.f, M_SQRT2, M_SQRT2, M_SQRT2, M_SQRT2};
   const size_t nb = di.size();
 
-  // working queue and arrays
-  std::vector<int>   queue_i;
-  std::vector<int>   queue_j;
-  std::vector<float> queue_d; // distance
-  queue_i.reserve(shape.x * shape.y);
-  queue_j.reserve(shape.x * shape.y);
-  queue_d.reserve(shape.x * shape.y);
+  // cells are stored using their linear index
+  auto index = [&shape](int i, int j) { return j * shape.x + i; };
+
+  std::vector<float> distance(z.size(), std::numeric_limits<float>::max());
+  std::vector<int>   previous(z.size(), -1);
+  std::vector<char>  settled(z.size(), 0);
+  std::vector<char>  is_end(z.size(), 0);
+
+  size_t nend = 0;
+  float  z_end_min = std::numeric_limits<float>::max();
+
+  for (auto &ij : ij_end_list)
+  {
+    char &flag = is_end[index(ij.x, ij.y)];
+    if (!flag) nend++;
+    flag = 1;
+    z_end_min = std::min(z_end_min, z(ij.x, ij.y));
+  }
+
+  // A* heuristic: reaching the lowest endpoint from a lower cell
+  // costs at least 'elevation_ratio' times the elevation gain (the
+  // upslope term of the cost function), this lower bound is
+  // consistent and does not change the resulting paths
+  auto heuristic = [&](int i, int j)
+  { return elevation_ratio * std::max(0.f, z_end_min - z(i, j)); };
 
-  Mat<float> distance(shape);
-  Mat<int>   mask(shape);
-  Mat<int>   next_idx_i(shape);
-  Mat<int>   next_idx_j(shape);
+  // --- Dijkstra's algorithm (binary heap, stale entries are skipped)
 
-  // --- Dijkstra's algorithm
+  using Item = std::pair<float, int>; // (distance + heuristic, index)
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
 
-  queue_i.push_back(ij_start.x);
-  queue_j.push_back(ij_start.y);
-  queue_d.push_back(0.f);
-  mask(ij_start.x, ij_start.y) = true;
+  distance[index(ij_start.x, ij_start.y)] = 0.f;
+  queue.push({heuristic(ij_start.x, ij_start.y),
+              index(ij_start.x, ij_start.y)});
 
-  while (queue_i.size() > 0)
+  while (!queue.empty() && nend > 0)
   {
-    // next cell == min distance value
-    int kmin = std::distance(queue_d.begin(),
-                             std::min_element(queue_d.begin(), queue_d.end()));
+    int r = queue.top().second;
+    queue.pop();
 
-    int i = queue_i[kmin];
-    int j = queue_j[kmin];
-    mask(i, j) = false;
+    if (settled[r]) continue;
+    settled[r] = 1;
 
-    queue_i.erase(queue_i.begin() + kmin);
-    queue_j.erase(queue_j.begin() + kmin);
-    queue_d.erase(queue_d.begin() + kmin);
+    // stop as soon as all the endpoints are settled
+    if (is_end[r]) nend--;
+
+    int i = r % shape.x;
+    int j = r / shape.x;
 
     // loop over neighbors
     for (size_t k = 0; k < nb; k++)
@@ -70,38 +89,33 @@ void find_path_dijkstra(const Array                   &z,
       int p = i + di[k];
       int q = j + dj[k];
 
-      if ((p >= 0) and (p < shape.x) and (q >= 0) and (q < shape.y))
-      {
-        // previous cumulative value
-        float dist = distance(i, j);
+      if ((p < 0) or (p >= shape.x) or (q < 0) or (q >= shape.y)) continue;
 
-        // elevation difference contribution (weighted for diagonal
-        // directions to avoid artifacts)
-        float dz = (z(i, j) - z(p, q)) * cd[k];
-        if (dz < 0.f) dz *= upward_penalization;
-        dz = std::abs(dz);
+      int s = index(p, q);
+      if (settled[s]) continue;
 
-        dist += (1.f - elevation_ratio) * std::pow(dz, distance_exponent);
+      // previous cumulative value
+      float dist = distance[r];
 
-        // absolute elevation contribution (puts the emphasize on
-        // going downslope rather than upslope)
-        dist += elevation_ratio * std::max(0.f, cd[k] * (z(p, q) - z(i, j)));
+      // elevation difference contribution (weighted for diagonal
+      // directions to avoid artifacts)
+      float dz = (z(i, j) - z(p, q)) * cd[k];
+      if (dz < 0.f) dz *= upward_penalization;
+      dz = std::abs(dz);
 
-        if (p_mask_nogo) dist += 1e5f * (*p_mask_nogo)(p, q);
+      dist += (1.f - elevation_ratio) * std::pow(dz, distance_exponent);
 
-        if (distance(p, q) == 0.f)
-          if ((mask(p, q) == 0) or (dist < distance(p, q)))
-          {
-            distance(p, q) = dist;
+      // absolute elevation contribution (puts the emphasize on
+      // going downslope rather than upslope)
+      dist += elevation_ratio * std::max(0.f, cd[k] * (z(p, q) - z(i, j)));
 
-            mask(p, q) = true;
-            queue_i.push_back(p);
-            queue_j.push_back(q);
-            queue_d.push_back(dist);
+      if (p_mask_nogo) dist += 1e5f * (*p_mask_nogo)(p, q);
 
-            next_idx_i(p, q) = i;
-            next_idx_j(p, q) = j;
-          }
+      if (dist < distance[s])
+      {
+        distance[s] = dist;
+        previous[s] = r;
+        queue.push({dist + heuristic(p, q), s});
       }
     }
   }
@@ -113,23 +127,14 @@ void find_path_dijkstra(const Array                   &z,
 
   for (auto ij_end : ij_end_list)
   {
-    int ic = ij_end.x;
-    int jc = ij_end.y;
-
     std::vector<int> i_path, j_path;
 
-    while ((ic != ij_start.x) or (jc != ij_start.y))
+    for (int r = index(ij_end.x, ij_end.y); r >= 0; r = previous[r])
     {
-      i_path.push_back(ic);
-      j_path.push_back(jc);
-
-      ic = next_idx_i(ic, jc);
-      jc = next_idx_j(ic, jc);
+      i_path.push_back(r % shape.x);
+      j_path.push_back(r / shape.x);
     }
 
-    i_path.push_back(ic);
-    j_path.push_back(jc);
-
     std::reverse(i_path.begin(), i_path.end());
     std::reverse(j_path.begin(), j_path.end());
 
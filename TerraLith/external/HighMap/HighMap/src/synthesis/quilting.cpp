@@ -4,6 +4,7 @@
 #include "macrologger.h"
 
 #include "highmap/array.hpp"
+#include "highmap/execution_context.hpp"
 #include "highmap/math.hpp"
 #include "highmap/operator.hpp"
 #include "highmap/transform.hpp"
@@ -51,6 +52,8 @@ Array quilting(const std::vector<const Array *> &p_arrays,
 
   for (int jt = 0; jt < tiling.y; jt++)
   {
+    poll_execution_context((float)jt / (float)tiling.y);
+
     int   j1 = jt * patch_base_shape.y; // tile start
     Array array_strip = Array(Vec2<int>(array_out.shape.x, patch_shape.y));
 
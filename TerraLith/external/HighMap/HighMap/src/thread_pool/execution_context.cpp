@@ -0,0 +1,59 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+
+#include "highmap/execution_context.hpp"
+
+namespace hmap
+{
+
+static thread_local const ExecutionContext *current_context = nullptr;
+
+// --- ExecutionContext
+
+ExecutionContext::ExecutionContext(std::function<bool()>      cancel_requested,
+                                   std::function<void(float)> progress)
+    : cancel_requested(std::move(cancel_requested)),
+      progress(std::move(progress))
+{
+}
+
+bool ExecutionContext::is_cancel_requested() const
+{
+  return this->cancel_requested && this->cancel_requested();
+}
+
+void ExecutionContext::report_progress(float progress) const
+{
+  if (this->progress) this->progress(std::clamp(progress, 0.f, 1.f));
+}
+
+// --- ScopedExecutionContext
+
+ScopedExecutionContext::ScopedExecutionContext(
+    const ExecutionContext *p_context)
+    : p_previous(current_context)
+{
+  current_context = p_context;
+}
+
+ScopedExecutionContext::~ScopedExecutionContext()
+{
+  current_context = this->p_previous;
+}
+
+// --- functions
+
+const ExecutionContext *get_execution_context() { return current_context; }
+
+void poll_execution_context(float progress)
+{
+  if (!current_context) return;
+
+  if (progress >= 0.f) current_context->report_progress(progress);
+
+  if (current_context->is_cancel_requested()) throw OperationCancelled();
+}
+
+} // namespace hmap
@@ -0,0 +1,264 @@
+/* Copyright (c) 2025 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include "macrologger.h"
+
+#include "highmap/execution_context.hpp"
+#include "highmap/thread_pool.hpp"
+
+namespace hmap
+{
+
+// index of the worker owning the current thread, -1 if the thread is
+// not a pool worker
+static thread_local int current_worker_index = -1;
+
+// --- ThreadPool
+
+ThreadPool &ThreadPool::get_instance()
+{
+  static ThreadPool instance;
+  return instance;
+}
+
+ThreadPool::ThreadPool() { this->start(0); }
+
+ThreadPool::~ThreadPool() { this->stop(); }
+
+size_t ThreadPool::get_nthreads() const { return this->workers.size(); }
+
+bool ThreadPool::is_worker_thread() const { return current_worker_index >= 0; }
+
+void ThreadPool::notify_all()
+{
+  // lock to avoid a lost wake-up between a predicate check and the
+  // actual wait of a sleeping thread
+  {
+    std::lock_guard<std::mutex> lock(this->sleep_mtx);
+  }
+  this->cv.notify_all();
+}
+
+bool ThreadPool::pop_task(std::function<void()> &task)
+{
+  if (this->ntasks_pending.load() == 0) return false;
+
+  const size_t nqueues = this->queues.size();
+  const size_t iinject = nqueues - 1;
+
+  // own queue first, most recent task (LIFO) for cache locality
+  if (current_worker_index >= 0)
+  {
+    WorkQueue                  &q = *this->queues[current_worker_index];
+    std::lock_guard<std::mutex> lock(q.mtx);
+
+    if (!q.tasks.empty())
+    {
+      task = std::move(q.tasks.back());
+      q.tasks.pop_back();
+      this->ntasks_pending--;
+      return true;
+    }
+  }
+
+  // then the injection queue and the other workers, oldest task
+  // (FIFO) first
+  size_t start = current_worker_index >= 0 ? (size_t)current_worker_index + 1
+                                           : iinject;
+
+  for (size_t r = 0; r < nqueues; ++r)
+  {
+    size_t k = (start + r) % nqueues;
+    if ((int)k == current_worker_index) continue;
+
+    WorkQueue                  &q = *this->queues[k];
+    std::lock_guard<std::mutex> lock(q.mtx);
+
+    if (!q.tasks.empty())
+    {
+      task = std::move(q.tasks.front());
+      q.tasks.pop_front();
+      this->ntasks_pending--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::set_nthreads(size_t new_nthreads)
+{
+  if (this->ntasks_pending.load() > 0)
+  {
+    LOG_ERROR("ThreadPool::set_nthreads: tasks are pending, request ignored");
+    return;
+  }
+
+  this->stop();
+  this->start(new_nthreads);
+}
+
+void ThreadPool::start(size_t nthreads)
+{
+  if (nthreads == 0)
+    nthreads = std::max(1u, std::thread::hardware_concurrency());
+
+  this->stop_requested = false;
+
+  this->queues.clear();
+  for (size_t k = 0; k < nthreads + 1; ++k)
+    this->queues.push_back(std::make_unique<WorkQueue>());
+
+  for (size_t k = 0; k < nthreads; ++k)
+    this->workers.emplace_back(&ThreadPool::worker_loop, this, k);
+
+  LOG_DEBUG("ThreadPool: %d workers", (int)nthreads);
+}
+
+void ThreadPool::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->sleep_mtx);
+    this->stop_requested = true;
+  }
+  this->cv.notify_all();
+
+  for (auto &t : this->workers)
+    t.join();
+
+  this->workers.clear();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+  // a worker keeps its own tasks, others go to the injection queue
+  size_t k = current_worker_index >= 0 ? (size_t)current_worker_index
+                                       : this->queues.size() - 1;
+  {
+    std::lock_guard<std::mutex> lock(this->queues[k]->mtx);
+    this->queues[k]->tasks.push_back(std::move(task));
+    this->ntasks_pending++;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->sleep_mtx);
+  }
+  this->cv.notify_one();
+}
+
+bool ThreadPool::try_run_pending_task()
+{
+  std::function<void()> task;
+
+  if (!this->pop_task(task)) return false;
+
+  task();
+  return true;
+}
+
+void ThreadPool::wait_until(const std::function<bool()> &done)
+{
+  while (!done())
+  {
+    if (this->try_run_pending_task()) continue;
+
+    std::unique_lock<std::mutex> lock(this->sleep_mtx);
+    this->cv.wait(lock,
+                  [this, &done]()
+                  {
+                    return done() || this->ntasks_pending.load() > 0 ||
+                           this->stop_requested;
+                  });
+  }
+}
+
+void ThreadPool::worker_loop(size_t index)
+{
+  current_worker_index = (int)index;
+
+  while (true)
+  {
+    if (this->try_run_pending_task()) continue;
+
+    std::unique_lock<std::mutex> lock(this->sleep_mtx);
+    this->cv.wait(lock,
+                  [this]()
+                  {
+                    return this->stop_requested ||
+                           this->ntasks_pending.load() > 0;
+                  });
+
+    if (this->stop_requested) break;
+  }
+
+  current_worker_index = -1;
+}
+
+// --- TaskGroup
+
+TaskGroup::~TaskGroup()
+{
+  ThreadPool::get_instance().wait_until([this]()
+                                        { return this->npending.load() == 0; });
+}
+
+void TaskGroup::run(std::function<void()> task)
+{
+  this->npending++;
+
+  // the tasks poll the execution context of the submitting thread
+  const ExecutionContext *p_context = get_execution_context();
+
+  auto wrapper = [this, task = std::move(task), p_context]()
+  {
+    try
+    {
+      ScopedExecutionContext scope(p_context);
+      task();
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(this->error_mtx);
+      if (!this->error) this->error = std::current_exception();
+    }
+
+    if (--this->npending == 0) ThreadPool::get_instance().notify_all();
+  };
+
+  ThreadPool::get_instance().submit(std::move(wrapper));
+}
+
+void TaskGroup::wait()
+{
+  ThreadPool::get_instance().wait_until([this]()
+                                        { return this->npending.load() == 0; });
+
+  if (this->error)
+  {
+    std::exception_ptr e = this->error;
+    this->error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+// --- helper
+
+void parallel_for(size_t n, const std::function<void(size_t)> &fct)
+{
+  if (n == 0) return;
+
+  if (n == 1)
+  {
+    fct(0);
+    return;
+  }
+
+  TaskGroup group;
+
+  for (size_t k = 0; k < n; ++k)
+    group.run([&fct, k]() { fct(k); });
+
+  group.wait();
+}
+
+} // namespace hmap
@@ -116,7 +116,7 @@ Array translate(const Array &array,
                                &dx_array,
                                &dy_array,
                                nullptr,
-                               f.get_delegate());
+                               f);
 
   return array_out;
 }
@@ -159,7 +159,7 @@ Array zoom(const Array &array,
                                p_noise_x,
                                p_noise_y,
                                nullptr,
-                               f.get_delegate());
+                               f);
 
   return array_out;
 }
@@ -0,0 +1,29 @@
+#include "highmap.hpp"
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {256, 256};
+  hmap::Vec2<float> kw = {2.f, 2.f};
+  int               seed = 2;
+
+  hmap::Array z1 = hmap::noise_fbm(hmap::NoiseType::PERLIN, shape, kw, ++seed);
+  hmap::Array z2 = 0.5f * hmap::noise_fbm(hmap::NoiseType::WORLEY,
+                                          shape,
+                                          2.f * kw,
+                                          ++seed);
+
+  hmap::Array z3 = hmap::blend_poisson(z1, z2);
+
+  // with a mask
+  hmap::Array mask = hmap::gaussian_pulse(shape, 32.f);
+  hmap::Array z4 = hmap::blend_poisson(z1, z2, &mask);
+
+  hmap::remap(z1);
+  hmap::remap(z2);
+  hmap::remap(z3);
+  hmap::remap(z4);
+
+  hmap::export_banner_png("ex_blend_poisson.png",
+                          {z1, z2, z3, mask, z4},
+                          hmap::Cmap::JET);
+}
@@ -0,0 +1,18 @@
+#include "highmap.hpp"
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {256, 256};
+  hmap::Vec2<float> res = {4.f, 4.f};
+  int               seed = 1;
+
+  hmap::Array z = hmap::noise_fbm(hmap::NoiseType::PERLIN, shape, res, seed);
+  hmap::remap(z);
+
+  auto z1 = z;
+  hmap::depression_filling(z1);
+
+  hmap::export_banner_png("ex_depression_filling.png",
+                          {z, z1, z1 - z},
+                          hmap::Cmap::JET);
+}
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <iostream>
+
+#include "highmap.hpp"
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {512, 512};
+  hmap::Vec2<float> res = {2.f, 2.f};
+  int               seed = 2;
+
+  hmap::Array z = hmap::noise_fbm(hmap::NoiseType::PERLIN, shape, res, seed);
+  hmap::remap(z);
+  auto z0 = z;
+
+  // cancel the erosion half-way (from the progress sink, usually from
+  // another thread)
+  std::atomic<bool> cancel = false;
+
+  hmap::ExecutionContext ctx([&cancel]() { return cancel.load(); },
+                             [&cancel](float progress)
+                             {
+                               if (progress >= 0.5f) cancel = true;
+                             });
+
+  hmap::VpipesState state;
+
+  try
+  {
+    hmap::ScopedExecutionContext scope(&ctx);
+    hmap::hydraulic_vpipes(z,
+                           state,
+                           300,
+                           nullptr,
+                           nullptr,
+                           0.1f,
+                           0.1f,
+                           0.05f,
+                           0.05f,
+                           0.f,
+                           0.01f);
+  }
+  catch (const hmap::OperationCancelled &e)
+  {
+    std::cout << e.what() << " at iteration " << state.iteration << "\n";
+  }
+
+  auto z1 = z;
+
+  // the state is consistent, the erosion can be resumed (without
+  // context, nothing is polled)
+  hmap::hydraulic_vpipes(z,
+                         state,
+                         300 - state.iteration,
+                         nullptr,
+                         nullptr,
+                         0.1f,
+                         0.1f,
+                         0.05f,
+                         0.05f,
+                         0.f,
+                         0.01f);
+
+  std::cout << "iterations: " << state.iteration << "\n";
+
+  z.infos();
+
+  hmap::export_banner_png("ex_execution_context.png",
+                          {z0, z1, z},
+                          hmap::Cmap::TERRAIN);
+}
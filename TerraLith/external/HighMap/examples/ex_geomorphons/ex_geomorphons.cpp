@@ -14,8 +14,10 @@ int main(void)
   int   irmax = 4;
   float epsilon = 0.001f;
 
-  hmap::Array labels = hmap::geomorphons(z, irmin, irmax, epsilon);
+  hmap::Array code;
+  hmap::Array labels = hmap::geomorphons(z, irmin, irmax, epsilon, &code);
 
   z.to_png("ex_geomorphons0.png", hmap::Cmap::TERRAIN);
   labels.to_png("ex_geomorphons1.png", hmap::Cmap::NIPY_SPECTRAL);
+  code.to_png("ex_geomorphons2.png", hmap::Cmap::NIPY_SPECTRAL);
 }
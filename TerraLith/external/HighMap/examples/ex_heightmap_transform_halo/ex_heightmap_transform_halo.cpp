@@ -0,0 +1,66 @@
+#include <iostream>
+
+#include "highmap.hpp"
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {256, 256};
+  hmap::Vec2<int>   tiling = {4, 2};
+  float             overlap = 0.25;
+  hmap::Vec2<float> kw = {16.f, 16.f};
+  int               seed = 1;
+
+  hmap::Heightmap h = hmap::Heightmap(shape, tiling, overlap);
+
+  hmap::fill(h,
+             [&kw, &seed](hmap::Vec2<int> shape, hmap::Vec4<float> bbox)
+             {
+               return hmap::noise(hmap::NoiseType::PERLIN,
+                                  shape,
+                                  kw,
+                                  seed,
+                                  nullptr,
+                                  nullptr,
+                                  nullptr,
+                                  bbox);
+             });
+
+  hmap::Heightmap h_single = h;
+  hmap::Heightmap h_distributed = h;
+  hmap::Heightmap h_halo = h;
+
+  // one Laplace iteration per call, the stencil radius is 1
+  auto op = [](std::vector<hmap::Array *> p_arrays)
+  { hmap::laplace(*p_arrays[0], 0.2f, 1); };
+
+  int iterations = 50;
+
+  hmap::transform({&h_single},
+                  op,
+                  hmap::TransformMode::SINGLE_ARRAY,
+                  -1,
+                  iterations);
+
+  hmap::transform({&h_distributed},
+                  op,
+                  hmap::TransformMode::DISTRIBUTED,
+                  -1,
+                  iterations);
+  h_distributed.smooth_overlap_buffers();
+
+  // ghost cells exchanged before each iteration, no blending required
+  hmap::transform({&h_halo}, op, hmap::TransformMode::HALO, 1, iterations);
+
+  hmap::Array a_single = h_single.to_array();
+  hmap::Array a_distributed = h_distributed.to_array();
+  hmap::Array a_halo = h_halo.to_array();
+
+  std::cout << "max. difference with the single array result\n";
+  std::cout << "distributed: "
+            << (hmap::abs(a_distributed - a_single)).max() << "\n";
+  std::cout << "halo: " << (hmap::abs(a_halo - a_single)).max() << "\n";
+
+  hmap::export_banner_png("ex_heightmap_transform_halo.png",
+                          {h.to_array(), a_single, a_distributed, a_halo},
+                          hmap::Cmap::INFERNO);
+}
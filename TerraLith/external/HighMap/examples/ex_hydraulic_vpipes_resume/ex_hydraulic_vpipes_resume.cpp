@@ -0,0 +1,66 @@
+#include <iostream>
+
+#include "highmap.hpp"
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {512, 512};
+  hmap::Vec2<float> res = {2.f, 2.f};
+  int               seed = 2;
+
+  hmap::Array z = hmap::noise_fbm(hmap::NoiseType::PERLIN, shape, res, seed);
+  hmap::remap(z);
+  auto z0 = z;
+
+  // first half of the simulation, then checkpoint
+  hmap::VpipesState   state;
+  hmap::VpipesTimings timings;
+
+  hmap::hydraulic_vpipes(z,
+                         state,
+                         150,
+                         nullptr,
+                         nullptr,
+                         0.1f,
+                         0.1f,
+                         0.05f,
+                         0.05f,
+                         0.f,
+                         0.01f,
+                         &timings);
+
+  auto z1 = z;
+  state.to_file("ex_hydraulic_vpipes_resume.bin", z);
+
+  // resume from the checkpoint
+  hmap::VpipesState state_resumed;
+  hmap::Array       z_resumed;
+
+  if (!state_resumed.from_file("ex_hydraulic_vpipes_resume.bin", z_resumed))
+    return 1;
+
+  hmap::hydraulic_vpipes(z_resumed,
+                         state_resumed,
+                         150,
+                         nullptr,
+                         nullptr,
+                         0.1f,
+                         0.1f,
+                         0.05f,
+                         0.05f,
+                         0.f,
+                         0.01f,
+                         &timings);
+
+  std::cout << "iterations: " << state_resumed.iteration << "\n";
+  std::cout << "flux: " << timings.flux << " ms\n";
+  std::cout << "transport: " << timings.transport << " ms\n";
+  std::cout << "erosion: " << timings.erosion << " ms\n";
+  std::cout << "advection: " << timings.advection << " ms\n";
+
+  z_resumed.infos();
+
+  hmap::export_banner_png("ex_hydraulic_vpipes_resume.png",
+                          {z0, z1, z_resumed, state_resumed.d},
+                          hmap::Cmap::TERRAIN);
+}
@@ -0,0 +1,22 @@
+#include "highmap.hpp"
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {256, 256};
+  hmap::Vec2<float> res = {4.f, 4.f};
+  int               seed = 1;
+
+  hmap::Array z = hmap::noise_fbm(hmap::NoiseType::PERLIN, shape, res, seed);
+  hmap::remap(z);
+
+  float azimuth = 180.f; // light from the west
+  float zenith = 20.f;   // light elevation angle
+
+  hmap::Array sh = hmap::shadow_heightmap(z, azimuth, zenith);
+  hmap::Array ao = hmap::ambient_occlusion(z);
+  hmap::Array svf = hmap::sky_view_factor(z);
+
+  hmap::export_banner_png("ex_shadow_heightmap.png",
+                          {z, sh, ao, svf},
+                          hmap::Cmap::BONE);
+}
@@ -0,0 +1,57 @@
+#include <iostream>
+
+#include "highmap.hpp"
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {1024, 1024};
+  hmap::Vec2<int>   tiling = {8, 8};
+  float             overlap = 0.25;
+  hmap::Vec2<float> kw = {4.f, 4.f};
+  int               seed = 1;
+
+  // room for about 4 tiles only, the other ones are paged out to the
+  // scratch file
+  size_t ram_budget = 4 * 192 * 192 * sizeof(float);
+
+  hmap::TileStore store(shape,
+                        tiling,
+                        overlap,
+                        "ex_tile_store.bin",
+                        ram_budget);
+
+  hmap::fill(store,
+             [&kw, &seed](hmap::Vec2<int> shape, hmap::Vec4<float> bbox)
+             {
+               return hmap::noise_fbm(hmap::NoiseType::PERLIN,
+                                      shape,
+                                      kw,
+                                      seed,
+                                      8,
+                                      0.7f,
+                                      0.5f,
+                                      2.f,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr,
+                                      bbox);
+             });
+
+  hmap::transform({&store},
+                  [](std::vector<hmap::Array *> p_arrays,
+                     hmap::Vec2<int>,
+                     hmap::Vec4<float>)
+                  { *p_arrays[0] = hmap::abs(*p_arrays[0]); });
+
+  std::cout << "resident memory: " << store.get_resident_bytes()
+            << " bytes (budget: " << ram_budget << " bytes)\n";
+
+  // written without assembling the full array
+  hmap::write_raw_16bit("ex_tile_store.raw", store);
+  hmap::export_tiled("ex_tile_store", store, 2, CV_16U);
+
+  // in-memory copy for comparison
+  hmap::Heightmap h = store.to_heightmap();
+  h.to_array().to_png("ex_tile_store.png", hmap::Cmap::INFERNO);
+}
@@ -0,0 +1,102 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "highmap.hpp"
+
+// number of tiles kept alive by an heightmap (slots and retired tiles)
+size_t resident_tiles(const hmap::Heightmap &h)
+{
+  return h.tiles.size() + h.tiles.get_nretired();
+}
+
+int main(void)
+{
+  hmap::Vec2<int>   shape = {256, 256};
+  hmap::Vec2<int>   tiling = {4, 4};
+  float             overlap = 0.25f;
+  hmap::Vec2<float> kw = {4.f, 4.f};
+  int               seed = 1;
+
+  hmap::Heightmap h(shape, tiling, overlap);
+  hmap::Heightmap dx(shape, tiling, overlap);
+
+  hmap::transform(
+      {&dx},
+      [&kw, &seed](std::vector<hmap::Array *> p_arrays,
+                   hmap::Vec2<int>            shape,
+                   hmap::Vec4<float>          bbox)
+      {
+        *p_arrays[0] = 0.1f * hmap::noise(hmap::NoiseType::PERLIN,
+                                          shape,
+                                          kw,
+                                          seed,
+                                          nullptr,
+                                          nullptr,
+                                          nullptr,
+                                          bbox);
+      });
+
+  // copies kept by a cache, the tiles are shared with 'h' and 'dx'
+  hmap::Heightmap h_cache;
+  hmap::Heightmap dx_cache = dx;
+
+  size_t nresident = 0;
+
+  // recompute loop, as done by a node graph with an output cache
+  for (int it = 0; it < 10; it++)
+  {
+    h_cache = h;
+
+    hmap::transform(
+        {&h},
+        {&dx},
+        [&kw, &seed](std::vector<hmap::Array *>       p_arrays_out,
+                     std::vector<const hmap::Array *> p_arrays_in,
+                     hmap::Vec2<int>                  shape,
+                     hmap::Vec4<float>                bbox)
+        {
+          *p_arrays_out[0] = hmap::noise(hmap::NoiseType::PERLIN,
+                                         shape,
+                                         kw,
+                                         seed,
+                                         p_arrays_in[0],
+                                         nullptr,
+                                         nullptr,
+                                         bbox);
+        });
+
+    // the input is only read, its shared tiles are not detached
+    for (size_t k = 0; k < dx.tiles.size(); k++)
+      if (!dx.tiles.is_shared(k))
+      {
+        std::cerr << "FAILED: input tile " << k << " detached\n";
+        return EXIT_FAILURE;
+      }
+
+    if (dx.tiles.get_nretired() != 0)
+    {
+      std::cerr << "FAILED: input tiles retired\n";
+      return EXIT_FAILURE;
+    }
+
+    // the output tiles shared with the cache have been detached, the
+    // previous ones are retired until the owner collects them
+    std::cout << "iteration " << it << ", retired tiles: "
+              << h.tiles.get_nretired() << "\n";
+
+    h.tiles.collect();
+
+    if (it == 0) nresident = resident_tiles(h);
+
+    if (h.tiles.get_nretired() != 0 || resident_tiles(h) != nresident)
+    {
+      std::cerr << "FAILED: resident tiles " << resident_tiles(h)
+                << " (expected " << nresident << ")\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "resident tiles: " << nresident << "\n";
+
+  return EXIT_SUCCESS;
+}
@@ -10,7 +10,7 @@ int main(void)
   hmap::remap(z);
 
   hmap::Array water_depth = hmap::flooding_uniform_level(z, 0.3f);
-  // hmap::Array water_depth = hmap::flooding_lake_system(z, 500, 1e-4f);
+  // hmap::Array water_depth = hmap::flooding_lake_system(z, 1e-4f);
 
   hmap::Array mask0 = hmap::water_mask(water_depth);
   hmap::Array mask1 = hmap::water_mask(water_depth, z, 0.075f);
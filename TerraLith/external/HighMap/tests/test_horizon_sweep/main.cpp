@@ -0,0 +1,121 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/* Accuracy of the horizon sweep (see shadow_heightmap) against a brute-force
+ * search along the line through each cell. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "highmap.hpp"
+#include "highmap/internal/horizon_sweep.hpp"
+
+#define CHECK(cond)                                                            \
+  if (!(cond))                                                                 \
+  {                                                                            \
+    std::cerr << "FAILED: " << #cond << " (line " << __LINE__ << ")\n";        \
+    return EXIT_FAILURE;                                                       \
+  }
+
+// horizon tangent of the cell (i, j), from the samples of the line through
+// the cell (same sampling as the sweep)
+float horizon_tangent_brute_force(const hmap::Array &z,
+                                  int                i,
+                                  int                j,
+                                  float              theta,
+                                  float              cell_size)
+{
+  const float ux = std::cos(theta);
+  const float uy = std::sin(theta);
+  const bool  x_major = std::abs(ux) >= std::abs(uy);
+  const int   nmaj = x_major ? z.shape.x : z.shape.y;
+  const int   nmin = x_major ? z.shape.y : z.shape.x;
+  const int   sa = (x_major ? ux : uy) > 0.f ? 1 : -1;
+  const float s = x_major ? uy / ux : ux / uy;
+  const float step = cell_size * std::sqrt(1.f + s * s);
+
+  float tmax = HMAP_HORIZON_NONE;
+
+  for (int k = 1;; k++)
+  {
+    int   a = (x_major ? i : j) + sa * k;
+    float b = (float)(x_major ? j : i) + s * (float)(sa * k);
+
+    if (a < 0 || a >= nmaj || b < -1e-3f || b > (float)(nmin - 1) + 1e-3f)
+      break;
+
+    b = std::clamp(b, 0.f, (float)(nmin - 1));
+    int   b0 = std::min((int)b, nmin - 2);
+    float w = b - (float)b0;
+    float h = x_major ? (1.f - w) * z(a, b0) + w * z(a, b0 + 1)
+                      : (1.f - w) * z(b0, a) + w * z(b0 + 1, a);
+
+    tmax = std::max(tmax, (h - z(i, j)) / ((float)k * step));
+  }
+
+  return tmax;
+}
+
+// sorted angular errors (in radians) over the cells with terrain ahead
+std::vector<float> horizon_errors(const hmap::Array &z, float theta)
+{
+  const float cell_size = 1.f / (float)z.shape.x;
+  hmap::Array hz = hmap::horizon_tangent(z, theta, cell_size);
+
+  std::vector<float> errors;
+
+  for (int j = 0; j < z.shape.y; j++)
+    for (int i = 0; i < z.shape.x; i++)
+    {
+      float t = horizon_tangent_brute_force(z, i, j, theta, cell_size);
+
+      // array edges, one of the lines has no terrain ahead
+      if (t == HMAP_HORIZON_NONE || hz(i, j) < -1e20f) continue;
+
+      errors.push_back(std::abs(std::atan(hz(i, j)) - std::atan(t)));
+    }
+
+  std::sort(errors.begin(), errors.end());
+  return errors;
+}
+
+int main(void)
+{
+  const hmap::Vec2<int> shape = {256, 256};
+
+  hmap::Array z = hmap::noise_fbm(hmap::NoiseType::PERLIN,
+                                  shape,
+                                  {4.f, 4.f},
+                                  1);
+  hmap::remap(z);
+
+  // --- axis and diagonal directions, the lines go through the cells
+
+  for (float deg : {0.f, 45.f, 90.f, 180.f, 225.f})
+  {
+    std::vector<float> errors = horizon_errors(z, deg * M_PI / 180.f);
+
+    CHECK(!errors.empty());
+    CHECK(errors.back() < 1e-3f);
+  }
+
+  // --- other directions, interpolated between the lines (the tolerances
+  //     documented by shadow_heightmap)
+
+  for (float deg : {20.f, 110.f, 200.f, 290.f})
+  {
+    std::vector<float> errors = horizon_errors(z, deg * M_PI / 180.f);
+
+    CHECK(!errors.empty());
+    CHECK(errors[errors.size() / 2] < 0.005f);
+    CHECK(errors[errors.size() * 99 / 100] < 0.15f);
+  }
+
+  std::cout << "test_horizon_sweep: OK\n";
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "highmap.hpp"
+
+#define CHECK(cond)                                                            \
+  if (!(cond))                                                                 \
+  {                                                                            \
+    std::cerr << "FAILED: " << #cond << " (line " << __LINE__ << ")\n";        \
+    return EXIT_FAILURE;                                                       \
+  }
+
+const hmap::Vec2<int> shape = {64, 64};
+const hmap::Vec2<int> tiling = {4, 4};
+const float           overlap = 0.f;
+const size_t          tile_bytes = 16 * 16 * sizeof(float);
+
+// value of the cell (i, j) of the tile k
+float tile_value(size_t k, int i, int j)
+{
+  return (float)(1000 * k + 16 * j + i);
+}
+
+int main(void)
+{
+  // --- evict -> reload round trip, the budget holds a single tile
+
+  {
+    hmap::TileStore store(shape,
+                          tiling,
+                          overlap,
+                          "test_tile_store_0.bin",
+                          tile_bytes);
+
+    for (size_t k = 0; k < store.get_ntiles(); k++)
+    {
+      std::shared_ptr<hmap::Tile> tile = store.acquire(k);
+      for (int j = 0; j < tile->shape.y; j++)
+        for (int i = 0; i < tile->shape.x; i++)
+          (*tile)(i, j) = tile_value(k, i, j);
+    }
+
+    CHECK(store.get_resident_bytes() <= tile_bytes);
+
+    for (size_t k = 0; k < store.get_ntiles(); k++)
+    {
+      std::shared_ptr<hmap::Tile> tile = store.acquire(k, false);
+      for (int j = 0; j < tile->shape.y; j++)
+        for (int i = 0; i < tile->shape.x; i++)
+          CHECK((*tile)(i, j) == tile_value(k, i, j));
+    }
+
+    CHECK(store.get_resident_bytes() <= tile_bytes);
+  }
+
+  // --- flush while a tile is held: the tile is not written (it can still
+  // --- be modified) and it is still written back when evicted
+
+  {
+    hmap::TileStore store(shape,
+                          tiling,
+                          overlap,
+                          "test_tile_store_1.bin",
+                          tile_bytes);
+
+    {
+      std::shared_ptr<hmap::Tile> tile = store.acquire(0);
+      std::fill(tile->vector.begin(), tile->vector.end(), 1.f);
+
+      store.flush();
+
+      std::fill(tile->vector.begin(), tile->vector.end(), 2.f);
+    }
+
+    // pages tile 0 out, then back in
+    for (size_t k = 1; k < store.get_ntiles(); k++)
+      store.acquire(k, false);
+
+    std::shared_ptr<hmap::Tile> tile = store.acquire(0, false);
+
+    CHECK(tile->min() == 2.f && tile->max() == 2.f);
+
+    // released tiles are written by the flush
+    tile.reset();
+    std::shared_ptr<hmap::Tile> tile1 = store.acquire(1);
+    std::fill(tile1->vector.begin(), tile1->vector.end(), 3.f);
+    tile1.reset();
+
+    store.flush();
+
+    for (size_t k = 2; k < store.get_ntiles(); k++)
+      store.acquire(k, false);
+
+    CHECK(store.acquire(1, false)->max() == 3.f);
+  }
+
+  std::cout << "test_tile_store: OK\n";
+
+  return EXIT_SUCCESS;
+}